@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/scratch/ns3-dev-evaluate_fst_mechanism-debug', 'build/scratch/ns3-dev-evaluate_SPAllocation-debug', 'build/scratch/ns3-dev-evaluate_4STAfeedback-debug', 'build/scratch/ns3-dev-evaluate_SP_5STA-debug', 'build/scratch/ns3-dev-evaluate_beacon_interval-debug', 'build/scratch/ns3-dev-evaluate_fullduplex_relay-debug', 'build/scratch/ns3-dev-evaluate_4STAalg-debug', 'build/scratch/subdir/ns3-dev-subdir-debug', 'build/scratch/ns3-dev-evaluate_4STAnewalg-debug', 'build/scratch/ns3-dev-evaluate_beamforming-debug', 'build/scratch/ns3-dev-evaluate_dmg_throughput_Sally3STAInterference-debug', 'build/scratch/ns3-dev-interference_dmgAdhocMac-debug', 'build/scratch/ns3-dev-evaluate_SP_4STA-debug', 'build/scratch/ns3-dev-evaluate_multiSTA-debug', 'build/scratch/ns3-dev-evaluate_dmg_throughput-debug', 'build/scratch/ns3-dev-evaluate_service_period-debug', 'build/scratch/ns3-dev-evaluate_4STAcomp-debug', 'build/scratch/ns3-dev-evaluate_dmg_throughput_SallyAddInterference-debug', 'build/scratch/ns3-dev-scratch-simulator-debug', 'build/scratch/ns3-dev-evaluate_dmg_throughput_SallyModify-debug', 'build/scratch/ns3-dev-wifi-simple-interference-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BURST_SEND_APPLICATION_H
+#define BURST_SEND_APPLICATION_H
+
+#include <string>
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class Address;
+class Socket;
+
+/**
+ * \ingroup applications
+ * \defgroup burstsend BurstSendApplication
+ *
+ * This traffic generator sends constant bit rate traffic, like the
+ * OnOffApplication in its on state, but in bursts: instead of scheduling
+ * an event per packet, it sends at once, every BurstInterval, the packets
+ * generated since the previous burst.  Each packet carries a TimestampTag
+ * holding the time it was generated, so that the delays measured by the
+ * receiver (see PacketSink::GetAverageDelay) include the time the packet
+ * waited for its burst.  At multi-gigabit rates this divides the number
+ * of application events by the number of packets in a burst.
+ *
+ * In saturated mode, the application rather keeps a queue below the
+ * socket (typically the MAC queue of the device) backlogged: every time
+ * packets leave the queue, it sends as many packets as needed to refill
+ * it to the Backlog size, with one event per refill.  While the packets
+ * do not reach the queue (e.g., dropped by a STA which is not associated
+ * yet), it tries to refill it again every BurstInterval.
+ */
+
+/**
+ * \ingroup burstsend
+ *
+ * \brief Send constant bit rate traffic in bursts, or keep a queue
+ * backlogged.
+ *
+ * The bursts are also limited by the socket: they stop when the socket
+ * does not accept a packet (e.g., a full TCP send buffer), the remaining
+ * packets being sent as soon as the socket notifies free space, or in the
+ * next burst.  If a backlog queue is set, they also stop when the queue
+ * holds Backlog packets, and resume when packets leave the queue.
+ */
+class BurstSendApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  BurstSendApplication ();
+
+  virtual ~BurstSendApplication ();
+
+  /**
+   * \brief Set the total number of bytes to send.
+   *
+   * Once these bytes are sent, no packet is sent again. The value zero
+   * means that there is no limit.
+   *
+   * \param maxBytes the total number of bytes to send
+   */
+  void SetMaxBytes (uint32_t maxBytes);
+
+  /**
+   * \brief Get the socket this application is attached to.
+   * \return pointer to associated socket
+   */
+  Ptr<Socket> GetSocket (void) const;
+
+  /**
+   * \brief Set the queue the packets go through below the socket.
+   *
+   * The application follows the number of packets in the queue through a
+   * trace source of type TracedValue<uint32_t>, e.g. "SizeChanged" for a
+   * WifiMacQueue or "PacketsInQueue" for a Queue.  It must be set before
+   * the application starts in saturated mode.
+   *
+   * \param queue the queue
+   * \param sizeTraceSource the name of the trace source of the number of
+   * packets in the queue
+   */
+  void SetBacklogQueue (Ptr<Object> queue, std::string sizeTraceSource);
+
+protected:
+  virtual void DoDispose (void);
+private:
+  // inherited from Application base class.
+  virtual void StartApplication (void);    // Called at time specified by Start
+  virtual void StopApplication (void);     // Called at time specified by Stop
+
+  /**
+   * \brief Send the packets generated until now, and schedule the next burst.
+   */
+  void SendBurst (void);
+  /**
+   * \brief Refill the backlog queue in saturated mode, or send the
+   * packets the previous bursts could not send.
+   */
+  void Refill (void);
+  /**
+   * \brief Send a packet.
+   * \param timestamp the time the packet was generated
+   * \return true if the socket accepted the packet
+   */
+  bool SendPacket (Time timestamp);
+  /**
+   * \param n the number of packets generated before
+   * \return the time the packet is generated at the configured rate
+   */
+  Time GetGenerationTime (uint64_t n) const;
+  /**
+   * \return true if the backlog queue (if any) holds less than Backlog packets
+   */
+  bool HasBacklogRoom (void) const;
+  /**
+   * \return true if the MaxBytes bytes have been sent
+   */
+  bool IsDone (void) const;
+  /**
+   * \brief Follow the number of packets in the backlog queue.
+   * \param oldValue the previous number of packets
+   * \param newValue the number of packets
+   */
+  void QueueSizeChanged (uint32_t oldValue, uint32_t newValue);
+
+  Ptr<Socket>     m_socket;         //!< Associated socket
+  Address         m_peer;           //!< Peer address
+  DataRate        m_cbrRate;        //!< Rate at which the packets are generated
+  uint32_t        m_pktSize;        //!< Size of packets
+  Time            m_burstInterval;  //!< Minimum time between two bursts
+  bool            m_saturated;      //!< True if the backlog queue is kept full
+  uint32_t        m_backlog;        //!< Number of packets kept in the backlog queue
+  uint32_t        m_maxBytes;       //!< Limit total number of bytes sent
+  uint32_t        m_totBytes;       //!< Total bytes sent so far
+  TypeId          m_tid;            //!< The type of protocol to use.
+  Time            m_startTime;      //!< Time the generation of packets started
+  uint64_t        m_nGenerated;     //!< Number of packets generated and sent since then
+  Time            m_nextTxTime;     //!< Time the next packet is generated
+  EventId         m_sendEvent;      //!< Event id of the next burst
+  EventId         m_refillEvent;    //!< Event id of the pending refill
+  bool            m_sending;        //!< True while packets are sent
+  Ptr<Object>     m_queue;          //!< The backlog queue
+  std::string     m_queueTraceSource; //!< The trace source of the number of packets in the queue
+  uint32_t        m_queueSize;      //!< The number of packets in the backlog queue
+
+  /// Traced Callback: sent packets
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+
+private:
+  /**
+   * \brief Connection Succeeded (called by Socket through a callback)
+   * \param socket the connected socket
+   */
+  void ConnectionSucceeded (Ptr<Socket> socket);
+  /**
+   * \brief Connection Failed (called by Socket through a callback)
+   * \param socket the connected socket
+   */
+  void ConnectionFailed (Ptr<Socket> socket);
+  /**
+   * \brief Send the pending packets as soon as some space is free.
+   */
+  void DataSend (Ptr<Socket>, uint32_t); // for socket's SetSendCallback
+};
+
+} // namespace ns3
+
+#endif /* BURST_SEND_APPLICATION_H */
@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DIRECTIONAL_ANTENNA_MODEL_H
+#define DIRECTIONAL_ANTENNA_MODEL_H
+
+#include "ns3/antenna-model.h"
+#include "directional-antenna.h"
+
+namespace ns3 {
+
+/**
+ * \brief AntennaModel view of the transmit or receive pattern of a DirectionalAntenna
+ * \ingroup wifi
+ *
+ * The spectrum channels apply the gains of the AntennaModel of the
+ * transmitter and of the receiver.  This class lets them apply the gain
+ * of the sector currently selected in a DirectionalAntenna, so that a
+ * DMG SpectrumWifiPhy is subject to the same antenna gains as on the
+ * YansWifiChannel, including the elevation pattern.
+ */
+class DirectionalAntennaModel : public AntennaModel
+{
+public:
+  static TypeId GetTypeId (void);
+  DirectionalAntennaModel ();
+  virtual ~DirectionalAntennaModel ();
+
+  /**
+   * \param antenna the directional antenna whose gains are reported
+   * \param transmit whether the transmit or the receive pattern of the
+   * antenna is reported
+   */
+  void SetDirectionalAntenna (Ptr<DirectionalAntenna> antenna, bool transmit);
+  /**
+   * \return the directional antenna whose gains are reported
+   */
+  Ptr<DirectionalAntenna> GetDirectionalAntenna (void) const;
+
+  // inherited from AntennaModel
+  virtual double GetGainDb (Angles a);
+
+
+protected:
+  virtual void DoDispose (void);
+
+
+private:
+  Ptr<DirectionalAntenna> m_antenna;  //!< The directional antenna
+  bool m_transmit;                    //!< Whether the transmit pattern is reported
+};
+
+} //namespace ns3
+
+#endif /* DIRECTIONAL_ANTENNA_MODEL_H */
@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_RADIO_ENERGY_MODEL_H
+#define DMG_RADIO_ENERGY_MODEL_H
+
+#include <map>
+#include "ns3/device-energy-model.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/mac48-address.h"
+#include "wifi-radio-energy-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup energy
+ * \brief A DMG radio energy model.
+ *
+ * This model follows the states of the WifiPhy like WifiRadioEnergyModel,
+ * but the current drawn while transmitting or receiving depends on the
+ * DMG PHY of the frame: the Control PHY, the SC PHY, the OFDM PHY and
+ * the low power SC PHY each have their own TX and RX current, which can
+ * be refined for a given MCS.  The SLEEP state of the PHY models the
+ * doze state of a DMG STA, which enters it outside of its allocations
+ * (see the DozeOutsideAllocations attribute of DmgStaWifiMac).
+ *
+ * Beamforming training draws an additional current from the phased
+ * antenna array while the radio transmits or receives a sector sweep
+ * frame (DMG Beacon, SSW, SSW-Feedback or SSW-ACK) or a frame carrying
+ * TRN fields.  The energy spent in these frames is also accounted
+ * separately.
+ *
+ * The model counts the bits of the data frames the radio transmits or
+ * successfully receives, and traces the energy consumed per such bit.
+ *
+ * The default currents are indicative of current 60 GHz chipsets, for
+ * the 3.0 V default supply voltage of the basic energy source, and should
+ * be set from measurements of the modelled device.
+ */
+class DmgRadioEnergyModel : public DeviceEnergyModel
+{
+public:
+  static TypeId GetTypeId (void);
+  DmgRadioEnergyModel ();
+  virtual ~DmgRadioEnergyModel ();
+
+  /**
+   * \brief Sets pointer to EnergySouce installed on node.
+   *
+   * \param source Pointer to EnergySource installed on node.
+   *
+   * Implements DeviceEnergyModel::SetEnergySource.
+   */
+  virtual void SetEnergySource (Ptr<EnergySource> source);
+
+  /**
+   * \returns Total energy consumption of the DMG device.
+   *
+   * Implements DeviceEnergyModel::GetTotalEnergyConsumption.
+   */
+  virtual double GetTotalEnergyConsumption (void) const;
+  /**
+   * \returns the energy consumed by the frames of beamforming training (J).
+   */
+  double GetBeamformingEnergyConsumption (void) const;
+  /**
+   * \returns the number of bits of the data frames transmitted or received.
+   */
+  uint64_t GetTrafficBits (void) const;
+  /**
+   * \returns the total energy consumption per bit of data (J/bit), or zero if no data was exchanged.
+   */
+  double GetEnergyPerBit (void) const;
+  /**
+   * Set the MAC address of the device: only the data frames received for
+   * this address, or for a group address, are counted in the traffic bits.
+   *
+   * \param address the MAC address of the device
+   */
+  void SetAddress (Mac48Address address);
+
+  /**
+   * Set the currents of a given MCS, overriding the currents of its DMG PHY.
+   *
+   * \param mode the MCS, e.g. DMG_MCS12
+   * \param txCurrentA the current while transmitting with this MCS (A)
+   * \param rxCurrentA the current while receiving with this MCS (A)
+   */
+  void SetMcsCurrentA (WifiMode mode, double txCurrentA, double rxCurrentA);
+  /**
+   * \param mode the MCS
+   * \returns the current while transmitting with this MCS (A)
+   */
+  double GetTxCurrentA (WifiMode mode) const;
+  /**
+   * \param mode the MCS
+   * \returns the current while receiving with this MCS (A)
+   */
+  double GetRxCurrentA (WifiMode mode) const;
+
+  /**
+   * \returns Current state.
+   */
+  WifiPhy::State GetCurrentState (void) const;
+
+  /**
+   * \param callback Callback function.
+   *
+   * Sets callback for energy depletion handling.
+   */
+  void SetEnergyDepletionCallback (WifiRadioEnergyModel::WifiRadioEnergyDepletionCallback callback);
+  /**
+   * \param callback Callback function.
+   *
+   * Sets callback for energy recharged handling.
+   */
+  void SetEnergyRechargedCallback (WifiRadioEnergyModel::WifiRadioEnergyRechargedCallback callback);
+
+  /**
+   * \brief Changes state of the DmgRadioEnergyModel.
+   *
+   * \param newState New state the wifi radio is in.
+   *
+   * Implements DeviceEnergyModel::ChangeState.
+   */
+  virtual void ChangeState (int newState);
+
+  /**
+   * \brief Handles energy depletion.
+   *
+   * Implements DeviceEnergyModel::HandleEnergyDepletion
+   */
+  virtual void HandleEnergyDepletion (void);
+
+  /**
+   * \brief Handles energy recharged.
+   *
+   * Implements DeviceEnergyModel::HandleEnergyRecharged
+   */
+  virtual void HandleEnergyRecharged (void);
+
+  /**
+   * \returns Pointer to the PHY listener.
+   */
+  WifiRadioEnergyModelPhyListener * GetPhyListener (void);
+
+  /**
+   * Select the TX current of a frame about to be transmitted, connected
+   * to the MonitorSnifferTx trace source of the WifiPhy.
+   *
+   * \param packet the packet being transmitted
+   * \param channelFreqMhz the frequency in MHz
+   * \param channelNumber the channel number
+   * \param rate the PHY data rate in units of 500kbps
+   * \param preamble the preamble of the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param aMpdu the A-MPDU information of the packet
+   */
+  void NotifyTx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                 uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu);
+  /**
+   * Select the RX current of a frame about to be received, connected to
+   * the PhyRxSync trace source of the WifiPhy.
+   *
+   * \param packet the packet being received
+   * \param txVector the TXVECTOR of the packet
+   */
+  void NotifyRxSync (Ptr<const Packet> packet, WifiTxVector txVector);
+  /**
+   * Count the bits of a successfully received frame addressed to the
+   * device, connected to the PhyRxEnd trace source of the WifiPhy.
+   *
+   * \param packet the received packet
+   */
+  void NotifyRxEnd (Ptr<const Packet> packet);
+
+private:
+  void DoDispose (void);
+
+  /**
+   * \returns Current draw of device, at current state.
+   *
+   * Implements DeviceEnergyModel::GetCurrentA.
+   */
+  virtual double DoGetCurrentA (void) const;
+  /**
+   * The tx power of the frames does not change the currents of this
+   * model, whose TX current is selected from the MCS of the frame.
+   *
+   * \param txPowerDbm the nominal tx power in dBm
+   */
+  void UpdateTxCurrent (double txPowerDbm);
+  /**
+   * Classify a frame exchanged by the radio.
+   *
+   * \param packet the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param dataBits set to the number of bits of the frame body if it is a data frame, zero otherwise
+   * \param receiver set to the receiver address (Addr1) of the frame
+   * \returns whether the frame is a frame of beamforming training
+   */
+  static bool ClassifyFrame (Ptr<const Packet> packet, WifiTxVector txVector, uint64_t &dataBits,
+                             Mac48Address &receiver);
+  /**
+   * Add bits of data and update the energy per bit.
+   *
+   * \param bits the number of bits
+   */
+  void AddTrafficBits (uint64_t bits);
+
+  Ptr<EnergySource> m_source;     //!< The energy source
+
+  double m_idleCurrentA;          //!< The current in the IDLE state (A)
+  double m_ccaBusyCurrentA;       //!< The current in the CCA_BUSY state (A)
+  double m_switchingCurrentA;     //!< The current in the SWITCHING state (A)
+  double m_sleepCurrentA;         //!< The current in the SLEEP (doze) state (A)
+  double m_ctrlTxCurrentA;        //!< The current while transmitting with the Control PHY (A)
+  double m_ctrlRxCurrentA;        //!< The current while receiving with the Control PHY (A)
+  double m_scTxCurrentA;          //!< The current while transmitting with the SC PHY (A)
+  double m_scRxCurrentA;          //!< The current while receiving with the SC PHY (A)
+  double m_ofdmTxCurrentA;        //!< The current while transmitting with the OFDM PHY (A)
+  double m_ofdmRxCurrentA;        //!< The current while receiving with the OFDM PHY (A)
+  double m_lpScTxCurrentA;        //!< The current while transmitting with the low power SC PHY (A)
+  double m_lpScRxCurrentA;        //!< The current while receiving with the low power SC PHY (A)
+  double m_beamformingCurrentA;   //!< The additional current during beamforming training frames (A)
+
+  /// The TX and RX currents of the MCSs whose currents are set, indexed by the MCS name.
+  std::map<std::string, std::pair<double, double> > m_mcsCurrents;
+
+  double m_txCurrentA;            //!< The TX current of the frame being transmitted (A)
+  double m_rxCurrentA;            //!< The RX current of the frame being received (A)
+  bool m_txBeamforming;           //!< Whether the frame being transmitted is a frame of beamforming training
+  bool m_rxBeamforming;           //!< Whether the frame being received is a frame of beamforming training
+
+  TracedValue<double> m_totalEnergyConsumption;       //!< The total energy consumption (J)
+  TracedValue<double> m_beamformingEnergyConsumption; //!< The energy consumed by beamforming training frames (J)
+  TracedValue<double> m_energyPerBit;                 //!< The total energy consumption per bit of data (J/bit)
+  uint64_t m_trafficBits;         //!< The number of bits of the data frames transmitted or received
+  Mac48Address m_address;         //!< The MAC address of the device
+
+  WifiPhy::State m_currentState;  //!< The current state the radio is in
+  Time m_lastUpdateTime;          //!< The time stamp of previous energy update
+
+  uint8_t m_nPendingChangeState;  //!< The number of nested state changes
+  bool m_isSupersededChangeState; //!< Whether the state change in progress was superseded
+
+  WifiRadioEnergyModel::WifiRadioEnergyDepletionCallback m_energyDepletionCallback; //!< Energy depletion callback
+  WifiRadioEnergyModel::WifiRadioEnergyRechargedCallback m_energyRechargedCallback; //!< Energy recharged callback
+
+  WifiRadioEnergyModelPhyListener *m_listener; //!< The WifiPhy listener
+};
+
+} // namespace ns3
+
+#endif /* DMG_RADIO_ENERGY_MODEL_H */
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_SNAPSHOT_HELPER_H
+#define DMG_SNAPSHOT_HELPER_H
+
+#include <string>
+#include "ns3/net-device-container.h"
+
+namespace ns3 {
+
+/**
+ * \brief save and restore the state of a DMG network once it is set up.
+ *
+ * Each simulation of a DMG network starts with the association of the
+ * DMG STAs, their beamforming training and the negotiation of their
+ * block ack agreements. This helper saves this state (association,
+ * AIDs, SNR tables, best antenna configurations, block ack agreements,
+ * and the information elements learnt from the association requests and
+ * the Information Response frames) to a text file at the end of a
+ * warm-up simulation, and
+ * restores it in the DMG devices of a fresh simulation of the same
+ * network, so that a sweep over seeds or MCSs skips the warm-up.
+ *
+ * The devices are matched by MAC address, so the restored network must
+ * be built in the same order as the saved one. The ARP caches and the
+ * routing tables, which scenarios already populate without any traffic,
+ * are not part of the snapshot.
+ */
+class DmgSnapshotHelper
+{
+public:
+  DmgSnapshotHelper ();
+
+  /**
+   * Save the state of the DMG devices, e.g. scheduled at the end of the warm-up.
+   * \param filename the name of the snapshot file
+   * \param devices the devices to save, the devices which are not DMG devices being ignored
+   */
+  void Save (std::string filename, NetDeviceContainer devices) const;
+  /**
+   * Restore the state of the DMG devices, before the simulation runs.
+   * \param filename the name of the snapshot file
+   * \param devices the devices to restore, each saved device must be found among them
+   */
+  void Restore (std::string filename, NetDeviceContainer devices) const;
+};
+
+} // namespace ns3
+
+#endif /* DMG_SNAPSHOT_HELPER_H */
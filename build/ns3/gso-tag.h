@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef GSO_TAG_H
+#define GSO_TAG_H
+
+#include <list>
+#include "ns3/tag.h"
+#include "ns3/ptr.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup packet
+ *
+ * \brief Tag of the super-segments handed down by a transport protocol
+ * with generic segmentation offload (GSO).
+ *
+ * A super-segment carries the data of several segments behind a single
+ * copy of the network and transport headers, and may be larger than the
+ * MTU of the device.  The tag gives the size of the payload of each
+ * segment.  A device that supports GSO (see NetDevice::SupportsGso)
+ * splits the super-segment as late as possible, with GsoTag::Segment;
+ * otherwise the network layer splits it before handing it to the
+ * device.
+ *
+ * The protocol that builds the headers registers the function that
+ * splits its super-segments with GsoTag::SetSegmentCallback.
+ *
+ * On receive, a device may coalesce the segments of a flow received
+ * together into a super-segment (generic receive offload, GRO) with
+ * GsoTag::Coalesce, which calls the function registered by the protocol
+ * with GsoTag::SetCoalesceCallback.  The super-segment carries the tag
+ * with the size of the segments coalesced.
+ */
+class GsoTag : public Tag
+{
+public:
+  /**
+   * Callback splitting a super-segment, starting with the header of the
+   * network protocol, into segments of the given payload size.
+   */
+  typedef Callback<std::list<Ptr<Packet> >, Ptr<const Packet>, uint16_t> SegmentCallback;
+  /**
+   * Callback coalescing the consecutive packets of a flow, starting with
+   * the header of the network protocol, into super-segments.  It returns
+   * the packets to pass up, in order.
+   */
+  typedef Callback<std::list<Ptr<Packet> >, const std::list<Ptr<Packet> > &> CoalesceCallback;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  GsoTag ();
+  /**
+   * Constructs a GsoTag with the given segment size
+   *
+   * \param segmentSize the payload size of the segments
+   */
+  GsoTag (uint16_t segmentSize);
+  /**
+   * \param segmentSize the payload size of the segments
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+  /**
+   * \returns the payload size of the segments
+   */
+  uint16_t GetSegmentSize (void) const;
+
+  /**
+   * Register the function splitting the super-segments of a network protocol.
+   *
+   * \param protocol the protocol number (EtherType) of the network protocol
+   * \param cb the callback
+   */
+  static void SetSegmentCallback (uint16_t protocol, SegmentCallback cb);
+  /**
+   * Split a super-segment.  The segments do not carry the GsoTag.
+   *
+   * \param packet the packet, starting with the header of the network protocol
+   * \param protocol the protocol number (EtherType) of the network protocol
+   * \param segments the list the segments are appended to
+   * \returns false if the packet is not a super-segment or no function
+   *          splits the super-segments of the protocol
+   */
+  static bool Segment (Ptr<const Packet> packet, uint16_t protocol, std::list<Ptr<Packet> > &segments);
+  /**
+   * Register the function coalescing the packets of a network protocol.
+   *
+   * \param protocol the protocol number (EtherType) of the network protocol
+   * \param cb the callback
+   */
+  static void SetCoalesceCallback (uint16_t protocol, CoalesceCallback cb);
+  /**
+   * Coalesce the packets received together.
+   *
+   * \param packets the packets received, in order, starting with the header
+   *        of the network protocol
+   * \param protocol the protocol number (EtherType) of the network protocol
+   * \returns the packets to pass up, in order: the packets unchanged if no
+   *          function coalesces the packets of the protocol
+   */
+  static std::list<Ptr<Packet> > Coalesce (const std::list<Ptr<Packet> > &packets, uint16_t protocol);
+
+private:
+  uint16_t m_segmentSize; //!< Payload size of the segments
+};
+
+} // namespace ns3
+
+#endif /* GSO_TAG_H */
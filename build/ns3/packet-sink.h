@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright 2007 University of Washington
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Tom Henderson (tomhend@u.washington.edu)
+ */
+
+#ifndef PACKET_SINK_H
+#define PACKET_SINK_H
+
+#include <fstream>
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "ns3/address.h"
+#include "ns3/log-linear-histogram.h"
+
+namespace ns3 {
+
+class Address;
+class Socket;
+class Packet;
+
+/**
+ * \ingroup applications 
+ * \defgroup packetsink PacketSink
+ *
+ * This application was written to complement OnOffApplication, but it
+ * is more general so a PacketSink name was selected.  Functionally it is
+ * important to use in multicast situations, so that reception of the layer-2
+ * multicast frames of interest are enabled, but it is also useful for
+ * unicast as an example of how you can write something simple to receive
+ * packets at the application layer.  Also, if an IP stack generates 
+ * ICMP Port Unreachable errors, receiving applications will be needed.
+ */
+
+/**
+ * \ingroup packetsink
+ *
+ * \brief Receive and consume traffic generated to an IP address and port
+ *
+ * This application was written to complement OnOffApplication, but it
+ * is more general so a PacketSink name was selected.  Functionally it is
+ * important to use in multicast situations, so that reception of the layer-2
+ * multicast frames of interest are enabled, but it is also useful for
+ * unicast as an example of how you can write something simple to receive
+ * packets at the application layer.  Also, if an IP stack generates 
+ * ICMP Port Unreachable errors, receiving applications will be needed.
+ *
+ * The constructor specifies the Address (IP address and port) and the 
+ * transport protocol to use.   A virtual Receive () method is installed 
+ * as a callback on the receiving socket.  By default, when logging is
+ * enabled, it prints out the size of packets and their address.
+ * A tracing source to Receive() is also available.
+ *
+ * If the StatsInterval attribute is set, the sink also computes the
+ * throughput of every interval, and the one-way delays of the packets,
+ * taken from their TimestampTag or, if the SeqTsHeader attribute is set,
+ * from their SeqTsHeader.  The delays and the interval throughputs are
+ * recorded in log-linear histograms, and, if the StatsFileName attribute
+ * is set, every interval is written to a CSV file as it ends, with the
+ * throughput and the percentiles of the delays of the interval.  The
+ * intervals are closed when the next packet arrives, or when the
+ * application stops, so that the statistics need no event, and a memory
+ * that does not depend on the length of the simulation.
+ */
+class PacketSink : public Application 
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PacketSink ();
+
+  virtual ~PacketSink ();
+
+  /**
+   * \return the total bytes received in this sink app
+   */
+  uint64_t GetTotalRx () const;
+  /**
+   * \return the total number of received
+   */
+  uint64_t GetTotalReceivedPackets (void) const;
+
+  Time GetAverageDelay (void) const;
+  /**
+   * \return the histogram of the one-way delays (in nanoseconds) of the
+   * packets received since the application started, if the StatsInterval
+   * attribute is set
+   */
+  const LogLinearHistogram & GetDelayHistogram (void) const;
+  /**
+   * \return the histogram of the throughputs (in bit/s) of the intervals
+   * completed since the application started, if the StatsInterval
+   * attribute is set
+   */
+  const LogLinearHistogram & GetThroughputHistogram (void) const;
+  /**
+   * \return pointer to listening socket
+   */
+  Ptr<Socket> GetListeningSocket (void) const;
+
+  /**
+   * \return list of pointers to accepted sockets
+   */
+  std::list<Ptr<Socket> > GetAcceptedSockets (void) const;
+ 
+protected:
+  virtual void DoDispose (void);
+private:
+  // inherited from Application base class.
+  virtual void StartApplication (void);    // Called at time specified by Start
+  virtual void StopApplication (void);     // Called at time specified by Stop
+
+  /**
+   * \brief Handle a packet received by the application
+   * \param socket the receiving socket
+   */
+  void HandleRead (Ptr<Socket> socket);
+  /**
+   * \brief Handle an incoming connection
+   * \param socket the incoming connection socket
+   * \param from the address the connection is from
+   */
+  void HandleAccept (Ptr<Socket> socket, const Address& from);
+  /**
+   * \brief Handle an connection close
+   * \param socket the connected socket
+   */
+  void HandlePeerClose (Ptr<Socket> socket);
+  /**
+   * \brief Handle an connection error
+   * \param socket the connected socket
+   */
+  void HandlePeerError (Ptr<Socket> socket);
+  /**
+   * \brief Record a packet in the interval statistics
+   * \param packet the received packet
+   */
+  void UpdateStats (Ptr<const Packet> packet);
+  /**
+   * \brief Close the intervals which ended before now
+   */
+  void CloseIntervals (void);
+  /**
+   * \brief Record the statistics of the current interval, and write them
+   * to the CSV file
+   * \param end the end of the interval
+   */
+  void CloseInterval (Time end);
+
+  // In the case of TCP, each socket accept returns a new socket, so the 
+  // listening socket is stored separately from the accepted sockets
+  Ptr<Socket>     m_socket;       //!< Listening socket
+  std::list<Ptr<Socket> > m_socketList; //!< the accepted sockets
+
+  Address         m_local;        //!< Local address to bind to
+  uint64_t        m_totalRx;      //!< Total bytes received
+  TypeId          m_tid;          //!< Protocol TypeId
+  uint64_t        m_totalPackets; //!< Total received packets.
+
+  /// Traced Callback: received packets, source address.
+  TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
+  Time accummulator;
+
+  Time            m_statsInterval;  //!< Duration of the statistics intervals
+  std::string     m_statsFileName;  //!< Name of the CSV file of the intervals
+  bool            m_seqTsHeader;    //!< True if the delay can be read from a SeqTsHeader
+  std::ofstream   m_statsStream;    //!< CSV file of the intervals
+  Time            m_intervalStart;  //!< Start of the current interval
+  uint64_t        m_intervalRx;     //!< Bytes received in the current interval
+  uint64_t        m_intervalPackets; //!< Packets received in the current interval
+  LogLinearHistogram m_intervalDelays; //!< Delays of the current interval (ns)
+  LogLinearHistogram m_delays;      //!< Delays since the start (ns)
+  LogLinearHistogram m_throughputs; //!< Throughputs of the intervals (bit/s)
+};
+
+} // namespace ns3
+
+#endif /* PACKET_SINK_H */
+
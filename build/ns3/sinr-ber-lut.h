@@ -0,0 +1,10 @@
+#ifndef __SINR_BER_LUT__
+#define __SINR_BER_LUT__
+
+namespace ns3 {
+
+double sinr_ber(unsigned int index1, unsigned int index2);
+
+}
+
+#endif /* __SINR_BER_LUT__ */
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 Adrian Sai-wah Tam
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Adrian Sai-wah Tam <adrian.sw.tam@gmail.com>
+ */
+
+#ifndef TCP_TX_BUFFER_H
+#define TCP_TX_BUFFER_H
+
+#include <deque>
+#include <map>
+#include "ns3/traced-value.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/object.h"
+#include "ns3/sequence-number.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/tcp-option-sack.h"
+
+namespace ns3 {
+class Packet;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief class for keeping the data sent by the application to the TCP socket, i.e.
+ *        the sending buffer.
+ *
+ * The packets written by the application are kept in a double-ended
+ * queue, each with the offset of its first byte in the byte stream, so
+ * that the packet holding a sequence number is found by a binary search
+ * and acknowledged packets are released from the head in constant time.
+ * The buffer remembers where the last segment extracted by
+ * CopyFromSequence ended: the next segment sent usually starts there,
+ * and is then found in constant time.  Small packets written by the
+ * application are merged into the last packet of the buffer, as long
+ * as none of its data was extracted, so that a segment is usually a
+ * fragment of a single packet.
+ *
+ * When SACK is enabled on the connection, the buffer also keeps the
+ * scoreboard of the transmitted data: the segments between SND.UNA and
+ * the highest transmitted sequence number, indexed by their first
+ * sequence number, with their last transmission time and whether they
+ * have been selectively acknowledged, marked lost or retransmitted.
+ * The scoreboard marks the lost segments with the DupThresh rule of
+ * \RFC{6675} and with the time-based rule of RACK (\RFC{8985}): a
+ * segment is lost when a segment sent later than it has been delivered
+ * and a reordering window has elapsed since.  It provides the estimate
+ * of the data in flight (the "pipe" of \RFC{6675}) used during SACK-based
+ * loss recovery.
+ */
+class TcpTxBuffer : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief Constructor
+   * \param n initial Sequence number to be transmitted
+   */
+  TcpTxBuffer (uint32_t n = 0);
+  virtual ~TcpTxBuffer (void);
+
+  // Accessors
+
+  /**
+   * Returns the first byte's sequence number
+   * \returns the first byte's sequence number
+   */
+  SequenceNumber32 HeadSequence (void) const;
+
+  /**
+   * Returns the last byte's sequence number + 1
+   * \returns the last byte's sequence number + 1
+   */
+  SequenceNumber32 TailSequence (void) const;
+
+  /**
+   * Returns total number of bytes in this Tx buffer
+   * \returns total number of bytes in this Tx buffer
+   */
+  uint32_t Size (void) const;
+
+  /**
+   * Returns the Tx window size
+   * \returns the Tx window size (in bytes)
+   */
+  uint32_t MaxBufferSize (void) const;
+
+  /**
+   * Set the Tx window size
+   * \param n Tx window size (in bytes)
+   */
+  void SetMaxBufferSize (uint32_t n);
+
+  /**
+   * Returns the available capacity in this Tx window
+   * \returns available capacity in this Tx window
+   */
+  uint32_t Available (void) const;
+
+  /**
+   * Append a data packet to the end of the buffer
+   *
+   * \param p The packet to be appended to the Tx buffer
+   * \return Boolean to indicate success
+   */
+  bool Add (Ptr<Packet> p);
+
+  /**
+   * Returns the number of bytes from the buffer in the range [seq, tailSequence)
+   * \param seq initial sequence number
+   * \returns the number of bytes from the buffer in the range
+   */
+  uint32_t SizeFromSequence (const SequenceNumber32& seq) const;
+
+  /**
+   * Copy data of size numBytes into a packet, data from the range [seq, seq+numBytes)
+   * \param numBytes number of bytes to copy
+   * \param seq start sequence number to extract
+   * \returns a packet
+   */
+  Ptr<Packet> CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq);
+
+  /**
+   * Set the m_firstByteSeq to seq. Supposed to be called only when the
+   * connection is just set up and we did not send any data out yet.
+   * \param seq The sequence number of the head byte
+   */
+  void SetHeadSequence (const SequenceNumber32& seq);
+
+  /**
+   * Discard data up to but not including this sequence number.
+   *
+   * \param seq The sequence number of the head byte
+   */
+  void DiscardUpTo (const SequenceNumber32& seq);
+
+  // SACK scoreboard
+
+  /**
+   * \brief Record the transmission of [seq, seq+size) in the scoreboard
+   *
+   * The data previously transmitted in this range is considered retransmitted.
+   *
+   * \param seq the sequence number of the first byte sent
+   * \param size the number of bytes sent
+   */
+  void MarkSent (const SequenceNumber32& seq, uint32_t size);
+
+  /**
+   * \brief Update the scoreboard with an incoming ACK
+   *
+   * The segments below the cumulative ACK leave the scoreboard, the
+   * segments covered by the SACK blocks are marked as SACKed.
+   *
+   * \param list the SACK blocks of the ACK (may be empty)
+   * \param ack the cumulative ACK
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t Update (const TcpOptionSack::SackList& list, const SequenceNumber32& ack);
+
+  /**
+   * \brief Mark the lost segments of the scoreboard
+   *
+   * A segment not yet retransmitted is lost if more than
+   * (dupThresh - 1) * segmentSize bytes above it have been SACKed
+   * (\RFC{6675}).  Any segment is lost if a segment sent later has been
+   * delivered and the reordering window has elapsed since it was sent
+   * (RACK).
+   *
+   * \param dupThresh the duplicate ACK threshold
+   * \param segmentSize the segment size
+   * \param timeout set to the time left before the next segment may be
+   *        marked lost by RACK, or to zero if no segment is waiting
+   * \returns the number of bytes newly marked lost
+   */
+  uint32_t DetectLosses (uint32_t dupThresh, uint32_t segmentSize, Time &timeout);
+
+  /**
+   * \brief Mark the first segment of the scoreboard as lost
+   *
+   * Used when fast retransmit is triggered by duplicate ACKs alone.
+   */
+  void MarkHeadLost (void);
+
+  /**
+   * \brief Remove all the segments from the scoreboard, on retransmission
+   * timeout
+   */
+  void ResetScoreboard (void);
+
+  /**
+   * \brief Get the first lost segment not yet retransmitted
+   * \param seq set to the sequence number of the segment
+   * \param size set to the size of the segment
+   * \returns true if there is such a segment
+   */
+  bool NextLost (SequenceNumber32 &seq, uint32_t &size) const;
+
+  /**
+   * \brief Check if a byte has been SACKed
+   * \param seq the sequence number of the byte
+   * \returns true if the scoreboard marks it as SACKed
+   */
+  bool IsSacked (const SequenceNumber32& seq) const;
+
+  /**
+   * \returns the number of bytes SACKed
+   */
+  uint32_t GetSackedBytes (void) const;
+
+  /**
+   * \returns the number of bytes marked lost and not retransmitted since
+   */
+  uint32_t GetLostBytes (void) const;
+
+  /**
+   * \brief Get the data in flight (pipe, \RFC{6675}): the bytes sent,
+   * neither acknowledged, SACKed nor marked lost since their last transmission
+   * \returns the number of bytes in flight
+   */
+  uint32_t BytesInFlight (void) const;
+
+private:
+  /**
+   * \brief A segment of the scoreboard
+   */
+  struct TcpTxSegment
+  {
+    uint32_t m_size;     //!< Size of the segment
+    Time     m_lastSent; //!< Time of the last transmission
+    bool     m_sacked;   //!< SACKed by the receiver
+    bool     m_lost;     //!< Marked lost, and not retransmitted since
+    bool     m_retrans;  //!< Retransmitted at least once
+  };
+  /// The scoreboard, indexed by the sequence number of the first byte of each segment
+  typedef std::map<SequenceNumber32, TcpTxSegment> Scoreboard;
+
+  /**
+   * \brief Make seq the first byte of a segment of the scoreboard, splitting
+   * the segment containing it if needed
+   * \param seq the sequence number
+   */
+  void SplitAt (const SequenceNumber32& seq);
+  /**
+   * \brief Add or remove a segment from the counters of the scoreboard
+   * \param segment the segment
+   * \param add true to add it, false to remove it
+   */
+  void Account (const TcpTxSegment& segment, bool add);
+  /**
+   * \brief Update the RACK state with a delivered segment
+   * \param segment the segment, SACKed or cumulatively acknowledged
+   * \param endSeq the sequence number following the segment
+   */
+  void RackUpdate (const TcpTxSegment& segment, const SequenceNumber32& endSeq);
+
+  /**
+   * \brief A packet of the buffer
+   */
+  struct TcpTxChunk
+  {
+    uint64_t m_offset;     //!< Offset of the first byte of the packet in the byte stream
+    Ptr<Packet> m_packet;  //!< The packet
+  };
+
+  /**
+   * \brief Find the packet holding a byte of the buffer
+   * \param offset the offset of the byte in the byte stream
+   * \returns the index of the packet in m_data
+   */
+  uint32_t FindChunk (uint64_t offset) const;
+
+  TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
+  uint32_t m_size;                              //!< Number of data bytes
+  uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
+  std::deque<TcpTxChunk> m_data;                //!< Packets of the buffer, in byte stream order
+  uint64_t m_headOffset;                        //!< Offset of m_firstByteSeq in the byte stream
+  uint64_t m_nRemoved;                          //!< Number of packets removed from the head of m_data
+  uint64_t m_cursor;                            //!< Number of the packet where the last extracted segment ended
+  uint64_t m_extractedEnd;                      //!< Offset following the highest byte extracted
+  bool m_tailMerged;                            //!< Whether the last packet was built by merging packets
+
+  Scoreboard m_scoreboard;    //!< The SACK scoreboard
+  uint32_t m_sentOut;         //!< Bytes of the segments of the scoreboard
+  uint32_t m_sackedOut;       //!< Bytes SACKed
+  uint32_t m_lostOut;         //!< Bytes marked lost and not SACKed
+  Time m_rackXmitTime;        //!< RACK: send time of the most recently sent delivered segment
+  SequenceNumber32 m_rackEndSeq; //!< RACK: end of the most recently sent delivered segment
+  Time m_rackRtt;             //!< RACK: RTT of the most recently sent delivered segment
+  Time m_rackMinRtt;          //!< RACK: minimum RTT measured on delivered segments
+};
+
+} // namepsace ns3
+
+#endif /* TCP_TX_BUFFER_H */
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006,2007 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef YANS_WIFI_CHANNEL_H
+#define YANS_WIFI_CHANNEL_H
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "wifi-channel.h"
+#include "wifi-mode.h"
+#include "wifi-preamble.h"
+#include "wifi-tx-vector.h"
+#include "yans-wifi-phy.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class NetDevice;
+class PropagationLossModel;
+class PropagationDelayModel;
+class MobilityModel;
+
+struct Parameters
+{
+  double rxPowerDbm;
+  enum mpduType type;
+  Time duration;
+  WifiTxVector txVector;
+  WifiPreamble preamble;
+};
+
+/**
+ * \brief A Yans wifi channel
+ * \ingroup wifi
+ *
+ * This wifi channel implements the propagation model described in
+ * "Yet Another Network Simulator", (http://cutebugs.net/files/wns2-yans.pdf).
+ *
+ * This class is expected to be used in tandem with the ns3::YansWifiPhy
+ * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
+ * By default, no propagation models are set so, it is the caller's responsability
+ * to set them before using the channel.
+ */
+class YansWifiChannel : public WifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  YansWifiChannel ();
+  virtual ~YansWifiChannel ();
+
+  //inherited from Channel.
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  /**
+   * Adds the given YansWifiPhy to the PHY list
+   *
+   * \param phy the YansWifiPhy to be added to the PHY list
+   */
+  void Add (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+
+  /**
+   * \param sender the device from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType.
+   * \param duration the transmission duration associated to the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from WifiPhy::Send. YansWifiChannel
+   * delivers packets only between PHYs with the same m_channelNumber,
+   * e.g. PHYs that are operating on the same channel.
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+             WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
+
+  /**
+   * Send the TRN Fields appended to a packet as a single event per
+   * receiver, which computes the received power of every TRN Field.
+   * \param sender the device from which the packet is originating.
+   * \param txPowerDbm the tx power associated to the packet.
+   * \param txVector the TXVECTOR associated to the packet.
+   */
+  void SendTrnFields (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector) const;
+  /**
+   * Compute the power a PHY would receive from a DMG PHY transmitting
+   * through the given sector, with the current receive configuration of
+   * the receiver, without sending anything.
+   *
+   * \param sender the transmitting PHY.
+   * \param receiver the receiving PHY.
+   * \param txPowerDbm the transmitted signal strength [dBm].
+   * \param sectorId the ID of the transmitting sector.
+   * \param antennaId the ID of the transmitting antenna.
+   * \return the received power [dBm], before the receiver gain.
+   */
+  double GetSectorRxPowerDbm (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver, double txPowerDbm,
+                              uint8_t sectorId, uint8_t antennaId) const;
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   *
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+  /**
+   * Add bloackage on a certain path between two WifiPhy objects.
+   * \param srcWifiPhy
+   * \param dstWifiPhy
+   */
+  void AddBlockage (double (*blockage)(), Ptr<WifiPhy> srcWifiPhy, Ptr<WifiPhy> dstWifiPhy);
+  void RemoveBlockage (void);
+  void AddPacketDropper (bool (*dropper)(), Ptr<WifiPhy> srcWifiPhy, Ptr<WifiPhy> dstWifiPhy);
+  void RemovePacketDropper (void);
+
+private:
+  /**
+   * A vector of pointers to YansWifiPhy.
+   */
+  typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+
+  /**
+   * This method is scheduled by Send for each associated YansWifiPhy.
+   * The method then calls the corresponding YansWifiPhy that the first
+   * bit of the packet has arrived.
+   *
+   * \param i index of the corresponding YansWifiPhy in the PHY list
+   * \param packet the packet being sent
+   * \param atts a vector containing the received power in dBm and the packet type
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble being used to send the packet
+   */
+  void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
+  /**
+   * Compute the power of each TRN Field at the receiver, before its
+   * receive antenna gain, and start receiving the TRN Fields.
+   * \param i index of the corresponding YansWifiPhy in the PHY list.
+   * \param sender the transmitting PHY.
+   * \param txVector the TXVECTOR of the packet.
+   * \param txPowerDbm the transmitted signal strength [dBm].
+   */
+  void ReceiveTrnFields (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector, double txPowerDbm) const;
+  /**
+   * Get the angles of the link between a transmitter and a receiver,
+   * which are only computed again when one of them moved.
+   *
+   * \param tx the mobility model of the transmitter.
+   * \param rx the mobility model of the receiver.
+   * \param azimuthTx the azimuth of the receiver seen from the transmitter.
+   * \param elevationTx the elevation of the receiver seen from the transmitter.
+   * \param azimuthRx the azimuth of the transmitter seen from the receiver.
+   * \param elevationRx the elevation of the transmitter seen from the receiver.
+   */
+  void GetLinkAngles (Ptr<MobilityModel> tx, Ptr<MobilityModel> rx,
+                      double &azimuthTx, double &elevationTx,
+                      double &azimuthRx, double &elevationRx) const;
+
+  /**
+   * The angles of a link between two mobility models a and b, a having
+   * the lower address.
+   */
+  struct LinkAngles
+  {
+    Vector positionA;   //!< The position of a when the angles were computed
+    Vector positionB;   //!< The position of b when the angles were computed
+    double azimuthA;    //!< The azimuth of b seen from a
+    double elevationA;  //!< The elevation of b seen from a
+    double azimuthB;    //!< The azimuth of a seen from b
+    double elevationB;  //!< The elevation of a seen from b
+  };
+
+  /**
+   * The angles of the links, indexed by their pair of mobility models.
+   */
+  typedef std::map<std::pair<const MobilityModel *, const MobilityModel *>, struct LinkAngles> LinkAnglesMap;
+
+  PhyList m_phyList;                    //!< List of YansWifiPhys connected to this YansWifiChannel
+  Ptr<PropagationLossModel> m_loss;     //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay;   //!< Propagation delay model
+  double (*m_blockage) ();              //!< Blockage model.
+  bool (*m_packetDropper) ();           //!< Packet Dropper Model.
+  Ptr<WifiPhy> m_srcWifiPhy;
+  Ptr<WifiPhy> m_dstWifiPhy;
+  mutable LinkAnglesMap m_linkAngles;   //!< The angles of the links
+
+};
+
+} //namespace ns3
+
+#endif /* YANS_WIFI_CHANNEL_H */
@@ -39,6 +39,8 @@ main(int argc, char *argv[])
   uint32_t maxPackets = 0;                      /* Maximum Number of Packets */
   string tcpVariant = "ns3::TcpNewReno";        /* TCP Variant Type. */
   uint32_t bufferSize = 131072;                 /* TCP Send/Receive Buffer Size. */
+  bool sack = true;                             /* Enable TCP SACK-based loss recovery. */
+  uint32_t gsoMaxSize = 0;                      /* Maximum payload of the TCP super-segments (0 disables GSO). */
   string phyMode = "DMG_MCS";                   /* Type of the Physical Layer. */
   double distance = 1.0;                        /* The distance between transmitter and receiver in meters. */
   bool verbose = false;                         /* Print Logging Information. */
@@ -83,6 +85,8 @@ main(int argc, char *argv[])
   cmd.AddValue ("maxPackets", "Maximum number of packets to send", maxPackets);
   cmd.AddValue ("tcpVariant", "Transport protocol to use: TcpTahoe, TcpReno, TcpNewReno, TcpWestwood, TcpWestwoodPlus ", tcpVariant);
   cmd.AddValue ("bufferSize", "TCP Buffer Size (Send/Receive)", bufferSize);
+  cmd.AddValue ("sack", "Enable TCP SACK-based loss recovery", sack);
+  cmd.AddValue ("gsoMaxSize", "Maximum payload of the TCP super-segments, 0 to disable GSO", gsoMaxSize);
   cmd.AddValue ("dist", "distance between nodes", distance);
   cmd.AddValue ("verbose", "turn on all WifiNetDevice log components", verbose);
   cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
@@ -101,6 +105,8 @@ main(int argc, char *argv[])
   Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (payloadSize));
   Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (bufferSize));
   Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (sack));
+  Config::SetDefault ("ns3::TcpSocketBase::GsoMaxSize", UintegerValue (gsoMaxSize));
 
   cout << "MCS" << '\t' << "Throughput (Mbps)" << endl;
 
@@ -0,0 +1,372 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/address.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "burst-send-application.h"
+#include "timestamp-tag.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BurstSendApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (BurstSendApplication);
+
+TypeId
+BurstSendApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BurstSendApplication")
+    .SetParent<Application> ()
+    .SetGroupName("Applications")
+    .AddConstructor<BurstSendApplication> ()
+    .AddAttribute ("DataRate", "The rate at which the packets are generated.",
+                   DataRateValue (DataRate ("500kb/s")),
+                   MakeDataRateAccessor (&BurstSendApplication::m_cbrRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("PacketSize", "The size of the packets.",
+                   UintegerValue (512),
+                   MakeUintegerAccessor (&BurstSendApplication::m_pktSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BurstInterval",
+                   "The minimum time between two bursts. The packets generated "
+                   "meanwhile are sent at once, each tagged with the time it "
+                   "was generated.",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&BurstSendApplication::m_burstInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Saturated",
+                   "Ignore the DataRate, and keep Backlog packets in the backlog "
+                   "queue instead.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&BurstSendApplication::m_saturated),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Backlog",
+                   "The number of packets the backlog queue holds at most "
+                   "because of the application (see SetBacklogQueue).",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&BurstSendApplication::m_backlog),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Remote", "The address of the destination",
+                   AddressValue (),
+                   MakeAddressAccessor (&BurstSendApplication::m_peer),
+                   MakeAddressChecker ())
+    .AddAttribute ("MaxBytes",
+                   "The total number of bytes to send. Once these bytes are sent, "
+                   "no packet is sent again. The value zero means "
+                   "that there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&BurstSendApplication::m_maxBytes),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Protocol", "The type of protocol to use.",
+                   TypeIdValue (UdpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&BurstSendApplication::m_tid),
+                   MakeTypeIdChecker ())
+    .AddTraceSource ("Tx", "A new packet is created and is sent",
+                     MakeTraceSourceAccessor (&BurstSendApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+
+BurstSendApplication::BurstSendApplication ()
+  : m_socket (0),
+    m_totBytes (0),
+    m_nGenerated (0),
+    m_sending (false),
+    m_queueSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BurstSendApplication::~BurstSendApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BurstSendApplication::SetMaxBytes (uint32_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << maxBytes);
+  m_maxBytes = maxBytes;
+}
+
+Ptr<Socket>
+BurstSendApplication::GetSocket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_socket;
+}
+
+void
+BurstSendApplication::SetBacklogQueue (Ptr<Object> queue, std::string sizeTraceSource)
+{
+  NS_LOG_FUNCTION (this << queue << sizeTraceSource);
+  if (m_queue != 0)
+    {
+      m_queue->TraceDisconnectWithoutContext (m_queueTraceSource,
+                                              MakeCallback (&BurstSendApplication::QueueSizeChanged, this));
+    }
+  m_queue = queue;
+  m_queueTraceSource = sizeTraceSource;
+  m_queueSize = 0;
+  if (m_queue != 0)
+    {
+      bool connected = m_queue->TraceConnectWithoutContext (m_queueTraceSource,
+                                                            MakeCallback (&BurstSendApplication::QueueSizeChanged, this));
+      NS_ABORT_MSG_UNLESS (connected, "No trace source " << m_queueTraceSource << " in the backlog queue");
+    }
+}
+
+void
+BurstSendApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  SetBacklogQueue (0, "");
+  m_socket = 0;
+  // chain up
+  Application::DoDispose ();
+}
+
+// Application Methods
+void BurstSendApplication::StartApplication (void) // Called at time specified by Start
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_saturated && m_queue == 0)
+    {
+      NS_FATAL_ERROR ("BurstSendApplication needs a backlog queue in saturated mode "
+                      "(see SetBacklogQueue).");
+    }
+
+  // Create the socket if not already
+  if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      if (Inet6SocketAddress::IsMatchingType (m_peer))
+        {
+          m_socket->Bind6 ();
+        }
+      else if (InetSocketAddress::IsMatchingType (m_peer) ||
+               PacketSocketAddress::IsMatchingType (m_peer))
+        {
+          m_socket->Bind ();
+        }
+      m_socket->Connect (m_peer);
+      m_socket->SetAllowBroadcast (true);
+      m_socket->ShutdownRecv ();
+
+      m_socket->SetConnectCallback (
+        MakeCallback (&BurstSendApplication::ConnectionSucceeded, this),
+        MakeCallback (&BurstSendApplication::ConnectionFailed, this));
+      m_socket->SetSendCallback (
+        MakeCallback (&BurstSendApplication::DataSend, this));
+    }
+
+  Simulator::Cancel (m_sendEvent);
+  Simulator::Cancel (m_refillEvent);
+  if (m_saturated)
+    {
+      Refill ();
+    }
+  else
+    {
+      m_startTime = Simulator::Now ();
+      m_nGenerated = 0;
+      m_nextTxTime = GetGenerationTime (0);
+      m_sendEvent = Simulator::Schedule (m_nextTxTime - Simulator::Now (),
+                                         &BurstSendApplication::SendBurst, this);
+    }
+}
+
+void BurstSendApplication::StopApplication (void) // Called at time specified by Stop
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_sendEvent);
+  Simulator::Cancel (m_refillEvent);
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+    }
+  else
+    {
+      NS_LOG_WARN ("BurstSendApplication found null socket to close in StopApplication");
+    }
+}
+
+
+// Private helpers
+
+bool
+BurstSendApplication::SendPacket (Time timestamp)
+{
+  NS_LOG_FUNCTION (this << timestamp);
+  Ptr<Packet> packet = Create<Packet> (m_pktSize);
+  TimestampTag tag;
+  tag.SetTimestamp (timestamp);
+  packet->AddByteTag (tag);
+  m_sending = true;
+  int actual = m_socket->Send (packet);
+  m_sending = false;
+  if (actual != static_cast<int> (m_pktSize))
+    {
+      NS_LOG_LOGIC ("The socket did not accept the packet");
+      return false;
+    }
+  m_txTrace (packet);
+  m_totBytes += m_pktSize;
+  return true;
+}
+
+Time
+BurstSendApplication::GetGenerationTime (uint64_t n) const
+{
+  // Computed from the start, rounded to the nearest time step, so that the
+  // rounding of the packet interval does not accumulate
+  int64x64_t bits = int64x64_t ((n + 1) * m_pktSize * 8);
+  int64x64_t steps = bits / int64x64_t (m_cbrRate.GetBitRate ())
+    * int64x64_t (Seconds (1).GetTimeStep ());
+  return m_startTime + TimeStep ((steps + int64x64_t (0.5)).GetHigh ());
+}
+
+bool
+BurstSendApplication::HasBacklogRoom (void) const
+{
+  return m_queue == 0 || m_queueSize < m_backlog;
+}
+
+bool
+BurstSendApplication::IsDone (void) const
+{
+  return m_maxBytes != 0 && m_totBytes >= m_maxBytes;
+}
+
+void
+BurstSendApplication::SendBurst (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_sendEvent);
+  Time now = Simulator::Now ();
+  uint32_t sent = 0;
+  while (m_nextTxTime <= now && !IsDone () && HasBacklogRoom ())
+    {
+      if (!SendPacket (m_nextTxTime))
+        {
+          break;
+        }
+      sent++;
+      m_nGenerated++;
+      m_nextTxTime = GetGenerationTime (m_nGenerated);
+    }
+  NS_LOG_LOGIC ("Sent a burst of " << sent << " packets, "
+                << (m_nextTxTime <= now ? "some packets pending" : "no packet pending"));
+  if (IsDone ())
+    { // All done, cancel any pending events
+      StopApplication ();
+      return;
+    }
+  m_sendEvent = Simulator::Schedule (std::max (m_nextTxTime, now + m_burstInterval) - now,
+                                     &BurstSendApplication::SendBurst, this);
+}
+
+void
+BurstSendApplication::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_saturated)
+    {
+      if (m_sendEvent.IsRunning () && m_nextTxTime <= Simulator::Now ())
+        {
+          SendBurst ();
+        }
+      return;
+    }
+  // Send at most the room left in the backlog queue: the packets dropped
+  // before they reach it (e.g., while ARP resolves the destination, or by
+  // a STA not associated yet) do not fill it
+  uint32_t room = HasBacklogRoom () ? m_backlog - m_queueSize : 0;
+  uint32_t sent = 0;
+  while (sent < room && !IsDone () && SendPacket (Simulator::Now ()))
+    {
+      sent++;
+    }
+  NS_LOG_LOGIC ("Refilled the backlog queue with " << sent << " packets");
+  if (IsDone ())
+    {
+      StopApplication ();
+      return;
+    }
+  // Nothing may leave the backlog queue to trigger the next refill if the
+  // packets were dropped before it: try again after the burst interval
+  if (HasBacklogRoom () && !m_refillEvent.IsRunning ())
+    {
+      m_refillEvent = Simulator::Schedule (m_burstInterval, &BurstSendApplication::Refill, this);
+    }
+}
+
+void
+BurstSendApplication::QueueSizeChanged (uint32_t oldValue, uint32_t newValue)
+{
+  m_queueSize = newValue;
+  // Refill once the packets being dequeued together have left the queue
+  if (newValue < oldValue && newValue < m_backlog && !m_refillEvent.IsRunning ()
+      && m_socket != 0 && (m_saturated || m_sendEvent.IsRunning ()))
+    {
+      m_refillEvent = Simulator::ScheduleNow (&BurstSendApplication::Refill, this);
+    }
+}
+
+void BurstSendApplication::ConnectionSucceeded (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  NS_LOG_LOGIC ("BurstSendApplication Connection succeeded");
+}
+
+void BurstSendApplication::ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  NS_LOG_LOGIC ("BurstSendApplication, Connection Failed");
+}
+
+void BurstSendApplication::DataSend (Ptr<Socket>, uint32_t)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Ignore the notifications of the packets being sent
+  if (!m_sending && !m_refillEvent.IsRunning ()
+      && (m_saturated || m_sendEvent.IsRunning ()))
+    {
+      Refill ();
+    }
+}
+
+} // Namespace ns3
@@ -17,6 +17,7 @@
  *
  * Author:  Tom Henderson (tomhend@u.washington.edu)
  */
+#include <algorithm>
 #include "ns3/address.h"
 #include "ns3/address-utils.h"
 #include "ns3/log.h"
@@ -30,8 +31,12 @@
 #include "ns3/packet.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/abort.h"
 #include "packet-sink.h"
 #include "timestamp-tag.h"
+#include "seq-ts-header.h"
 
 namespace ns3 {
 
@@ -56,6 +61,24 @@ PacketSink::GetTypeId (void)
                    TypeIdValue (UdpSocketFactory::GetTypeId ()),
                    MakeTypeIdAccessor (&PacketSink::m_tid),
                    MakeTypeIdChecker ())
+    .AddAttribute ("StatsInterval",
+                   "The duration of the intervals over which the throughput "
+                   "and the delays are computed. Zero disables the statistics.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PacketSink::m_statsInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("StatsFileName",
+                   "The name of the CSV file the statistics of every interval "
+                   "are written to. Empty for no file.",
+                   StringValue (""),
+                   MakeStringAccessor (&PacketSink::m_statsFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("SeqTsHeader",
+                   "Read the delay of the packets without TimestampTag from "
+                   "a SeqTsHeader, as sent by the UdpClient.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PacketSink::m_seqTsHeader),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Rx",
                      "A packet has been received",
                      MakeTraceSourceAccessor (&PacketSink::m_rxTrace),
@@ -69,6 +92,9 @@ PacketSink::PacketSink ()
   NS_LOG_FUNCTION (this);
   m_socket = 0;
   m_totalRx = 0;
+  m_totalPackets = 0;
+  m_intervalRx = 0;
+  m_intervalPackets = 0;
 }
 
 PacketSink::~PacketSink()
@@ -109,6 +135,10 @@ void PacketSink::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_socket = 0;
   m_socketList.clear ();
+  if (m_statsStream.is_open ())
+    {
+      m_statsStream.close ();
+    }
 
   // chain up
   Application::DoDispose ();
@@ -148,6 +178,22 @@ void PacketSink::StartApplication ()    // Called at time specified by Start
   m_socket->SetCloseCallbacks (
     MakeCallback (&PacketSink::HandlePeerClose, this),
     MakeCallback (&PacketSink::HandlePeerError, this));
+
+  if (m_statsInterval.IsStrictlyPositive ())
+    {
+      m_intervalStart = Simulator::Now ();
+      m_intervalRx = 0;
+      m_intervalPackets = 0;
+      m_intervalDelays.Reset ();
+      if (!m_statsFileName.empty () && !m_statsStream.is_open ())
+        {
+          m_statsStream.open (m_statsFileName.c_str ());
+          NS_ABORT_MSG_UNLESS (m_statsStream.is_open (), "Cannot open " << m_statsFileName);
+          m_statsStream << "time_s,rx_bytes,rx_packets,throughput_bps,delay_samples,"
+                        << "delay_min_ns,delay_mean_ns,delay_p50_ns,delay_p90_ns,"
+                        << "delay_p99_ns,delay_max_ns" << std::endl;
+        }
+    }
 }
 
 void PacketSink::StopApplication ()     // Called at time specified by Stop
@@ -164,6 +210,15 @@ void PacketSink::StopApplication ()     // Called at time specified by Stop
       m_socket->Close ();
       m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
     }
+  if (m_statsInterval.IsStrictlyPositive ())
+    {
+      CloseIntervals ();
+      if (Simulator::Now () > m_intervalStart)
+        {
+          CloseInterval (Simulator::Now ());
+        }
+      m_statsStream.flush ();
+    }
 }
 
 void PacketSink::HandleRead (Ptr<Socket> socket)
@@ -198,6 +253,10 @@ std::cout << "sally test m_totalRx change in HandleRead function, m_totalRx=" <<
                        << " total Rx " << m_totalRx << " bytes");
         }
       m_rxTrace (packet, from);
+      if (m_statsInterval.IsStrictlyPositive ())
+        {
+          UpdateStats (packet);
+        }
 
       TimestampTag timestamp;
       // Should never not be found since the sender is adding it, but
@@ -224,6 +283,83 @@ PacketSink::GetAverageDelay (void) const
     }
 }
 
+const LogLinearHistogram &
+PacketSink::GetDelayHistogram (void) const
+{
+  return m_delays;
+}
+
+const LogLinearHistogram &
+PacketSink::GetThroughputHistogram (void) const
+{
+  return m_throughputs;
+}
+
+void
+PacketSink::UpdateStats (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  CloseIntervals ();
+  m_intervalRx += packet->GetSize ();
+  m_intervalPackets++;
+
+  Time tx;
+  bool found = false;
+  TimestampTag timestamp;
+  SeqTsHeader seqTs;
+  if (packet->FindFirstMatchingByteTag (timestamp))
+    {
+      tx = timestamp.GetTimestamp ();
+      found = true;
+    }
+  else if (m_seqTsHeader && packet->GetSize () >= seqTs.GetSerializedSize ())
+    {
+      packet->PeekHeader (seqTs);
+      tx = seqTs.GetTs ();
+      found = true;
+    }
+  if (found)
+    {
+      uint64_t delay = std::max ((Simulator::Now () - tx).GetNanoSeconds (), static_cast<int64_t> (0));
+      m_intervalDelays.Add (delay);
+      m_delays.Add (delay);
+    }
+}
+
+void
+PacketSink::CloseIntervals (void)
+{
+  while (Simulator::Now () >= m_intervalStart + m_statsInterval)
+    {
+      CloseInterval (m_intervalStart + m_statsInterval);
+    }
+}
+
+void
+PacketSink::CloseInterval (Time end)
+{
+  NS_LOG_FUNCTION (this << end);
+  uint64_t throughput = m_intervalRx * 8 / (end - m_intervalStart).GetSeconds ();
+  m_throughputs.Add (throughput);
+  if (m_statsStream.is_open ())
+    {
+      m_statsStream << end.GetSeconds () << "," << m_intervalRx << "," << m_intervalPackets
+                    << "," << throughput << "," << m_intervalDelays.GetCount ()
+                    << "," << m_intervalDelays.GetMin () << "," << m_intervalDelays.GetMean ()
+                    << "," << m_intervalDelays.GetPercentile (50)
+                    << "," << m_intervalDelays.GetPercentile (90)
+                    << "," << m_intervalDelays.GetPercentile (99)
+                    << "," << m_intervalDelays.GetMax () << "\n";
+    }
+  m_intervalStart = end;
+  m_intervalRx = 0;
+  m_intervalPackets = 0;
+  if (m_intervalDelays.GetCount () != 0)
+    {
+      m_intervalDelays.Reset ();
+    }
+}
+
 void PacketSink::HandlePeerClose (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
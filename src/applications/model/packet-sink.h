@@ -21,11 +21,14 @@
 #ifndef PACKET_SINK_H
 #define PACKET_SINK_H
 
+#include <fstream>
 #include "ns3/application.h"
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
+#include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
+#include "ns3/log-linear-histogram.h"
 
 namespace ns3 {
 
@@ -64,6 +67,17 @@ class Packet;
  * as a callback on the receiving socket.  By default, when logging is
  * enabled, it prints out the size of packets and their address.
  * A tracing source to Receive() is also available.
+ *
+ * If the StatsInterval attribute is set, the sink also computes the
+ * throughput of every interval, and the one-way delays of the packets,
+ * taken from their TimestampTag or, if the SeqTsHeader attribute is set,
+ * from their SeqTsHeader.  The delays and the interval throughputs are
+ * recorded in log-linear histograms, and, if the StatsFileName attribute
+ * is set, every interval is written to a CSV file as it ends, with the
+ * throughput and the percentiles of the delays of the interval.  The
+ * intervals are closed when the next packet arrives, or when the
+ * application stops, so that the statistics need no event, and a memory
+ * that does not depend on the length of the simulation.
  */
 class PacketSink : public Application 
 {
@@ -87,6 +101,18 @@ public:
   uint64_t GetTotalReceivedPackets (void) const;
 
   Time GetAverageDelay (void) const;
+  /**
+   * \return the histogram of the one-way delays (in nanoseconds) of the
+   * packets received since the application started, if the StatsInterval
+   * attribute is set
+   */
+  const LogLinearHistogram & GetDelayHistogram (void) const;
+  /**
+   * \return the histogram of the throughputs (in bit/s) of the intervals
+   * completed since the application started, if the StatsInterval
+   * attribute is set
+   */
+  const LogLinearHistogram & GetThroughputHistogram (void) const;
   /**
    * \return pointer to listening socket
    */
@@ -125,6 +151,21 @@ private:
    * \param socket the connected socket
    */
   void HandlePeerError (Ptr<Socket> socket);
+  /**
+   * \brief Record a packet in the interval statistics
+   * \param packet the received packet
+   */
+  void UpdateStats (Ptr<const Packet> packet);
+  /**
+   * \brief Close the intervals which ended before now
+   */
+  void CloseIntervals (void);
+  /**
+   * \brief Record the statistics of the current interval, and write them
+   * to the CSV file
+   * \param end the end of the interval
+   */
+  void CloseInterval (Time end);
 
   // In the case of TCP, each socket accept returns a new socket, so the 
   // listening socket is stored separately from the accepted sockets
@@ -139,6 +180,17 @@ private:
   /// Traced Callback: received packets, source address.
   TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
   Time accummulator;
+
+  Time            m_statsInterval;  //!< Duration of the statistics intervals
+  std::string     m_statsFileName;  //!< Name of the CSV file of the intervals
+  bool            m_seqTsHeader;    //!< True if the delay can be read from a SeqTsHeader
+  std::ofstream   m_statsStream;    //!< CSV file of the intervals
+  Time            m_intervalStart;  //!< Start of the current interval
+  uint64_t        m_intervalRx;     //!< Bytes received in the current interval
+  uint64_t        m_intervalPackets; //!< Packets received in the current interval
+  LogLinearHistogram m_intervalDelays; //!< Delays of the current interval (ns)
+  LogLinearHistogram m_delays;      //!< Delays since the start (ns)
+  LogLinearHistogram m_throughputs; //!< Throughputs of the intervals (bit/s)
 };
 
 } // namespace ns3
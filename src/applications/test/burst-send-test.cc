@@ -0,0 +1,359 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <set>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/packet-socket-server.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/burst-send-helper.h"
+#include "ns3/burst-send-application.h"
+#include "ns3/timestamp-tag.h"
+
+using namespace ns3;
+
+/**
+ * Base of the tests of the BurstSendApplication: a BurstSendApplication
+ * sends packets through a packet socket to a PacketSocketServer over a
+ * simple channel.
+ */
+class BurstSendTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param linkRate the rate of the sending device
+   */
+  BurstSendTestCase (std::string name, DataRate linkRate);
+
+protected:
+  /**
+   * Create the nodes and the devices, and install the application.
+   * \param helper the helper of the application
+   * \return the application
+   */
+  Ptr<BurstSendApplication> Setup (BurstSendHelper &helper);
+  /**
+   * \return the address of the receiving device
+   */
+  PacketSocketAddress GetRemote (void) const;
+
+  /**
+   * \param packet the sent packet
+   */
+  void Sent (Ptr<const Packet> packet);
+  /**
+   * \param packet the received packet
+   * \param from the address of the sender
+   */
+  void Received (Ptr<const Packet> packet, const Address &from);
+  /**
+   * \param oldValue the previous number of packets in the device queue
+   * \param newValue the number of packets in the device queue
+   */
+  void QueueSizeChanged (uint32_t oldValue, uint32_t newValue);
+  /**
+   * \param packet the dropped packet
+   */
+  void Dropped (Ptr<const Packet> packet);
+
+  DataRate m_linkRate;                 //!< Rate of the sending device
+  NodeContainer m_nodes;               //!< The sending and receiving nodes
+  Ptr<SimpleNetDevice> m_txDev;        //!< The sending device
+  Ptr<SimpleNetDevice> m_rxDev;        //!< The receiving device
+  std::set<int64_t> m_sendTimes;       //!< Times at which packets were sent (ns)
+  std::vector<Time> m_timestamps;      //!< Timestamps of the received packets
+  uint32_t m_received;                 //!< Number of received packets
+  uint32_t m_maxQueueSize;             //!< Maximum number of packets in the device queue
+  uint32_t m_dropped;                  //!< Number of packets dropped by the device queue
+};
+
+BurstSendTestCase::BurstSendTestCase (std::string name, DataRate linkRate)
+  : TestCase (name),
+    m_linkRate (linkRate),
+    m_received (0),
+    m_maxQueueSize (0),
+    m_dropped (0)
+{
+}
+
+Ptr<BurstSendApplication>
+BurstSendTestCase::Setup (BurstSendHelper &helper)
+{
+  m_nodes.Create (2);
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (m_nodes);
+
+  m_txDev = CreateObject<SimpleNetDevice> ();
+  m_txDev->SetAttribute ("DataRate", DataRateValue (m_linkRate));
+  m_nodes.Get (0)->AddDevice (m_txDev);
+  m_rxDev = CreateObject<SimpleNetDevice> ();
+  m_nodes.Get (1)->AddDevice (m_rxDev);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  m_txDev->SetChannel (channel);
+  m_rxDev->SetChannel (channel);
+  m_txDev->SetNode (m_nodes.Get (0));
+  m_rxDev->SetNode (m_nodes.Get (1));
+  m_txDev->GetQueue ()->TraceConnectWithoutContext ("PacketsInQueue",
+                                                    MakeCallback (&BurstSendTestCase::QueueSizeChanged, this));
+  m_txDev->GetQueue ()->TraceConnectWithoutContext ("Drop",
+                                                    MakeCallback (&BurstSendTestCase::Dropped, this));
+
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->SetLocal (GetRemote ());
+  server->TraceConnectWithoutContext ("Rx", MakeCallback (&BurstSendTestCase::Received, this));
+  m_nodes.Get (1)->AddApplication (server);
+
+  Ptr<BurstSendApplication> app = DynamicCast<BurstSendApplication> (helper.Install (m_nodes.Get (0)).Get (0));
+  app->TraceConnectWithoutContext ("Tx", MakeCallback (&BurstSendTestCase::Sent, this));
+  return app;
+}
+
+PacketSocketAddress
+BurstSendTestCase::GetRemote (void) const
+{
+  PacketSocketAddress address;
+  address.SetSingleDevice (m_txDev->GetIfIndex ());
+  address.SetPhysicalAddress (m_rxDev->GetAddress ());
+  address.SetProtocol (1);
+  return address;
+}
+
+void
+BurstSendTestCase::Sent (Ptr<const Packet> packet)
+{
+  m_sendTimes.insert (Simulator::Now ().GetNanoSeconds ());
+}
+
+void
+BurstSendTestCase::Received (Ptr<const Packet> packet, const Address &from)
+{
+  TimestampTag tag;
+  NS_TEST_ASSERT_MSG_EQ (packet->FindFirstMatchingByteTag (tag), true, "Packet without timestamp");
+  m_timestamps.push_back (tag.GetTimestamp ());
+  m_received++;
+}
+
+void
+BurstSendTestCase::QueueSizeChanged (uint32_t oldValue, uint32_t newValue)
+{
+  m_maxQueueSize = std::max (m_maxQueueSize, newValue);
+}
+
+void
+BurstSendTestCase::Dropped (Ptr<const Packet> packet)
+{
+  m_dropped++;
+}
+
+/**
+ * Test that the packets sent in bursts carry the times they were
+ * generated at the configured rate, and that the application sends them
+ * with one event per burst.
+ */
+class BurstSendRateTestCase : public BurstSendTestCase
+{
+public:
+  BurstSendRateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BurstSendRateTestCase::BurstSendRateTestCase ()
+  : BurstSendTestCase ("Check the timestamps and the bursts of the packets sent at a constant rate",
+                       DataRate ("1Gbps"))
+{
+}
+
+void
+BurstSendRateTestCase::DoRun (void)
+{
+  // 1000 bytes at 100 Mb/s: a packet every 80 us, 12 or 13 packets per burst
+  BurstSendHelper helper ("ns3::PacketSocketFactory", Address ());
+  helper.SetAttribute ("DataRate", StringValue ("100Mbps"));
+  helper.SetAttribute ("PacketSize", UintegerValue (1000));
+  helper.SetAttribute ("BurstInterval", TimeValue (MilliSeconds (1)));
+  Ptr<BurstSendApplication> app = Setup (helper);
+  app->SetAttribute ("Remote", AddressValue (GetRemote ()));
+  app->SetStartTime (MilliSeconds (10));
+  app->SetStopTime (MilliSeconds (30));
+
+  Simulator::Stop (MilliSeconds (40));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // Bursts at 10.08 ms, then every millisecond until 29.08 ms: the
+  // packets generated after 29.08 ms are never sent
+  NS_TEST_ASSERT_MSG_EQ (m_received, 238, "Unexpected number of packets received");
+  for (uint32_t i = 0; i < m_timestamps.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_timestamps[i], MilliSeconds (10) + MicroSeconds (80 * (i + 1)),
+                             "Unexpected timestamp of packet " << i);
+    }
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_sendTimes.size (), 20, "More bursts than expected");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped, 0, "Packets dropped");
+}
+
+/**
+ * Test that the application keeps the queue of the device backlogged in
+ * saturated mode, without overflowing it.
+ */
+class BurstSendSaturatedTestCase : public BurstSendTestCase
+{
+public:
+  BurstSendSaturatedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BurstSendSaturatedTestCase::BurstSendSaturatedTestCase ()
+  : BurstSendTestCase ("Check that the saturated mode keeps the device queue backlogged",
+                       DataRate ("100Mbps"))
+{
+}
+
+void
+BurstSendSaturatedTestCase::DoRun (void)
+{
+  BurstSendHelper helper ("ns3::PacketSocketFactory", Address ());
+  helper.SetAttribute ("PacketSize", UintegerValue (1000));
+  helper.SetAttribute ("Saturated", BooleanValue (true));
+  helper.SetAttribute ("Backlog", UintegerValue (20));
+  Ptr<BurstSendApplication> app = Setup (helper);
+  app->SetAttribute ("Remote", AddressValue (GetRemote ()));
+  app->SetBacklogQueue (m_txDev->GetQueue (), "PacketsInQueue");
+  app->SetStartTime (MilliSeconds (10));
+  app->SetStopTime (MilliSeconds (110));
+
+  Simulator::Stop (MilliSeconds (120));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // 100 ms at 100 Mb/s, 80 us per packet
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_received, 1240, "The link was not saturated");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxQueueSize, 20, "The backlog was exceeded");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped, 0, "Packets dropped");
+}
+
+/**
+ * Test that the application does not loop forever in saturated mode
+ * while the packets are dropped before the backlog queue: over UDP and
+ * IPv4, ARP keeps only the first packets until the destination is
+ * resolved, then the application keeps the device queue backlogged.
+ */
+class BurstSendSaturatedIpv4TestCase : public TestCase
+{
+public:
+  BurstSendSaturatedIpv4TestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param oldValue the previous number of packets in the device queue
+   * \param newValue the number of packets in the device queue
+   */
+  void QueueSizeChanged (uint32_t oldValue, uint32_t newValue);
+
+  uint32_t m_maxQueueSize;             //!< Maximum number of packets in the device queue
+};
+
+BurstSendSaturatedIpv4TestCase::BurstSendSaturatedIpv4TestCase ()
+  : TestCase ("Check the saturated mode over UDP while ARP drops packets"),
+    m_maxQueueSize (0)
+{
+}
+
+void
+BurstSendSaturatedIpv4TestCase::QueueSizeChanged (uint32_t oldValue, uint32_t newValue)
+{
+  m_maxQueueSize = std::max (m_maxQueueSize, newValue);
+}
+
+void
+BurstSendSaturatedIpv4TestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  NetDeviceContainer devices = simple.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  Ptr<SimpleNetDevice> txDev = DynamicCast<SimpleNetDevice> (devices.Get (0));
+  txDev->GetQueue ()->TraceConnectWithoutContext ("PacketsInQueue",
+                                                  MakeCallback (&BurstSendSaturatedIpv4TestCase::QueueSizeChanged, this));
+
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkHelper.Install (nodes.Get (1)).Get (0));
+
+  BurstSendHelper helper ("ns3::UdpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), 9));
+  helper.SetAttribute ("PacketSize", UintegerValue (1000));
+  helper.SetAttribute ("Saturated", BooleanValue (true));
+  helper.SetAttribute ("Backlog", UintegerValue (20));
+  Ptr<BurstSendApplication> app = DynamicCast<BurstSendApplication> (helper.Install (nodes.Get (0)).Get (0));
+  app->SetBacklogQueue (txDev->GetQueue (), "PacketsInQueue");
+  app->SetStartTime (MilliSeconds (10));
+  app->SetStopTime (MilliSeconds (110));
+
+  Simulator::Stop (MilliSeconds (120));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // 100 ms at 100 Mb/s, 88 us per packet with the UDP, IPv4 and link headers
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (sink->GetTotalRx (), 1130 * 1000, "The link was not saturated");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxQueueSize, 20, "The backlog was exceeded");
+}
+
+/**
+ * BurstSendApplication TestSuite
+ */
+class BurstSendTestSuite : public TestSuite
+{
+public:
+  BurstSendTestSuite ();
+};
+
+BurstSendTestSuite::BurstSendTestSuite ()
+  : TestSuite ("burst-send", UNIT)
+{
+  AddTestCase (new BurstSendRateTestCase, TestCase::QUICK);
+  AddTestCase (new BurstSendSaturatedTestCase, TestCase::QUICK);
+  AddTestCase (new BurstSendSaturatedIpv4TestCase, TestCase::QUICK);
+}
+
+static BurstSendTestSuite burstSendTestSuite;
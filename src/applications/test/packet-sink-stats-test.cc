@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/burst-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+
+using namespace ns3;
+
+/**
+ * Test the interval statistics of the PacketSink: a BurstSendApplication
+ * sends 100 Mb/s in bursts of 1 ms to a PacketSink, which writes the
+ * statistics of intervals of 10 ms to a CSV file.
+ */
+class PacketSinkStatsTestCase : public TestCase
+{
+public:
+  PacketSinkStatsTestCase ();
+  virtual ~PacketSinkStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PacketSinkStatsTestCase::PacketSinkStatsTestCase ()
+  : TestCase ("Check the interval throughputs and the delay percentiles of the PacketSink")
+{
+}
+
+PacketSinkStatsTestCase::~PacketSinkStatsTestCase ()
+{
+}
+
+void
+PacketSinkStatsTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (nodes);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  txDev->SetAttribute ("DataRate", StringValue ("1Gbps"));
+  nodes.Get (0)->AddDevice (txDev);
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  nodes.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  txDev->SetChannel (channel);
+  rxDev->SetChannel (channel);
+  txDev->SetNode (nodes.Get (0));
+  rxDev->SetNode (nodes.Get (1));
+
+  PacketSocketAddress address;
+  address.SetSingleDevice (txDev->GetIfIndex ());
+  address.SetPhysicalAddress (rxDev->GetAddress ());
+  address.SetProtocol (1);
+
+  BurstSendHelper burst ("ns3::PacketSocketFactory", address);
+  burst.SetAttribute ("DataRate", StringValue ("100Mbps"));
+  burst.SetAttribute ("PacketSize", UintegerValue (1000));
+  burst.SetAttribute ("BurstInterval", TimeValue (MilliSeconds (1)));
+  ApplicationContainer sender = burst.Install (nodes.Get (0));
+  sender.Start (MilliSeconds (10));
+  sender.Stop (MilliSeconds (60));
+
+  std::string fileName = CreateTempDirFilename ("packet-sink-stats.csv");
+  PacketSinkHelper sinkHelper ("ns3::PacketSocketFactory", address);
+  sinkHelper.SetAttribute ("StatsInterval", TimeValue (MilliSeconds (10)));
+  sinkHelper.SetAttribute ("StatsFileName", StringValue (fileName));
+  ApplicationContainer receiver = sinkHelper.Install (nodes.Get (1));
+  receiver.Start (Seconds (0));
+  receiver.Stop (MilliSeconds (70));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (receiver.Get (0));
+
+  Simulator::Run ();
+
+  // The packets generated in (10, 59.08] ms are received: 113 in the first
+  // interval, then 125 (100 Mb/s) per interval
+  const uint64_t rxPackets[] = { 0, 113, 125, 125, 125, 125, 0 };
+  const LogLinearHistogram &delays = sink->GetDelayHistogram ();
+  NS_TEST_ASSERT_MSG_EQ (delays.GetCount (), 613, "Unexpected number of delays");
+  // The 13 packets of a burst are generated 80 us apart, the oldest is
+  // sent first, and each waits 8 us more than the previous one in the
+  // device queue: the j-th youngest waits j * 80 + (12 - j) * 8 us
+  NS_TEST_ASSERT_MSG_EQ_TOL (delays.GetPercentile (50), 528000, 528000 / 128, "Unexpected median delay");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (delays.GetMax (), 960000, "Delay above the burst interval");
+  NS_TEST_ASSERT_MSG_EQ (sink->GetThroughputHistogram ().GetCount (), 7, "Unexpected number of intervals");
+  NS_TEST_ASSERT_MSG_EQ (sink->GetThroughputHistogram ().GetMax (), 100000000, "Unexpected throughput");
+
+  Simulator::Destroy ();
+
+  std::ifstream file (fileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "No CSV file");
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line.substr (0, 7), "time_s,", "No CSV header");
+  uint32_t row = 0;
+  while (std::getline (file, line))
+    {
+      std::vector<double> values;
+      std::istringstream fields (line);
+      std::string field;
+      while (std::getline (fields, field, ','))
+        {
+          values.push_back (atof (field.c_str ()));
+        }
+      NS_TEST_ASSERT_MSG_EQ (values.size (), 11, "Unexpected number of columns in row " << row);
+      NS_TEST_ASSERT_MSG_LT (row, 7, "Too many rows");
+      NS_TEST_ASSERT_MSG_EQ_TOL (values[0], 0.01 * (row + 1), 1e-9, "Unexpected end of interval " << row);
+      NS_TEST_ASSERT_MSG_EQ (values[2], rxPackets[row], "Unexpected packets in interval " << row);
+      NS_TEST_ASSERT_MSG_EQ (values[3], rxPackets[row] * 8000 * 100, "Unexpected throughput in interval " << row);
+      NS_TEST_ASSERT_MSG_EQ (values[4], rxPackets[row], "Unexpected delays in interval " << row);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (values[5], values[7], "Minimum above the median in interval " << row);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (values[7], values[8], "Median above the 90th percentile in interval " << row);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (values[8], values[9], "90th above the 99th percentile in interval " << row);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (values[9], values[10], "99th percentile above the maximum in interval " << row);
+      row++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (row, 7, "Unexpected number of rows");
+}
+
+/**
+ * PacketSink statistics TestSuite
+ */
+class PacketSinkStatsTestSuite : public TestSuite
+{
+public:
+  PacketSinkStatsTestSuite ();
+};
+
+PacketSinkStatsTestSuite::PacketSinkStatsTestSuite ()
+  : TestSuite ("packet-sink-stats", UNIT)
+{
+  AddTestCase (new PacketSinkStatsTestCase, TestCase::QUICK);
+}
+
+static PacketSinkStatsTestSuite packetSinkStatsTestSuite;
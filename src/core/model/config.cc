@@ -24,9 +24,11 @@
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "boolean.h"
 #include "log.h"
 
 #include <sstream>
+#include <map>
 
 /**
  * \file
@@ -38,6 +40,21 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Config");
 
+/**
+ * \ingroup config
+ * The \c ConfigMatchCache GlobalValue: whether Config path lookups
+ * are cached.
+ */
+static GlobalValue g_configMatchCache =
+  GlobalValue ("ConfigMatchCache",
+               "Whether the objects matched by Config paths are cached between calls to "
+               "Config::Set, Config::Connect and Config::LookupMatches. The cache is "
+               "invalidated when nodes, devices, applications, aggregated objects or "
+               "object names are added, and when Config::Set changes a Pointer attribute; "
+               "objects re-parented by other means are not noticed.",
+               BooleanValue (false),
+               MakeBooleanChecker ());
+
 namespace Config {
 
 MatchContainer::MatchContainer ()
@@ -89,6 +106,18 @@ MatchContainer::GetPath (void) const
   NS_LOG_FUNCTION (this);
   return m_path;
 }
+const std::vector<Ptr<Object> > &
+MatchContainer::GetObjects (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_objects;
+}
+const std::vector<std::string> &
+MatchContainer::GetMatchedPaths (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_contexts;
+}
 
 void
 MatchContainer::Set (std::string name, const AttributeValue &value)
@@ -99,6 +128,18 @@ MatchContainer::Set (std::string name, const AttributeValue &value)
       Ptr<Object> object = *tmp;
       object->SetAttribute (name, value);
     }
+  //
+  // Setting a Pointer or ObjectPtrContainer attribute changes the object
+  // tree below the matched objects.
+  //
+  struct TypeId::AttributeInformation info;
+  if (!m_objects.empty ()
+      && m_objects.front ()->GetInstanceTypeId ().LookupAttributeByName (name, &info)
+      && (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0
+          || dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0))
+    {
+      InvalidateMatchCache ();
+    }
 }
 void 
 MatchContainer::Connect (std::string name, const CallbackBase &cb)
@@ -156,6 +197,9 @@ public:
   /**
    * Construct from a Config path specification.
    *
+   * The specification is parsed once, here, so that Matches() only
+   * performs integer comparisons.
+   *
    * \param [in] element The Config path specification.
    */
   ArrayMatcher (std::string element);
@@ -175,75 +219,91 @@ private:
    * \returns \c true if the string could be converted.
    */
   bool StringToUint32 (std::string str, uint32_t *value) const;
+  /**
+   * Parse one '|'-separated alternative of the specification.
+   *
+   * \param [in] element The alternative.
+   */
+  void ParseAlternative (std::string element);
+
+  /** A closed range of matching indices. */
+  struct Range
+  {
+    uint32_t min;  //!< Lowest matching index.
+    uint32_t max;  //!< Highest matching index.
+  };
+
   /** The Config path element. */
   std::string m_element;
+  /** Whether the element matches every index. */
+  bool m_any;
+  /** The ranges of matching indices; single indices are one-element ranges. */
+  std::vector<struct Range> m_ranges;
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_any (false)
+{
+  NS_LOG_FUNCTION (this << element);
+  std::string::size_type start = 0;
+  std::string::size_type bar;
+  while ((bar = element.find ("|", start)) != std::string::npos)
+    {
+      ParseAlternative (element.substr (start, bar - start));
+      start = bar + 1;
+    }
+  ParseAlternative (element.substr (start));
+}
+void
+ArrayMatcher::ParseAlternative (std::string element)
 {
   NS_LOG_FUNCTION (this << element);
+  if (element == "*")
+    {
+      m_any = true;
+      return;
+    }
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
+      dash > leftBracket && dash < rightBracket)
+    {
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
+      struct Range range;
+      if (StringToUint32 (lowerBound, &range.min) &&
+          StringToUint32 (upperBound, &range.max))
+        {
+          m_ranges.push_back (range);
+        }
+      return;
+    }
+  struct Range range;
+  if (StringToUint32 (element, &range.min))
+    {
+      range.max = range.min;
+      m_ranges.push_back (range);
+    }
 }
 bool
 ArrayMatcher::Matches (uint32_t i) const
 {
   NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  if (m_any)
     {
       NS_LOG_DEBUG ("Array "<<i<<" matches *");
       return true;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  for (std::vector<struct Range>::const_iterator it = m_ranges.begin (); it != m_ranges.end (); ++it)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
-    }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
-      dash > leftBracket && dash < rightBracket)
-    {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
-      uint32_t min;
-      uint32_t max;
-      if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+      if (i >= it->min && i <= it->max)
         {
           NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
           return true;
         }
-      else
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
-        }
-    }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
-    {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
     }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
@@ -259,6 +319,115 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * A Config path compiled into its elements.
+ *
+ * The path is split once, array specifications are parsed once and
+ * the TypeIds named by "$" elements are looked up once, so resolving
+ * the path against many objects does no string processing beyond
+ * attribute name comparisons.
+ */
+class CompiledPath
+{
+public:
+  /** One element of the path, between two '/'. */
+  struct Element
+  {
+    /**
+     * Construct from the text of the element.
+     * \param [in] element The text of the element.
+     */
+    Element (std::string element);
+
+    std::string item;       //!< The text of the element.
+    bool isGetObject;       //!< Whether the element is a "$TypeId" element.
+    bool isNames;           //!< Whether the element selects the "/Names" namespace.
+    bool hasTid;            //!< Whether the TypeId of a "$" element is known.
+    TypeId tid;             //!< The TypeId of a "$" element.
+    ArrayMatcher matcher;   //!< The matcher used when the element indexes a container.
+  };
+
+  /**
+   * Compile a Config path.  A '/' is assumed at the start and the end
+   * of the path if missing.
+   *
+   * \param [in] path The Config path.
+   */
+  CompiledPath (std::string path);
+
+  /** \returns The canonical (slash-terminated) path. */
+  std::string GetPath (void) const;
+  /** \returns The number of elements in the path. */
+  uint32_t GetN (void) const;
+  /**
+   * \param [in] i The index of the element.
+   * \returns The requested element.
+   */
+  const struct Element & Get (uint32_t i) const;
+
+private:
+  /** The canonical path. */
+  std::string m_path;
+  /** The elements of the path. */
+  std::vector<struct Element> m_elements;
+};
+
+CompiledPath::Element::Element (std::string element)
+  : item (element),
+    isGetObject (element.find ("$") == 0),
+    isNames (element.find ("Names") == 0),
+    hasTid (false),
+    matcher (element)
+{
+  if (isGetObject)
+    {
+      hasTid = TypeId::LookupByNameFailSafe (element.substr (1, element.size () - 1), &tid);
+    }
+}
+
+CompiledPath::CompiledPath (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // ensure that we start and end with a '/'
+  std::string::size_type tmp = path.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      path = "/" + path;
+    }
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
+    {
+      // no slash at end
+      path = path + "/";
+    }
+  m_path = path;
+
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", start)) != std::string::npos)
+    {
+      m_elements.push_back (Element (path.substr (start, next - start)));
+      start = next + 1;
+    }
+}
+std::string
+CompiledPath::GetPath (void) const
+{
+  return m_path;
+}
+uint32_t
+CompiledPath::GetN (void) const
+{
+  return m_elements.size ();
+}
+const struct CompiledPath::Element &
+CompiledPath::Get (uint32_t i) const
+{
+  return m_elements[i];
+}
+
 /**
  * Abstract class to parse Config paths into object references.
  */
@@ -271,6 +440,12 @@ public:
    * \param [in] path The Config path.
    */
   Resolver (std::string path);
+  /**
+   * Construct from a compiled Config path.
+   *
+   * \param [in] path The compiled Config path.
+   */
+  Resolver (const CompiledPath &path);
   /** Destructor. */
   virtual ~Resolver ();
 
@@ -282,25 +457,32 @@ public:
    *                  in the Config path.
    */
   void Resolve (Ptr<Object> root);
+  /**
+   * Parse the stored Config path relative to an object already found
+   * at some position of a longer Config path.
+   *
+   * \param [in] root The object from which the stored path is resolved.
+   * \param [in] context The matched Config path of \p root, which
+   *                     prefixes the matched paths passed to DoOne().
+   */
+  void Resolve (Ptr<Object> root, std::string context);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] index The index of the next element of the Config path.
    * \param [in] root The object corresponding to the current positon
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (uint32_t index, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
+   * \param [in] index The index of the array element of the Config path.
    * \param [in,out] vector The resulting list of matching objects.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (uint32_t index, const ObjectPtrContainerValue &vector);
   /**
    * Handle one object found on the path.
    *
@@ -323,38 +505,94 @@ private:
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The compiled Config path. */
+  CompiledPath m_path;
+  /** The matched path of the object the resolution started from. */
+  std::string m_context;
+};
+
+/**
+ * An attribute which leads from an object to other objects, that is,
+ * a Pointer or an ObjectPtrContainer attribute.
+ */
+struct PathAttribute
+{
+  std::string name;   //!< The attribute name.
+  bool isContainer;   //!< Whether the attribute is an ObjectPtrContainer.
 };
 
+/**
+ * Find the Pointer and ObjectPtrContainer attributes of a TypeId, and of
+ * its parents, which match one Config path element.
+ *
+ * TypeIds do not change once registered, so the answer is computed once
+ * per (TypeId, element) pair.
+ *
+ * \param [in] tid The TypeId of the object being resolved.
+ * \param [in] item The Config path element.
+ * \returns The matching attributes, in resolution order.
+ */
+static const std::vector<struct PathAttribute> &
+LookupPathAttributes (TypeId tid, std::string item)
+{
+  typedef std::map<std::pair<uint16_t, std::string>, std::vector<struct PathAttribute> > AttributeMap;
+  static AttributeMap attributes;
+
+  std::pair<uint16_t, std::string> key = std::make_pair (tid.GetUid (), item);
+  AttributeMap::const_iterator found = attributes.find (key);
+  if (found != attributes.end ())
+    {
+      return found->second;
+    }
+
+  std::vector<struct PathAttribute> matches;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          // attempt to cast to a pointer checker.
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              struct PathAttribute attribute = { info.name, false };
+              matches.push_back (attribute);
+            }
+          // attempt to cast to an object vector.
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              struct PathAttribute attribute = { info.name, true };
+              matches.push_back (attribute);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+
+  return attributes.insert (std::make_pair (key, matches)).first->second;
+}
+
 Resolver::Resolver (std::string path)
-  : m_path (path)
+  : m_path (path),
+    m_context ("/")
 {
   NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
 }
-Resolver::~Resolver ()
+Resolver::Resolver (const CompiledPath &path)
+  : m_path (path),
+    m_context ("/")
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << path.GetPath ());
 }
-void
-Resolver::Canonicalize (void)
+Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
 }
 
 void 
@@ -362,7 +600,19 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  m_context = "/";
+  DoResolve (0, root);
+}
+
+void 
+Resolver::Resolve (Ptr<Object> root, std::string context)
+{
+  NS_LOG_FUNCTION (this << root << context);
+  NS_ASSERT (root != 0);
+
+  m_context = context;
+  DoResolve (0, root);
+  m_context = "/";
 }
 
 std::string
@@ -370,7 +620,7 @@ Resolver::GetResolvedPath (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  std::string fullPath = "/";
+  std::string fullPath = m_context;
   for (std::vector<std::string>::const_iterator i = m_workStack.begin (); i != m_workStack.end (); i++)
     {
       fullPath += *i + "/";
@@ -388,13 +638,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t index, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << index << root);
 
-  if (next == std::string::npos)
+  if (index == m_path.GetN ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -410,8 +658,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const struct CompiledPath::Element &element = m_path.Get (index);
+  std::string const &item = element.item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -422,11 +670,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (element.isNames)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (index + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -443,7 +690,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (index + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -459,82 +706,59 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (element.isGetObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject="<<item<<" on path="<<GetResolvedPath ());
+      TypeId tid = element.hasTid ? element.tid : TypeId::LookupByName (item.substr (1, item.size () - 1));
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<item<<") failed on path="<<GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (index + 1, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const std::vector<struct PathAttribute> &attributes = LookupPathAttributes (root->GetInstanceTypeId (), item);
       bool foundMatch = false;
-      
-      do
+
+      for (std::vector<struct PathAttribute>::const_iterator i = attributes.begin (); i != attributes.end (); ++i)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (!i->isContainer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              root->GetAttribute (i->name, ptr);
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoResolve (index + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              foundMatch = true;
+              ObjectPtrContainerValue vector;
+              root->GetAttribute (i->name, vector);
+              m_workStack.push_back (i->name);
+              DoArrayResolve (index + 1, vector);
+              m_workStack.pop_back ();
             }
+        }
 
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
       if (!foundMatch)
         {
           NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
@@ -544,29 +768,24 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t index, const ObjectPtrContainerValue &container)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION(this << index << &container);
+  if (index == m_path.GetN ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const struct CompiledPath::Element &element = m_path.Get (index);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
-      if (matcher.Matches ((*it).first))
+      if (element.matcher.Matches ((*it).first))
         {
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (index + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -588,6 +807,12 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   Config::MatchContainer LookupMatches (std::string path);
+  /** \copydoc Config::ConnectAll() */
+  void ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb);
+  /** \copydoc Config::ConnectAllWithoutContext() */
+  void ConnectAllWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb);
+  /** \copydoc Config::InvalidateMatchCache() */
+  void InvalidateMatchCache (void);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -608,12 +833,31 @@ private:
    * \param [in,out] leaf The trailing part of the \p path.
    */
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+  /**
+   * Find the objects matching a compiled Config path.
+   * \param [in] path The compiled Config path.
+   * \returns The matching objects.
+   */
+  Config::MatchContainer LookupMatches (const CompiledPath &path);
+  /**
+   * Resolve the trace source paths sharing their leading elements
+   * once, then hand every matching (object, trace source) pair to a
+   * connect operation.
+   * \param [in] paths The trace source paths.
+   * \param [in] cb The callback to connect.
+   * \param [in] withContext Whether the callback gets the context string.
+   */
+  void DoConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb, bool withContext);
 
   /** Container type to hold the root Config path tokens. */
   typedef std::vector<Ptr<Object> > Roots;
+  /** Container type for the cached matches, by canonical path. */
+  typedef std::map<std::string, Config::MatchContainer> MatchCache;
 
   /** The list of Config path roots. */
   Roots m_roots;
+  /** The cached matches. */
+  MatchCache m_matchCache;
 };
 
 void 
@@ -677,23 +921,53 @@ ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
   container.Disconnect (leaf, cb);
 }
 
+/** Resolver which collects the matched objects and their contexts. */
+class LookupMatchesResolver : public Resolver 
+{
+public:
+  /**
+   * Construct from a compiled Config path.
+   * \param [in] path The compiled Config path.
+   */
+  LookupMatchesResolver (const CompiledPath &path)
+    : Resolver (path)
+  {}
+  virtual void DoOne (Ptr<Object> object, std::string path) {
+    m_objects.push_back (object);
+    m_contexts.push_back (path);
+  }
+  /** The matched objects. */
+  std::vector<Ptr<Object> > m_objects;
+  /** The matched paths of the objects. */
+  std::vector<std::string> m_contexts;
+};
+
 Config::MatchContainer 
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver 
-  {
-  public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path) {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  Config::MatchContainer matches = LookupMatches (CompiledPath (path));
+  return Config::MatchContainer (matches.GetObjects (), matches.GetMatchedPaths (), path);
+}
+
+Config::MatchContainer 
+ConfigImpl::LookupMatches (const CompiledPath &path)
+{
+  NS_LOG_FUNCTION (this << path.GetPath ());
+
+  BooleanValue useCache;
+  g_configMatchCache.GetValue (useCache);
+  if (useCache.Get ())
+    {
+      MatchCache::const_iterator cached = m_matchCache.find (path.GetPath ());
+      if (cached != m_matchCache.end ())
+        {
+          NS_LOG_DEBUG ("cached matches for " << path.GetPath ());
+          return cached->second;
+        }
+    }
+
+  LookupMatchesResolver resolver = LookupMatchesResolver (path);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -706,7 +980,152 @@ ConfigImpl::LookupMatches (std::string path)
   //
   resolver.Resolve (0);
 
-  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+  Config::MatchContainer matches (resolver.m_objects, resolver.m_contexts, path.GetPath ());
+  if (useCache.Get ())
+    {
+      m_matchCache[path.GetPath ()] = matches;
+    }
+  return matches;
+}
+
+void
+ConfigImpl::ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << paths.size () << &cb);
+  DoConnectAll (paths, cb, true);
+}
+
+void
+ConfigImpl::ConnectAllWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << paths.size () << &cb);
+  DoConnectAll (paths, cb, false);
+}
+
+void
+ConfigImpl::DoConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb, bool withContext)
+{
+  NS_LOG_FUNCTION (this << paths.size () << &cb << withContext);
+  if (paths.empty ())
+    {
+      return;
+    }
+
+  //
+  // Group the trace sources by the path of the objects holding them.
+  //
+  typedef std::map<std::string, std::vector<std::string> > Leaves;
+  Leaves leaves;
+  for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); ++i)
+    {
+      std::string root, leaf;
+      ParsePath (*i, &root, &leaf);
+      leaves[CompiledPath (root).GetPath ()].push_back (leaf);
+    }
+
+  //
+  // Find the leading elements shared by all object paths, and look up
+  // the objects matching them once.
+  //
+  std::vector<CompiledPath> roots;
+  for (Leaves::const_iterator i = leaves.begin (); i != leaves.end (); ++i)
+    {
+      roots.push_back (CompiledPath (i->first));
+    }
+  uint32_t common = roots.front ().GetN ();
+  for (std::vector<CompiledPath>::const_iterator i = roots.begin (); i != roots.end (); ++i)
+    {
+      uint32_t n = 0;
+      while (n < common && n < i->GetN () && i->Get (n).item == roots.front ().Get (n).item)
+        {
+          n++;
+        }
+      common = n;
+    }
+  //
+  // Container attributes and their indices must be resolved together:
+  // do not split the paths right before an index.
+  //
+  bool splitsIndex = true;
+  while (common > 0 && splitsIndex)
+    {
+      splitsIndex = false;
+      for (std::vector<CompiledPath>::const_iterator i = roots.begin (); i != roots.end (); ++i)
+        {
+          if (common < i->GetN ()
+              && i->Get (common).item.find_first_not_of ("0123456789*[]-|") == std::string::npos)
+            {
+              splitsIndex = true;
+            }
+        }
+      if (splitsIndex)
+        {
+          common--;
+        }
+    }
+  //
+  // The objects named under "/Names" are not reachable from the root
+  // namespace objects nor from the "/Names" root itself: without a shared
+  // prefix below it, look up each object path on its own.
+  //
+  bool perPath = common == 0 || (common == 1 && roots.front ().Get (0).item == "Names");
+  Config::MatchContainer base;
+  if (!perPath)
+    {
+      std::string prefix = "/";
+      for (uint32_t n = 0; n < common; n++)
+        {
+          prefix += roots.front ().Get (n).item + "/";
+        }
+      base = LookupMatches (CompiledPath (prefix));
+      NS_LOG_DEBUG ("shared prefix " << prefix << " matches " << base.GetN () << " objects");
+    }
+
+  //
+  // Resolve what is left of each object path from the shared matches and
+  // connect its trace sources.
+  //
+  Leaves::const_iterator leaf = leaves.begin ();
+  for (std::vector<CompiledPath>::const_iterator i = roots.begin (); i != roots.end (); ++i, ++leaf)
+    {
+      std::string suffix = "/";
+      for (uint32_t n = common; n < i->GetN (); n++)
+        {
+          suffix += i->Get (n).item + "/";
+        }
+      Config::MatchContainer matches = base;
+      if (perPath)
+        {
+          matches = LookupMatches (*i);
+        }
+      else if (common != i->GetN ())
+        {
+          LookupMatchesResolver resolver = LookupMatchesResolver (CompiledPath (suffix));
+          for (uint32_t j = 0; j < base.GetN (); j++)
+            {
+              resolver.Resolve (base.Get (j), base.GetMatchedPath (j));
+            }
+          matches = Config::MatchContainer (resolver.m_objects, resolver.m_contexts, i->GetPath ());
+        }
+      for (std::vector<std::string>::const_iterator name = leaf->second.begin (); name != leaf->second.end (); ++name)
+        {
+          if (withContext)
+            {
+              matches.Connect (*name, cb);
+            }
+          else
+            {
+              matches.ConnectWithoutContext (*name, cb);
+            }
+        }
+    }
+}
+
+void
+ConfigImpl::InvalidateMatchCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_matchCache.clear ();
 }
 
 void 
@@ -714,6 +1133,7 @@ ConfigImpl::RegisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (this << obj);
   m_roots.push_back (obj);
+  InvalidateMatchCache ();
 }
 
 void 
@@ -726,6 +1146,7 @@ ConfigImpl::UnregisterRootNamespaceObject (Ptr<Object> obj)
       if (*i == obj)
         {
           m_roots.erase (i);
+          InvalidateMatchCache ();
           return;
         }
     }
@@ -843,11 +1264,28 @@ Disconnect (std::string path, const CallbackBase &cb)
   NS_LOG_FUNCTION (path << &cb);
   ConfigImpl::Get ()->Disconnect (path, cb);
 }
+void
+ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (paths.size () << &cb);
+  ConfigImpl::Get ()->ConnectAll (paths, cb);
+}
+void
+ConnectAllWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (paths.size () << &cb);
+  ConfigImpl::Get ()->ConnectAllWithoutContext (paths, cb);
+}
 Config::MatchContainer LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (path);
   return ConfigImpl::Get ()->LookupMatches (path);
 }
+void InvalidateMatchCache (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  ConfigImpl::Get ()->InvalidateMatchCache ();
+}
 
 void RegisterRootNamespaceObject (Ptr<Object> obj)
 {
@@ -139,6 +139,28 @@ void Connect (std::string path, const CallbackBase &cb);
  * This function undoes the work of Config::ConnectWithContext.
  */
 void Disconnect (std::string path, const CallbackBase &cb);
+/**
+ * \ingroup config
+ * \param [in] paths Paths to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ *
+ * This function is equivalent to calling Config::Connect on each of
+ * the input paths, but the leading part of the paths which is common
+ * to all of them is resolved only once.  For example, trace sources of
+ * the PHY and of the MAC of every wifi device can be connected with a
+ * single walk of the node and device lists.
+ */
+void ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb);
+/**
+ * \ingroup config
+ * \param [in] paths Paths to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ *
+ * This function is equivalent to calling Config::ConnectWithoutContext
+ * on each of the input paths, but the leading part of the paths which is
+ * common to all of them is resolved only once.
+ */
+void ConnectAllWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb);
 
 /**
  * \ingroup config
@@ -194,6 +216,15 @@ public:
    * \returns The path used to perform the object matching.
    */
   std::string GetPath (void) const;
+  /**
+   * \returns The objects in this container.
+   */
+  const std::vector<Ptr<Object> > & GetObjects (void) const;
+  /**
+   * \returns The fully-qualified matching paths of the objects
+   *          in this container.
+   */
+  const std::vector<std::string> & GetMatchedPaths (void) const;
 
   /**
    * \param [in] name Name of attribute to set
@@ -258,6 +289,20 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * Forget the objects matched by earlier path lookups.
+ *
+ * When the \c ConfigMatchCache GlobalValue is true, the objects matched
+ * by a path are remembered and reused by later lookups of the same path.
+ * This function must be called whenever the object tree changes: it is
+ * called when root namespace objects, nodes, devices, applications,
+ * aggregated objects or object names are added, and when Config::Set
+ * changes a Pointer attribute.  Code which otherwise changes the objects
+ * reachable from a path must call it explicitly.
+ */
+void InvalidateMatchCache (void);
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
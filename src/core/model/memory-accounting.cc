@@ -0,0 +1,339 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "memory-accounting.h"
+#include "object.h"
+#include "config.h"
+#include "pointer.h"
+#include "object-ptr-container.h"
+#include "log.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::MemoryAccounting implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MemoryAccounting");
+
+bool MemoryAccounting::m_enabled = false;
+bool MemoryAccounting::m_reportAtDestroy = false;
+
+namespace {
+
+/** The live instances of a TypeId or of a named category. */
+struct Category
+{
+  std::string name;     //!< The name of the TypeId or category.
+  uint32_t size;        //!< The size of an Object of the TypeId.
+  uint64_t count;       //!< The number of live instances.
+  uint64_t bytes;       //!< The bytes held by the live instances.
+  uint64_t peakBytes;   //!< The peak of bytes.
+};
+
+/** All the categories. */
+struct CategoryTable
+{
+  std::vector<struct Category> categories;     //!< The categories.
+  std::vector<uint32_t> byTypeId;              //!< TypeId uid --> category index + 1, or 0.
+  std::map<std::string, uint32_t> byName;      //!< Category name --> category index.
+};
+
+/**
+ * \returns The table of categories.
+ */
+CategoryTable &
+GetTable (void)
+{
+  // never deleted: Objects held by static variables may be deleted
+  // after the static variables of this file
+  static CategoryTable *table = new CategoryTable ();
+  return *table;
+}
+
+/**
+ * Compare categories by decreasing bytes.
+ * \param [in] a A category.
+ * \param [in] b Another category.
+ * \returns \c true if \p a holds more bytes than \p b.
+ */
+bool
+CompareBytes (const struct Category *a, const struct Category *b)
+{
+  return a->bytes > b->bytes;
+}
+
+/**
+ * Count the objects reachable from an object and not visited yet.
+ *
+ * \param [in] root The object to start from.
+ * \param [in,out] visited The objects already counted.
+ * \param [in,out] objects The number of objects counted.
+ * \param [in,out] bytes The bytes of the objects counted.
+ */
+void
+CountReachable (Ptr<Object> root, std::set<const Object *> &visited, uint64_t &objects, uint64_t &bytes)
+{
+  std::vector<Ptr<Object> > stack;
+  stack.push_back (root);
+  while (!stack.empty ())
+    {
+      Ptr<Object> object = stack.back ();
+      stack.pop_back ();
+      if (object == 0 || !visited.insert (PeekPointer (object)).second)
+        {
+          continue;
+        }
+      TypeId tid = object->GetInstanceTypeId ();
+      objects++;
+      if (tid.GetSize () != (std::size_t)(-1))
+        {
+          bytes += tid.GetSize ();
+        }
+
+      Object::AggregateIterator aggregates = object->GetAggregateIterator ();
+      while (aggregates.HasNext ())
+        {
+          stack.push_back (ConstCast<Object> (aggregates.Next ()));
+        }
+      for (TypeId t = tid; ; t = t.GetParent ())
+        {
+          for (uint32_t i = 0; i < t.GetAttributeN (); i++)
+            {
+              struct TypeId::AttributeInformation info = t.GetAttribute (i);
+              if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+                {
+                  continue;
+                }
+              if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+                {
+                  PointerValue ptr;
+                  object->GetAttribute (info.name, ptr);
+                  stack.push_back (ptr.Get<Object> ());
+                }
+              else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+                {
+                  ObjectPtrContainerValue container;
+                  object->GetAttribute (info.name, container);
+                  for (ObjectPtrContainerValue::Iterator j = container.Begin (); j != container.End (); ++j)
+                    {
+                      stack.push_back (j->second);
+                    }
+                }
+            }
+          if (!t.HasParent () || t.GetParent () == t)
+            {
+              break;
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+void
+MemoryAccounting::Enable (bool reportAtDestroy)
+{
+  NS_LOG_FUNCTION (reportAtDestroy);
+  m_enabled = true;
+  m_reportAtDestroy = reportAtDestroy;
+}
+
+void
+MemoryAccounting::Disable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enabled = false;
+  m_reportAtDestroy = false;
+}
+
+uint32_t
+MemoryAccounting::GetCategory (std::string name)
+{
+  NS_LOG_FUNCTION (name);
+  CategoryTable &table = GetTable ();
+  std::map<std::string, uint32_t>::const_iterator i = table.byName.find (name);
+  if (i != table.byName.end ())
+    {
+      return i->second;
+    }
+  struct Category category;
+  category.name = name;
+  category.size = 0;
+  category.count = 0;
+  category.bytes = 0;
+  category.peakBytes = 0;
+  table.categories.push_back (category);
+  uint32_t index = table.categories.size () - 1;
+  table.byName[name] = index;
+  return index;
+}
+
+uint32_t
+MemoryAccounting::GetCategory (TypeId tid)
+{
+  CategoryTable &table = GetTable ();
+  uint16_t uid = tid.GetUid ();
+  if (uid < table.byTypeId.size () && table.byTypeId[uid] != 0)
+    {
+      return table.byTypeId[uid] - 1;
+    }
+  uint32_t index = GetCategory (tid.GetName ());
+  // classes which do not invoke NS_OBJECT_ENSURE_REGISTERED take the
+  // size of the nearest registered parent
+  TypeId sized = tid;
+  while (sized.GetSize () == (std::size_t)(-1) && sized.HasParent () && sized.GetParent () != sized)
+    {
+      sized = sized.GetParent ();
+    }
+  table.categories[index].size = sized.GetSize () == (std::size_t)(-1) ? sizeof (Object) : sized.GetSize ();
+  if (uid >= table.byTypeId.size ())
+    {
+      table.byTypeId.resize (uid + 1, 0);
+    }
+  table.byTypeId[uid] = index + 1;
+  return index;
+}
+
+void
+MemoryAccounting::NotifyAllocation (uint32_t category, uint32_t bytes)
+{
+  struct Category &c = GetTable ().categories[category];
+  c.count++;
+  c.bytes += bytes;
+  c.peakBytes = std::max (c.peakBytes, c.bytes);
+}
+
+void
+MemoryAccounting::NotifyDeallocation (uint32_t category, uint32_t bytes)
+{
+  struct Category &c = GetTable ().categories[category];
+  // instances created before accounting was enabled are not counted
+  if (c.count == 0 || c.bytes < bytes)
+    {
+      return;
+    }
+  c.count--;
+  c.bytes -= bytes;
+}
+
+void
+MemoryAccounting::NotifyObjectCreated (TypeId tid)
+{
+  uint32_t category = GetCategory (tid);
+  NotifyAllocation (category, GetTable ().categories[category].size);
+}
+
+void
+MemoryAccounting::NotifyObjectDeleted (TypeId tid)
+{
+  uint32_t category = GetCategory (tid);
+  NotifyDeallocation (category, GetTable ().categories[category].size);
+}
+
+uint64_t
+MemoryAccounting::GetLiveCount (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  return GetTable ().categories[GetCategory (tid)].count;
+}
+
+uint64_t
+MemoryAccounting::GetLiveBytes (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  return GetTable ().categories[GetCategory (tid)].bytes;
+}
+
+uint64_t
+MemoryAccounting::GetLiveBytes (std::string name)
+{
+  NS_LOG_FUNCTION (name);
+  CategoryTable &table = GetTable ();
+  std::map<std::string, uint32_t>::const_iterator i = table.byName.find (name);
+  if (i == table.byName.end ())
+    {
+      return 0;
+    }
+  return table.categories[i->second].bytes;
+}
+
+void
+MemoryAccounting::Report (std::ostream &os)
+{
+  NS_LOG_FUNCTION (&os);
+  CategoryTable &table = GetTable ();
+  std::vector<const struct Category *> sorted;
+  uint64_t totalBytes = 0;
+  for (std::vector<struct Category>::const_iterator i = table.categories.begin ();
+       i != table.categories.end (); ++i)
+    {
+      if (i->peakBytes > 0)
+        {
+          sorted.push_back (&(*i));
+          totalBytes += i->bytes;
+        }
+    }
+  std::sort (sorted.begin (), sorted.end (), &CompareBytes);
+
+  os << "Memory accounting: " << totalBytes << " bytes live" << std::endl;
+  os << std::left << std::setw (48) << "Type" << std::right
+     << std::setw (12) << "Live" << std::setw (16) << "Bytes" << std::setw (16) << "PeakBytes" << std::endl;
+  for (std::vector<const struct Category *>::const_iterator i = sorted.begin (); i != sorted.end (); ++i)
+    {
+      os << std::left << std::setw (48) << (*i)->name << std::right
+         << std::setw (12) << (*i)->count << std::setw (16) << (*i)->bytes
+         << std::setw (16) << (*i)->peakBytes << std::endl;
+    }
+
+  Config::MatchContainer nodes = Config::LookupMatches ("/NodeList/*");
+  if (nodes.GetN () == 0)
+    {
+      return;
+    }
+  os << std::left << std::setw (48) << "Node" << std::right
+     << std::setw (12) << "Objects" << std::setw (16) << "Bytes" << std::endl;
+  std::set<const Object *> visited;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      uint64_t objects = 0;
+      uint64_t bytes = 0;
+      CountReachable (nodes.Get (i), visited, objects, bytes);
+      os << std::left << std::setw (48) << nodes.GetMatchedPath (i) << std::right
+         << std::setw (12) << objects << std::setw (16) << bytes << std::endl;
+    }
+}
+
+void
+MemoryAccounting::NotifySimulatorDestroy (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (m_reportAtDestroy)
+    {
+      Report (std::cout);
+    }
+}
+
+} // namespace ns3
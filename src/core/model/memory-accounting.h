@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include "type-id.h"
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::MemoryAccounting declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup object
+ *
+ * \brief Opt-in accounting of the memory held by live objects.
+ *
+ * When enabled, every Object constructed through CreateObject() or an
+ * ObjectFactory is counted against its TypeId, with the size recorded
+ * for the TypeId by NS_OBJECT_ENSURE_REGISTERED, until it is deleted.
+ * Structures which are not Objects, such as packets, packet buffers or
+ * PHY interference events, are counted against named categories by the
+ * code which allocates them.
+ *
+ * Report() prints, for every TypeId and category, the number of live
+ * instances, the bytes they hold and the peak of these bytes, followed
+ * by the bytes of the objects reachable from each node of the
+ * "/NodeList/" Config namespace through aggregation and Pointer or
+ * ObjectPtrContainer attributes.  Objects reachable from several nodes,
+ * such as channels, are counted once, against the node with the lowest
+ * index.
+ *
+ * Only the fixed size of each instance is accounted, not the memory
+ * owned by its containers: the counts therefore point at the
+ * structures which dominate the footprint rather than giving an exact
+ * total.  Accounting must be enabled before the objects of interest
+ * are created, typically at the start of main():
+ * \code
+ *   MemoryAccounting::Enable (true);
+ * \endcode
+ * When disabled (the default), the only cost is a test of a boolean
+ * when objects and packets are created and deleted.
+ */
+class MemoryAccounting
+{
+public:
+  /**
+   * Start accounting the objects created from now on.
+   *
+   * \param [in] reportAtDestroy Whether to print the report to
+   *             std::cout when Simulator::Destroy() is called.
+   */
+  static void Enable (bool reportAtDestroy = false);
+  /**
+   * Stop accounting the objects created from now on.  The objects
+   * already accounted are still accounted when they are deleted.
+   */
+  static void Disable (void);
+  /**
+   * \returns \c true if objects are being accounted.
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * Look up or create a category for structures which are not Objects.
+   *
+   * \param [in] name The name of the category.
+   * \returns The identifier of the category.
+   */
+  static uint32_t GetCategory (std::string name);
+  /**
+   * Account an allocation against a category.
+   *
+   * \param [in] category The identifier of the category.
+   * \param [in] bytes The size of the allocation.
+   */
+  static void NotifyAllocation (uint32_t category, uint32_t bytes);
+  /**
+   * Account a deallocation against a category.
+   *
+   * \param [in] category The identifier of the category.
+   * \param [in] bytes The size of the deallocation.
+   */
+  static void NotifyDeallocation (uint32_t category, uint32_t bytes);
+
+  /**
+   * Account the construction of an Object.
+   *
+   * \param [in] tid The TypeId of the Object.
+   */
+  static void NotifyObjectCreated (TypeId tid);
+  /**
+   * Account the deletion of an Object.
+   *
+   * \param [in] tid The TypeId of the Object.
+   */
+  static void NotifyObjectDeleted (TypeId tid);
+
+  /**
+   * \param [in] tid A TypeId.
+   * \returns The number of live Objects of this exact TypeId.
+   */
+  static uint64_t GetLiveCount (TypeId tid);
+  /**
+   * \param [in] tid A TypeId.
+   * \returns The bytes held by the live Objects of this exact TypeId.
+   */
+  static uint64_t GetLiveBytes (TypeId tid);
+  /**
+   * \param [in] name The name of a category or of a TypeId.
+   * \returns The bytes held by the live instances of this category.
+   */
+  static uint64_t GetLiveBytes (std::string name);
+
+  /**
+   * Print the per-TypeId, per-category and per-node report.
+   *
+   * \param [in,out] os The output stream.
+   */
+  static void Report (std::ostream &os);
+  /**
+   * Print the report if it was requested by Enable().  Called by
+   * Simulator::Destroy(), before the objects are disposed of.
+   */
+  static void NotifySimulatorDestroy (void);
+
+private:
+  /**
+   * \param [in] tid A TypeId.
+   * \returns The category accounting the Objects of \p tid.
+   */
+  static uint32_t GetCategory (TypeId tid);
+
+  static bool m_enabled;          //!< Whether new objects are accounted.
+  static bool m_reportAtDestroy;  //!< Whether to report at Simulator::Destroy().
+};
+
+inline bool
+MemoryAccounting::IsEnabled (void)
+{
+  return m_enabled;
+}
+
+} // namespace ns3
+
+#endif /* MEMORY_ACCOUNTING_H */
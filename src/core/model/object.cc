@@ -25,6 +25,8 @@
 #include "attribute.h"
 #include "log.h"
 #include "string.h"
+#include "config.h"
+#include "memory-accounting.h"
 #include <vector>
 #include <sstream>
 #include <cstdlib>
@@ -97,6 +99,7 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
+    m_accounted (false),
     m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
     m_getObjectCount (0)
 {
@@ -108,6 +111,10 @@ Object::~Object ()
 {
   // remove this object from the aggregate list
   NS_LOG_FUNCTION (this);
+  if (m_accounted)
+    {
+      MemoryAccounting::NotifyObjectDeleted (m_tid);
+    }
   uint32_t n = m_aggregates->n;
   for (uint32_t i = 0; i < n; i++)
     {
@@ -132,6 +139,7 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
+    m_accounted (false),
     m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
     m_getObjectCount (0)
 {
@@ -143,6 +151,11 @@ Object::Construct (const AttributeConstructionList &attributes)
 {
   NS_LOG_FUNCTION (this << &attributes);
   ConstructSelf (attributes);
+  if (MemoryAccounting::IsEnabled () && !m_accounted)
+    {
+      m_accounted = true;
+      MemoryAccounting::NotifyObjectCreated (m_tid);
+    }
 }
 
 Ptr<Object>
@@ -316,6 +329,9 @@ Object::AggregateObject (Ptr<Object> o)
   // Now that we are done with them, we can free our old aggregate buffers
   std::free (a);
   std::free (b);
+
+  // The objects reachable through "$TypeId" path elements have changed.
+  Config::InvalidateMatchCache ();
 }
 /**
  * This function must be implemented in the stack that needs to notify
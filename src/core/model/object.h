@@ -419,6 +419,11 @@ private:
    * \c false otherwise
    */
   bool m_initialized;
+  /**
+   * Set to \c true if the construction of this Object was counted
+   * by MemoryAccounting, \c false otherwise.
+   */
+  bool m_accounted;
   /**
    * A pointer to an array of 'aggregates'.
    *
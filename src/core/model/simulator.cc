@@ -24,6 +24,7 @@
 #include "map-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
+#include "memory-accounting.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -178,6 +179,10 @@ Simulator::Destroy (void)
    */
   LogSetTimePrinter (0);
   LogSetNodePrinter (0);
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::NotifySimulatorDestroy ();
+    }
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
@@ -30,6 +30,8 @@
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
 
 
 #include <sstream>
@@ -669,6 +671,139 @@ ObjectVectorTraceConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodeB/NodesB/1/Source", "Trace 1 did not provide expected context");
 }
 
+// ===========================================================================
+// Test for the match cache and for connecting several paths at once
+// ===========================================================================
+class MatchCacheConfigTestCase : public TestCase
+{
+public:
+  MatchCacheConfigTestCase ();
+  virtual ~MatchCacheConfigTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_count++; }
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_paths.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_count;
+  std::vector<std::string> m_paths;
+};
+
+MatchCacheConfigTestCase::MatchCacheConfigTestCase ()
+  : TestCase ("Check that cached path matches are invalidated and that paths can be connected together")
+{
+}
+
+void
+MatchCacheConfigTestCase::DoRun (void)
+{
+  GlobalValue::Bind ("ConfigMatchCache", BooleanValue (true));
+
+  //
+  // Other test cases leave root namespace objects behind: name the
+  // objects used here to keep them apart.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("MatchCacheRoot", root);
+
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> obj0 = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> obj1 = CreateObject<ConfigTestObject> ();
+  a->AddNodeB (obj0);
+  a->AddNodeB (obj1);
+
+  Config::MatchContainer m = Config::LookupMatches ("/Names/MatchCacheRoot/NodeA/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 2, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (m.GetMatchedPath (1), "/Names/MatchCacheRoot/NodeA/NodesB/1/", "Unexpected matched path");
+
+  //
+  // Equivalent spellings of a path share the same cache entry.
+  //
+  m = Config::LookupMatches ("Names/MatchCacheRoot/NodeA/NodesB/*/");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 2, "Unexpected number of matches for non-canonical path");
+
+  //
+  // Changing the object tree behind the back of the Config subsystem
+  // requires an explicit invalidation.
+  //
+  Ptr<ConfigTestObject> obj2 = CreateObject<ConfigTestObject> ();
+  a->AddNodeB (obj2);
+  m = Config::LookupMatches ("/Names/MatchCacheRoot/NodeA/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 2, "Cached matches were not reused");
+  Config::InvalidateMatchCache ();
+  m = Config::LookupMatches ("/Names/MatchCacheRoot/NodeA/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 3, "Cached matches were not invalidated");
+
+  //
+  // Setting a Pointer attribute through Config invalidates the cache.
+  //
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  b->AddNodeB (obj0);
+  Config::Set ("/Names/MatchCacheRoot/NodeA", PointerValue (b));
+  m = Config::LookupMatches ("/Names/MatchCacheRoot/NodeA/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 1, "Config::Set did not invalidate cached matches");
+
+  //
+  // Connect several trace sources sharing a common prefix in one call.
+  //
+  root->SetNodeA (a);
+  Config::InvalidateMatchCache ();
+  std::vector<std::string> paths;
+  paths.push_back ("/Names/MatchCacheRoot/NodeA/NodesB/0/Source");
+  paths.push_back ("/Names/MatchCacheRoot/NodeA/NodesB/2/Source");
+  paths.push_back ("/Names/MatchCacheRoot/NodeB/Source");
+  m_count = 0;
+  Config::ConnectAllWithoutContext (paths, MakeCallback (&MatchCacheConfigTestCase::Trace, this));
+  obj0->SetAttribute ("Source", IntegerValue (1));
+  obj1->SetAttribute ("Source", IntegerValue (2));
+  obj2->SetAttribute ("Source", IntegerValue (3));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Unexpected number of trace invocations");
+
+  paths.pop_back ();
+  Config::ConnectAll (paths, MakeCallback (&MatchCacheConfigTestCase::TraceWithPath, this));
+  obj2->SetAttribute ("Source", IntegerValue (4));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 1, "Unexpected number of trace invocations");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/Names/MatchCacheRoot/NodeA/NodesB/2/Source", "Unexpected trace context");
+
+  //
+  // Connect paths below different names, which share only the "/Names"
+  // root.
+  //
+  Ptr<ConfigTestObject> other = CreateObject<ConfigTestObject> ();
+  Names::Add ("MatchCacheOther", other);
+  paths.clear ();
+  paths.push_back ("/Names/MatchCacheRoot/NodeA/NodesB/1/Source");
+  paths.push_back ("/Names/MatchCacheOther/Source");
+  m_count = 0;
+  Config::ConnectAllWithoutContext (paths, MakeCallback (&MatchCacheConfigTestCase::Trace, this));
+  obj1->SetAttribute ("Source", IntegerValue (5));
+  other->SetAttribute ("Source", IntegerValue (6));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Paths below different names were not all connected");
+
+  //
+  // Connect a mix of paths below "/Names" and below a root namespace object.
+  //
+  Ptr<ConfigTestObject> mixedRoot = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> mixedB = CreateObject<ConfigTestObject> ();
+  mixedRoot->SetNodeB (mixedB);
+  Config::RegisterRootNamespaceObject (mixedRoot);
+  paths.clear ();
+  paths.push_back ("/Names/MatchCacheOther/Source");
+  paths.push_back ("/NodeB/Source");
+  m_count = 0;
+  Config::ConnectAllWithoutContext (paths, MakeCallback (&MatchCacheConfigTestCase::Trace, this));
+  other->SetAttribute ("Source", IntegerValue (7));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "The path below \"/Names\" was not connected along the root namespace path");
+  mixedB->SetAttribute ("Source", IntegerValue (8));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 3, "The root namespace path was not connected along the path below \"/Names\"");
+  Config::UnregisterRootNamespaceObject (mixedRoot);
+
+  Names::Clear ();
+  GlobalValue::Bind ("ConfigMatchCache", BooleanValue (false));
+}
+
 // ===========================================================================
 // Test for the ability to search attributes of parent classes
 // when Resolver searches for attributes in a derived class object.
@@ -737,6 +872,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new MatchCacheConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/memory-accounting.h"
+#include "ns3/object.h"
+#include "ns3/object-factory.h"
+#include "ns3/test.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+namespace {
+
+class AccountedObject : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("MemoryAccountingTestAccountedObject")
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .HideFromDocumentation ()
+      .AddConstructor<AccountedObject> ();
+    return tid;
+  }
+private:
+  uint8_t m_payload[100];
+};
+
+NS_OBJECT_ENSURE_REGISTERED (AccountedObject);
+
+} // anonymous namespace
+
+/**
+ * Check the accounting of Objects and of named categories.
+ */
+class MemoryAccountingTestCase : public TestCase
+{
+public:
+  MemoryAccountingTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+MemoryAccountingTestCase::MemoryAccountingTestCase ()
+  : TestCase ("Check the accounting of live objects")
+{
+}
+
+void
+MemoryAccountingTestCase::DoRun (void)
+{
+  TypeId tid = AccountedObject::GetTypeId ();
+  // created before accounting is enabled: never accounted
+  Ptr<AccountedObject> before = CreateObject<AccountedObject> ();
+
+  MemoryAccounting::Enable ();
+  uint64_t count = MemoryAccounting::GetLiveCount (tid);
+  uint64_t bytes = MemoryAccounting::GetLiveBytes (tid);
+  Ptr<AccountedObject> a = CreateObject<AccountedObject> ();
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  Ptr<Object> b = factory.Create ();
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetLiveCount (tid), count + 2, "Objects not accounted");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetLiveBytes (tid), bytes + 2 * sizeof (AccountedObject),
+                         "Unexpected size of the objects");
+  before = 0;
+  a = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetLiveCount (tid), count + 1, "Deletion not accounted");
+
+  uint32_t category = MemoryAccounting::GetCategory ("MemoryAccountingTestCategory");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCategory ("MemoryAccountingTestCategory"), category,
+                         "Category looked up twice");
+  MemoryAccounting::NotifyAllocation (category, 1000);
+  MemoryAccounting::NotifyAllocation (category, 500);
+  MemoryAccounting::NotifyDeallocation (category, 1000);
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetLiveBytes ("MemoryAccountingTestCategory"), 500,
+                         "Unexpected bytes of the category");
+
+  std::ostringstream oss;
+  MemoryAccounting::Report (oss);
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("MemoryAccountingTestCategory"), std::string::npos,
+                         "Category missing from the report");
+  NS_TEST_EXPECT_MSG_NE (oss.str ().find ("MemoryAccountingTestAccountedObject"), std::string::npos,
+                         "TypeId missing from the report");
+
+  MemoryAccounting::NotifyDeallocation (category, 500);
+  MemoryAccounting::Disable ();
+  // accounted objects are still accounted when deleted after Disable()
+  b = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetLiveCount (tid), count, "Deletion not accounted");
+}
+
+/**
+ * MemoryAccounting TestSuite
+ */
+class MemoryAccountingTestSuite : public TestSuite
+{
+public:
+  MemoryAccountingTestSuite ();
+};
+
+MemoryAccountingTestSuite::MemoryAccountingTestSuite ()
+  : TestSuite ("memory-accounting", UNIT)
+{
+  AddTestCase (new MemoryAccountingTestCase, TestCase::QUICK);
+}
+
+static MemoryAccountingTestSuite g_memoryAccountingTestSuite;
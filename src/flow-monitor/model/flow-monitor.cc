@@ -22,6 +22,9 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
 #include <fstream>
 #include <sstream>
 
@@ -29,6 +32,14 @@
 
 #define PERIODIC_CHECK_INTERVAL (Seconds (1))
 
+// Flow IDs below this value are looked up in dense tables; the others
+// (only expected from custom classifiers) fall back to std::map lookups.
+#define MAX_DENSE_FLOW_ID (1 << 20)
+
+// Largest gap of packet IDs filled with empty slots in the window of
+// packets in flight of a flow.
+#define MAX_TRACKED_PACKET_GAP 1024
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FlowMonitor");
@@ -72,6 +83,25 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("EnableHistograms", ("Record the delay, jitter, packet size and flow interruptions histograms.  "
+                                        "Disabling them saves memory and time in simulations with many flows."),
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&FlowMonitor::m_enableHistograms),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ExportInterval", ("The interval between the exports of the per-flow interval statistics "
+                                      "to the export file.  Zero disables the periodic export."),
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_exportInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("ExportFileName", ("The name of the file the per-flow interval statistics are exported to."),
+                   StringValue ("flowmon-intervals.csv"),
+                   MakeStringAccessor (&FlowMonitor::m_exportFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("ExportFormat", ("The format of the file the per-flow interval statistics are exported to."),
+                   EnumValue (FlowMonitor::EXPORT_CSV),
+                   MakeEnumAccessor (&FlowMonitor::m_exportFormat),
+                   MakeEnumChecker (FlowMonitor::EXPORT_CSV, "Csv",
+                                    FlowMonitor::EXPORT_BINARY, "Binary"))
   ;
   return tid;
 }
@@ -83,7 +113,9 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_enabled (false),
+    m_enableHistograms (true),
+    m_exportFormat (EXPORT_CSV)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -102,17 +134,38 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  Simulator::Cancel (m_exportEvent);
+  if (m_exportStream.is_open ())
+    {
+      m_exportStream.close ();
+    }
+  m_flowStatsIndex.clear ();
+  m_trackedFlows.clear ();
+  m_trackedPackets.clear ();
   Object::DoDispose ();
 }
 
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
+  if (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0)
+    {
+      return *m_flowStatsIndex[flowId];
+    }
   FlowStatsContainerI iter;
   iter = m_flowStats.find (flowId);
   if (iter == m_flowStats.end ())
     {
       FlowMonitor::FlowStats &ref = m_flowStats[flowId];
+      // std::map nodes are never moved, so the index can point to them
+      if (flowId < MAX_DENSE_FLOW_ID)
+        {
+          if (flowId >= m_flowStatsIndex.size ())
+            {
+              m_flowStatsIndex.resize (flowId + 1, 0);
+            }
+          m_flowStatsIndex[flowId] = &ref;
+        }
       ref.delaySum = Seconds (0);
       ref.jitterSum = Seconds (0);
       ref.lastDelay = Seconds (0);
@@ -134,6 +187,106 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
     }
 }
 
+FlowMonitor::TrackedPacket&
+FlowMonitor::AddTrackedPacket (FlowId flowId, FlowPacketId packetId)
+{
+  if (flowId < MAX_DENSE_FLOW_ID)
+    {
+      if (flowId >= m_trackedFlows.size ())
+        {
+          m_trackedFlows.resize (flowId + 1);
+        }
+      TrackedFlow &flow = m_trackedFlows[flowId];
+      if (flow.packets.empty ())
+        {
+          flow.firstPacketId = packetId;
+        }
+      if (packetId >= flow.firstPacketId
+          && packetId - flow.firstPacketId < flow.packets.size () + MAX_TRACKED_PACKET_GAP)
+        {
+          uint32_t slot = packetId - flow.firstPacketId;
+          if (slot >= flow.packets.size ())
+            {
+              TrackedPacket empty;
+              empty.timesForwarded = 0;
+              empty.inFlight = false;
+              flow.packets.resize (slot + 1, empty);
+            }
+          TrackedPacket &tracked = flow.packets[slot];
+          if (!tracked.inFlight)
+            {
+              tracked.inFlight = true;
+              flow.nInFlight++;
+            }
+          return tracked;
+        }
+    }
+  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  tracked.inFlight = true;
+  return tracked;
+}
+
+FlowMonitor::TrackedPacket*
+FlowMonitor::FindTrackedPacket (FlowId flowId, FlowPacketId packetId)
+{
+  if (flowId < m_trackedFlows.size ())
+    {
+      TrackedFlow &flow = m_trackedFlows[flowId];
+      if (packetId >= flow.firstPacketId && packetId - flow.firstPacketId < flow.packets.size ())
+        {
+          TrackedPacket &tracked = flow.packets[packetId - flow.firstPacketId];
+          if (tracked.inFlight)
+            {
+              return &tracked;
+            }
+        }
+    }
+  if (m_trackedPackets.empty ())
+    {
+      return 0;
+    }
+  TrackedPacketMap::iterator iter = m_trackedPackets.find (std::make_pair (flowId, packetId));
+  if (iter == m_trackedPackets.end ())
+    {
+      return 0;
+    }
+  return &iter->second;
+}
+
+void
+FlowMonitor::RemoveTrackedPacket (FlowId flowId, FlowPacketId packetId, TrackedPacket *tracked)
+{
+  if (flowId < m_trackedFlows.size ())
+    {
+      TrackedFlow &flow = m_trackedFlows[flowId];
+      if (packetId >= flow.firstPacketId && packetId - flow.firstPacketId < flow.packets.size ()
+          && tracked == &flow.packets[packetId - flow.firstPacketId])
+        {
+          tracked->inFlight = false;
+          flow.nInFlight--;
+          CompactTrackedFlow (flow);
+          return;
+        }
+    }
+  m_trackedPackets.erase (std::make_pair (flowId, packetId));
+}
+
+void
+FlowMonitor::CompactTrackedFlow (TrackedFlow &flow)
+{
+  if (flow.nInFlight == 0)
+    {
+      flow.firstPacketId += flow.packets.size ();
+      flow.packets.clear ();
+      return;
+    }
+  while (!flow.packets.front ().inFlight)
+    {
+      flow.packets.pop_front ();
+      flow.firstPacketId++;
+    }
+}
+
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
@@ -143,7 +296,7 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  TrackedPacket &tracked = AddTrackedPacket (flowId, packetId);
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
@@ -170,19 +323,18 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
-  if (tracked == m_trackedPackets.end ())
+  TrackedPacket *tracked = FindTrackedPacket (flowId, packetId);
+  if (tracked == 0)
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
       return;
     }
 
-  tracked->second.timesForwarded++;
-  tracked->second.lastSeenTime = Simulator::Now ();
+  tracked->timesForwarded++;
+  tracked->lastSeenTime = Simulator::Now ();
 
-  Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
+  Time delay = (Simulator::Now () - tracked->firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 }
 
@@ -194,8 +346,8 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked == m_trackedPackets.end ())
+  TrackedPacket *tracked = FindTrackedPacket (flowId, packetId);
+  if (tracked == 0)
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
@@ -203,30 +355,35 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     }
 
   Time now = Simulator::Now ();
-  Time delay = (now - tracked->second.firstSeenTime);
+  Time delay = (now - tracked->firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 
   FlowStats &stats = GetStatsForFlow (flowId);
   stats.delaySum += delay;
-  stats.delayHistogram.AddValue (delay.GetSeconds ());
+  if (m_enableHistograms)
+    {
+      stats.delayHistogram.AddValue (delay.GetSeconds ());
+    }
   if (stats.rxPackets > 0 )
     {
       Time jitter = stats.lastDelay - delay;
-      if (jitter > Seconds (0))
+      if (jitter < Seconds (0))
         {
-          stats.jitterSum += jitter;
-          stats.jitterHistogram.AddValue (jitter.GetSeconds ());
+          jitter = delay - stats.lastDelay;
         }
-      else 
+      stats.jitterSum += jitter;
+      if (m_enableHistograms)
         {
-          stats.jitterSum -= jitter;
-          stats.jitterHistogram.AddValue (-jitter.GetSeconds ());
+          stats.jitterHistogram.AddValue (jitter.GetSeconds ());
         }
     }
   stats.lastDelay = delay;
 
   stats.rxBytes += packetSize;
-  stats.packetSizeHistogram.AddValue ((double) packetSize);
+  if (m_enableHistograms)
+    {
+      stats.packetSizeHistogram.AddValue ((double) packetSize);
+    }
   stats.rxPackets++;
   if (stats.rxPackets == 1)
     {
@@ -236,18 +393,18 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       // measure possible flow interruptions
       Time interArrivalTime = now - stats.timeLastRxPacket;
-      if (interArrivalTime > m_flowInterruptionsMinTime)
+      if (m_enableHistograms && interArrivalTime > m_flowInterruptionsMinTime)
         {
           stats.flowInterruptionsHistogram.AddValue (interArrivalTime.GetSeconds ());
         }
     }
   stats.timeLastRxPacket = now;
-  stats.timesForwarded += tracked->second.timesForwarded;
+  stats.timesForwarded += tracked->timesForwarded;
 
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  RemoveTrackedPacket (flowId, packetId, tracked); // we don't need to track this packet anymore
 }
 
 void
@@ -272,14 +429,14 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked != m_trackedPackets.end ())
+  TrackedPacket *tracked = FindTrackedPacket (flowId, packetId);
+  if (tracked != 0)
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      RemoveTrackedPacket (flowId, packetId, tracked);
     }
 }
 
@@ -295,6 +452,30 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
+  for (FlowId flowId = 0; flowId < m_trackedFlows.size (); flowId++)
+    {
+      TrackedFlow &flow = m_trackedFlows[flowId];
+      if (flow.nInFlight == 0)
+        {
+          continue;
+        }
+      for (std::deque<TrackedPacket>::iterator iter = flow.packets.begin ();
+           iter != flow.packets.end (); iter++)
+        {
+          if (iter->inFlight && now - iter->lastSeenTime >= maxDelay)
+            {
+              // packet is considered lost, add it to the loss statistics
+              NS_ASSERT (flowId < m_flowStatsIndex.size () && m_flowStatsIndex[flowId] != 0);
+              m_flowStatsIndex[flowId]->lostPackets++;
+
+              // we won't track it anymore
+              iter->inFlight = false;
+              flow.nInFlight--;
+            }
+        }
+      CompactTrackedFlow (flow);
+    }
+
   for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
        iter != m_trackedPackets.end (); )
     {
@@ -380,6 +561,11 @@ FlowMonitor::StartRightNow ()
       return;
     }
   m_enabled = true;
+  if (m_exportInterval.IsStrictlyPositive ())
+    {
+      Simulator::Cancel (m_exportEvent);
+      m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExportIntervalStats, this);
+    }
 }
 
 
@@ -392,6 +578,100 @@ FlowMonitor::StopRightNow ()
     }
   m_enabled = false;
   CheckForLostPackets ();
+  if (m_exportInterval.IsStrictlyPositive ())
+    {
+      Simulator::Cancel (m_exportEvent);
+      ExportIntervalStats ();
+    }
+}
+
+void
+FlowMonitor::PeriodicExportIntervalStats ()
+{
+  CheckForLostPackets ();
+  ExportIntervalStats ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExportIntervalStats, this);
+}
+
+void
+FlowMonitor::ExportIntervalStats ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_exportStream.is_open ())
+    {
+      m_exportStream.open (m_exportFileName.c_str (), std::ios::out | std::ios::binary);
+      if (!m_exportStream.is_open ())
+        {
+          NS_LOG_WARN ("Could not open export file " << m_exportFileName);
+          return;
+        }
+      if (m_exportFormat == EXPORT_CSV)
+        {
+          m_exportStream << "time,flowId,txPackets,rxPackets,lostPackets,txBytes,rxBytes,delaySum,jitterSum\n";
+        }
+      else
+        {
+          m_exportStream.write ("ns3fmon1", 8);
+        }
+    }
+
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  std::map<FlowId, ExportSnapshot>::iterator snapshot = m_exportSnapshots.begin ();
+  for (FlowStatsContainerCI flowI = m_flowStats.begin (); flowI != m_flowStats.end (); flowI++)
+    {
+      // both containers are sorted by flow ID: walk them together
+      while (snapshot != m_exportSnapshots.end () && snapshot->first < flowI->first)
+        {
+          snapshot++;
+        }
+      if (snapshot == m_exportSnapshots.end () || snapshot->first != flowI->first)
+        {
+          snapshot = m_exportSnapshots.insert (snapshot, std::make_pair (flowI->first, ExportSnapshot ()));
+        }
+      const FlowStats &stats = flowI->second;
+      ExportSnapshot &last = snapshot->second;
+      if (stats.txPackets == last.txPackets && stats.rxPackets == last.rxPackets
+          && stats.lostPackets == last.lostPackets)
+        {
+          continue;
+        }
+
+      uint32_t flowId = flowI->first;
+      uint32_t txPackets = stats.txPackets - last.txPackets;
+      uint32_t rxPackets = stats.rxPackets - last.rxPackets;
+      uint32_t lostPackets = stats.lostPackets - last.lostPackets;
+      uint64_t txBytes = stats.txBytes - last.txBytes;
+      uint64_t rxBytes = stats.rxBytes - last.rxBytes;
+      int64_t delaySum = (stats.delaySum - last.delaySum).GetNanoSeconds ();
+      int64_t jitterSum = (stats.jitterSum - last.jitterSum).GetNanoSeconds ();
+      if (m_exportFormat == EXPORT_CSV)
+        {
+          m_exportStream << now << "," << flowId << "," << txPackets << "," << rxPackets << ","
+                         << lostPackets << "," << txBytes << "," << rxBytes << ","
+                         << delaySum << "," << jitterSum << "\n";
+        }
+      else
+        {
+          m_exportStream.write (reinterpret_cast<const char *> (&now), sizeof (now));
+          m_exportStream.write (reinterpret_cast<const char *> (&flowId), sizeof (flowId));
+          m_exportStream.write (reinterpret_cast<const char *> (&txPackets), sizeof (txPackets));
+          m_exportStream.write (reinterpret_cast<const char *> (&rxPackets), sizeof (rxPackets));
+          m_exportStream.write (reinterpret_cast<const char *> (&lostPackets), sizeof (lostPackets));
+          m_exportStream.write (reinterpret_cast<const char *> (&txBytes), sizeof (txBytes));
+          m_exportStream.write (reinterpret_cast<const char *> (&rxBytes), sizeof (rxBytes));
+          m_exportStream.write (reinterpret_cast<const char *> (&delaySum), sizeof (delaySum));
+          m_exportStream.write (reinterpret_cast<const char *> (&jitterSum), sizeof (jitterSum));
+        }
+
+      last.delaySum = stats.delaySum;
+      last.jitterSum = stats.jitterSum;
+      last.txBytes = stats.txBytes;
+      last.rxBytes = stats.rxBytes;
+      last.txPackets = stats.txPackets;
+      last.rxPackets = stats.rxPackets;
+      last.lostPackets = stats.lostPackets;
+    }
+  m_exportStream.flush ();
 }
 
 void
@@ -23,6 +23,8 @@
 
 #include <vector>
 #include <map>
+#include <deque>
+#include <fstream>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -256,6 +258,29 @@ public:
   /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /// Format of the periodic export of interval statistics
+  enum ExportFormat
+  {
+    EXPORT_CSV,   //!< one comma-separated line per flow and interval
+    EXPORT_BINARY //!< one fixed-size binary record per flow and interval
+  };
+
+  /// Write to the export file the statistics of the flows which have
+  /// been active since the previous export.  This is called
+  /// periodically when the ExportInterval attribute is not zero, and
+  /// once more when monitoring stops.
+  ///
+  /// Each record holds the time of the export, the flow ID, and the
+  /// number of transmitted, received and lost packets, the number of
+  /// transmitted and received bytes, and the sums of the delays and
+  /// of the jitters (in nanoseconds) accumulated in the interval.  In
+  /// CSV format, these are written as text after a header line.  In
+  /// binary format, the file begins with the 8-byte magic "ns3fmon1",
+  /// followed by records made of an int64 time, a uint32 flow ID,
+  /// three uint32 packet counters, two uint64 byte counters and two
+  /// int64 delay sums, all in host byte order.
+  void ExportIntervalStats ();
+
 
 protected:
 
@@ -270,14 +295,44 @@ private:
     Time firstSeenTime; //!< absolute time when the packet was first seen by a probe
     Time lastSeenTime; //!< absolute time when the packet was last seen by a probe
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
+    bool inFlight; //!< false for the slots of packets no longer tracked
+  };
+
+  /// Packets of a flow which are in flight.  Packet IDs are allocated
+  /// sequentially within each flow, so the packets are kept in a window
+  /// indexed by their ID relative to the oldest packet still in flight.
+  struct TrackedFlow
+  {
+    TrackedFlow () : firstPacketId (0), nInFlight (0) {}
+    FlowPacketId firstPacketId; //!< packet ID of the first slot of the window
+    uint32_t nInFlight; //!< number of slots of the window in flight
+    std::deque<TrackedPacket> packets; //!< window of tracked packets
+  };
+
+  /// Interval statistics of a flow at the time of the previous export
+  struct ExportSnapshot
+  {
+    ExportSnapshot () : txBytes (0), rxBytes (0), txPackets (0), rxPackets (0), lostPackets (0) {}
+    Time delaySum; //!< delay sum
+    Time jitterSum; //!< jitter sum
+    uint64_t txBytes; //!< transmitted bytes
+    uint64_t rxBytes; //!< received bytes
+    uint32_t txPackets; //!< transmitted packets
+    uint32_t rxPackets; //!< received packets
+    uint32_t lostPackets; //!< lost packets
   };
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
+  /// FlowId --> FlowStats, for the flow IDs low enough to be densely indexed
+  std::vector<FlowStats *> m_flowStatsIndex;
 
+  /// FlowId --> packets in flight, for the densely indexed flow IDs
+  std::vector<TrackedFlow> m_trackedFlows;
   /// (FlowId,PacketId) --> TrackedPacket
   typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
-  TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  /// Tracked packets which do not fit in the window of their flow
+  TrackedPacketMap m_trackedPackets;
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
@@ -292,12 +347,43 @@ private:
   double m_packetSizeBinWidth;  //!< packet size bin width (for histograms)
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
+  bool m_enableHistograms;  //!< Record the delay, jitter, size and interruptions histograms
+
+  Time m_exportInterval;         //!< Interval between the exports of interval statistics
+  std::string m_exportFileName;  //!< Name of the export file
+  ExportFormat m_exportFormat;   //!< Format of the export file
+  EventId m_exportEvent;         //!< Next export event
+  std::ofstream m_exportStream;  //!< Export file
+  std::map<FlowId, ExportSnapshot> m_exportSnapshots; //!< Statistics at the previous export
 
   /// Get the stats for a given flow
   /// \param flowId the Flow identification
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// Start tracking a packet
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the tracked packet data
+  TrackedPacket& AddTrackedPacket (FlowId flowId, FlowPacketId packetId);
+  /// Find a tracked packet
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the tracked packet data, or 0 if the packet is not tracked
+  TrackedPacket* FindTrackedPacket (FlowId flowId, FlowPacketId packetId);
+  /// Stop tracking a packet
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \param tracked the tracked packet data, as returned by FindTrackedPacket
+  void RemoveTrackedPacket (FlowId flowId, FlowPacketId packetId, TrackedPacket *tracked);
+  /// Drop the slots of the packets no longer in flight from the
+  /// front of the window of a flow
+  /// \param flow the packets in flight of the flow
+  void CompactTrackedFlow (TrackedFlow &flow);
+
+  /// Periodic function to export the interval statistics
+  void PeriodicExportIntervalStats ();
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
 };
@@ -23,6 +23,9 @@
 
 namespace ns3 {
 
+// Flow IDs below this value are looked up in a dense table.
+#define MAX_DENSE_FLOW_ID (1 << 20)
+
 /* static */
 TypeId FlowProbe::GetTypeId (void)
 {
@@ -50,13 +53,34 @@ void
 FlowProbe::DoDispose (void)
 {
   m_flowMonitor = 0;
+  m_statsIndex.clear ();
   Object::DoDispose ();
 }
 
+FlowProbe::FlowStats&
+FlowProbe::GetStatsForFlow (FlowId flowId)
+{
+  if (flowId < m_statsIndex.size () && m_statsIndex[flowId] != 0)
+    {
+      return *m_statsIndex[flowId];
+    }
+  FlowStats &flow = m_stats[flowId];
+  // std::map nodes are never moved, so the index can point to them
+  if (flowId < MAX_DENSE_FLOW_ID)
+    {
+      if (flowId >= m_statsIndex.size ())
+        {
+          m_statsIndex.resize (flowId + 1, 0);
+        }
+      m_statsIndex[flowId] = &flow;
+    }
+  return flow;
+}
+
 void
 FlowProbe::AddPacketStats (FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe)
 {
-  FlowStats &flow = m_stats[flowId];
+  FlowStats &flow = GetStatsForFlow (flowId);
   flow.delayFromFirstProbeSum += delayFromFirstProbe;
   flow.bytes += packetSize;
   ++flow.packets;
@@ -65,7 +89,7 @@ FlowProbe::AddPacketStats (FlowId flowId, uint32_t packetSize, Time delayFromFir
 void
 FlowProbe::AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reasonCode)
 {
-  FlowStats &flow = m_stats[flowId];
+  FlowStats &flow = GetStatsForFlow (flowId);
 
   if (flow.packetsDropped.size () < reasonCode + 1)
     {
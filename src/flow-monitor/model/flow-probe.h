@@ -106,6 +106,14 @@ protected:
   Ptr<FlowMonitor> m_flowMonitor; //!< the FlowMonitor instance
   Stats m_stats; //!< The flow stats
 
+private:
+  /// Get the stats of a flow, creating them if needed
+  /// \param flowId the flow Identifier
+  /// \returns the stats of the flow
+  FlowStats& GetStatsForFlow (FlowId flowId);
+
+  /// FlowId --> FlowStats in m_stats, for the flow IDs low enough to be densely indexed
+  std::vector<FlowStats *> m_statsIndex;
 };
 
 
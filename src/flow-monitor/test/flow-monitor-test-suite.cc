@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * A probe which lets the test case report packet events directly.
+ */
+class FlowMonitorTestProbe : public FlowProbe
+{
+public:
+  FlowMonitorTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * Check the tracking of packets in flight, the loss accounting and
+ * the periodic export of the interval statistics.
+ */
+class FlowMonitorTrackingTestCase : public TestCase
+{
+public:
+  FlowMonitorTrackingTestCase ();
+  virtual void DoRun (void);
+
+private:
+  void Transmit (FlowId flowId, FlowPacketId firstPacketId, uint32_t nPackets);
+  void Receive (FlowId flowId, FlowPacketId packetId);
+  void Drop (FlowId flowId, FlowPacketId packetId);
+
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<FlowProbe> m_probe;
+};
+
+FlowMonitorTrackingTestCase::FlowMonitorTrackingTestCase ()
+  : TestCase ("FlowMonitor packet tracking and interval export")
+{
+}
+
+void
+FlowMonitorTrackingTestCase::Transmit (FlowId flowId, FlowPacketId firstPacketId, uint32_t nPackets)
+{
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      m_monitor->ReportFirstTx (m_probe, flowId, firstPacketId + i, 100);
+    }
+}
+
+void
+FlowMonitorTrackingTestCase::Receive (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 100);
+}
+
+void
+FlowMonitorTrackingTestCase::Drop (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportDrop (m_probe, flowId, packetId, 100, 0);
+}
+
+void
+FlowMonitorTrackingTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flowmon-intervals.csv");
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("ExportInterval", TimeValue (Seconds (1)));
+  m_monitor->SetAttribute ("ExportFileName", StringValue (fileName));
+  m_probe = CreateObject<FlowMonitorTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+
+  Simulator::Schedule (MilliSeconds (500), &FlowMonitorTrackingTestCase::Transmit, this, 1, 0, 10);
+  Simulator::Schedule (MilliSeconds (500), &FlowMonitorTrackingTestCase::Transmit, this, 2, 0, 1);
+  // far away from the other packets of the flow
+  Simulator::Schedule (MilliSeconds (500), &FlowMonitorTrackingTestCase::Transmit, this, 2, 5000, 1);
+  // out of order
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorTrackingTestCase::Receive, this, 1, 3);
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorTrackingTestCase::Receive, this, 1, 0);
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorTrackingTestCase::Receive, this, 1, 9);
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorTrackingTestCase::Drop, this, 1, 5);
+  Simulator::Schedule (MilliSeconds (600), &FlowMonitorTrackingTestCase::Receive, this, 2, 5000);
+  // duplicate reception, must be ignored
+  Simulator::Schedule (MilliSeconds (700), &FlowMonitorTrackingTestCase::Receive, this, 1, 3);
+  Simulator::Schedule (MilliSeconds (1500), &FlowMonitorTrackingTestCase::Transmit, this, 1, 10, 2);
+  Simulator::Schedule (MilliSeconds (1600), &FlowMonitorTrackingTestCase::Receive, this, 1, 11);
+  Simulator::Schedule (MilliSeconds (1600), &FlowMonitorTrackingTestCase::Receive, this, 1, 10);
+  Simulator::Schedule (Seconds (15), &FlowMonitor::StopRightNow, m_monitor);
+  Simulator::Stop (Seconds (16));
+  Simulator::Run ();
+
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), 2, "Unexpected number of flows");
+  const FlowMonitor::FlowStats &flow1 = stats.find (1)->second;
+  NS_TEST_EXPECT_MSG_EQ (flow1.txPackets, 12, "Unexpected number of transmitted packets");
+  NS_TEST_EXPECT_MSG_EQ (flow1.rxPackets, 5, "Unexpected number of received packets");
+  NS_TEST_EXPECT_MSG_EQ (flow1.lostPackets, 7, "Unexpected number of lost packets");
+  NS_TEST_EXPECT_MSG_EQ (flow1.delaySum, MilliSeconds (500), "Unexpected delay sum");
+  const FlowMonitor::FlowStats &flow2 = stats.find (2)->second;
+  NS_TEST_EXPECT_MSG_EQ (flow2.txPackets, 2, "Unexpected number of transmitted packets");
+  NS_TEST_EXPECT_MSG_EQ (flow2.rxPackets, 1, "Unexpected number of received packets");
+  NS_TEST_EXPECT_MSG_EQ (flow2.lostPackets, 1, "Unexpected number of lost packets");
+
+  std::ifstream file (fileName.c_str ());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      lines.push_back (line);
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines.size (), 6, "Unexpected number of exported lines");
+  NS_TEST_EXPECT_MSG_EQ (lines[1], "1000000000,1,10,3,1,1000,300,300000000,0", "Unexpected first interval of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (lines[2], "1000000000,2,2,1,0,200,100,100000000,0", "Unexpected first interval of flow 2");
+  NS_TEST_EXPECT_MSG_EQ (lines[3], "2000000000,1,2,2,0,200,200,200000000,0", "Unexpected second interval of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (lines[4], "11000000000,1,0,0,6,0,0,0,0", "Unexpected losses of flow 1");
+  NS_TEST_EXPECT_MSG_EQ (lines[5], "11000000000,2,0,0,1,0,0,0,0", "Unexpected losses of flow 2");
+
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  m_probe = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * FlowMonitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new FlowMonitorTrackingTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
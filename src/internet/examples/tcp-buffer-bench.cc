@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+/**
+ * Microbenchmark of the TCP send and receive buffers with a large
+ * window, as in a multi-gigabit transfer.
+ *
+ * The send buffer is filled by the application with packets of
+ * writeSize bytes, segments of segmentSize bytes are extracted from it
+ * as the window opens, and every second segment is acknowledged.  The
+ * receive buffer gets the segments of the window with a hole every
+ * holeInterval segments, which is filled one window later, as a
+ * retransmission would, and the application reads the data as soon as
+ * it is in order.
+ *
+ * The number of segments processed per second by each buffer is
+ * reported along with the segment rate of a 10 Gbps link, e.g.:
+ * \code
+ *   ./waf --run "tcp-buffer-bench --n=1000000 --window=4194304"
+ * \endcode
+ */
+
+using namespace ns3;
+
+static void
+RunTxBuffer (uint32_t n, uint32_t window, uint32_t segmentSize, uint32_t writeSize)
+{
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (1);
+  buffer->SetMaxBufferSize (window + writeSize + 4 * segmentSize);
+  Ptr<Packet> write = Create<Packet> (writeSize);
+
+  SystemWallClockMs time;
+  time.Start ();
+  SequenceNumber32 nextTx (1);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      while (buffer->Available () >= writeSize)
+        {
+          buffer->Add (write->Copy ());
+        }
+      if (buffer->SizeFromSequence (nextTx) >= segmentSize)
+        {
+          buffer->CopyFromSequence (segmentSize, nextTx);
+          nextTx += segmentSize;
+        }
+      if (nextTx - buffer->HeadSequence () >= window && i % 2)
+        {
+          buffer->DiscardUpTo (buffer->HeadSequence () + 2 * segmentSize);
+        }
+    }
+  uint64_t deltaMs = std::max<uint64_t> (time.End (), 1);
+  std::cout << "TcpTxBuffer: " << n * 1000.0 / deltaMs << " segments/s" << std::endl;
+}
+
+static void
+RunRxBuffer (uint32_t n, uint32_t window, uint32_t segmentSize, uint32_t holeInterval)
+{
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> (1);
+  buffer->SetMaxBufferSize (2 * window);
+  Ptr<Packet> segment = Create<Packet> (segmentSize);
+  uint32_t windowSegments = window / segmentSize;
+  std::vector<SequenceNumber32> holes;
+
+  SystemWallClockMs time;
+  time.Start ();
+  TcpHeader tcph;
+  SequenceNumber32 seq (1);
+  uint32_t i = 0;
+  while (i < n)
+    {
+      if (i % holeInterval == holeInterval - 1)
+        {
+          holes.push_back (seq);
+        }
+      else
+        {
+          tcph.SetSequenceNumber (seq);
+          buffer->Add (segment->Copy (), tcph);
+        }
+      seq += segmentSize;
+      ++i;
+      if (i % windowSegments == 0)
+        { // The holes of the previous window are filled
+          for (std::vector<SequenceNumber32>::const_iterator it = holes.begin (); it != holes.end (); ++it)
+            {
+              tcph.SetSequenceNumber (*it);
+              buffer->Add (segment->Copy (), tcph);
+              ++i;
+            }
+          holes.clear ();
+        }
+      buffer->GetSackList (3);
+      buffer->Extract (buffer->Available ());
+    }
+  uint64_t deltaMs = std::max<uint64_t> (time.End (), 1);
+  std::cout << "TcpRxBuffer: " << n * 1000.0 / deltaMs << " segments/s" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t window = 4 * 1024 * 1024;
+  uint32_t segmentSize = 1448;
+  uint32_t writeSize = 512;
+  uint32_t holeInterval = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the TCP send and receive buffers");
+  cmd.AddValue ("n", "number of segments", n);
+  cmd.AddValue ("window", "window in bytes", window);
+  cmd.AddValue ("segmentSize", "segment size in bytes", segmentSize);
+  cmd.AddValue ("writeSize", "size of the application writes in bytes", writeSize);
+  cmd.AddValue ("holeInterval", "number of received segments per hole", holeInterval);
+  cmd.Parse (argc, argv);
+
+  std::cout << "10 Gbps: " << 10e9 / (8.0 * segmentSize) << " segments/s" << std::endl;
+  RunTxBuffer (n, window, segmentSize, writeSize);
+  RunRxBuffer (n, window, segmentSize, holeInterval);
+
+  return 0;
+}
@@ -82,6 +82,8 @@ public:
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * Only the nodes whose routes may have changed with the topology get
+   * new routes; see GlobalRouteManager::RecomputeRoutes ().
    */
   static void RecomputeRoutingTables (void);
 private:
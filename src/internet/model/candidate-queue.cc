@@ -49,24 +49,37 @@ operator<< (std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream& 
 operator<< (std::ostream& os, const CandidateQueue& q)
 {
-  typedef CandidateQueue::CandidateList_t List_t;
-  typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  typedef CandidateQueue::CandidateHeap_t Heap_t;
+  typedef Heap_t::const_iterator CIter_t;
+  Heap_t list;
+  for (CIter_t iter = q.m_heap.begin (); iter != q.m_heap.end (); iter++)
+    {
+      CandidateQueue::CandidateOrders_t::const_iterator c = q.m_candidates.find (iter->vertex);
+      if (c != q.m_candidates.end () && c->second == iter->order)
+        {
+          list.push_back (*iter);
+        }
+    }
+  std::sort_heap (list.begin (), list.end (), &CandidateQueue::IsAfter);
+  std::reverse (list.begin (), list.end ());
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
   for (CIter_t iter = list.begin (); iter != list.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->vertex->GetVertexId () << ", "
+      << iter->vertex->GetDistanceFromRoot () << ", "
+      << iter->vertex->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_heap (),
+    m_candidates (),
+    m_ids (),
+    m_nextOrder (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -94,11 +107,8 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  m_ids.insert (std::make_pair (vNew->GetVertexId (), vNew));
+  PushEntry (vNew);
 }
 
 SPFVertex *
@@ -110,8 +120,20 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_heap.front ().vertex;
+  std::pop_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsAfter);
+  m_heap.pop_back ();
+  m_candidates.erase (v);
+  std::pair<CandidateIds_t::iterator, CandidateIds_t::iterator> ids = m_ids.equal_range (v->GetVertexId ());
+  for (CandidateIds_t::iterator i = ids.first; i != ids.second; i++)
+    {
+      if (i->second == v)
+        {
+          m_ids.erase (i);
+          break;
+        }
+    }
+  DropStaleEntries ();
   return v;
 }
 
@@ -124,7 +146,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_heap.front ().vertex;
 }
 
 bool
@@ -145,18 +167,41 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
-
-  for (; i != m_candidates.end (); i++)
+  std::pair<CandidateIds_t::const_iterator, CandidateIds_t::const_iterator> ids = m_ids.equal_range (addr);
+  if (ids.first == ids.second)
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
+      return 0;
+    }
+//
+// Should several vertices have the same ID, return the first one to be
+// popped.
+//
+  CandidateIds_t::const_iterator first = ids.first;
+  for (CandidateIds_t::const_iterator i = ids.first; i != ids.second; i++)
+    {
+      Entry e1 = { i->second->GetDistanceFromRoot (), i->second->GetVertexType () == SPFVertex::VertexNetwork,
+                   m_candidates.find (i->second)->second, i->second };
+      Entry e2 = { first->second->GetDistanceFromRoot (), first->second->GetVertexType () == SPFVertex::VertexNetwork,
+                   m_candidates.find (first->second)->second, first->second };
+      if (IsAfter (e2, e1))
         {
-          return v;
+          first = i;
         }
     }
+  return first->second;
+}
 
-  return 0;
+void
+CandidateQueue::Update (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+  NS_ASSERT (m_candidates.find (v) != m_candidates.end ());
+//
+// The entry holding the former distance is left in the heap, and dropped
+// when it reaches the top.
+//
+  PushEntry (v);
+  DropStaleEntries ();
 }
 
 void
@@ -164,11 +209,63 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  m_heap.clear ();
+  for (CandidateOrders_t::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+    {
+      Entry e = { i->first->GetDistanceFromRoot (), i->first->GetVertexType () == SPFVertex::VertexNetwork,
+                  i->second, i->first };
+      m_heap.push_back (e);
+    }
+  std::make_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsAfter);
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::PushEntry (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+  Entry e = { v->GetDistanceFromRoot (), v->GetVertexType () == SPFVertex::VertexNetwork, m_nextOrder++, v };
+  m_candidates[v] = e.order;
+  m_heap.push_back (e);
+  std::push_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsAfter);
+}
+
+void
+CandidateQueue::DropStaleEntries (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_heap.empty ())
+    {
+      CandidateOrders_t::const_iterator c = m_candidates.find (m_heap.front ().vertex);
+      if (c != m_candidates.end () && c->second == m_heap.front ().order)
+        {
+          break;
+        }
+      std::pop_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsAfter);
+      m_heap.pop_back ();
+    }
+}
+
+//
+// The heap keeps the vertex to be popped first at its front.  Vertices
+// are ordered as by CompareSPFVertex () and then by the order in which
+// they were pushed, as they were when the queue was a sorted list.
+//
+bool
+CandidateQueue::IsAfter (const Entry &e1, const Entry &e2)
+{
+  if (e1.distance != e2.distance)
+    {
+      return e1.distance > e2.distance;
+    }
+  if (e1.network != e2.network)
+    {
+      return e2.network;
+    }
+  return e1.order > e2.order;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
+#include <map>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +48,11 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The vertices are kept in a binary heap, so that Push (), Pop () and
+ * Update () take a logarithmic time, and are indexed by vertex ID for
+ * Find ().  Vertices at the same distance from the root are popped in
+ * the order they were pushed, or last updated, networks first.
  */
 class CandidateQueue
 {
@@ -139,6 +145,19 @@ public:
  */
   SPFVertex* Find (const Ipv4Address addr) const;
 
+/**
+ * @brief Moves a Shortest Path First Vertex pointer in the queue after the
+ * value of its field m_distanceFromRoot decreased.
+ *
+ * The vertex is then ordered after the vertices already in the queue at
+ * the same distance from the root, as if it had just been pushed.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex in the queue whose distance
+ * decreased.
+ */
+  void Update (SPFVertex *v);
+
 /**
  * @brief Reorders the Candidate Queue according to the priority scheme.
  * 
@@ -184,8 +203,45 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  /**
+   * \brief An entry of the heap: a vertex and its priority when it was
+   * pushed or updated
+   */
+  struct Entry
+  {
+    uint32_t distance;   //!< Distance from the root
+    bool network;        //!< True if the vertex is a network
+    uint64_t order;      //!< Order in which the vertex was pushed or updated
+    SPFVertex *vertex;   //!< The vertex
+  };
+  /**
+   * \brief return true if e1 should be popped after e2
+   *
+   * \param e1 first operand
+   * \param e2 second operand
+   * \return True if e1 should be popped after e2
+   */
+  static bool IsAfter (const Entry &e1, const Entry &e2);
+  /**
+   * \brief Add a heap entry for a vertex with a new order.
+   *
+   * \param v the vertex
+   */
+  void PushEntry (SPFVertex *v);
+  /**
+   * \brief Remove the entries of the vertices updated since they were
+   * added from the top of the heap.
+   */
+  void DropStaleEntries (void);
+
+  typedef std::vector<Entry> CandidateHeap_t; //!< heap of SPFVertex entries
+  typedef std::map<SPFVertex*, uint64_t> CandidateOrders_t; //!< order of the current entry of each SPFVertex
+  typedef std::multimap<Ipv4Address, SPFVertex*> CandidateIds_t; //!< SPFVertex pointers by vertex ID
+
+  CandidateHeap_t m_heap;          //!< SPFVertex entries, including the outdated ones
+  CandidateOrders_t m_candidates;  //!< SPFVertex candidates and the order of their current entry
+  CandidateIds_t m_ids;            //!< SPFVertex candidates by vertex ID
+  uint64_t m_nextOrder;            //!< Order of the next entry
 
   /**
    * \brief Stream insertion operator.
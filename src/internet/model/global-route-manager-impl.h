@@ -26,6 +26,7 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <set>
 #include <vector>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -37,6 +38,7 @@ namespace ns3 {
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -674,6 +676,26 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief Copy the database and all of its Link State Advertisements.
+   *
+   * The copy is owned by the caller.
+   *
+   * @returns A new Link State Database holding copies of the LSAs.
+   */
+  GlobalRouteManagerLSDB* Copy () const;
+
+  /**
+   * @brief Compare the Link State Advertisements with those of another
+   * database.
+   *
+   * @param other the other Link State Database.
+   * @param changed the set the Link State IDs of the LSAs that are only in
+   * one of the databases, or differ, are inserted into.
+   * @returns true if the External Link State Advertisements differ.
+   */
+  bool Compare (const GlobalRouteManagerLSDB& other, std::set<Ipv4Address>& changed) const;
+
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -681,6 +703,8 @@ private:
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  mutable LSDBMap_t m_linkDataIndex; //!< LSAs by the link data of their transit network links, built on demand
+  mutable bool m_linkDataIndexed; //!< true if m_linkDataIndex is up to date
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -735,6 +759,16 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes of the
+ * nodes whose shortest path tree may have changed.
+ *
+ * The routes of the other nodes are left untouched; they are those a
+ * call to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+ * InitializeRoutes () would install.
+ */
+  virtual void RecomputeRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  */
@@ -766,8 +800,70 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+  /**
+   * \brief A node the routes of which are computed, with the objects the
+   * routes are installed through
+   */
+  struct SPFRoot
+  {
+    Ipv4Address routerId;                //!< router ID of the node
+    Ptr<Ipv4> ipv4;                      //!< Ipv4 of the node
+    Ptr<Ipv4GlobalRouting> routing;      //!< global routing protocol of the node
+  };
+
+  /**
+   * \brief What the last SPF calculation of a node read from the LSDB
+   *
+   * A node whose LSAs all read are unchanged, or differ only by the
+   * metrics of links on none of its shortest paths, gets the same routes
+   * from a new calculation.
+   */
+  struct SPFRootState
+  {
+    std::map<Ipv4Address, uint32_t> distances; //!< distance of the vertices in the SPF tree, SPF_INFINITY for the other LSAs read
+    uint32_t nRoutes;                          //!< number of routes of the node after the calculation
+  };
+
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  Ptr<Ipv4> m_spfrootIpv4; //!< Ipv4 of the root node
+  Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< global routing protocol of the root node
+  std::map<Ipv4Address, SPFRootState> m_spfRootStates; //!< last SPF calculation of the nodes, by router ID
+  std::vector<SPFRoot> m_workerRoots; //!< the nodes whose routes a worker thread computes
+
+  /**
+   * \brief Compute the routes of nodes, in several threads if the global
+   * value GlobalRouteManagerThreads allows it.
+   *
+   * \param roots the nodes
+   */
+  void CalculateRoutes (const std::vector<SPFRoot>& roots);
+
+  /**
+   * \brief Compute the routes of the nodes in m_workerRoots; the body of a
+   * worker thread.
+   */
+  void CalculateWorkerRoutes (void);
+
+  /**
+   * \brief Test if the routes of a node may change with the LSDB.
+   *
+   * \param root the router ID of the node
+   * \param routing the global routing protocol of the node
+   * \param previous the LSDB the routes of the node were computed with
+   * \param changed the Link State IDs of the LSAs that differ in the two LSDBs
+   * \returns true if the routes of the node must be computed again
+   */
+  bool IsRootAffected (Ipv4Address root, Ptr<Ipv4GlobalRouting> routing,
+                       const GlobalRouteManagerLSDB* previous,
+                       const std::set<Ipv4Address>& changed) const;
+
+  /**
+   * \brief Delete all the routes of a global routing protocol.
+   *
+   * \param routing the global routing protocol
+   */
+  static void DeleteRoutes (Ptr<Ipv4GlobalRouting> routing);
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -787,7 +883,7 @@ private:
    * Equivalent to quagga ospf_spf_calculate
    * \param root the root node
    */
-  void SPFCalculate (Ipv4Address root);
+  void SPFCalculate (const SPFRoot& root);
 
   /**
    * \brief Process Stub nodes
@@ -935,9 +1031,8 @@ private:
   /**
    * \brief Return the interface number corresponding to a given IP address and mask
    *
-   * This is a wrapper around GetInterfaceForPrefix(), but we first
-   * have to find the right node pointer to pass to that function.
-   * If no such interface is found, return -1 (note:  unit test framework
+   * This is a wrapper around GetInterfaceForPrefix() on the Ipv4 of the
+   * root node.  If no such interface is found, return -1 (note:  unit test framework
    * for routing assumes -1 to be a legal return value)
    *
    * \param a the target IP address
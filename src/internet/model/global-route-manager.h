@@ -64,6 +64,15 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database, and compute again the routes of the
+ * nodes whose shortest path tree may have changed.
+ *
+ * The other nodes keep their routes, which are those DeleteGlobalRoutes (),
+ * BuildGlobalRoutingDatabase () and InitializeRoutes () would give them.
+ */
+  static void RecomputeRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
@@ -28,8 +29,63 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+Ipv4EndPointDemux::Tuple::Tuple (Ipv4Address localAddress, uint16_t localPort,
+                                 Ipv4Address peerAddress, uint16_t peerPort)
+  : localAddress (localAddress),
+    localPort (localPort),
+    peerAddress (peerAddress),
+    peerPort (peerPort)
+{
+}
+
+bool
+Ipv4EndPointDemux::Tuple::operator== (const Tuple &other) const
+{
+  return localPort == other.localPort && peerPort == other.peerPort
+         && localAddress == other.localAddress && peerAddress == other.peerAddress;
+}
+
+size_t
+Ipv4EndPointDemux::TupleHash::operator() (const Tuple &tuple) const
+{
+  Ipv4AddressHash hash;
+  size_t h = hash (tuple.peerAddress);
+  h = h * 31 + hash (tuple.localAddress);
+  h = h * 31 + ((static_cast<size_t> (tuple.localPort) << 16) | tuple.peerPort);
+  return h;
+}
+
+/**
+ * \brief Check if an endpoint can receive the packets of an interface.
+ * \param endP the endpoint
+ * \param incomingInterface the incoming interface
+ * \return true if the endpoint can receive the packets
+ */
+static bool
+CanReceive (Ipv4EndPoint *endP, Ptr<Ipv4Interface> incomingInterface)
+{
+  if (!endP->IsRxEnabled ())
+    {
+      NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                    << " because endpoint can not receive packets");
+      return false;
+    }
+  if (endP->GetBoundNetDevice ())
+    {
+      if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          return false;
+        }
+    }
+  return true;
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152), m_nextOrder (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -49,29 +105,14 @@ bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_locals.find (Tuple (addr, port, Ipv4Address::GetAny (), 0)) != m_locals.end ();
 }
 
 Ipv4EndPoint *
@@ -84,10 +125,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -100,10 +138,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -123,10 +158,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -134,39 +166,48 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  Tuple tuple (localAddress, localPort, peerAddress, peerPort);
+  bool duplicate = false;
+  if (IsConnected (tuple))
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
+      duplicate = m_connected.find (tuple) != m_connected.end ();
+    }
+  else
+    {
+      sgi::hash_map<uint16_t, OrderedEndPoints>::const_iterator wildcards = m_wildcards.find (localPort);
+      if (wildcards != m_wildcards.end ())
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          for (OrderedEndPoints::const_iterator i = wildcards->second.begin (); i != wildcards->second.end (); i++)
+            {
+              if (GetTuple (*i->second) == tuple)
+                {
+                  duplicate = true;
+                  break;
+                }
+            }
         }
     }
+  if (duplicate)
+    {
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
+    }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  EndPointsI position;
+  uint64_t order;
+  if (RemoveFromIndex (endPoint, GetTuple (endPoint), position, order))
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      delete endPoint;
+      m_endPoints.erase (position);
     }
 }
 
@@ -203,58 +244,56 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval1; // Matches exact on local port, wildcards on others
   EndPoints retval2; // Matches exact on local port/adder, wildcards on others
   EndPoints retval3; // Matches all but local address
-  EndPoints retval4; // Exact match on all 4
+  OrderedEndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; incomingInterface != 0 && i < incomingInterface->GetNAddresses (); i++)
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  // The endpoints connected to a peer have no wildcard, and only match
+  // exactly on all 4 (the local address of a broadcast being the one of
+  // the incoming interface)
+  sgi::hash_map<Tuple, OrderedEndPoints, TupleHash>::const_iterator connected =
+    m_connected.find (Tuple (incomingInterfaceAddr, dport, saddr, sport));
+  if (connected != m_connected.end ())
+    {
+      for (OrderedEndPoints::const_iterator i = connected->second.begin (); i != connected->second.end (); i++)
+        {
+          if (CanReceive (*i->second, incomingInterface))
+            {
+              retval4.push_back (*i);
+            }
+        }
+    }
+
+  sgi::hash_map<uint16_t, OrderedEndPoints>::const_iterator wildcards = m_wildcards.find (dport);
+  OrderedEndPoints noEndPoints;
+  const OrderedEndPoints &endPoints = wildcards != m_wildcards.end () ? wildcards->second : noEndPoints;
+  for (OrderedEndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv4EndPoint* endP = *i->second;
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
                                                  << " sport=" << endP->GetPeerPort ()
                                                  << " saddr=" << endP->GetPeerAddress ());
 
-      if (!endP->IsRxEnabled ())
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                        << " because endpoint can not receive packets");
-          continue;
-        }
-
-      if (endP->GetLocalPort () != dport) 
+      if (!CanReceive (endP, incomingInterface))
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
           continue;
         }
-      if (endP->GetBoundNetDevice ())
-        {
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
-            {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
-              continue;
-            }
-        }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -307,12 +346,23 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
           remotePeerMatchesExact &&
           remoteAddressMatchesExact)
         { // All 4 match
-          retval4.push_back (endP);
+          retval4.push_back (*i);
         }
     }
 
   // Here we find the most exact match
-  if (!retval4.empty ()) return retval4;
+  if (!retval4.empty ())
+    {
+      // Both tables may hold exact matches: return them in the order
+      // the endpoints were allocated
+      std::sort (retval4.begin (), retval4.end (), &Ipv4EndPointDemux::IsAllocatedBefore);
+      EndPoints retval;
+      for (OrderedEndPoints::const_iterator i = retval4.begin (); i != retval4.end (); i++)
+        {
+          retval.push_back (*i->second);
+        }
+      return retval;
+    }
   if (!retval3.empty ()) return retval3;
   if (!retval2.empty ()) return retval2;
   return retval1;  // might be empty if no matches
@@ -326,6 +376,36 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  // Look for the exact match allocated first in both tables
+  Tuple tuple (daddr, dport, saddr, sport);
+  Ipv4EndPoint *exact = 0;
+  uint64_t exactOrder = 0;
+  sgi::hash_map<Tuple, OrderedEndPoints, TupleHash>::const_iterator connected = m_connected.find (tuple);
+  if (connected != m_connected.end ())
+    {
+      exact = *connected->second.front ().second;
+      exactOrder = connected->second.front ().first;
+    }
+  sgi::hash_map<uint16_t, OrderedEndPoints>::const_iterator wildcards = m_wildcards.find (dport);
+  OrderedEndPoints noEndPoints;
+  const OrderedEndPoints &endPoints = wildcards != m_wildcards.end () ? wildcards->second : noEndPoints;
+  for (OrderedEndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      if (exact != 0 && i->first > exactOrder)
+        {
+          break;
+        }
+      if (GetTuple (*i->second) == tuple)
+        {
+          exact = *i->second;
+          break;
+        }
+    }
+  if (exact != 0)
+    {
+      return exact;
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
@@ -336,13 +416,6 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
         {
           continue;
         }
-      if ((*i)->GetLocalAddress () == daddr &&
-          (*i)->GetPeerPort () == sport &&
-          (*i)->GetPeerAddress () == saddr) 
-        {
-          /* this is an exact match. */
-          return *i;
-        }
       uint32_t tmp = 0;
       if ((*i)->GetLocalAddress () == Ipv4Address::GetAny ()) 
         {
@@ -383,5 +456,124 @@ Ipv4EndPointDemux::AllocateEphemeralPort (void)
   return port;
 }
 
-} // namespace ns3
+bool
+Ipv4EndPointDemux::IsConnected (const Tuple &tuple)
+{
+  return tuple.localAddress != Ipv4Address::GetAny ()
+         && tuple.peerAddress != Ipv4Address::GetAny ()
+         && tuple.peerPort != 0;
+}
+
+Ipv4EndPointDemux::Tuple
+Ipv4EndPointDemux::GetTuple (Ipv4EndPoint *endPoint)
+{
+  return Tuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+}
+
+bool
+Ipv4EndPointDemux::IsAllocatedBefore (const OrderedEndPoints::value_type &a, const OrderedEndPoints::value_type &b)
+{
+  return a.first < b.first;
+}
+
+bool
+Ipv4EndPointDemux::Remove (OrderedEndPoints &endPoints, Ipv4EndPoint *endPoint, EndPointsI &position, uint64_t &order)
+{
+  for (OrderedEndPoints::iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      if (*i->second == endPoint)
+        {
+          position = i->second;
+          order = i->first;
+          endPoints.erase (i);
+          return true;
+        }
+    }
+  return false;
+}
 
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  EndPointsI position = m_endPoints.insert (m_endPoints.end (), endPoint);
+  AddToIndex (position, GetTuple (endPoint), m_nextOrder++);
+  endPoint->m_demux = this;
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::AddToIndex (EndPointsI position, const Tuple &tuple, uint64_t order)
+{
+  NS_LOG_FUNCTION (this << *position << order);
+  OrderedEndPoints &endPoints = IsConnected (tuple) ? m_connected[tuple] : m_wildcards[tuple.localPort];
+  // Endpoints are rehashed with their allocation order
+  OrderedEndPoints::iterator i = endPoints.end ();
+  while (i != endPoints.begin () && (i - 1)->first > order)
+    {
+      i--;
+    }
+  endPoints.insert (i, std::make_pair (order, position));
+  m_locals[Tuple (tuple.localAddress, tuple.localPort, Ipv4Address::GetAny (), 0)]++;
+  m_ports[tuple.localPort]++;
+}
+
+bool
+Ipv4EndPointDemux::RemoveFromIndex (Ipv4EndPoint *endPoint, const Tuple &tuple, EndPointsI &position, uint64_t &order)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  if (IsConnected (tuple))
+    {
+      sgi::hash_map<Tuple, OrderedEndPoints, TupleHash>::iterator connected = m_connected.find (tuple);
+      if (connected == m_connected.end () || !Remove (connected->second, endPoint, position, order))
+        {
+          return false;
+        }
+      if (connected->second.empty ())
+        {
+          m_connected.erase (connected);
+        }
+    }
+  else
+    {
+      sgi::hash_map<uint16_t, OrderedEndPoints>::iterator wildcards = m_wildcards.find (tuple.localPort);
+      if (wildcards == m_wildcards.end () || !Remove (wildcards->second, endPoint, position, order))
+        {
+          return false;
+        }
+      if (wildcards->second.empty ())
+        {
+          m_wildcards.erase (wildcards);
+        }
+    }
+  sgi::hash_map<Tuple, uint32_t, TupleHash>::iterator local =
+    m_locals.find (Tuple (tuple.localAddress, tuple.localPort, Ipv4Address::GetAny (), 0));
+  NS_ASSERT (local != m_locals.end ());
+  if (--local->second == 0)
+    {
+      m_locals.erase (local);
+    }
+  sgi::hash_map<uint16_t, uint32_t>::iterator port = m_ports.find (tuple.localPort);
+  NS_ASSERT (port != m_ports.end ());
+  if (--port->second == 0)
+    {
+      m_ports.erase (port);
+    }
+  return true;
+}
+
+void
+Ipv4EndPointDemux::Rehash (Ipv4EndPoint *endPoint, Ipv4Address localAddress, Ipv4Address peerAddress, uint16_t peerPort)
+{
+  NS_LOG_FUNCTION (this << endPoint << localAddress << peerAddress << peerPort);
+  EndPointsI position;
+  uint64_t order;
+  if (RemoveFromIndex (endPoint, GetTuple (endPoint), position, order))
+    {
+      AddToIndex (position, Tuple (localAddress, endPoint->GetLocalPort (), peerAddress, peerPort), order);
+    }
+}
+
+} // namespace ns3
@@ -59,7 +59,8 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_routeOrder (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -80,6 +81,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  InsertRouteInTrie (m_hostRoutesTrie, route);
 }
 
 void 
@@ -90,6 +92,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  InsertRouteInTrie (m_hostRoutesTrie, route);
 }
 
 void 
@@ -105,6 +108,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  InsertRouteInTrie (m_networkRoutesTrie, route);
 }
 
 void 
@@ -118,6 +122,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  InsertRouteInTrie (m_networkRoutesTrie, route);
 }
 
 void 
@@ -133,83 +138,121 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  InsertRouteInTrie (m_ASexternalRoutesTrie, route);
 }
 
 
+void
+Ipv4GlobalRouting::InsertRouteInTrie (RoutesTrie &trie, Ipv4RoutingTableEntry *route)
+{
+  trie.Insert (route->GetDestNetwork (), route->GetDestNetworkMask ().GetPrefixLength (), m_routeOrder++, route);
+  m_routeCache.clear ();
+}
+
+void
+Ipv4GlobalRouting::RemoveRouteFromTrie (RoutesTrie &trie, Ipv4RoutingTableEntry *route)
+{
+  bool found = trie.Remove (route->GetDestNetwork (), route->GetDestNetworkMask ().GetPrefixLength (), route);
+  NS_ASSERT (found);
+  m_routeCache.clear ();
+}
+
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << oif);
   NS_LOG_LOGIC ("Looking for route for destination " << dest);
+  // The route to a destination does not change until the tables do,
+  // unless it is picked at random among ECMP routes
+  bool cacheable = oif == 0 && !m_randomEcmpRouting;
+  if (cacheable)
+    {
+      RouteCache::const_iterator cached = m_routeCache.find (dest);
+      if (cached != m_routeCache.end ())
+        {
+          NS_LOG_LOGIC ("Found route in the cache");
+          return cached->second == 0 ? 0 : Create<Ipv4Route> (*cached->second);
+        }
+    }
   Ptr<Ipv4Route> rtentry = 0;
   // store all available routes that bring packets to their destination
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
+  // the routes of a table whose prefix matches the destination, in table order
+  std::vector<RoutesTrie::Item> candidates;
 
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  m_hostRoutesTrie.Lookup (dest, candidates);
+  for (std::vector<RoutesTrie::Item>::const_iterator c = candidates.begin ();
+       c != candidates.end ();
+       c++)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      Ipv4RoutingTableEntry *i = c->second;
+      NS_ASSERT (i->IsHost ());
+      if (i->GetDest ().IsEqual (dest)) 
         {
           if (oif != 0)
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
+              if (oif != m_ipv4->GetNetDevice (i->GetInterface ()))
                 {
                   NS_LOG_LOGIC ("Not on requested interface, skipping");
                   continue;
                 }
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
+          allRoutes.push_back (i);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << i); 
         }
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      candidates.clear ();
+      m_networkRoutesTrie.Lookup (dest, candidates);
+      for (std::vector<RoutesTrie::Item>::const_iterator c = candidates.begin ();
+           c != candidates.end ();
+           c++)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
+          Ipv4RoutingTableEntry *j = c->second;
+          Ipv4Mask mask = j->GetDestNetworkMask ();
+          Ipv4Address entry = j->GetDestNetwork ();
           if (mask.IsMatch (dest, entry)) 
             {
               if (oif != 0)
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                  if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
                     {
                       NS_LOG_LOGIC ("Not on requested interface, skipping");
                       continue;
                     }
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+              allRoutes.push_back (j);
+              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << j);
             }
         }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      candidates.clear ();
+      m_ASexternalRoutesTrie.Lookup (dest, candidates);
+      for (std::vector<RoutesTrie::Item>::const_iterator c = candidates.begin ();
+           c != candidates.end ();
+           c++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
+          Ipv4RoutingTableEntry *k = c->second;
+          Ipv4Mask mask = k->GetDestNetworkMask ();
+          Ipv4Address entry = k->GetDestNetwork ();
           if (mask.IsMatch (dest, entry))
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
+              NS_LOG_LOGIC ("Found external route" << k);
               if (oif != 0)
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                  if (oif != m_ipv4->GetNetDevice (k->GetInterface ()))
                     {
                       NS_LOG_LOGIC ("Not on requested interface, skipping");
                       continue;
                     }
                 }
-              allRoutes.push_back (*k);
+              allRoutes.push_back (k);
               break;
             }
         }
@@ -237,12 +280,12 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
       rtentry->SetGateway (route->GetGateway ());
       uint32_t interfaceIdx = route->GetInterface ();
       rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-      return rtentry;
     }
-  else 
+  if (cacheable)
     {
-      return 0;
+      m_routeCache[dest] = rtentry == 0 ? 0 : Create<Ipv4Route> (*rtentry);
     }
+  return rtentry;
 }
 
 uint32_t 
@@ -319,6 +362,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              RemoveRouteFromTrie (m_hostRoutesTrie, *i);
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -336,6 +380,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          RemoveRouteFromTrie (m_networkRoutesTrie, *j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -352,6 +397,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          RemoveRouteFromTrie (m_ASexternalRoutesTrie, *k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -392,6 +438,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostRoutesTrie.Clear ();
+  m_networkRoutesTrie.Clear ();
+  m_ASexternalRoutesTrie.Clear ();
+  m_routeCache.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -535,11 +585,10 @@ void
 Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  m_routeCache.clear ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -547,11 +596,10 @@ void
 Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  m_routeCache.clear ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -559,11 +607,10 @@ void
 Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << address);
+  m_routeCache.clear ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -571,11 +618,10 @@ void
 Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << address);
+  m_routeCache.clear ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -21,6 +21,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <map>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +29,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ipv4-routing-trie.h"
 
 namespace ns3 {
 
@@ -260,6 +262,11 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /// Trie of the routes, indexed by destination prefix
+  typedef Ipv4RoutingTrie<Ipv4RoutingTableEntry *> RoutesTrie;
+  /// Cache of the routes looked up without output interface, by destination
+  typedef std::map<Ipv4Address, Ptr<Ipv4Route> > RouteCache;
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -268,10 +275,29 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Insert a route in the trie of its table and invalidate the route cache.
+   * \param trie the trie
+   * \param route the route
+   */
+  void InsertRouteInTrie (RoutesTrie &trie, Ipv4RoutingTableEntry *route);
+  /**
+   * \brief Remove a route from the trie of its table and invalidate the route cache.
+   * \param trie the trie
+   * \param route the route
+   */
+  void RemoveRouteFromTrie (RoutesTrie &trie, Ipv4RoutingTableEntry *route);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  RoutesTrie m_hostRoutesTrie;             //!< Trie of the routes to hosts
+  RoutesTrie m_networkRoutesTrie;          //!< Trie of the routes to networks
+  RoutesTrie m_ASexternalRoutesTrie;       //!< Trie of the external routes
+  uint64_t m_routeOrder;                   //!< Order of the next route added, in its table
+  RouteCache m_routeCache;                 //!< Routes looked up since the last change of the tables
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
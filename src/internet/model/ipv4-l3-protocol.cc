@@ -33,6 +33,7 @@
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/traffic-control-layer.h"
+#include "ns3/gso-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -41,6 +42,8 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-header.h"
+#include "tcp-l4-protocol.h"
 
 namespace ns3 {
 
@@ -816,6 +819,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
     {
       NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 3:  passed in with route");
       ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+      ReserveGsoIdentifications (packet, ipHeader);
       int32_t interface = GetInterfaceForDevice (route->GetOutputDevice ());
       m_sendOutgoingTrace (ipHeader, packet, interface);
       SendRealOut (route, packet->Copy (), ipHeader);
@@ -835,6 +839,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
   Socket::SocketErrno errno_; 
   Ptr<NetDevice> oif (0); // unused for now
   ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
+  ReserveGsoIdentifications (packet, ipHeader);
   Ptr<Ipv4Route> newRoute;
   if (m_routingProtocol != 0)
     {
@@ -907,6 +912,27 @@ Ipv4L3Protocol::BuildHeader (
   return ipHeader;
 }
 
+void
+Ipv4L3Protocol::ReserveGsoIdentifications (Ptr<const Packet> packet, const Ipv4Header &ipHeader)
+{
+  NS_LOG_FUNCTION (this << packet << &ipHeader);
+  GsoTag gsoTag;
+  if (ipHeader.GetProtocol () != TcpL4Protocol::PROT_NUMBER || !packet->PeekPacketTag (gsoTag))
+    {
+      return;
+    }
+  TcpHeader tcpHeader;
+  packet->PeekHeader (tcpHeader);
+  uint32_t size = packet->GetSize () - tcpHeader.GetSerializedSize ();
+  uint32_t segments = (size + gsoTag.GetSegmentSize () - 1) / gsoTag.GetSegmentSize ();
+  if (segments > 1)
+    {
+      uint64_t srcDst = ipHeader.GetDestination ().Get () | (uint64_t (ipHeader.GetSource ().Get ()) << 32);
+      // BuildHeader already counted the first segment
+      m_identification[std::make_pair (srcDst, ipHeader.GetProtocol ())] += segments - 1;
+    }
+}
+
 void
 Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
                              Ptr<Packet> packet,
@@ -925,12 +951,34 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
+  // A super-segment is handed whole to a device supporting GSO, and split here for the others
+  GsoTag gsoTag;
+  bool gso = packet->PeekPacketTag (gsoTag);
+  if (gso && !outDev->SupportsGso ())
+    {
+      Ptr<Packet> superSegment = packet->Copy ();
+      superSegment->AddHeader (ipHeader);
+      std::list<Ptr<Packet> > segments;
+      if (GsoTag::Segment (superSegment, PROT_NUMBER, segments))
+        {
+          NS_LOG_LOGIC ("Split a super-segment into " << segments.size () << " segments");
+          for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it)
+            {
+              Ipv4Header segmentHeader;
+              (*it)->RemoveHeader (segmentHeader);
+              SendRealOut (route, *it, segmentHeader);
+            }
+          return;
+        }
+      gso = false;
+    }
+
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!gso && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -957,7 +1005,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!gso && packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
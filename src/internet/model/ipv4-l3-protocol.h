@@ -313,6 +313,18 @@ private:
     uint8_t tos,
     bool mayFragment);
 
+  /**
+   * \brief Reserve the identifications of the segments of a TCP super-segment.
+   *
+   * The segments split from a super-segment tagged with a GsoTag take the
+   * identifications following the one of its header: skip them for the
+   * next packets of the same flow.
+   *
+   * \param packet the TCP super-segment, without IPv4 header
+   * \param ipHeader the IPv4 header built for it
+   */
+  void ReserveGsoIdentifications (Ptr<const Packet> packet, const Ipv4Header &ipHeader);
+
   /**
    * \brief Send packet with route.
    * \param route route
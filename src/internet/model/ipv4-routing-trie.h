@@ -0,0 +1,350 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTING_TRIE_H
+#define IPV4_ROUTING_TRIE_H
+
+#include <stdint.h>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "ns3/ipv4-address.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Path-compressed binary trie of IPv4 prefixes, for the
+ * longest-prefix-match lookups of the routing protocols.
+ *
+ * Each prefix holds the values (typically routing table entries)
+ * inserted with it, along with a key giving their order in the
+ * routing table.  A lookup returns the values of all the prefixes
+ * matching an address in O(32), so that a routing protocol keeping its
+ * routes in a list can examine the candidate routes only, in the order
+ * of the list, instead of walking the whole list.
+ *
+ * The trie is maintained alongside the routing table: the routing
+ * protocol inserts and removes the values as it adds and removes its
+ * routes.
+ *
+ * \tparam T the type of the values, which must be equality comparable
+ */
+template <typename T>
+class Ipv4RoutingTrie
+{
+public:
+  /// A value and its order in the routing table
+  typedef std::pair<uint64_t, T> Item;
+
+  Ipv4RoutingTrie ();
+  ~Ipv4RoutingTrie ();
+
+  /**
+   * \brief Insert a value for a prefix.
+   * \param network the network address (the host bits are ignored)
+   * \param prefixLength the length of the prefix, up to 32
+   * \param order the order of the value in the routing table
+   * \param value the value
+   */
+  void Insert (Ipv4Address network, uint8_t prefixLength, uint64_t order, T value);
+  /**
+   * \brief Remove a value inserted for a prefix.
+   * \param network the network address (the host bits are ignored)
+   * \param prefixLength the length of the prefix, up to 32
+   * \param value the value
+   * \return true if the value was found
+   */
+  bool Remove (Ipv4Address network, uint8_t prefixLength, T value);
+  /**
+   * \brief Get the values of the prefixes matching an address.
+   * \param address the address
+   * \param items the vector the items are appended to, by increasing order
+   */
+  void Lookup (Ipv4Address address, std::vector<Item> &items) const;
+  /**
+   * \brief Remove all the values.
+   */
+  void Clear (void);
+  /**
+   * \return the number of values
+   */
+  uint32_t GetNItems (void) const;
+
+private:
+  /// A node of the trie: a prefix, its values and its subtrees
+  struct Node
+  {
+    uint32_t prefix;          //!< The prefix, host bits cleared
+    uint8_t length;           //!< The length of the prefix
+    Node *child[2];           //!< The subtrees, by the bit following the prefix
+    std::vector<Item> items;  //!< The values of the prefix
+  };
+
+  /// Disable the copy: the trie owns its nodes
+  Ipv4RoutingTrie (const Ipv4RoutingTrie &);
+  /**
+   * \brief Disable the assignment: the trie owns its nodes
+   * \return the trie
+   */
+  Ipv4RoutingTrie &operator= (const Ipv4RoutingTrie &);
+
+  /**
+   * \param address an address
+   * \param length a prefix length, up to 32
+   * \return the address with the bits after the prefix cleared
+   */
+  static uint32_t Mask (uint32_t address, uint8_t length);
+  /**
+   * \param address an address
+   * \param i the index of the bit, from the most significant one
+   * \return the bit
+   */
+  static uint32_t Bit (uint32_t address, uint8_t i);
+  /**
+   * \param a an item
+   * \param b another item
+   * \return true if the first item comes before the other in the routing table
+   */
+  static bool IsBefore (const Item &a, const Item &b);
+  /**
+   * \brief Create a node.
+   * \param prefix the prefix, host bits cleared
+   * \param length the length of the prefix
+   * \return the node
+   */
+  static Node *CreateNode (uint32_t prefix, uint8_t length);
+  /**
+   * \brief Delete a subtree.
+   * \param node the root of the subtree
+   */
+  static void DeleteTree (Node *node);
+  /**
+   * \brief Remove a value from a subtree.
+   * \param node the root of the subtree
+   * \param prefix the prefix, host bits cleared
+   * \param length the length of the prefix
+   * \param value the value
+   * \param found set to true if the value was found
+   * \return the new root of the subtree, which may be 0
+   */
+  static Node *Remove (Node *node, uint32_t prefix, uint8_t length, const T &value, bool &found);
+
+  Node *m_root;       //!< The root of the trie
+  uint32_t m_nItems;  //!< The number of values
+};
+
+template <typename T>
+Ipv4RoutingTrie<T>::Ipv4RoutingTrie ()
+  : m_root (0),
+    m_nItems (0)
+{
+}
+
+template <typename T>
+Ipv4RoutingTrie<T>::~Ipv4RoutingTrie ()
+{
+  Clear ();
+}
+
+template <typename T>
+uint32_t
+Ipv4RoutingTrie<T>::Mask (uint32_t address, uint8_t length)
+{
+  return length == 0 ? 0 : address & (0xffffffff << (32 - length));
+}
+
+template <typename T>
+uint32_t
+Ipv4RoutingTrie<T>::Bit (uint32_t address, uint8_t i)
+{
+  return (address >> (31 - i)) & 1;
+}
+
+template <typename T>
+bool
+Ipv4RoutingTrie<T>::IsBefore (const Item &a, const Item &b)
+{
+  return a.first < b.first;
+}
+
+template <typename T>
+typename Ipv4RoutingTrie<T>::Node *
+Ipv4RoutingTrie<T>::CreateNode (uint32_t prefix, uint8_t length)
+{
+  Node *node = new Node;
+  node->prefix = prefix;
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+template <typename T>
+void
+Ipv4RoutingTrie<T>::DeleteTree (Node *node)
+{
+  if (node != 0)
+    {
+      DeleteTree (node->child[0]);
+      DeleteTree (node->child[1]);
+      delete node;
+    }
+}
+
+template <typename T>
+void
+Ipv4RoutingTrie<T>::Insert (Ipv4Address network, uint8_t prefixLength, uint64_t order, T value)
+{
+  NS_ASSERT (prefixLength <= 32);
+  uint32_t prefix = Mask (network.Get (), prefixLength);
+  ++m_nItems;
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0)
+        {
+          node = CreateNode (prefix, prefixLength);
+          node->items.push_back (Item (order, value));
+          *link = node;
+          return;
+        }
+      // Length of the prefix common to the node and the new prefix
+      uint8_t common = 0;
+      uint8_t maxCommon = std::min (node->length, prefixLength);
+      while (common < maxCommon && Bit (node->prefix, common) == Bit (prefix, common))
+        {
+          ++common;
+        }
+      if (common == node->length && common == prefixLength)
+        {
+          node->items.push_back (Item (order, value));
+          return;
+        }
+      if (common == node->length)
+        { // The node prefix is a prefix of the new prefix
+          link = &node->child[Bit (prefix, common)];
+          continue;
+        }
+      Node *parent;
+      if (common == prefixLength)
+        { // The new prefix is a prefix of the node prefix
+          parent = CreateNode (prefix, prefixLength);
+          parent->items.push_back (Item (order, value));
+        }
+      else
+        { // The prefixes diverge after their common part
+          parent = CreateNode (Mask (prefix, common), common);
+          Node *leaf = CreateNode (prefix, prefixLength);
+          leaf->items.push_back (Item (order, value));
+          parent->child[Bit (prefix, common)] = leaf;
+        }
+      parent->child[Bit (node->prefix, common)] = node;
+      *link = parent;
+      return;
+    }
+}
+
+template <typename T>
+typename Ipv4RoutingTrie<T>::Node *
+Ipv4RoutingTrie<T>::Remove (Node *node, uint32_t prefix, uint8_t length, const T &value, bool &found)
+{
+  if (node == 0 || node->length > length || Mask (prefix, node->length) != node->prefix)
+    {
+      return node;
+    }
+  if (node->length == length)
+    {
+      for (typename std::vector<Item>::iterator it = node->items.begin (); it != node->items.end (); ++it)
+        {
+          if (it->second == value)
+            {
+              node->items.erase (it);
+              found = true;
+              break;
+            }
+        }
+    }
+  else
+    {
+      uint32_t bit = Bit (prefix, node->length);
+      node->child[bit] = Remove (node->child[bit], prefix, length, value, found);
+    }
+  // A node without values is only kept to join two subtrees
+  if (node->items.empty () && (node->child[0] == 0 || node->child[1] == 0))
+    {
+      Node *child = node->child[0] != 0 ? node->child[0] : node->child[1];
+      delete node;
+      return child;
+    }
+  return node;
+}
+
+template <typename T>
+bool
+Ipv4RoutingTrie<T>::Remove (Ipv4Address network, uint8_t prefixLength, T value)
+{
+  NS_ASSERT (prefixLength <= 32);
+  bool found = false;
+  m_root = Remove (m_root, Mask (network.Get (), prefixLength), prefixLength, value, found);
+  if (found)
+    {
+      --m_nItems;
+    }
+  return found;
+}
+
+template <typename T>
+void
+Ipv4RoutingTrie<T>::Lookup (Ipv4Address address, std::vector<Item> &items) const
+{
+  uint32_t addr = address.Get ();
+  typename std::vector<Item>::size_type first = items.size ();
+  const Node *node = m_root;
+  while (node != 0 && Mask (addr, node->length) == node->prefix)
+    {
+      items.insert (items.end (), node->items.begin (), node->items.end ());
+      if (node->length == 32)
+        {
+          break;
+        }
+      node = node->child[Bit (addr, node->length)];
+    }
+  std::sort (items.begin () + first, items.end (), &Ipv4RoutingTrie<T>::IsBefore);
+}
+
+template <typename T>
+void
+Ipv4RoutingTrie<T>::Clear (void)
+{
+  DeleteTree (m_root);
+  m_root = 0;
+  m_nItems = 0;
+}
+
+template <typename T>
+uint32_t
+Ipv4RoutingTrie<T>::GetNItems (void) const
+{
+  return m_nItems;
+}
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTING_TRIE_H */
@@ -23,6 +23,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include <list>
+#include <map>
 #include <utility>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
@@ -31,6 +32,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ipv4-routing-trie.h"
 
 namespace ns3 {
 
@@ -395,6 +397,12 @@ private:
   /// Iterator for container for the multicast routes
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  /// Trie of the network routes and their metric, indexed by destination prefix
+  typedef Ipv4RoutingTrie<std::pair <Ipv4RoutingTableEntry *, uint32_t> > NetworkRoutesTrie;
+
+  /// Cache of the routes looked up without output interface, by destination
+  typedef std::map<Ipv4Address, Ptr<Ipv4Route> > RouteCache;
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -413,11 +421,40 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  /**
+   * \brief Add a network route and its metric to the forwarding table.
+   * \param route the route
+   * \param metric the metric of the route
+   */
+  void AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Remove a network route from the forwarding table.
+   * \param it the route
+   * \return the route following the route removed
+   */
+  NetworkRoutesI RemoveNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the trie of the network routes, for the lookups.
+   */
+  NetworkRoutesTrie m_networkRoutesTrie;
+
+  /**
+   * \brief the order of the next network route added.
+   */
+  uint64_t m_routeOrder;
+
+  /**
+   * \brief the routes looked up since the last change of the forwarding table.
+   */
+  RouteCache m_routeCache;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -18,6 +18,7 @@
  * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
  */
 
+#include <algorithm>
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
@@ -26,10 +27,68 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 
+Ipv6EndPointDemux::Tuple::Tuple (Ipv6Address localAddress, uint16_t localPort,
+                                 Ipv6Address peerAddress, uint16_t peerPort)
+  : localAddress (localAddress),
+    localPort (localPort),
+    peerAddress (peerAddress),
+    peerPort (peerPort)
+{
+}
+
+bool Ipv6EndPointDemux::Tuple::operator== (const Tuple &other) const
+{
+  return localPort == other.localPort && peerPort == other.peerPort
+         && localAddress == other.localAddress && peerAddress == other.peerAddress;
+}
+
+size_t Ipv6EndPointDemux::TupleHash::operator() (const Tuple &tuple) const
+{
+  Ipv6AddressHash hash;
+  size_t h = hash (tuple.peerAddress);
+  h = h * 31 + hash (tuple.localAddress);
+  h = h * 31 + ((static_cast<size_t> (tuple.localPort) << 16) | tuple.peerPort);
+  return h;
+}
+
+/**
+ * \brief Check if an end point can receive the packets of an interface.
+ * \param endP the end point
+ * \param incomingInterface the incoming interface
+ * \return true if the end point can receive the packets
+ */
+static bool CanReceive (Ipv6EndPoint *endP, Ptr<Ipv6Interface> incomingInterface)
+{
+  if (!endP->IsRxEnabled ())
+    {
+      NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                    << " because endpoint can not receive packets");
+      return false;
+    }
+
+  if (endP->GetBoundNetDevice ())
+    {
+      if (!incomingInterface)
+        {
+          return false;
+        }
+      if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          return false;
+        }
+    }
+  return true;
+}
+
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_nextOrder (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -48,28 +107,13 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_locals.find (Tuple (addr, port, Ipv6Address::GetAny (), 0)) != m_locals.end ();
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
@@ -81,10 +125,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -96,10 +137,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (uint16_t port)
@@ -117,48 +155,54 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t localPort,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  Tuple tuple (localAddress, localPort, peerAddress, peerPort);
+  bool duplicate = false;
+  if (IsConnected (tuple))
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
+      duplicate = m_connected.find (tuple) != m_connected.end ();
+    }
+  else
+    {
+      sgi::hash_map<uint16_t, OrderedEndPoints>::const_iterator wildcards = m_wildcards.find (localPort);
+      if (wildcards != m_wildcards.end ())
         {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
+          for (OrderedEndPoints::const_iterator i = wildcards->second.begin (); i != wildcards->second.end (); i++)
+            {
+              if (GetTuple (*i->second) == tuple)
+                {
+                  duplicate = true;
+                  break;
+                }
+            }
         }
     }
+  if (duplicate)
+    {
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
+    }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  EndPointsI position;
+  uint64_t order;
+  if (RemoveFromIndex (endPoint, GetTuple (endPoint), position, order))
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      delete endPoint;
+      m_endPoints.erase (position);
     }
 }
 
@@ -176,50 +220,42 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval1; /* Matches exact on local port, wildcards on others */
   EndPoints retval2; /* Matches exact on local port/adder, wildcards on others */
   EndPoints retval3; /* Matches all but local address */
-  EndPoints retval4; /* Exact match on all 4 */
+  OrderedEndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+
+  /* The end points connected to a peer have no wildcard, and only match
+     exactly on all 4 */
+  sgi::hash_map<Tuple, OrderedEndPoints, TupleHash>::const_iterator connected =
+    m_connected.find (Tuple (daddr, dport, saddr, sport));
+  if (connected != m_connected.end ())
     {
-      Ipv6EndPoint* endP = *i;
+      for (OrderedEndPoints::const_iterator i = connected->second.begin (); i != connected->second.end (); i++)
+        {
+          if (CanReceive (*i->second, incomingInterface))
+            {
+              retval4.push_back (*i);
+            }
+        }
+    }
+
+  sgi::hash_map<uint16_t, OrderedEndPoints>::const_iterator wildcards = m_wildcards.find (dport);
+  OrderedEndPoints noEndPoints;
+  const OrderedEndPoints &endPoints = wildcards != m_wildcards.end () ? wildcards->second : noEndPoints;
+  for (OrderedEndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv6EndPoint* endP = *i->second;
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
                                                  << " sport=" << endP->GetPeerPort ()
                                                  << " saddr=" << endP->GetPeerAddress ());
 
-      if (!endP->IsRxEnabled ())
+      if (!CanReceive (endP, incomingInterface))
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                        << " because endpoint can not receive packets");
           continue;
         }
 
-      if (endP->GetLocalPort () != dport)
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-
-      if (endP->GetBoundNetDevice ())
-        {
-          if (!incomingInterface)
-            {
-              continue;
-            }
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
-            {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
-              continue;
-            }
-        }
-
       /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
       NS_LOG_DEBUG ("dest addr " << daddr);
 
@@ -271,14 +307,22 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
           && remotePeerMatchesExact
           && remoteAddressMatchesExact)
         { /* All 4 match */
-          retval4.push_back (endP);
+          retval4.push_back (*i);
         }
     }
 
   /* Here we find the most exact match */
   if (!retval4.empty ())
     {
-      return retval4;
+      /* Both tables may hold exact matches: return them in the order
+         the end points were allocated */
+      std::sort (retval4.begin (), retval4.end (), &Ipv6EndPointDemux::IsAllocatedBefore);
+      EndPoints retval;
+      for (OrderedEndPoints::const_iterator i = retval4.begin (); i != retval4.end (); i++)
+        {
+          retval.push_back (*i->second);
+        }
+      return retval;
     }
   if (!retval3.empty ())
     {
@@ -293,6 +337,36 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  /* Look for the exact match allocated first in both tables */
+  Tuple tuple (dst, dport, src, sport);
+  Ipv6EndPoint *exact = 0;
+  uint64_t exactOrder = 0;
+  sgi::hash_map<Tuple, OrderedEndPoints, TupleHash>::const_iterator connected = m_connected.find (tuple);
+  if (connected != m_connected.end ())
+    {
+      exact = *connected->second.front ().second;
+      exactOrder = connected->second.front ().first;
+    }
+  sgi::hash_map<uint16_t, OrderedEndPoints>::const_iterator wildcards = m_wildcards.find (dport);
+  OrderedEndPoints noEndPoints;
+  const OrderedEndPoints &endPoints = wildcards != m_wildcards.end () ? wildcards->second : noEndPoints;
+  for (OrderedEndPoints::const_iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      if (exact != 0 && i->first > exactOrder)
+        {
+          break;
+        }
+      if (GetTuple (*i->second) == tuple)
+        {
+          exact = *i->second;
+          break;
+        }
+    }
+  if (exact != 0)
+    {
+      return exact;
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
@@ -305,13 +379,6 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
           continue;
         }
 
-      if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
-          && (*i)->GetPeerAddress () == src)
-        {
-          /* this is an exact match. */
-          return *i;
-        }
-
       if ((*i)->GetLocalAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
@@ -358,5 +425,117 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
   return m_endPoints;
 }
 
+bool Ipv6EndPointDemux::IsConnected (const Tuple &tuple)
+{
+  return tuple.localAddress != Ipv6Address::GetAny ()
+         && tuple.peerAddress != Ipv6Address::GetAny ()
+         && tuple.peerPort != 0;
+}
+
+Ipv6EndPointDemux::Tuple Ipv6EndPointDemux::GetTuple (Ipv6EndPoint *endPoint)
+{
+  return Tuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+}
+
+bool Ipv6EndPointDemux::IsAllocatedBefore (const OrderedEndPoints::value_type &a, const OrderedEndPoints::value_type &b)
+{
+  return a.first < b.first;
+}
+
+bool Ipv6EndPointDemux::Remove (OrderedEndPoints &endPoints, Ipv6EndPoint *endPoint, EndPointsI &position, uint64_t &order)
+{
+  for (OrderedEndPoints::iterator i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      if (*i->second == endPoint)
+        {
+          position = i->second;
+          order = i->first;
+          endPoints.erase (i);
+          return true;
+        }
+    }
+  return false;
+}
+
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  EndPointsI position = m_endPoints.insert (m_endPoints.end (), endPoint);
+  AddToIndex (position, GetTuple (endPoint), m_nextOrder++);
+  endPoint->m_demux = this;
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::AddToIndex (EndPointsI position, const Tuple &tuple, uint64_t order)
+{
+  NS_LOG_FUNCTION (this << *position << order);
+  OrderedEndPoints &endPoints = IsConnected (tuple) ? m_connected[tuple] : m_wildcards[tuple.localPort];
+  /* End points are rehashed with their allocation order */
+  OrderedEndPoints::iterator i = endPoints.end ();
+  while (i != endPoints.begin () && (i - 1)->first > order)
+    {
+      i--;
+    }
+  endPoints.insert (i, std::make_pair (order, position));
+  m_locals[Tuple (tuple.localAddress, tuple.localPort, Ipv6Address::GetAny (), 0)]++;
+  m_ports[tuple.localPort]++;
+}
+
+bool Ipv6EndPointDemux::RemoveFromIndex (Ipv6EndPoint *endPoint, const Tuple &tuple, EndPointsI &position, uint64_t &order)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  if (IsConnected (tuple))
+    {
+      sgi::hash_map<Tuple, OrderedEndPoints, TupleHash>::iterator connected = m_connected.find (tuple);
+      if (connected == m_connected.end () || !Remove (connected->second, endPoint, position, order))
+        {
+          return false;
+        }
+      if (connected->second.empty ())
+        {
+          m_connected.erase (connected);
+        }
+    }
+  else
+    {
+      sgi::hash_map<uint16_t, OrderedEndPoints>::iterator wildcards = m_wildcards.find (tuple.localPort);
+      if (wildcards == m_wildcards.end () || !Remove (wildcards->second, endPoint, position, order))
+        {
+          return false;
+        }
+      if (wildcards->second.empty ())
+        {
+          m_wildcards.erase (wildcards);
+        }
+    }
+  sgi::hash_map<Tuple, uint32_t, TupleHash>::iterator local =
+    m_locals.find (Tuple (tuple.localAddress, tuple.localPort, Ipv6Address::GetAny (), 0));
+  NS_ASSERT (local != m_locals.end ());
+  if (--local->second == 0)
+    {
+      m_locals.erase (local);
+    }
+  sgi::hash_map<uint16_t, uint32_t>::iterator port = m_ports.find (tuple.localPort);
+  NS_ASSERT (port != m_ports.end ());
+  if (--port->second == 0)
+    {
+      m_ports.erase (port);
+    }
+  return true;
+}
+
+void Ipv6EndPointDemux::Rehash (Ipv6EndPoint *endPoint, Ipv6Address localAddress, Ipv6Address peerAddress, uint16_t peerPort)
+{
+  NS_LOG_FUNCTION (this << endPoint << localAddress << peerAddress << peerPort);
+  EndPointsI position;
+  uint64_t order;
+  if (RemoveFromIndex (endPoint, GetTuple (endPoint), position, order))
+    {
+      AddToIndex (position, Tuple (localAddress, endPoint->GetLocalPort (), peerAddress, peerPort), order);
+    }
+}
+
 } /* namespace ns3 */
 
@@ -23,7 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <utility>
 #include "ns3/ipv6-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv6-interface.h"
 
 namespace ns3 {
@@ -34,6 +37,11 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points connected to a peer are hashed by four-tuple, and the
+ * other end points by local port, so that a lookup does not walk all the
+ * end points of the node.  The end points notify the demux when their
+ * addresses change.
  */
 class Ipv6EndPointDemux
 {
@@ -147,6 +155,119 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief The addresses and ports of an endpoint.
+   */
+  struct Tuple
+  {
+    /**
+     * \brief Constructor.
+     * \param localAddress local address
+     * \param localPort local port
+     * \param peerAddress peer address
+     * \param peerPort peer port
+     */
+    Tuple (Ipv6Address localAddress, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+    /**
+     * \param other another tuple
+     * \return true if the tuples are equal
+     */
+    bool operator== (const Tuple &other) const;
+
+    Ipv6Address localAddress; //!< The local address
+    uint16_t localPort;       //!< The local port
+    Ipv6Address peerAddress;  //!< The peer address
+    uint16_t peerPort;        //!< The peer port
+  };
+
+  /**
+   * \brief Hash function class for the tuples.
+   */
+  struct TupleHash
+  {
+    /**
+     * \param tuple the tuple
+     * \return the hash of the tuple
+     */
+    size_t operator() (const Tuple &tuple) const;
+  };
+
+  /**
+   * \brief Endpoints, with their allocation order, in that order.
+   */
+  typedef std::vector<std::pair<uint64_t, EndPointsI> > OrderedEndPoints;
+
+  /**
+   * \param tuple a tuple
+   * \return true if the tuple has no wildcard, i.e., it is the one of
+   * an endpoint connected to a peer
+   */
+  static bool IsConnected (const Tuple &tuple);
+
+  /**
+   * \param endPoint an endpoint
+   * \return the tuple of the endpoint
+   */
+  static Tuple GetTuple (Ipv6EndPoint *endPoint);
+
+  /**
+   * \param a an endpoint and its allocation order
+   * \param b another endpoint and its allocation order
+   * \return true if the first endpoint was allocated before the other
+   */
+  static bool IsAllocatedBefore (const OrderedEndPoints::value_type &a, const OrderedEndPoints::value_type &b);
+
+  /**
+   * \brief Remove an endpoint from a set of endpoints.
+   * \param endPoints the endpoints
+   * \param endPoint the endpoint to remove
+   * \param position set to the position of the endpoint in the list of
+   * endpoints
+   * \param order set to the allocation order of the endpoint
+   * \return true if the endpoint was found
+   */
+  static bool Remove (OrderedEndPoints &endPoints, Ipv6EndPoint *endPoint, EndPointsI &position, uint64_t &order);
+
+  /**
+   * \brief Add a new endpoint to the demux.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an endpoint to the lookup tables.
+   * \param position the position of the endpoint in the list of endpoints
+   * \param tuple the tuple of the endpoint
+   * \param order the allocation order of the endpoint
+   */
+  void AddToIndex (EndPointsI position, const Tuple &tuple, uint64_t order);
+
+  /**
+   * \brief Remove an endpoint from the lookup tables.
+   * \param endPoint the endpoint
+   * \param tuple the tuple the endpoint was added with
+   * \param position set to the position of the endpoint in the list of
+   * endpoints
+   * \param order set to the allocation order of the endpoint
+   * \return true if the endpoint was found
+   */
+  bool RemoveFromIndex (Ipv6EndPoint *endPoint, const Tuple &tuple, EndPointsI &position, uint64_t &order);
+
+  /**
+   * \brief Move an endpoint in the lookup tables before its addresses change.
+   *
+   * Called by the endpoint.
+   *
+   * \param endPoint the endpoint
+   * \param localAddress the new local address
+   * \param peerAddress the new peer address
+   * \param peerPort the new peer port
+   */
+  void Rehash (Ipv6EndPoint *endPoint, Ipv6Address localAddress, Ipv6Address peerAddress, uint16_t peerPort);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -172,6 +293,32 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The allocation order of the next end point.
+   */
+  uint64_t m_nextOrder;
+
+  /**
+   * \brief The end points connected to a peer, by tuple.
+   */
+  sgi::hash_map<Tuple, OrderedEndPoints, TupleHash> m_connected;
+
+  /**
+   * \brief The other end points, by local port.
+   */
+  sgi::hash_map<uint16_t, OrderedEndPoints> m_wildcards;
+
+  /**
+   * \brief The number of end points by local address and port (the peer
+   * fields of the tuples are wildcards).
+   */
+  sgi::hash_map<Tuple, uint32_t, TupleHash> m_locals;
+
+  /**
+   * \brief The number of end points by local port.
+   */
+  sgi::hash_map<uint16_t, uint32_t> m_ports;
 };
 
 } /* namespace ns3 */
@@ -29,9 +29,12 @@
 #include "ns3/simulator.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
+#include "ns3/gso-tag.h"
+#include "ns3/ipv4-header.h"
 
 #include "tcp-l4-protocol.h"
 #include "tcp-header.h"
+#include "tcp-option-ts.h"
 #include "ipv4-end-point-demux.h"
 #include "ipv6-end-point-demux.h"
 #include "ipv4-end-point.h"
@@ -45,6 +48,7 @@
 #include "rtt-estimator.h"
 
 #include <vector>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -93,6 +97,8 @@ TcpL4Protocol::TcpL4Protocol ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   NS_LOG_LOGIC ("Made a TcpL4Protocol " << this);
+  GsoTag::SetSegmentCallback (Ipv4L3Protocol::PROT_NUMBER, MakeCallback (&TcpL4Protocol::GsoSegmentIpv4));
+  GsoTag::SetCoalesceCallback (Ipv4L3Protocol::PROT_NUMBER, MakeCallback (&TcpL4Protocol::GroCoalesceIpv4));
 }
 
 TcpL4Protocol::~TcpL4Protocol ()
@@ -531,6 +537,241 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
   return IpL4Protocol::RX_OK;
 }
 
+std::list<Ptr<Packet> >
+TcpL4Protocol::GsoSegmentIpv4 (Ptr<const Packet> packet, uint16_t segmentSize)
+{
+  std::list<Ptr<Packet> > segments;
+  Ptr<Packet> payload = packet->Copy ();
+  Ipv4Header ipHeader;
+  payload->RemoveHeader (ipHeader);
+  NS_ASSERT (ipHeader.GetProtocol () == PROT_NUMBER);
+  TcpHeader tcpHeader;
+  payload->RemoveHeader (tcpHeader);
+
+  uint32_t size = payload->GetSize ();
+  uint16_t identification = ipHeader.GetIdentification ();
+  for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+      uint32_t length = std::min<uint32_t> (segmentSize, size - offset);
+      Ptr<Packet> segment = payload->CreateFragment (offset, length);
+
+      TcpHeader header = tcpHeader;
+      header.SetSequenceNumber (tcpHeader.GetSequenceNumber () + SequenceNumber32 (offset));
+      uint8_t flags = tcpHeader.GetFlags ();
+      if (offset + length < size)
+        {
+          flags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+        }
+      if (offset > 0)
+        {
+          flags &= ~TcpHeader::CWR;
+        }
+      header.SetFlags (flags);
+      if (Node::ChecksumEnabled ())
+        {
+          header.EnableChecksums ();
+        }
+      header.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (), PROT_NUMBER);
+      segment->AddHeader (header);
+
+      Ipv4Header ip = ipHeader;
+      ip.SetPayloadSize (segment->GetSize ());
+      ip.SetIdentification (identification++);
+      if (Node::ChecksumEnabled ())
+        {
+          ip.EnableChecksum ();
+        }
+      segment->AddHeader (ip);
+      segments.push_back (segment);
+    }
+  return segments;
+}
+
+/**
+ * \brief A TCP data segment received over IPv4 which may be coalesced
+ */
+struct GroSegment
+{
+  Ipv4Header ipHeader;    //!< The IPv4 header
+  TcpHeader tcpHeader;    //!< The TCP header
+  Ptr<Packet> payload;    //!< The data, without headers
+};
+
+/**
+ * \brief Get the headers and the data of a TCP data segment received over IPv4
+ *
+ * \param packet the packet, starting with the IPv4 header
+ * \param segment the segment
+ * \returns true if the packet is a TCP data segment which may be coalesced
+ */
+static bool
+GroParseIpv4 (Ptr<const Packet> packet, GroSegment &segment)
+{
+  Ptr<Packet> p = packet->Copy ();
+  if (Node::ChecksumEnabled ())
+    {
+      segment.ipHeader.EnableChecksum ();
+    }
+  if (p->RemoveHeader (segment.ipHeader) == 0
+      || segment.ipHeader.GetProtocol () != TcpL4Protocol::PROT_NUMBER
+      || !segment.ipHeader.IsLastFragment () || segment.ipHeader.GetFragmentOffset () != 0
+      || segment.ipHeader.GetPayloadSize () != p->GetSize ()
+      || !segment.ipHeader.IsChecksumOk ())
+    {
+      return false;
+    }
+  if (Node::ChecksumEnabled ())
+    {
+      segment.tcpHeader.EnableChecksums ();
+      segment.tcpHeader.InitializeChecksum (segment.ipHeader.GetSource (), segment.ipHeader.GetDestination (),
+                                            TcpL4Protocol::PROT_NUMBER);
+    }
+  if (p->GetSize () < 20 || p->RemoveHeader (segment.tcpHeader) == 0
+      || !segment.tcpHeader.IsChecksumOk () || p->GetSize () == 0)
+    {
+      return false;
+    }
+  // Only the ACK and PSH flags and the timestamp option are allowed
+  uint8_t flags = segment.tcpHeader.GetFlags ();
+  if ((flags & ~(TcpHeader::ACK | TcpHeader::PSH)) != 0 || (flags & TcpHeader::ACK) == 0)
+    {
+      return false;
+    }
+  uint8_t optionLength = segment.tcpHeader.GetOptionLength ();
+  if (optionLength > 12 || (optionLength > 0 && !segment.tcpHeader.HasOption (TcpOption::TS)))
+    {
+      return false;
+    }
+  segment.payload = p;
+  return true;
+}
+
+/**
+ * \brief Check whether a segment continues the super-segment being built
+ *
+ * \param first the first segment of the super-segment
+ * \param last the last segment of the super-segment
+ * \param size the size of the data of the super-segment
+ * \param segment the segment
+ * \returns true if the segment may be appended to the super-segment
+ */
+static bool
+GroContinues (const GroSegment &first, const GroSegment &last, uint32_t size, const GroSegment &segment)
+{
+  const Ipv4Header &ip = segment.ipHeader;
+  const TcpHeader &tcp = segment.tcpHeader;
+  uint32_t segmentSize = first.payload->GetSize ();
+  if (ip.GetSource () != first.ipHeader.GetSource () || ip.GetDestination () != first.ipHeader.GetDestination ()
+      || ip.GetTos () != first.ipHeader.GetTos () || ip.GetTtl () != first.ipHeader.GetTtl ()
+      || tcp.GetSourcePort () != first.tcpHeader.GetSourcePort ()
+      || tcp.GetDestinationPort () != first.tcpHeader.GetDestinationPort ())
+    {
+      return false; // Another flow
+    }
+  if ((last.tcpHeader.GetFlags () & TcpHeader::PSH) || last.payload->GetSize () != segmentSize
+      || segment.payload->GetSize () > segmentSize
+      || first.ipHeader.GetSerializedSize () + first.tcpHeader.GetSerializedSize () + size
+         + segment.payload->GetSize () > 65535)
+    {
+      return false; // The super-segment is complete
+    }
+  if (tcp.GetSequenceNumber () != first.tcpHeader.GetSequenceNumber () + SequenceNumber32 (size)
+      || tcp.GetAckNumber () != first.tcpHeader.GetAckNumber ()
+      || tcp.GetWindowSize () != first.tcpHeader.GetWindowSize ()
+      || tcp.GetLength () != first.tcpHeader.GetLength ()
+      || tcp.HasOption (TcpOption::TS) != first.tcpHeader.HasOption (TcpOption::TS))
+    {
+      return false;
+    }
+  if (tcp.HasOption (TcpOption::TS))
+    {
+      Ptr<const TcpOptionTS> ts = DynamicCast<const TcpOptionTS> (tcp.GetOption (TcpOption::TS));
+      Ptr<const TcpOptionTS> firstTs = DynamicCast<const TcpOptionTS> (first.tcpHeader.GetOption (TcpOption::TS));
+      if (ts->GetTimestamp () != firstTs->GetTimestamp () || ts->GetEcho () != firstTs->GetEcho ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+std::list<Ptr<Packet> >
+TcpL4Protocol::GroCoalesceIpv4 (const std::list<Ptr<Packet> > &packets)
+{
+  std::list<Ptr<Packet> > coalesced;
+  GroSegment first;       // First segment of the super-segment being built
+  GroSegment last;        // Last segment of the super-segment being built
+  Ptr<Packet> head;       // First packet of the super-segment
+  Ptr<Packet> data;       // Data of the super-segment, once a segment is appended
+  uint32_t size = 0;      // Size of the data of the super-segment
+  std::list<Ptr<Packet> >::const_iterator it = packets.begin ();
+  while (head != 0 || it != packets.end ())
+    {
+      GroSegment segment;
+      bool valid = it != packets.end () && GroParseIpv4 (*it, segment);
+      if (head != 0 && valid && GroContinues (first, last, size, segment))
+        {
+          if (data == 0)
+            { // The super-segment keeps the packet tags of its first segment
+              data = head->Copy ();
+              Ipv4Header ipHeader;
+              data->RemoveHeader (ipHeader);
+              TcpHeader tcpHeader;
+              data->RemoveHeader (tcpHeader);
+            }
+          data->AddAtEnd (segment.payload);
+          size += segment.payload->GetSize ();
+          last = segment;
+          ++it;
+          continue;
+        }
+      if (head != 0)
+        { // The super-segment is complete
+          if (data == 0)
+            {
+              coalesced.push_back (head);
+            }
+          else
+            {
+              TcpHeader tcpHeader = first.tcpHeader;
+              tcpHeader.SetFlags (tcpHeader.GetFlags () | (last.tcpHeader.GetFlags () & TcpHeader::PSH));
+              if (Node::ChecksumEnabled ())
+                {
+                  tcpHeader.EnableChecksums ();
+                }
+              tcpHeader.InitializeChecksum (first.ipHeader.GetSource (), first.ipHeader.GetDestination (), PROT_NUMBER);
+              data->AddHeader (tcpHeader);
+              Ipv4Header ipHeader = first.ipHeader;
+              ipHeader.SetPayloadSize (data->GetSize ());
+              if (Node::ChecksumEnabled ())
+                {
+                  ipHeader.EnableChecksum ();
+                }
+              data->AddHeader (ipHeader);
+              GsoTag gsoTag (first.payload->GetSize ());
+              data->ReplacePacketTag (gsoTag);
+              coalesced.push_back (data);
+            }
+          head = 0;
+          data = 0;
+          continue;
+        }
+      if (valid)
+        { // A super-segment may start with this segment
+          head = *it;
+          first = segment;
+          last = segment;
+          size = segment.payload->GetSize ();
+        }
+      else
+        {
+          coalesced.push_back (*it);
+        }
+      ++it;
+    }
+  return coalesced;
+}
+
 void
 TcpL4Protocol::SendPacketV4 (Ptr<Packet> packet, const TcpHeader &outgoing,
                              const Ipv4Address &saddr, const Ipv4Address &daddr,
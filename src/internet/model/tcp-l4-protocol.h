@@ -22,6 +22,7 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <list>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
@@ -197,6 +198,39 @@ public:
                    const Address &saddr, const Address &daddr,
                    Ptr<NetDevice> oif = 0) const;
 
+  /**
+   * \brief Split an IPv4 super-segment built by a socket with generic
+   * segmentation offload (see TcpSocketBase::GsoMaxSize)
+   *
+   * Each segment gets a copy of the IPv4 and TCP headers, with its own
+   * sequence number, IPv4 payload size and identification.  Only the
+   * last segment keeps the FIN and PSH flags, only the first one the CWR flag.
+   * This function is registered with GsoTag::SetSegmentCallback for IPv4.
+   *
+   * \param packet the super-segment, starting with the IPv4 header
+   * \param segmentSize the payload size of the segments
+   * \returns the segments, starting with the IPv4 header
+   */
+  static std::list<Ptr<Packet> > GsoSegmentIpv4 (Ptr<const Packet> packet, uint16_t segmentSize);
+
+  /**
+   * \brief Coalesce the TCP segments received together over IPv4
+   * (generic receive offload)
+   *
+   * The consecutive data segments of a flow, in sequence, with the same
+   * acknowledgment, window and options and without other flag than ACK
+   * and PSH, are coalesced into a super-segment tagged with a GsoTag
+   * giving the size of the segments.  The super-segment keeps the
+   * headers and the packet tags of its first segment; a segment with
+   * the PSH flag or smaller than the first one ends it.  The other
+   * packets are passed up unchanged, in order.  This function is
+   * registered with GsoTag::SetCoalesceCallback for IPv4.
+   *
+   * \param packets the packets received, starting with the IPv4 header
+   * \returns the packets to pass up, starting with the IPv4 header
+   */
+  static std::list<Ptr<Packet> > GroCoalesceIpv4 (const std::list<Ptr<Packet> > &packets);
+
   /**
    * \brief Make a socket fully operational
    *
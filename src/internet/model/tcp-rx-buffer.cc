@@ -52,7 +52,8 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0),
+    m_lastRxSeq (n)
 {
 }
 
@@ -156,8 +157,13 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet. The buffered packets do not
+  // overlap, so the search starts from the last one beginning at headSeq
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -196,21 +202,17 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   // Insert packet into buffer
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
   m_data [ headSeq ] = p;
+  m_lastRxSeq = headSeq;
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
-    {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+  AddRange (headSeq, tailSeq);
+  RangeMap::iterator first = m_ranges.begin ();
+  if (first->first == m_nextRxSeq)
+    { // The data is now contiguous up to the end of the first range
+      m_availBytes += first->second - first->first;
+      m_nextRxSeq = first->second;
+      m_ranges.erase (first);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -265,4 +267,74 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   return outPkt;
 }
 
+void
+TcpRxBuffer::AddRange (SequenceNumber32 head, SequenceNumber32 tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+
+  RangeMap::iterator it = m_ranges.upper_bound (head);
+  if (it != m_ranges.begin ())
+    {
+      RangeMap::iterator prev = it;
+      --prev;
+      if (prev->second >= head)
+        { // Merge with the previous range
+          head = prev->first;
+          if (prev->second > tail)
+            {
+              tail = prev->second;
+            }
+          m_ranges.erase (prev);
+        }
+    }
+  while (it != m_ranges.end () && it->first <= tail)
+    { // Merge with the following ranges
+      if (it->second > tail)
+        {
+          tail = it->second;
+        }
+      m_ranges.erase (it++);
+    }
+  m_ranges[head] = tail;
+}
+
+TcpOptionSack::SackList
+TcpRxBuffer::GetSackList (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+
+  TcpOptionSack::SackList blocks;
+  if (maxBlocks == 0 || m_ranges.empty ())
+    {
+      return blocks;
+    }
+  // The first block reports the most recently received segment
+  RangeMap::const_iterator last = m_ranges.upper_bound (m_lastRxSeq);
+  if (last != m_ranges.begin ())
+    {
+      --last;
+      if (m_lastRxSeq < last->second)
+        {
+          blocks.push_back (TcpOptionSack::SackBlock (last->first, last->second));
+        }
+      else
+        {
+          last = m_ranges.end ();
+        }
+    }
+  else
+    {
+      last = m_ranges.end ();
+    }
+  for (RangeMap::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end () && blocks.size () < maxBlocks; ++it)
+    {
+      if (it != last)
+        {
+          blocks.push_back (TcpOptionSack::SackBlock (it->first, it->second));
+        }
+    }
+  return blocks;
+}
+
 } //namepsace ns3
@@ -27,6 +27,7 @@
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +37,12 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The data is kept in packets indexed by their first sequence number.
+ * The out-of-order data is also described by the list of the disjoint
+ * ranges of sequence numbers it covers, which are merged as segments
+ * arrive: a segment is inserted, and the next expected sequence number
+ * advanced over the data it makes contiguous, in logarithmic time.
  */
 class TcpRxBuffer : public Object
 {
@@ -125,16 +132,40 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the SACK blocks of the out-of-order data, as in \RFC{2018}
+   *
+   * The blocks are the contiguous ranges of data held above the next
+   * expected sequence number.  The first block contains the most recently
+   * received segment, the others follow in sequence order.
+   *
+   * \param maxBlocks the maximum number of blocks to return
+   * \returns the SACK blocks
+   */
+  TcpOptionSack::SackList GetSackList (uint32_t maxBlocks) const;
+
 private:
+  /**
+   * \brief Add a range of sequence numbers to the out-of-order ranges,
+   * merging it with the ranges it overlaps or touches
+   * \param head the first sequence number of the range
+   * \param tail the sequence number following the range
+   */
+  void AddRange (SequenceNumber32 head, SequenceNumber32 tail);
+
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /// The ranges of out-of-order data, from their first sequence number to the one following them
+  typedef std::map<SequenceNumber32, SequenceNumber32> RangeMap;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
+  SequenceNumber32 m_lastRxSeq;              //!< Seqnum of the first byte of the most recently buffered segment
   std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  RangeMap m_ranges;                         //!< The disjoint ranges of data above m_nextRxSeq
 };
 
 } //namepsace ns3
@@ -40,6 +40,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
+#include "ns3/gso-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -49,6 +50,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 
@@ -98,6 +101,16 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable the SACK option and SACK-based loss recovery",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("GsoMaxSize",
+                   "Maximum payload of the super-segments handed to IPv4 with generic "
+                   "segmentation offload (GSO), 0 to send each segment separately",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpSocketBase::m_gsoMaxSize),
+                   MakeUintegerChecker<uint32_t> (0, 65000))
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -311,6 +324,8 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_gsoMaxSize (0),
     m_sendPendingDataEvent (),
     // Set m_recover to the initial sequence number
     m_recover (0),
@@ -389,6 +404,8 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_gsoMaxSize (sock.m_gsoMaxSize),
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
@@ -1253,6 +1270,12 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      // SACK is used only if both ends sent the SACK-permitted option
+      if (!tcpHeader.HasOption (TcpOption::SACKPERMITTED))
+        {
+          m_sackEnabled = false;
+        }
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1463,6 +1486,29 @@ TcpSocketBase::FastRetransmit ()
 
   m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb,
                                                         BytesInFlight ());
+
+  if (m_sackEnabled)
+    {
+      // RFC 6675: retransmit the first lost segment regardless of the
+      // pipe, then send as the pipe allows
+      m_tcb->m_cWnd = m_tcb->m_ssThresh;
+      m_txBuffer->MarkHeadLost ();
+
+      NS_LOG_INFO (m_dupAckCount << " dupack. Enter SACK recovery mode." <<
+                   "Reset cwnd to " << m_tcb->m_cWnd << ", ssthresh to " <<
+                   m_tcb->m_ssThresh << " at fast recovery seqnum " << m_recover);
+
+      SequenceNumber32 seq;
+      uint32_t size;
+      if (m_txBuffer->NextLost (seq, size))
+        {
+          SendDataPacket (seq, size, true);
+          ++m_retransOut;
+        }
+      SendPendingData (m_connected);
+      return;
+    }
+
   m_tcb->m_cWnd = m_tcb->m_ssThresh + m_dupAckCount * m_tcb->m_segmentSize;
 
   NS_LOG_INFO (m_dupAckCount << " dupack. Enter fast recovery mode." <<
@@ -1504,6 +1550,14 @@ TcpSocketBase::DupAck ()
           LimitedTransmit ();
         }
     }
+  else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY && m_sackEnabled)
+    { // The pipe accounts for the SACKed data: no cwnd inflation (RFC 6675)
+      SendPendingData (m_connected);
+    }
+  else if (m_tcb->m_congState == TcpSocketState::CA_LOSS && m_sackEnabled)
+    { // Keep retransmitting the segments marked lost on timeout
+      SendPendingData (m_connected);
+    }
   else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
       m_tcb->m_cWnd += m_tcb->m_segmentSize;
@@ -1533,6 +1587,11 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
   m_tcb->m_lastAckedSeq = ackNumber;
 
+  if (m_sackEnabled && ackNumber >= m_txBuffer->HeadSequence ())
+    {
+      ProcessSackAck (tcpHeader);
+    }
+
   if (ackNumber == m_txBuffer->HeadSequence ()
       && ackNumber < m_tcb->m_nextTxSequence
       && packet->GetSize () == 0)
@@ -1602,7 +1661,33 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
       else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
         {
-          if (ackNumber < m_recover)
+          if (ackNumber < m_recover && m_sackEnabled)
+            {
+              /* Partial ACK with SACK (RFC 6675). The scoreboard already
+               * knows which segments are lost: they are retransmitted by
+               * SendPendingData as the pipe allows, without any change of
+               * the congestion window.
+               */
+              callCongestionControl = false;
+              m_txBuffer->DiscardUpTo (ackNumber);
+
+              if (m_isFirstPartialAck)
+                {
+                  m_isFirstPartialAck = false;
+                }
+              else
+                {
+                  resetRTO = false;
+                }
+
+              m_congestionControl->PktsAcked (m_tcb, 1, m_lastRtt);
+
+              NS_LOG_INFO ("Partial ACK for seq " << ackNumber <<
+                           " in SACK recovery: pipe " << BytesInFlight () <<
+                           " cwnd " << m_tcb->m_cWnd <<
+                           " recover seq: " << m_recover);
+            }
+          else if (ackNumber < m_recover)
             {
               /* Partial ACK.
                * In case of partial ACK, retransmit the first unacknowledged
@@ -2250,6 +2335,11 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
           AddOptionWScale (header);
         }
 
+      if (m_sackEnabled)
+        {
+          AddOptionSackPermitted (header);
+        }
+
       if (m_synCount == 0)
         { // No more connection retries, give up
           NS_LOG_LOGIC ("Connection failed.");
@@ -2519,6 +2609,12 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->ReplacePacketTag (priorityTag);
     }
 
+  if (sz > m_tcb->m_segmentSize)
+    {
+      GsoTag gsoTag (m_tcb->m_segmentSize);
+      p->ReplacePacketTag (gsoTag);
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -2588,6 +2684,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   UpdateRttHistory (seq, sz, isRetransmission);
 
+  if (m_sackEnabled)
+    {
+      m_txBuffer->MarkSent (seq, sz);
+    }
+
   // Notify the application of the data being sent unless this is a retransmit
   if (seq + sz > m_tcb->m_highTxMark)
     {
@@ -2641,6 +2742,24 @@ TcpSocketBase::SendPendingData (bool withAck)
       return false; // Is this the right way to handle this condition?
     }
   uint32_t nPacketsSent = 0;
+  if (m_sackEnabled)
+    {
+      // Retransmit the segments marked lost by the scoreboard first (RFC 6675 NextSeg)
+      SequenceNumber32 seq;
+      uint32_t size;
+      while (m_txBuffer->NextLost (seq, size))
+        {
+          size = std::min (size, m_tcb->m_segmentSize);
+          if (m_txBuffer->BytesInFlight () + size > m_tcb->m_cWnd)
+            {
+              break;
+            }
+          NS_LOG_DEBUG ("Retransmitting lost segment " << seq << " size " << size);
+          SendDataPacket (seq, size, withAck);
+          ++m_retransOut;
+          nPacketsSent++;
+        }
+    }
   while (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence))
     {
       uint32_t w = AvailableWindow (); // Get available window size
@@ -2672,6 +2791,12 @@ TcpSocketBase::SendPendingData (bool withAck)
                     " unAck: " << UnAckDataCount ());
 
       uint32_t s = std::min (w, m_tcb->m_segmentSize);  // Send no more than window
+      if (m_gsoMaxSize >= 2 * m_tcb->m_segmentSize && m_endPoint != 0 && w >= 2 * m_tcb->m_segmentSize)
+        {
+          // GSO: a super-segment of whole segments, split below the IP layer
+          s = std::min (w, m_gsoMaxSize);
+          s -= s % m_tcb->m_segmentSize;
+        }
       uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_tcb->m_nextTxSequence += sz;                     // Advance next tx sequence
@@ -2704,7 +2829,12 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled)
+    {
+      // With SACK, the scoreboard knows the pipe (RFC 6675)
+      bytesInFlight = m_txBuffer->BytesInFlight ();
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -2739,6 +2869,16 @@ TcpSocketBase::AvailableWindow () const
   uint32_t unack = UnAckDataCount (); // Number of outstanding bytes
   uint32_t win = Window ();           // Number of bytes allowed to be outstanding
 
+  if (m_sackEnabled)
+    {
+      // The congestion window limits the pipe, the receiver window the outstanding data
+      uint32_t pipe = m_txBuffer->BytesInFlight ();
+      uint32_t cWndAvail = (m_tcb->m_cWnd < pipe) ? 0 : (m_tcb->m_cWnd.Get () - pipe);
+      uint32_t rWndAvail = (m_rWnd < unack) ? 0 : (m_rWnd.Get () - unack);
+      NS_LOG_DEBUG ("UnAckCount=" << unack << ", Pipe=" << pipe << ", Win=" << win);
+      return std::min (cWndAvail, rWndAvail);
+    }
+
   NS_LOG_DEBUG ("UnAckCount=" << unack << ", Win=" << win);
   return (win < unack) ? 0 : (win - unack);
 }
@@ -2770,12 +2910,60 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
   NS_LOG_DEBUG ("Data segment, seq=" << tcpHeader.GetSequenceNumber () <<
                 " pkt size=" << p->GetSize () );
 
+  SequenceNumber32 expectedSeq = m_rxBuffer->NextRxSequence ();
+  GsoTag gsoTag;
+  if (p->RemovePacketTag (gsoTag) && p->GetSize () > gsoTag.GetSegmentSize ())
+    { // Segments coalesced on receive: they are added one at a time, to
+      // acknowledge them as if they had been received separately
+      NS_LOG_LOGIC ("Coalesced segments of size " << gsoTag.GetSegmentSize ());
+      TcpHeader header = tcpHeader;
+      uint32_t size = p->GetSize ();
+      for (uint32_t offset = 0; offset < size; offset += gsoTag.GetSegmentSize ())
+        {
+          header.SetSequenceNumber (tcpHeader.GetSequenceNumber () + SequenceNumber32 (offset));
+          uint32_t length = std::min<uint32_t> (gsoTag.GetSegmentSize (), size - offset);
+          if (!AddRxData (p->CreateFragment (offset, length), header))
+            {
+              break;
+            }
+        }
+    }
+  else if (!AddRxData (p, tcpHeader))
+    {
+      return;
+    }
+  // Notify app to receive if necessary
+  if (expectedSeq < m_rxBuffer->NextRxSequence ())
+    { // NextRxSeq advanced, we have something to send to the app
+      if (!m_shutdownRecv)
+        {
+          NotifyDataRecv ();
+        }
+      // Handle exceptions
+      if (m_closeNotified)
+        {
+          NS_LOG_WARN ("Why TCP " << this << " got data after close notification?");
+        }
+      // If we received FIN before and now completed all "holes" in rx buffer,
+      // invoke peer close procedure
+      if (m_rxBuffer->Finished () && (tcpHeader.GetFlags () & TcpHeader::FIN) == 0)
+        {
+          DoPeerClose ();
+        }
+    }
+}
+
+bool
+TcpSocketBase::AddRxData (Ptr<Packet> p, const TcpHeader& tcpHeader)
+{
+  NS_LOG_FUNCTION (this << tcpHeader);
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer->NextRxSequence ();
   if (!m_rxBuffer->Add (p, tcpHeader))
     { // Insert failed: No data or RX buffer full
       SendEmptyPacket (TcpHeader::ACK);
-      return;
+      return false;
     }
   // Now send a new ACK packet acknowledging all received and delivered data
   if (m_rxBuffer->Size () > m_rxBuffer->Available () || m_rxBuffer->NextRxSequence () > expectedSeq + p->GetSize ())
@@ -2798,25 +2986,7 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
                         (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
         }
     }
-  // Notify app to receive if necessary
-  if (expectedSeq < m_rxBuffer->NextRxSequence ())
-    { // NextRxSeq advanced, we have something to send to the app
-      if (!m_shutdownRecv)
-        {
-          NotifyDataRecv ();
-        }
-      // Handle exceptions
-      if (m_closeNotified)
-        {
-          NS_LOG_WARN ("Why TCP " << this << " got data after close notification?");
-        }
-      // If we received FIN before and now completed all "holes" in rx buffer,
-      // invoke peer close procedure
-      if (m_rxBuffer->Finished () && (tcpHeader.GetFlags () & TcpHeader::FIN) == 0)
-        {
-          DoPeerClose ();
-        }
-    }
+  return true;
 }
 
 /**
@@ -3058,6 +3228,12 @@ TcpSocketBase::Retransmit ()
       m_tcb->m_cWnd = m_tcb->m_segmentSize;
     }
 
+  if (m_sackEnabled)
+    {
+      // The receiver may have reneged on the SACKed data: forget the
+      // scoreboard and retransmit everything (RFC 2018 sec. 8)
+      m_txBuffer->ResetScoreboard ();
+    }
   m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
   m_dupAckCount = 0;
 
@@ -3125,6 +3301,7 @@ TcpSocketBase::CancelAllTimers ()
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_rackEvent.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3307,6 +3484,11 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled && !(header.GetFlags () & TcpHeader::SYN))
+    {
+      AddOptionSack (header);
+    }
 }
 
 void
@@ -3406,6 +3588,94 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+  NS_ASSERT (header.GetFlags () & TcpHeader::SYN);
+
+  Ptr<TcpOptionSackPermitted> option = CreateObject<TcpOptionSackPermitted> ();
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK-PERMITTED");
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  // The kind and length take 2 bytes, each block 8 bytes
+  uint8_t space = header.GetMaxOptionLength () - header.GetOptionLength ();
+  if (space < 10)
+    {
+      return;
+    }
+  TcpOptionSack::SackList list = m_rxBuffer->GetSackList ((space - 2) / 8);
+  if (list.empty ())
+    {
+      return;
+    }
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      option->AddSackBlock (*it);
+    }
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK, blocks=" << option->GetNumSackBlocks ());
+}
+
+void
+TcpSocketBase::ProcessSackAck (const TcpHeader& tcpHeader)
+{
+  NS_LOG_FUNCTION (this << tcpHeader);
+
+  TcpOptionSack::SackList list;
+  if (tcpHeader.HasOption (TcpOption::SACK))
+    {
+      Ptr<const TcpOptionSack> option = DynamicCast<const TcpOptionSack> (tcpHeader.GetOption (TcpOption::SACK));
+      list = option->GetSackList ();
+    }
+  m_txBuffer->Update (list, tcpHeader.GetAckNumber ());
+  DetectLosses ();
+}
+
+void
+TcpSocketBase::DetectLosses (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time timeout;
+  m_txBuffer->DetectLosses (m_retxThresh, m_tcb->m_segmentSize, timeout);
+  m_rackEvent.Cancel ();
+  if (!timeout.IsZero ())
+    {
+      m_rackEvent = Simulator::Schedule (timeout, &TcpSocketBase::RackTimeout, this);
+    }
+
+  // A lost segment starts the recovery, without waiting for the third dupack
+  if (m_txBuffer->GetLostBytes () > 0
+      && (m_tcb->m_congState == TcpSocketState::CA_OPEN
+          || m_tcb->m_congState == TcpSocketState::CA_DISORDER))
+    {
+      NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
+                    " -> RECOVERY");
+      FastRetransmit ();
+    }
+}
+
+void
+TcpSocketBase::RackTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == CLOSED || m_state == TIME_WAIT)
+    {
+      return;
+    }
+  DetectLosses ();
+  SendPendingData (m_connected);
+}
+
 void TcpSocketBase::UpdateWindowSize (const TcpHeader &header)
 {
   NS_LOG_FUNCTION (this << header);
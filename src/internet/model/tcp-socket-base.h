@@ -835,6 +835,19 @@ protected:
    */
   virtual void ReceivedData (Ptr<Packet> packet, const TcpHeader& tcpHeader);
 
+  /**
+   * \brief Put a segment into the Rx buffer and acknowledge it, now or
+   * with a delayed ACK
+   *
+   * Segments coalesced on receive are added one at a time, so that they
+   * are acknowledged as if they had been received separately.
+   *
+   * \param packet the data of the segment
+   * \param tcpHeader the segment's TCP header
+   * \returns false if the Rx buffer did not take the segment
+   */
+  bool AddRxData (Ptr<Packet> packet, const TcpHeader& tcpHeader);
+
   /**
    * \brief Take into account the packet for RTT estimation
    * \param tcpHeader the packet's TCP header
@@ -963,6 +976,38 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK-permitted option to the header of a SYN segment
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSackPermitted (TcpHeader& header);
+  /**
+   * \brief Add the SACK option to the header
+   *
+   * The option reports the out-of-order data of the Rx buffer, with as
+   * many blocks as the space left by the other options allows.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+  /**
+   * \brief Update the SACK scoreboard with an incoming ACK and mark the lost segments
+   *
+   * \param tcpHeader the header of the ACK
+   */
+  void ProcessSackAck (const TcpHeader& tcpHeader);
+  /**
+   * \brief Mark the lost segments of the scoreboard, and arm the RACK
+   * reordering timer if some segments may be marked lost later
+   */
+  void DetectLosses (void);
+  /**
+   * \brief The RACK reordering timer expired: mark the lost segments and
+   * start their retransmission
+   */
+  void RackTimeout (void);
+
   /**
    * \brief Performs a safe subtraction between a and b (a-b)
    *
@@ -981,6 +1026,7 @@ protected:
   EventId           m_delAckEvent;     //!< Delayed ACK timeout event
   EventId           m_persistEvent;    //!< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent;   //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+  EventId           m_rackEvent;       //!< RACK reordering timeout event
   uint32_t          m_dupAckCount;     //!< Dupack counter
   uint32_t          m_delAckCount;     //!< Delayed ACK counter
   uint32_t          m_delAckMaxCount;  //!< Number of packet to fire an ACK before delay timeout
@@ -1039,6 +1085,9 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool     m_sackEnabled;         //!< SACK option enabled (RFC 2018)
+  uint32_t m_gsoMaxSize;          //!< Maximum payload of the GSO super-segments, 0 if GSO is disabled
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
   // Fast Retransmit and Recovery
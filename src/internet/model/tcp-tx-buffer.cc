@@ -25,6 +25,7 @@
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include "tcp-tx-buffer.h"
 
@@ -34,6 +35,9 @@ NS_LOG_COMPONENT_DEFINE ("TcpTxBuffer");
 
 NS_OBJECT_ENSURE_REGISTERED (TcpTxBuffer);
 
+/// The maximum size of a packet built by merging the packets written by the application
+#define TCP_TX_BUFFER_MERGE_SIZE 4096
+
 TypeId
 TcpTxBuffer::GetTypeId (void)
 {
@@ -57,7 +61,9 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768),
+    m_headOffset (0), m_nRemoved (0), m_cursor (0), m_extractedEnd (0), m_tailMerged (false),
+    m_sentOut (0), m_sackedOut (0), m_lostOut (0), m_rackEndSeq (0)
 {
 }
 
@@ -111,7 +117,27 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          if (!m_data.empty () && m_data.back ().m_offset >= m_extractedEnd
+              && m_data.back ().m_packet->GetSize () + p->GetSize () <= TCP_TX_BUFFER_MERGE_SIZE)
+            { // Merge the packet into the last one, which the buffer owns once merged
+              TcpTxChunk &tail = m_data.back ();
+              if (!m_tailMerged)
+                {
+                  Ptr<Packet> merged = Create<Packet> ();
+                  merged->AddAtEnd (tail.m_packet);
+                  tail.m_packet = merged;
+                  m_tailMerged = true;
+                }
+              tail.m_packet->AddAtEnd (p);
+            }
+          else
+            {
+              TcpTxChunk chunk;
+              chunk.m_offset = m_headOffset + m_size;
+              chunk.m_packet = p;
+              m_data.push_back (chunk);
+              m_tailMerged = false;
+            }
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -148,59 +174,87 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
+  uint64_t offset = m_headOffset + (seq - m_firstByteSeq.Get ());
+  uint64_t end = offset + s;
+  uint32_t i = FindChunk (offset);
+  const TcpTxChunk *chunk = &m_data[i];
+  uint32_t packetOffset = offset - chunk->m_offset;
+  uint32_t fragmentLength = std::min<uint64_t> (chunk->m_packet->GetSize () - packetOffset, s);
+  NS_LOG_LOGIC ("First byte found in packet #" << i << " at buffer offset " << chunk->m_offset - m_headOffset
+                                               << ", packet len=" << chunk->m_packet->GetSize ());
   Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  if (fragmentLength < s)
+    { // The segment spans several packets: they are appended to a new
+      // packet, which owns its buffer and can grow it in place
+      outPacket = Create<Packet> ();
+      outPacket->AddAtEnd (chunk->m_packet->CreateFragment (packetOffset, fragmentLength));
+    }
+  else if (packetOffset == 0 && fragmentLength == chunk->m_packet->GetSize ())
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
-        { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+      outPacket = chunk->m_packet->Copy ();
+    }
+  else
+    {
+      outPacket = chunk->m_packet->CreateFragment (packetOffset, fragmentLength);
+    }
+  while (chunk->m_offset + chunk->m_packet->GetSize () < end)
+    {
+      chunk = &m_data[++i];
+      fragmentLength = std::min<uint64_t> (chunk->m_packet->GetSize (), end - chunk->m_offset);
+      NS_LOG_LOGIC ("Appending " << fragmentLength << " bytes of packet #" << i);
+      if (fragmentLength == chunk->m_packet->GetSize ())
+        {
+          outPacket->AddAtEnd (chunk->m_packet);
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (chunk->m_packet->CreateFragment (0, fragmentLength));
         }
-      count += pktSize;
     }
+  // The next segment usually starts where this one ends
+  m_extractedEnd = std::max (m_extractedEnd, end);
+  m_cursor = m_nRemoved + i;
+  if (chunk->m_offset + chunk->m_packet->GetSize () == end)
+    {
+      ++m_cursor;
+    }
+  NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
 }
 
+uint32_t
+TcpTxBuffer::FindChunk (uint64_t offset) const
+{
+  NS_ASSERT (!m_data.empty ());
+  NS_ASSERT (m_data.front ().m_offset <= offset);
+  NS_ASSERT (offset < m_headOffset + m_size);
+  if (m_cursor >= m_nRemoved && m_cursor - m_nRemoved < m_data.size ())
+    {
+      uint32_t i = m_cursor - m_nRemoved;
+      if (m_data[i].m_offset <= offset && offset < m_data[i].m_offset + m_data[i].m_packet->GetSize ())
+        {
+          return i;
+        }
+    }
+  // Binary search of the last packet starting at or before the offset
+  uint32_t low = 0;
+  uint32_t high = m_data.size ();
+  while (high - low > 1)
+    {
+      uint32_t mid = low + (high - low) / 2;
+      if (m_data[mid].m_offset <= offset)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+  return low;
+}
+
 void
 TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 {
@@ -217,40 +271,315 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
+  // Number of bytes to remove, the FIN being acknowledged after the last byte
+  uint32_t offset = std::min<uint32_t> (seq - m_firstByteSeq.Get (), m_size);
+  uint64_t headOffset = m_headOffset + offset;
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  // Release the packets behind the seqnum
+  while (!m_data.empty () && m_data.front ().m_offset + m_data.front ().m_packet->GetSize () <= headOffset)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
-        }
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.front ().m_packet->GetSize ());
+      m_data.pop_front ();
+      ++m_nRemoved;
     }
-  // Catching the case of ACKing a FIN
-  if (m_size == 0)
+  // A packet partly behind the seqnum is kept whole: the segments are
+  // fragments of it anyway, and fragments of fragments of a packet made of
+  // several writes trip the packet metadata
+  m_size -= offset;
+  m_headOffset += seq - m_firstByteSeq.Get ();
+  m_firstByteSeq = seq;
+  // Acknowledged segments leave the scoreboard
+  if (!m_scoreboard.empty ())
     {
-      m_firstByteSeq = seq;
+      Update (TcpOptionSack::SackList (), seq);
     }
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
                         <<" numPkts="<< m_data.size ());
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+void
+TcpTxBuffer::MarkSent (const SequenceNumber32& seq, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << seq << size);
+  if (size == 0)
+    {
+      return;
+    }
+  SequenceNumber32 end = seq + SequenceNumber32 (size);
+  SplitAt (seq);
+  SplitAt (end);
+
+  // Data already in the scoreboard is being retransmitted
+  bool retrans = false;
+  Scoreboard::iterator it = m_scoreboard.lower_bound (seq);
+  while (it != m_scoreboard.end () && it->first < end)
+    {
+      retrans = true;
+      Account (it->second, false);
+      m_scoreboard.erase (it++);
+    }
+
+  TcpTxSegment segment;
+  segment.m_size = size;
+  segment.m_lastSent = Simulator::Now ();
+  segment.m_sacked = false;
+  segment.m_lost = false;
+  segment.m_retrans = retrans;
+  m_scoreboard[seq] = segment;
+  Account (segment, true);
+}
+
+uint32_t
+TcpTxBuffer::Update (const TcpOptionSack::SackList& list, const SequenceNumber32& ack)
+{
+  NS_LOG_FUNCTION (this << ack);
+
+  // Remove the cumulatively acknowledged segments
+  SplitAt (ack);
+  Scoreboard::iterator it = m_scoreboard.begin ();
+  while (it != m_scoreboard.end () && it->first < ack)
+    {
+      if (!it->second.m_sacked)
+        {
+          RackUpdate (it->second, it->first + SequenceNumber32 (it->second.m_size));
+        }
+      Account (it->second, false);
+      m_scoreboard.erase (it++);
+    }
+
+  // Mark the SACKed segments
+  uint32_t newlySacked = 0;
+  for (TcpOptionSack::SackList::const_iterator block = list.begin (); block != list.end (); ++block)
+    {
+      SequenceNumber32 left = std::max (block->first, ack);
+      SequenceNumber32 right = block->second;
+      if (right <= left)
+        {
+          continue; // D-SACK or block below the cumulative ACK
+        }
+      SplitAt (left);
+      SplitAt (right);
+      for (it = m_scoreboard.lower_bound (left); it != m_scoreboard.end () && it->first < right; ++it)
+        {
+          if (it->second.m_sacked)
+            {
+              continue;
+            }
+          RackUpdate (it->second, it->first + SequenceNumber32 (it->second.m_size));
+          Account (it->second, false);
+          it->second.m_sacked = true;
+          it->second.m_lost = false;
+          Account (it->second, true);
+          newlySacked += it->second.m_size;
+        }
+    }
+  NS_LOG_LOGIC ("Newly SACKed " << newlySacked << " sacked " << m_sackedOut <<
+                " lost " << m_lostOut << " in flight " << BytesInFlight ());
+  return newlySacked;
+}
+
+uint32_t
+TcpTxBuffer::DetectLosses (uint32_t dupThresh, uint32_t segmentSize, Time &timeout)
+{
+  NS_LOG_FUNCTION (this << dupThresh << segmentSize);
+  timeout = Time (0);
+  uint32_t newlyLost = 0;
+
+  // RFC 6675: more than (DupThresh - 1) * SMSS bytes SACKed above the segment
+  uint32_t threshold = (dupThresh - 1) * segmentSize;
+  if (m_sackedOut > threshold)
+    {
+      uint32_t sackedAbove = 0;
+      for (Scoreboard::reverse_iterator it = m_scoreboard.rbegin (); it != m_scoreboard.rend (); ++it)
+        {
+          if (it->second.m_sacked)
+            {
+              sackedAbove += it->second.m_size;
+            }
+          else if (!it->second.m_lost && !it->second.m_retrans && sackedAbove > threshold)
+            {
+              Account (it->second, false);
+              it->second.m_lost = true;
+              Account (it->second, true);
+              newlyLost += it->second.m_size;
+            }
+        }
+    }
+
+  // RACK: a segment sent before the most recently sent delivered one is
+  // lost once the reordering window has elapsed after its expected delivery
+  if (m_rackRtt.IsStrictlyPositive ())
+    {
+      Time reoWnd = m_rackMinRtt / 4;
+      Time now = Simulator::Now ();
+      for (Scoreboard::iterator it = m_scoreboard.begin (); it != m_scoreboard.end (); ++it)
+        {
+          TcpTxSegment &segment = it->second;
+          if (segment.m_sacked || segment.m_lost)
+            {
+              continue;
+            }
+          SequenceNumber32 endSeq = it->first + SequenceNumber32 (segment.m_size);
+          if (segment.m_lastSent > m_rackXmitTime
+              || (segment.m_lastSent == m_rackXmitTime && endSeq > m_rackEndSeq))
+            {
+              continue; // Sent after the most recently delivered segment
+            }
+          Time left = segment.m_lastSent + m_rackRtt + reoWnd - now;
+          if (!left.IsStrictlyPositive ())
+            {
+              Account (segment, false);
+              segment.m_lost = true;
+              Account (segment, true);
+              newlyLost += segment.m_size;
+            }
+          else if (timeout.IsZero () || left < timeout)
+            {
+              timeout = left;
+            }
+        }
+    }
+
+  NS_LOG_LOGIC ("Newly lost " << newlyLost << " lost " << m_lostOut <<
+                " reordering timeout " << timeout);
+  return newlyLost;
+}
+
+void
+TcpTxBuffer::MarkHeadLost (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_scoreboard.empty ())
+    {
+      return;
+    }
+  TcpTxSegment &segment = m_scoreboard.begin ()->second;
+  if (!segment.m_sacked && !segment.m_lost)
+    {
+      Account (segment, false);
+      segment.m_lost = true;
+      Account (segment, true);
+    }
+}
+
+void
+TcpTxBuffer::ResetScoreboard (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_scoreboard.clear ();
+  m_sentOut = 0;
+  m_sackedOut = 0;
+  m_lostOut = 0;
+}
+
+bool
+TcpTxBuffer::NextLost (SequenceNumber32 &seq, uint32_t &size) const
+{
+  if (m_lostOut == 0)
+    {
+      return false;
+    }
+  for (Scoreboard::const_iterator it = m_scoreboard.begin (); it != m_scoreboard.end (); ++it)
+    {
+      if (it->second.m_lost)
+        {
+          seq = it->first;
+          size = it->second.m_size;
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+TcpTxBuffer::IsSacked (const SequenceNumber32& seq) const
+{
+  Scoreboard::const_iterator it = m_scoreboard.upper_bound (seq);
+  if (it == m_scoreboard.begin ())
+    {
+      return false;
+    }
+  --it;
+  return it->second.m_sacked && seq < it->first + SequenceNumber32 (it->second.m_size);
+}
+
+uint32_t
+TcpTxBuffer::GetSackedBytes (void) const
+{
+  return m_sackedOut;
+}
+
+uint32_t
+TcpTxBuffer::GetLostBytes (void) const
+{
+  return m_lostOut;
+}
+
+uint32_t
+TcpTxBuffer::BytesInFlight (void) const
+{
+  return m_sentOut - m_sackedOut - m_lostOut;
+}
+
+void
+TcpTxBuffer::SplitAt (const SequenceNumber32& seq)
+{
+  Scoreboard::iterator it = m_scoreboard.upper_bound (seq);
+  if (it == m_scoreboard.begin ())
+    {
+      return;
+    }
+  --it;
+  if (it->first == seq || it->first + SequenceNumber32 (it->second.m_size) <= seq)
+    {
+      return;
+    }
+  // Both parts keep the state of the segment, the counters do not change
+  TcpTxSegment tail = it->second;
+  it->second.m_size = seq - it->first;
+  tail.m_size -= it->second.m_size;
+  m_scoreboard[seq] = tail;
+}
+
+void
+TcpTxBuffer::Account (const TcpTxSegment& segment, bool add)
+{
+  uint32_t sacked = segment.m_sacked ? segment.m_size : 0;
+  uint32_t lost = (segment.m_lost && !segment.m_sacked) ? segment.m_size : 0;
+  if (add)
+    {
+      m_sentOut += segment.m_size;
+      m_sackedOut += sacked;
+      m_lostOut += lost;
+    }
+  else
+    {
+      m_sentOut -= segment.m_size;
+      m_sackedOut -= sacked;
+      m_lostOut -= lost;
+    }
+}
+
+void
+TcpTxBuffer::RackUpdate (const TcpTxSegment& segment, const SequenceNumber32& endSeq)
+{
+  Time rtt = Simulator::Now () - segment.m_lastSent;
+  if (segment.m_retrans && rtt < m_rackMinRtt)
+    {
+      return; // The ACK may be for the original transmission
+    }
+  if (!segment.m_retrans && (m_rackMinRtt.IsZero () || rtt < m_rackMinRtt))
+    {
+      m_rackMinRtt = rtt;
+    }
+  if (segment.m_lastSent > m_rackXmitTime
+      || (segment.m_lastSent == m_rackXmitTime && endSeq > m_rackEndSeq))
+    {
+      m_rackXmitTime = segment.m_lastSent;
+      m_rackEndSeq = endSeq;
+      m_rackRtt = rtt;
+    }
+}
+
 } // namepsace ns3
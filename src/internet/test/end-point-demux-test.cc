@@ -0,0 +1,489 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-interface-address.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv4-end-point.h"
+#include "../model/ipv6-end-point-demux.h"
+#include "../model/ipv6-end-point.h"
+#include <vector>
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Compare the lookups of the IPv4 demux with a walk of all the
+ * endpoints
+ *
+ * Endpoints are randomly allocated, connected, rebound, disabled and
+ * deallocated, and the endpoints found by the hashed lookups are
+ * compared with the ones the original linear lookups find.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the endpoints of a packet by walking all the endpoints
+   * \param endPoints the endpoints
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \param incomingInterface the incoming interface
+   * \return the most-matching endpoints
+   */
+  static Ipv4EndPointDemux::EndPoints Lookup (Ipv4EndPointDemux::EndPoints endPoints,
+                                              Ipv4Address daddr, uint16_t dport,
+                                              Ipv4Address saddr, uint16_t sport,
+                                              Ptr<Ipv4Interface> incomingInterface);
+  /**
+   * \brief Look up the endpoint of an ICMP error by walking all the endpoints
+   * \param endPoints the endpoints
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \return the endpoint (0 if not found)
+   */
+  static Ipv4EndPoint *SimpleLookup (Ipv4EndPointDemux::EndPoints endPoints,
+                                     Ipv4Address daddr, uint16_t dport,
+                                     Ipv4Address saddr, uint16_t sport);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Lookups of the IPv4 endpoint demux")
+{
+}
+
+Ipv4EndPointDemux::EndPoints
+Ipv4EndPointDemuxTestCase::Lookup (Ipv4EndPointDemux::EndPoints endPoints,
+                                   Ipv4Address daddr, uint16_t dport,
+                                   Ipv4Address saddr, uint16_t sport,
+                                   Ptr<Ipv4Interface> incomingInterface)
+{
+  Ipv4EndPointDemux::EndPoints retval1, retval2, retval3, retval4;
+  for (Ipv4EndPointDemux::EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv4EndPoint* endP = *i;
+      if (!endP->IsRxEnabled () || endP->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      bool subnetDirected = false;
+      Ipv4Address incomingInterfaceAddr = daddr;
+      for (uint32_t j = 0; j < incomingInterface->GetNAddresses (); j++)
+        {
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (j);
+          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+            {
+              subnetDirected = true;
+              incomingInterfaceAddr = addr.GetLocal ();
+            }
+        }
+      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+      bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv4Address::GetAny ();
+      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
+      if (isBroadcast && (endP->GetLocalAddress () != Ipv4Address::GetAny ()))
+        {
+          localAddressMatchesExact = (endP->GetLocalAddress () == incomingInterfaceAddr);
+        }
+      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+        {
+          continue;
+        }
+      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
+      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
+      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
+      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv4Address::GetAny ();
+      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard)
+          || !(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+        {
+          continue;
+        }
+      if (localAddressMatchesWildCard && remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+        {
+          retval1.push_back (endP);
+        }
+      if ((localAddressMatchesExact || (isBroadcast && localAddressMatchesWildCard))
+          && remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+        {
+          retval2.push_back (endP);
+        }
+      if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
+        {
+          retval3.push_back (endP);
+        }
+      if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
+        {
+          retval4.push_back (endP);
+        }
+    }
+  if (!retval4.empty ())
+    {
+      return retval4;
+    }
+  if (!retval3.empty ())
+    {
+      return retval3;
+    }
+  if (!retval2.empty ())
+    {
+      return retval2;
+    }
+  return retval1;
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::SimpleLookup (Ipv4EndPointDemux::EndPoints endPoints,
+                                         Ipv4Address daddr, uint16_t dport,
+                                         Ipv4Address saddr, uint16_t sport)
+{
+  uint32_t genericity = 3;
+  Ipv4EndPoint *generic = 0;
+  for (Ipv4EndPointDemux::EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      if ((*i)->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      if ((*i)->GetLocalAddress () == daddr && (*i)->GetPeerPort () == sport
+          && (*i)->GetPeerAddress () == saddr)
+        {
+          return *i;
+        }
+      uint32_t tmp = ((*i)->GetLocalAddress () == Ipv4Address::GetAny () ? 1 : 0)
+        + ((*i)->GetPeerAddress () == Ipv4Address::GetAny () ? 1 : 0);
+      if (tmp < genericity)
+        {
+          generic = (*i);
+          genericity = tmp;
+        }
+    }
+  return generic;
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  interface->AddAddress (Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("255.255.255.0")));
+
+  Ipv4Address locals[] = {Ipv4Address::GetAny (), Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2")};
+  Ipv4Address destinations[] = {Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2"), Ipv4Address ("10.0.0.3"),
+                                Ipv4Address ("10.0.0.255"), Ipv4Address::GetBroadcast ()};
+  Ipv4Address peers[] = {Ipv4Address::GetAny (), Ipv4Address ("10.0.1.1"), Ipv4Address ("10.0.1.2"),
+                         Ipv4Address ("10.0.1.3")};
+  uint16_t localPorts[] = {80, 81};
+  uint16_t peerPorts[] = {0, 1000, 1001};
+
+  Ipv4EndPointDemux demux;
+  std::vector<Ipv4EndPoint *> endPoints;
+  uint32_t nLookups = 0;
+  for (uint32_t round = 0; round < 5000; round++)
+    {
+      Ipv4Address local = locals[rand->GetInteger (0, 2)];
+      uint16_t localPort = localPorts[rand->GetInteger (0, 1)];
+      Ipv4Address peer = peers[rand->GetInteger (0, 3)];
+      uint16_t peerPort = peerPorts[rand->GetInteger (0, 2)];
+      Ipv4EndPoint *endPoint = endPoints.empty () ? 0 : endPoints[rand->GetInteger (0, endPoints.size () - 1)];
+      switch (rand->GetInteger (0, 9))
+        {
+        case 0:
+          {
+            bool duplicate = false;
+            for (uint32_t i = 0; i < endPoints.size (); i++)
+              {
+                duplicate |= endPoints[i]->GetLocalAddress () == local && endPoints[i]->GetLocalPort () == localPort;
+              }
+            endPoint = demux.Allocate (local, localPort);
+            NS_TEST_ASSERT_MSG_EQ ((endPoint == 0), duplicate, "Wrong allocation of " << local << ":" << localPort);
+            break;
+          }
+        case 1:
+          {
+            bool duplicate = false;
+            for (uint32_t i = 0; i < endPoints.size (); i++)
+              {
+                duplicate |= endPoints[i]->GetLocalAddress () == local && endPoints[i]->GetLocalPort () == localPort
+                  && endPoints[i]->GetPeerAddress () == peer && endPoints[i]->GetPeerPort () == peerPort;
+              }
+            endPoint = demux.Allocate (local, localPort, peer, peerPort);
+            NS_TEST_ASSERT_MSG_EQ ((endPoint == 0), duplicate, "Wrong allocation of " << local << ":" << localPort
+                                   << " " << peer << ":" << peerPort);
+            break;
+          }
+        case 2:
+          endPoint = demux.Allocate (local);
+          NS_TEST_ASSERT_MSG_NE (endPoint, 0, "Ephemeral port allocation failed");
+          break;
+        case 3:
+          if (endPoint != 0)
+            {
+              demux.DeAllocate (endPoint);
+              endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+            }
+          endPoint = 0;
+          break;
+        case 4:
+          if (endPoint != 0)
+            {
+              endPoint->SetPeer (peer, peerPort);
+            }
+          endPoint = 0;
+          break;
+        case 5:
+          if (endPoint != 0)
+            {
+              endPoint->SetLocalAddress (local);
+            }
+          endPoint = 0;
+          break;
+        case 6:
+          if (endPoint != 0)
+            {
+              endPoint->SetRxEnabled (rand->GetInteger (0, 3) != 0);
+            }
+          endPoint = 0;
+          break;
+        default:
+          {
+            Ipv4Address daddr = destinations[rand->GetInteger (0, 4)];
+            uint16_t dport = endPoint != 0 && rand->GetInteger (0, 3) == 0 ? endPoint->GetLocalPort () : localPort;
+            Ipv4EndPointDemux::EndPoints expected = Lookup (demux.GetAllEndPoints (), daddr, dport, peer, peerPort, interface);
+            Ipv4EndPointDemux::EndPoints found = demux.Lookup (daddr, dport, peer, peerPort, interface);
+            NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong endpoints for " << peer << ":" << peerPort
+                                   << " -> " << daddr << ":" << dport);
+            NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (daddr, dport, peer, peerPort),
+                                   SimpleLookup (demux.GetAllEndPoints (), daddr, dport, peer, peerPort),
+                                   "Wrong endpoint for an error from " << daddr << ":" << dport);
+            nLookups += expected.empty () ? 0 : 1;
+            endPoint = 0;
+            break;
+          }
+        }
+      if (endPoint != 0)
+        {
+          endPoints.push_back (endPoint);
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (nLookups, 0, "No endpoint ever found");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Compare the lookups of the IPv6 demux with a walk of all the
+ * end points
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the end points of a packet by walking all the end points
+   * \param endPoints the end points
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \return the most-matching end points
+   */
+  static Ipv6EndPointDemux::EndPoints Lookup (Ipv6EndPointDemux::EndPoints endPoints,
+                                              Ipv6Address daddr, uint16_t dport,
+                                              Ipv6Address saddr, uint16_t sport);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Lookups of the IPv6 end point demux")
+{
+}
+
+Ipv6EndPointDemux::EndPoints
+Ipv6EndPointDemuxTestCase::Lookup (Ipv6EndPointDemux::EndPoints endPoints,
+                                   Ipv6Address daddr, uint16_t dport,
+                                   Ipv6Address saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints retval1, retval2, retval3, retval4;
+  for (Ipv6EndPointDemux::EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv6EndPoint* endP = *i;
+      if (!endP->IsRxEnabled () || endP->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
+      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
+      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+        {
+          continue;
+        }
+      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
+      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
+      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
+      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
+      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard)
+          || !(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+        {
+          continue;
+        }
+      if (localAddressMatchesWildCard && remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+        {
+          retval1.push_back (endP);
+        }
+      if (localAddressMatchesExact && remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+        {
+          retval2.push_back (endP);
+        }
+      if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
+        {
+          retval3.push_back (endP);
+        }
+      if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
+        {
+          retval4.push_back (endP);
+        }
+    }
+  if (!retval4.empty ())
+    {
+      return retval4;
+    }
+  if (!retval3.empty ())
+    {
+      return retval3;
+    }
+  if (!retval2.empty ())
+    {
+      return retval2;
+    }
+  return retval1;
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (2);
+
+  Ipv6Address locals[] = {Ipv6Address::GetAny (), Ipv6Address ("2001:1::1"), Ipv6Address ("2001:1::2")};
+  Ipv6Address peers[] = {Ipv6Address::GetAny (), Ipv6Address ("2001:2::1"), Ipv6Address ("2001:2::2"),
+                         Ipv6Address ("2001:2::3")};
+  uint16_t localPorts[] = {80, 81};
+  uint16_t peerPorts[] = {0, 1000, 1001};
+
+  Ipv6EndPointDemux demux;
+  std::vector<Ipv6EndPoint *> endPoints;
+  uint32_t nLookups = 0;
+  for (uint32_t round = 0; round < 5000; round++)
+    {
+      Ipv6Address local = locals[rand->GetInteger (0, 2)];
+      uint16_t localPort = localPorts[rand->GetInteger (0, 1)];
+      Ipv6Address peer = peers[rand->GetInteger (0, 3)];
+      uint16_t peerPort = peerPorts[rand->GetInteger (0, 2)];
+      Ipv6EndPoint *endPoint = endPoints.empty () ? 0 : endPoints[rand->GetInteger (0, endPoints.size () - 1)];
+      switch (rand->GetInteger (0, 9))
+        {
+        case 0:
+          endPoint = demux.Allocate (local, localPort);
+          break;
+        case 1:
+          endPoint = demux.Allocate (local, localPort, peer, peerPort);
+          break;
+        case 2:
+          endPoint = demux.Allocate (local);
+          break;
+        case 3:
+          if (endPoint != 0)
+            {
+              demux.DeAllocate (endPoint);
+              endPoints.erase (std::find (endPoints.begin (), endPoints.end (), endPoint));
+            }
+          endPoint = 0;
+          break;
+        case 4:
+          if (endPoint != 0)
+            {
+              endPoint->SetPeer (peer, peerPort);
+            }
+          endPoint = 0;
+          break;
+        case 5:
+          if (endPoint != 0)
+            {
+              endPoint->SetLocalAddress (local);
+            }
+          endPoint = 0;
+          break;
+        case 6:
+          if (endPoint != 0)
+            {
+              endPoint->SetRxEnabled (rand->GetInteger (0, 3) != 0);
+            }
+          endPoint = 0;
+          break;
+        default:
+          {
+            Ipv6Address daddr = locals[rand->GetInteger (1, 2)];
+            uint16_t dport = endPoint != 0 && rand->GetInteger (0, 3) == 0 ? endPoint->GetLocalPort () : localPort;
+            Ipv6EndPointDemux::EndPoints expected = Lookup (demux.GetEndPoints (), daddr, dport, peer, peerPort);
+            Ipv6EndPointDemux::EndPoints found = demux.Lookup (daddr, dport, peer, peerPort, 0);
+            NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong end points for " << peer << ":" << peerPort
+                                   << " -> " << daddr << ":" << dport);
+            nLookups += expected.empty () ? 0 : 1;
+            endPoint = 0;
+            break;
+          }
+        }
+      if (endPoint != 0)
+        {
+          endPoints.push_back (endPoint);
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (nLookups, 0, "No end point ever found");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the IPv4 and IPv6 endpoint demuxes
+ */
+static class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase (), TestCase::QUICK);
+  }
+} g_endPointDemuxTestSuite;
@@ -42,6 +42,10 @@
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/bridge-helper.h"
+#include "ns3/global-route-manager.h"
+#include "ns3/global-value.h"
+#include "ns3/random-variable-stream.h"
+#include <sstream>
 
 using namespace ns3;
 
@@ -1167,6 +1171,192 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Compare the routes recomputed after changes of the topology with
+ * the routes computed from scratch
+ *
+ * A mesh of routers, with a LAN and a stub router, has the metrics of its
+ * interfaces changed and its interfaces brought down and up at random.
+ * After each change, the routes given by RecomputeRoutingTables, which only
+ * recomputes the routes of the nodes which may be affected, must be those
+ * of a complete computation.  The routes computed in several threads must
+ * also be the same.
+ */
+class Ipv4GlobalRoutingRecomputeTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingRecomputeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Describe the global routes of the nodes.
+   * \param nodes the nodes
+   * \return a description of the routes of each node, in table order
+   */
+  std::vector<std::string> GetRoutes (NodeContainer nodes);
+  /**
+   * \brief Get the global routing tables entries of a node.
+   * \param node the node
+   * \return the routing table entries, in table order
+   */
+  std::vector<Ipv4RoutingTableEntry *> GetEntries (Ptr<Node> node);
+};
+
+Ipv4GlobalRoutingRecomputeTestCase::Ipv4GlobalRoutingRecomputeTestCase ()
+  : TestCase ("Global routes recomputed after changes of the topology")
+{
+}
+
+std::vector<Ipv4RoutingTableEntry *>
+Ipv4GlobalRoutingRecomputeTestCase::GetEntries (Ptr<Node> node)
+{
+  Ptr<Ipv4GlobalRouting> routing = node->GetObject<Ipv4L3Protocol> ()->GetRoutingProtocol ()->GetObject<Ipv4GlobalRouting> ();
+  std::vector<Ipv4RoutingTableEntry *> entries;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      entries.push_back (routing->GetRoute (i));
+    }
+  return entries;
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingRecomputeTestCase::GetRoutes (NodeContainer nodes)
+{
+  std::vector<std::string> routes;
+  for (uint32_t n = 0; n < nodes.GetN (); n++)
+    {
+      std::ostringstream oss;
+      std::vector<Ipv4RoutingTableEntry *> entries = GetEntries (nodes.Get (n));
+      for (uint32_t i = 0; i < entries.size (); i++)
+        {
+          oss << *entries[i] << ";";
+        }
+      routes.push_back (oss.str ());
+    }
+  return routes;
+}
+
+void
+Ipv4GlobalRoutingRecomputeTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (2);
+  // Routers 0 to 8 in a mesh, routers 6 to 8 sharing a LAN, and the stub
+  // router 9 behind router 0
+  const uint32_t nRouters = 10;
+  uint32_t links[][2] = { {0, 1}, {0, 2}, {1, 2}, {1, 3}, {2, 4}, {3, 4}, {3, 5}, {4, 5},
+                          {4, 6}, {5, 7}, {1, 4}, {2, 3}, {0, 9} };
+  NodeContainer nodes;
+  nodes.Create (nRouters);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetNetDevicePointToPointMode (true);
+  for (uint32_t i = 0; i < sizeof (links) / sizeof (links[0]); i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject <SimpleChannel> ();
+      NetDeviceContainer net = simpleHelper.Install (nodes.Get (links[i][0]), channel);
+      net.Add (simpleHelper.Install (nodes.Get (links[i][1]), channel));
+      ipv4.Assign (net);
+      ipv4.NewNetwork ();
+    }
+  SimpleNetDeviceHelper lanHelper;
+  NetDeviceContainer lan = lanHelper.Install (NodeContainer (nodes.Get (6), nodes.Get (7), nodes.Get (8)));
+  ipv4.SetBase ("10.2.0.0", "255.255.255.0");
+  ipv4.Assign (lan);
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> populated = GetRoutes (nodes);
+
+  uint32_t nKept = 0;
+  uint32_t nRecomputed = 0;
+  for (uint32_t round = 0; round < 60; round++)
+    {
+      Ptr<Ipv4> ip = nodes.Get (rand->GetInteger (0, nRouters - 1))->GetObject<Ipv4> ();
+      uint32_t interface = rand->GetInteger (1, ip->GetNInterfaces () - 1);
+      if (rand->GetInteger (0, 3) == 0)
+        {
+          if (ip->IsUp (interface))
+            {
+              ip->SetDown (interface);
+            }
+          else
+            {
+              ip->SetUp (interface);
+            }
+        }
+      else
+        {
+          ip->SetMetric (interface, rand->GetInteger (1, 4));
+        }
+
+      std::vector<std::vector<Ipv4RoutingTableEntry *> > before;
+      for (uint32_t n = 0; n < nRouters; n++)
+        {
+          before.push_back (GetEntries (nodes.Get (n)));
+        }
+      Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+      std::vector<std::string> recomputed = GetRoutes (nodes);
+      for (uint32_t n = 0; n < nRouters; n++)
+        {
+          if (GetEntries (nodes.Get (n)) == before[n])
+            {
+              nKept++;
+            }
+          else
+            {
+              nRecomputed++;
+            }
+        }
+
+      GlobalRouteManager::DeleteGlobalRoutes ();
+      GlobalRouteManager::BuildGlobalRoutingDatabase ();
+      GlobalRouteManager::InitializeRoutes ();
+      std::vector<std::string> computed = GetRoutes (nodes);
+      for (uint32_t n = 0; n < nRouters; n++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (recomputed[n], computed[n], "Wrong routes for node " << n << " in round " << round);
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (nKept, 0, "The routes of all the nodes were recomputed");
+  NS_TEST_ASSERT_MSG_GT (nRecomputed, 0, "The routes of no node were recomputed");
+
+  // Routes computed in several threads
+  for (uint32_t n = 0; n < nRouters; n++)
+    {
+      Ptr<Ipv4> ip = nodes.Get (n)->GetObject<Ipv4> ();
+      for (uint32_t interface = 1; interface < ip->GetNInterfaces (); interface++)
+        {
+          ip->SetUp (interface);
+          ip->SetMetric (interface, 1);
+        }
+    }
+  GlobalRouteManager::DeleteGlobalRoutes ();
+  GlobalRouteManager::BuildGlobalRoutingDatabase ();
+  GlobalRouteManager::InitializeRoutes ();
+  NS_TEST_ASSERT_MSG_EQ ((GetRoutes (nodes) == populated), true, "Routes differ from the first ones");
+  Config::SetGlobal ("GlobalRouteManagerThreads", UintegerValue (3));
+  GlobalRouteManager::DeleteGlobalRoutes ();
+  GlobalRouteManager::BuildGlobalRoutingDatabase ();
+  GlobalRouteManager::InitializeRoutes ();
+  Config::SetGlobal ("GlobalRouteManagerThreads", UintegerValue (1));
+  std::vector<std::string> threaded = GetRoutes (nodes);
+  for (uint32_t n = 0; n < nRouters; n++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (threaded[n], populated[n], "Wrong routes computed in threads for node " << n);
+    }
+
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -1184,6 +1374,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingRecomputeTestCase, TestCase::QUICK);
   }
 
 // Do not forget to allocate an instance of this TestSuite
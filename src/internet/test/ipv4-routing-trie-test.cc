@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-routing-trie.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Compare the lookups of the trie with a walk of all the prefixes
+ *
+ * Random prefixes, many of them nested, are inserted and then removed
+ * from the trie, and the values it returns for random addresses are
+ * compared with the prefixes which match them.
+ */
+class Ipv4RoutingTrieTestCase : public TestCase
+{
+public:
+  Ipv4RoutingTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// A prefix inserted in the trie, and its value
+  struct Prefix
+  {
+    uint32_t network;   //!< The network address
+    uint8_t length;     //!< The prefix length
+    uint32_t value;     //!< The value
+    bool removed;       //!< True if the value was removed from the trie
+  };
+  /**
+   * \brief Check the lookup of an address
+   * \param trie the trie
+   * \param prefixes the prefixes inserted
+   * \param address the address
+   */
+  void CheckLookup (const Ipv4RoutingTrie<uint32_t> &trie, const std::vector<Prefix> &prefixes, uint32_t address);
+};
+
+Ipv4RoutingTrieTestCase::Ipv4RoutingTrieTestCase ()
+  : TestCase ("Lookups of the IPv4 routing trie")
+{
+}
+
+void
+Ipv4RoutingTrieTestCase::CheckLookup (const Ipv4RoutingTrie<uint32_t> &trie, const std::vector<Prefix> &prefixes,
+                                      uint32_t address)
+{
+  std::vector<Ipv4RoutingTrie<uint32_t>::Item> items;
+  trie.Lookup (Ipv4Address (address), items);
+  std::vector<Ipv4RoutingTrie<uint32_t>::Item>::const_iterator item = items.begin ();
+  for (uint32_t i = 0; i < prefixes.size (); i++)
+    {
+      const Prefix &prefix = prefixes[i];
+      uint32_t mask = prefix.length == 0 ? 0 : 0xffffffff << (32 - prefix.length);
+      if (prefix.removed || (address & mask) != (prefix.network & mask))
+        {
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ ((item != items.end ()), true, "Missing value " << prefix.value << " for " << Ipv4Address (address));
+      NS_TEST_ASSERT_MSG_EQ (item->first, i, "Wrong order for " << Ipv4Address (address));
+      NS_TEST_ASSERT_MSG_EQ (item->second, prefix.value, "Wrong value for " << Ipv4Address (address));
+      ++item;
+    }
+  NS_TEST_ASSERT_MSG_EQ ((item == items.end ()), true, "Unexpected value for " << Ipv4Address (address));
+}
+
+void
+Ipv4RoutingTrieTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  // Prefixes in a few /16 networks, so that they are nested
+  uint32_t bases[] = {0x0a000000, 0x0a010000, 0xac100000, 0xc0a80000};
+  Ipv4RoutingTrie<uint32_t> trie;
+  std::vector<Prefix> prefixes;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Prefix prefix;
+      prefix.network = bases[rand->GetInteger (0, 3)] | rand->GetInteger (0, 0xffff);
+      prefix.length = i == 0 ? 0 : rand->GetInteger (8, 32);
+      prefix.value = 3 * i + 1;
+      prefix.removed = false;
+      trie.Insert (Ipv4Address (prefix.network), prefix.length, i, prefix.value);
+      prefixes.push_back (prefix);
+    }
+  NS_TEST_ASSERT_MSG_EQ (trie.GetNItems (), prefixes.size (), "Wrong number of values");
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      CheckLookup (trie, prefixes, bases[rand->GetInteger (0, 3)] | rand->GetInteger (0, 0xffff));
+    }
+  CheckLookup (trie, prefixes, 0x01020304);
+
+  uint32_t nItems = prefixes.size ();
+  for (uint32_t i = 0; i < prefixes.size (); i++)
+    {
+      if (rand->GetInteger (0, 1) == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (Ipv4Address (prefixes[i].network), prefixes[i].length, prefixes[i].value),
+                                 true, "Value not found");
+          prefixes[i].removed = true;
+          --nItems;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (trie.Remove (Ipv4Address ("1.2.3.4"), 32, 0), false, "Value of a missing prefix found");
+  NS_TEST_ASSERT_MSG_EQ (trie.GetNItems (), nItems, "Wrong number of values");
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      CheckLookup (trie, prefixes, bases[rand->GetInteger (0, 3)] | rand->GetInteger (0, 0xffff));
+    }
+
+  trie.Clear ();
+  std::vector<Ipv4RoutingTrie<uint32_t>::Item> items;
+  trie.Lookup (Ipv4Address ("10.0.0.1"), items);
+  NS_TEST_ASSERT_MSG_EQ (items.size (), 0, "Value found after Clear");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the IPv4 routing trie
+ */
+static class Ipv4RoutingTrieTestSuite : public TestSuite
+{
+public:
+  Ipv4RoutingTrieTestSuite ()
+    : TestSuite ("ipv4-routing-trie", UNIT)
+  {
+    AddTestCase (new Ipv4RoutingTrieTestCase (), TestCase::QUICK);
+  }
+} g_ipv4RoutingTrieTestSuite;
@@ -21,6 +21,8 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
@@ -179,6 +181,94 @@ Ipv4StaticRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Longest prefix match of the static routes, and invalidation of
+ * the route cache when the table changes.
+ */
+class Ipv4StaticRoutingLongestPrefixTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLongestPrefixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the route to a destination
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \return the gateway of the route, or 255.255.255.255 if there is no route
+   */
+  Ipv4Address Lookup (Ptr<Ipv4StaticRouting> routing, Ipv4Address dest);
+};
+
+Ipv4StaticRoutingLongestPrefixTestCase::Ipv4StaticRoutingLongestPrefixTestCase ()
+  : TestCase ("Longest prefix match and route cache of static routing")
+{
+}
+
+Ipv4Address
+Ipv4StaticRoutingLongestPrefixTestCase::Lookup (Ptr<Ipv4StaticRouting> routing, Ipv4Address dest)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = routing->RouteOutput (Create<Packet> (), header, 0, sockerr);
+  return route == 0 ? Ipv4Address::GetBroadcast () : route->GetGateway ();
+}
+
+void
+Ipv4StaticRoutingLongestPrefixTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (device);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  int32_t ifIndex = ipv4->AddInterface (device);
+  ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("/24")));
+  ipv4->SetUp (ifIndex);
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> routing = ipv4RoutingHelper.GetStaticRouting (ipv4);
+  routing->SetDefaultRoute (Ipv4Address ("10.0.0.254"), ifIndex);
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.0.0"), Ipv4Mask ("/12"), Ipv4Address ("10.0.0.12"), ifIndex);
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.4.0"), Ipv4Mask ("/22"), Ipv4Address ("10.0.0.22"), ifIndex, 10);
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.4.0"), Ipv4Mask ("/22"), Ipv4Address ("10.0.0.23"), ifIndex, 5);
+  routing->AddHostRouteTo (Ipv4Address ("172.16.5.5"), Ipv4Address ("10.0.0.32"), ifIndex);
+
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("192.168.0.1")), Ipv4Address ("10.0.0.254"), "Wrong default route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("10.0.0.7")), Ipv4Address ("0.0.0.0"), "Wrong route to the local network");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.17.0.1")), Ipv4Address ("10.0.0.12"), "Wrong /12 route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.16.6.1")), Ipv4Address ("10.0.0.23"), "Wrong metric of the /22 routes");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.16.5.5")), Ipv4Address ("10.0.0.32"), "Wrong host route");
+  // The same lookups, from the route cache
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.16.6.1")), Ipv4Address ("10.0.0.23"), "Wrong cached route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.16.5.5")), Ipv4Address ("10.0.0.32"), "Wrong cached route");
+
+  // A more specific route is used as soon as it is added
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.6.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.0.24"), ifIndex);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.16.6.1")), Ipv4Address ("10.0.0.24"), "Stale cached route");
+
+  // The routes removed are not used anymore
+  for (uint32_t i = routing->GetNRoutes (); i > 0; i--)
+    {
+      Ipv4RoutingTableEntry route = routing->GetRoute (i - 1);
+      if (route.GetDest () == Ipv4Address ("172.16.5.5") || route.GetGateway () == Ipv4Address ("10.0.0.254"))
+        {
+          routing->RemoveRoute (i - 1);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("172.16.5.5")), Ipv4Address ("10.0.0.23"), "Removed host route used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, Ipv4Address ("192.168.0.1")), Ipv4Address::GetBroadcast (), "Removed default route used");
+
+  Simulator::Destroy ();
+}
+
 class Ipv4StaticRoutingTestSuite : public TestSuite
 {
 public:
@@ -189,6 +279,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite ()
   : TestSuite ("ipv4-static-routing", UNIT)
 {
   AddTestCase (new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4StaticRoutingLongestPrefixTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBufferTestSuite");
+
+/**
+ * \param offset the offset of a byte in the stream
+ * \returns the value of the byte in the streams of the tests
+ */
+static uint8_t
+StreamByte (uint32_t offset)
+{
+  return offset % 251;
+}
+
+/**
+ * \param offset the offset of the first byte of the packet in the stream
+ * \param size the size of the packet
+ * \returns a packet holding the bytes [offset, offset + size) of the stream
+ */
+static Ptr<Packet>
+CreateStreamPacket (uint32_t offset, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = StreamByte (offset + i);
+    }
+  return Create<Packet> (&data[0], size);
+}
+
+/**
+ * \param p a packet
+ * \param offset the offset of the first byte of the packet in the stream
+ * \returns true if the packet holds the bytes of the stream from offset
+ */
+static bool
+CheckStreamPacket (Ptr<const Packet> p, uint32_t offset)
+{
+  std::vector<uint8_t> data (p->GetSize () + 1);
+  p->CopyData (&data[0], p->GetSize ());
+  for (uint32_t i = 0; i < p->GetSize (); i++)
+    {
+      if (data[i] != StreamByte (offset + i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the segments extracted from the Tx buffer against the data written
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param isn the initial sequence number
+   * \param desc the test description
+   */
+  TcpTxBufferTestCase (uint32_t isn, std::string desc);
+
+private:
+  virtual void DoRun (void);
+  uint32_t m_isn; //!< The initial sequence number
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase (uint32_t isn, std::string desc)
+  : TestCase (desc),
+    m_isn (isn)
+{
+}
+
+void
+TcpTxBufferTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+  u->SetStream (7);
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (m_isn);
+  buffer->SetMaxBufferSize (65536);
+
+  uint32_t written = 0;      // Bytes written by the application
+  uint32_t acked = 0;        // Bytes acknowledged
+  uint32_t sent = 0;         // Bytes sent
+  const uint32_t segmentSize = 1448;
+  while (acked < 1000000)
+    {
+      // The application writes packets of any size
+      uint32_t size = u->GetInteger (1, 4000);
+      if (size <= buffer->Available ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (buffer->Add (CreateStreamPacket (written, size)), true, "Add failed");
+          written += size;
+        }
+      // New segments are sent
+      while (written - sent >= segmentSize)
+        {
+          Ptr<Packet> p = buffer->CopyFromSequence (segmentSize, SequenceNumber32 (m_isn + sent));
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), segmentSize, "Wrong segment size");
+          NS_TEST_ASSERT_MSG_EQ (CheckStreamPacket (p, sent), true, "Wrong data at offset " << sent);
+          sent += segmentSize;
+        }
+      // An old segment is retransmitted
+      if (sent > acked && u->GetValue () < 0.3)
+        {
+          uint32_t offset = acked + u->GetInteger (0, sent - acked - 1);
+          Ptr<Packet> p = buffer->CopyFromSequence (segmentSize, SequenceNumber32 (m_isn + offset));
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), std::min (segmentSize, written - offset), "Wrong retransmission size");
+          NS_TEST_ASSERT_MSG_EQ (CheckStreamPacket (p, offset), true, "Wrong data at offset " << offset);
+        }
+      // Part of the data sent is acknowledged
+      if (sent > acked)
+        {
+          acked += u->GetInteger (0, sent - acked);
+          buffer->DiscardUpTo (SequenceNumber32 (m_isn + acked));
+          NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (m_isn + acked), "Wrong head");
+          NS_TEST_ASSERT_MSG_EQ (buffer->Size (), written - acked, "Wrong size");
+        }
+    }
+  // The FIN is acknowledged after the last byte
+  Ptr<Packet> p = buffer->CopyFromSequence (written - acked, SequenceNumber32 (m_isn + acked));
+  NS_TEST_ASSERT_MSG_EQ (CheckStreamPacket (p, acked), true, "Wrong data at offset " << acked);
+  buffer->DiscardUpTo (SequenceNumber32 (m_isn + written + 1));
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "Data left in the buffer");
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (m_isn + written + 1), "Wrong head after the FIN");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the data and the SACK blocks of the Rx buffer when segments
+ * arrive out of order, duplicated or overlapping
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param isn the initial sequence number
+   * \param desc the test description
+   */
+  TcpRxBufferTestCase (uint32_t isn, std::string desc);
+
+private:
+  virtual void DoRun (void);
+  uint32_t m_isn; //!< The initial sequence number
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase (uint32_t isn, std::string desc)
+  : TestCase (desc),
+    m_isn (isn)
+{
+}
+
+void
+TcpRxBufferTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+  u->SetStream (11);
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> (m_isn);
+  const uint32_t window = 65536;
+  buffer->SetMaxBufferSize (window);
+
+  const uint32_t streamSize = 300000;
+  std::vector<bool> received (streamSize + 2 * window, false); // The bytes held or read
+  uint32_t read = 0;    // Bytes read by the application
+  uint32_t next = 0;    // Next byte expected
+  TcpHeader tcph;
+  while (read < streamSize)
+    {
+      // A segment of any size, anywhere in the window, possibly duplicated
+      uint32_t offset = next + u->GetInteger (0, window / 2);
+      if (u->GetValue () < 0.2)
+        {
+          offset = next;
+        }
+      uint32_t size = u->GetInteger (1, 3000);
+      // The data beyond the window is dropped
+      uint32_t maxOffset = buffer->MaxRxSequence () - SequenceNumber32 (m_isn);
+      tcph.SetSequenceNumber (SequenceNumber32 (m_isn + offset));
+      buffer->Add (CreateStreamPacket (offset, size), tcph);
+      for (uint32_t i = offset; i < offset + size && i < maxOffset; i++)
+        {
+          received[i] = true;
+        }
+      while (received[next])
+        {
+          ++next;
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer->NextRxSequence (), SequenceNumber32 (m_isn + next), "Wrong next sequence");
+      NS_TEST_ASSERT_MSG_EQ (buffer->Available (), next - read, "Wrong available data");
+
+      // The SACK blocks describe the ranges received above the next byte expected
+      TcpOptionSack::SackList blocks = buffer->GetSackList (100);
+      std::vector<bool> sacked (window + 3000, false);
+      for (TcpOptionSack::SackList::iterator it = blocks.begin (); it != blocks.end (); ++it)
+        {
+          NS_TEST_ASSERT_MSG_LT (it->first, it->second, "Empty SACK block");
+          uint32_t head = it->first - SequenceNumber32 (m_isn);
+          uint32_t tail = it->second - SequenceNumber32 (m_isn);
+          NS_TEST_ASSERT_MSG_GT (head, next, "SACK block below the next sequence");
+          NS_TEST_ASSERT_MSG_EQ (received[head - 1], false, "The SACK block is not maximal");
+          NS_TEST_ASSERT_MSG_EQ (received[tail], false, "The SACK block is not maximal");
+          for (uint32_t i = head; i < tail; i++)
+            {
+              sacked[i - next] = true;
+            }
+        }
+      for (uint32_t i = next; i < next + window / 2 + 3000; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (sacked[i - next], received[i], "Wrong SACK blocks at offset " << i);
+        }
+
+      // The application reads part of the data
+      if (u->GetValue () < 0.5)
+        {
+          Ptr<Packet> p = buffer->Extract (u->GetInteger (1, 10000));
+          if (p)
+            {
+              NS_TEST_ASSERT_MSG_EQ (CheckStreamPacket (p, read), true, "Wrong data at offset " << read);
+              read += p->GetSize ();
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the Tx and Rx buffers of TCP
+ */
+static class TcpBufferTestSuite : public TestSuite
+{
+public:
+  TcpBufferTestSuite ()
+    : TestSuite ("tcp-buffer-test", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase (1, "Tx buffer"), TestCase::QUICK);
+    AddTestCase (new TcpTxBufferTestCase (0xfff00000, "Tx buffer across the sequence number wrap"), TestCase::QUICK);
+    AddTestCase (new TcpRxBufferTestCase (1, "Rx buffer"), TestCase::QUICK);
+    AddTestCase (new TcpRxBufferTestCase (0xfff00000, "Rx buffer across the sequence number wrap"), TestCase::QUICK);
+  }
+} g_tcpBufferTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,561 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/gso-tag.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpGsoTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the segments a TCP over IPv4 super-segment is split into
+ */
+class TcpGsoSegmentTestCase : public TestCase
+{
+public:
+  TcpGsoSegmentTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpGsoSegmentTestCase::TcpGsoSegmentTestCase ()
+  : TestCase ("Split a TCP over IPv4 super-segment")
+{
+}
+
+void
+TcpGsoSegmentTestCase::DoRun ()
+{
+  // The TCP protocol registers the function splitting its super-segments
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+
+  const uint32_t size = 3500;
+  const uint16_t segmentSize = 1000;
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = i % 251;
+    }
+  Ptr<Packet> p = Create<Packet> (&data[0], size);
+
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (49153);
+  tcpHeader.SetDestinationPort (50000);
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (0xfffffc00));
+  tcpHeader.SetAckNumber (SequenceNumber32 (1));
+  tcpHeader.SetFlags (TcpHeader::ACK | TcpHeader::PSH | TcpHeader::FIN);
+  p->AddHeader (tcpHeader);
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  ipHeader.SetIdentification (100);
+  p->AddHeader (ipHeader);
+
+  std::list<Ptr<Packet> > segments;
+  NS_TEST_ASSERT_MSG_EQ (GsoTag::Segment (p, Ipv4L3Protocol::PROT_NUMBER, segments), false,
+                         "A packet without GsoTag is not a super-segment");
+  p->AddPacketTag (GsoTag (segmentSize));
+  NS_TEST_ASSERT_MSG_EQ (GsoTag::Segment (p, Ipv4L3Protocol::PROT_NUMBER, segments), true,
+                         "The super-segment was not split");
+  NS_TEST_ASSERT_MSG_EQ (segments.size (), 4, "Wrong number of segments");
+
+  uint32_t offset = 0;
+  uint16_t identification = 100;
+  for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it)
+    {
+      GsoTag tag;
+      NS_TEST_ASSERT_MSG_EQ ((*it)->PeekPacketTag (tag), false, "The segment is tagged");
+      Ipv4Header ip;
+      (*it)->RemoveHeader (ip);
+      TcpHeader tcph;
+      (*it)->RemoveHeader (tcph);
+      uint32_t length = std::min<uint32_t> (segmentSize, size - offset);
+      NS_TEST_ASSERT_MSG_EQ ((*it)->GetSize (), length, "Wrong segment size");
+      NS_TEST_ASSERT_MSG_EQ (ip.GetPayloadSize (), length + tcph.GetSerializedSize (), "Wrong IP payload size");
+      NS_TEST_ASSERT_MSG_EQ (ip.GetIdentification (), identification++, "Wrong IP identification");
+      NS_TEST_ASSERT_MSG_EQ (ip.GetSource (), ipHeader.GetSource (), "Wrong source");
+      NS_TEST_ASSERT_MSG_EQ (tcph.GetSequenceNumber (), SequenceNumber32 (0xfffffc00 + offset), "Wrong sequence number");
+      NS_TEST_ASSERT_MSG_EQ (tcph.GetAckNumber (), SequenceNumber32 (1), "Wrong ACK number");
+      NS_TEST_ASSERT_MSG_EQ (tcph.GetDestinationPort (), 50000, "Wrong port");
+
+      uint8_t flags = TcpHeader::ACK;
+      if (offset + length == size)
+        {
+          flags |= TcpHeader::PSH | TcpHeader::FIN;
+        }
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (tcph.GetFlags ()), static_cast<uint32_t> (flags), "Wrong flags");
+
+      std::vector<uint8_t> payload (length);
+      (*it)->CopyData (&payload[0], length);
+      for (uint32_t i = 0; i < length; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (payload[i]), static_cast<uint32_t> (data[offset + i]),
+                                 "Wrong data at offset " << offset + i);
+        }
+      offset += length;
+    }
+  tcp->Dispose ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief A transfer with GSO over a device which does not support it
+ *
+ * The sender hands super-segments to IPv4, which splits them into
+ * segments of the negotiated size before the device: the receiver gets
+ * the whole stream in segments no larger than the segment size.
+ */
+class TcpGsoTransferTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param gsoMaxSize the maximum payload of the super-segments
+   * \param desc the test description
+   */
+  TcpGsoTransferTest (uint32_t gsoMaxSize, const std::string &desc);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual void ConfigureEnvironment ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+  /**
+   * \brief Record the identification of an IPv4 packet sent by the sender.
+   * \param p the packet, with its IPv4 header
+   * \param ipv4 the IPv4 stack
+   * \param interface the interface index
+   */
+  void IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  uint32_t m_gsoMaxSize;      //!< Maximum payload of the super-segments
+  uint32_t m_superSegments;   //!< Number of super-segments sent
+  uint32_t m_rxBytes;         //!< Bytes received
+  SequenceNumber32 m_nextRx;  //!< Next sequence number expected by the receiver
+  std::set<uint16_t> m_ids;   //!< IPv4 identifications sent by the sender
+  uint32_t m_duplicateIds;    //!< Number of IPv4 identifications sent twice
+};
+
+TcpGsoTransferTest::TcpGsoTransferTest (uint32_t gsoMaxSize, const std::string &desc)
+  : TcpGeneralTest (desc),
+    m_gsoMaxSize (gsoMaxSize),
+    m_superSegments (0),
+    m_rxBytes (0),
+    m_nextRx (1),
+    m_duplicateIds (0)
+{
+}
+
+void
+TcpGsoTransferTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (100);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGsoTransferTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("GsoMaxSize", UintegerValue (m_gsoMaxSize));
+  node->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&TcpGsoTransferTest::IpTx, this));
+  return socket;
+}
+
+void
+TcpGsoTransferTest::IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ipv4Header ipHeader;
+  p->PeekHeader (ipHeader);
+  if (!m_ids.insert (ipHeader.GetIdentification ()).second)
+    {
+      ++m_duplicateIds;
+    }
+}
+
+void
+TcpGsoTransferTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && p->GetSize () > GetSegSize (SENDER))
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), m_gsoMaxSize, "Super-segment above GsoMaxSize");
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize () % GetSegSize (SENDER), 0, "Super-segment of partial segments");
+      ++m_superSegments;
+    }
+}
+
+void
+TcpGsoTransferTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == RECEIVER && p->GetSize () > 0)
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), GetSegSize (SENDER), "Segment above the segment size");
+      NS_TEST_ASSERT_MSG_EQ (h.GetSequenceNumber (), m_nextRx, "Segment out of order");
+      m_nextRx = h.GetSequenceNumber () + SequenceNumber32 (p->GetSize ());
+      m_rxBytes += p->GetSize ();
+    }
+}
+
+void
+TcpGsoTransferTest::FinalChecks ()
+{
+  if (m_gsoMaxSize == 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_superSegments, 0, "Super-segments sent with GSO disabled");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (m_superSegments, 0, "No super-segment sent");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, GetPktSize () * GetPktCount (), "Data lost");
+  NS_TEST_ASSERT_MSG_EQ (m_duplicateIds, 0, "IPv4 identification sent twice");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the coalescing of TCP over IPv4 segments received together
+ */
+class TcpGroCoalesceTestCase : public TestCase
+{
+public:
+  TcpGroCoalesceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Build a TCP over IPv4 segment
+   * \param seq the sequence number
+   * \param size the size of the data
+   * \param flags the TCP flags
+   * \param sourcePort the source port
+   * \return the segment, starting with the IPv4 header
+   */
+  Ptr<Packet> MakeSegment (uint32_t seq, uint32_t size, uint8_t flags, uint16_t sourcePort = 49153);
+};
+
+TcpGroCoalesceTestCase::TcpGroCoalesceTestCase ()
+  : TestCase ("Coalesce TCP over IPv4 segments received together")
+{
+}
+
+Ptr<Packet>
+TcpGroCoalesceTestCase::MakeSegment (uint32_t seq, uint32_t size, uint8_t flags, uint16_t sourcePort)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = (seq + i) % 251;
+    }
+  Ptr<Packet> p = Create<Packet> (&data[0], size);
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (sourcePort);
+  tcpHeader.SetDestinationPort (50000);
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (seq));
+  tcpHeader.SetAckNumber (SequenceNumber32 (1));
+  tcpHeader.SetFlags (flags);
+  tcpHeader.SetWindowSize (1000);
+  p->AddHeader (tcpHeader);
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  p->AddHeader (ipHeader);
+  return p;
+}
+
+void
+TcpGroCoalesceTestCase::DoRun ()
+{
+  // The TCP protocol registers the function coalescing its segments
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+
+  std::list<Ptr<Packet> > packets;
+  packets.push_back (MakeSegment (1000, 1000, TcpHeader::ACK));
+  packets.push_back (MakeSegment (2000, 1000, TcpHeader::ACK));
+  packets.push_back (MakeSegment (3000, 500, TcpHeader::ACK | TcpHeader::PSH));
+  packets.push_back (MakeSegment (3500, 1000, TcpHeader::ACK));          // after a partial segment
+  packets.push_back (MakeSegment (5500, 1000, TcpHeader::ACK));          // after a gap
+  packets.push_back (MakeSegment (6500, 1000, TcpHeader::ACK, 49154));   // another flow
+  packets.push_back (MakeSegment (6500, 1000, TcpHeader::ACK | TcpHeader::FIN));
+  packets.push_back (MakeSegment (7500, 1000, TcpHeader::ACK));
+  packets.push_back (MakeSegment (8500, 1000, TcpHeader::ACK));
+
+  std::list<Ptr<Packet> > coalesced = GsoTag::Coalesce (packets, Ipv4L3Protocol::PROT_NUMBER);
+  NS_TEST_ASSERT_MSG_EQ (coalesced.size (), 6, "Wrong number of packets passed up");
+
+  uint32_t expectedSeq[] = {1000, 3500, 5500, 6500, 6500, 7500};
+  uint32_t expectedSize[] = {2500, 1000, 1000, 1000, 1000, 2000};
+  uint32_t i = 0;
+  for (std::list<Ptr<Packet> >::iterator it = coalesced.begin (); it != coalesced.end (); ++it, ++i)
+    {
+      Ptr<Packet> p = (*it)->Copy ();
+      GsoTag tag;
+      bool tagged = p->PeekPacketTag (tag);
+      Ipv4Header ip;
+      p->RemoveHeader (ip);
+      TcpHeader tcph;
+      p->RemoveHeader (tcph);
+      NS_TEST_ASSERT_MSG_EQ (tcph.GetSequenceNumber (), SequenceNumber32 (expectedSeq[i]), "Wrong sequence number of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expectedSize[i], "Wrong size of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (ip.GetPayloadSize (), p->GetSize () + tcph.GetSerializedSize (), "Wrong IP payload size");
+      NS_TEST_ASSERT_MSG_EQ (tagged, (expectedSize[i] > 1000), "Wrong GsoTag on packet " << i);
+      if (tagged)
+        {
+          NS_TEST_ASSERT_MSG_EQ (tag.GetSegmentSize (), 1000, "Wrong segment size");
+        }
+      if (i == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (tcph.GetFlags ()),
+                                 static_cast<uint32_t> (TcpHeader::ACK | TcpHeader::PSH),
+                                 "The PSH flag of the last segment is lost");
+        }
+      std::vector<uint8_t> data (p->GetSize ());
+      p->CopyData (&data[0], data.size ());
+      for (uint32_t j = 0; j < data.size (); j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (data[j]), (expectedSeq[i] + j) % 251,
+                                 "Wrong data at offset " << j << " of packet " << i);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (*std::prev (coalesced.end (), 2), *std::prev (packets.end (), 3), "The FIN segment is not passed up unchanged");
+
+  // A single packet is passed up unchanged
+  std::list<Ptr<Packet> > single;
+  single.push_back (packets.front ());
+  NS_TEST_ASSERT_MSG_EQ (GsoTag::Coalesce (single, Ipv4L3Protocol::PROT_NUMBER).front (), packets.front (),
+                         "A single packet is changed");
+  tcp->Dispose ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief A channel coalescing the IPv4 packets sent by its first device
+ *
+ * The packets sent by the first device within a propagation delay are
+ * delivered together, after GsoTag::Coalesce, as a receiver with GRO
+ * would pass up the packets of an aggregate.
+ */
+class GroChannel : public SimpleChannel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual void Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
+                     Ptr<SimpleNetDevice> sender);
+
+private:
+  /**
+   * \brief Deliver the packets held
+   * \param device the receiving device
+   * \param to the destination
+   * \param from the source
+   */
+  void Flush (Ptr<SimpleNetDevice> device, Mac48Address to, Mac48Address from);
+
+  std::list<Ptr<Packet> > m_batch; //!< Packets held
+};
+
+TypeId
+GroChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GroChannel")
+    .SetParent<SimpleChannel> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<GroChannel> ()
+  ;
+  return tid;
+}
+
+void
+GroChannel::Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
+                  Ptr<SimpleNetDevice> sender)
+{
+  if (protocol != Ipv4L3Protocol::PROT_NUMBER || sender != GetDevice (0))
+    {
+      SimpleChannel::Send (p, protocol, to, from, sender);
+      return;
+    }
+  if (m_batch.empty ())
+    {
+      Ptr<SimpleNetDevice> device = DynamicCast<SimpleNetDevice> (GetDevice (1));
+      TimeValue delay;
+      GetAttribute ("Delay", delay);
+      Simulator::ScheduleWithContext (device->GetNode ()->GetId (), delay.Get (),
+                                      &GroChannel::Flush, this, device, to, from);
+    }
+  m_batch.push_back (p->Copy ());
+}
+
+void
+GroChannel::Flush (Ptr<SimpleNetDevice> device, Mac48Address to, Mac48Address from)
+{
+  std::list<Ptr<Packet> > batch;
+  batch.swap (m_batch);
+  batch = GsoTag::Coalesce (batch, Ipv4L3Protocol::PROT_NUMBER);
+  for (std::list<Ptr<Packet> >::iterator it = batch.begin (); it != batch.end (); ++it)
+    {
+      device->Receive (*it, Ipv4L3Protocol::PROT_NUMBER, to, from);
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief A transfer to a receiver which coalesces the segments received together
+ *
+ * The receiver gets super-segments, and acknowledges their data as if
+ * the segments had been received separately.
+ */
+class TcpGroTransferTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the test description
+   */
+  TcpGroTransferTest (const std::string &desc);
+
+protected:
+  virtual Ptr<SimpleChannel> CreateChannel ();
+  virtual void ConfigureEnvironment ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+  uint32_t m_superSegments;   //!< Number of super-segments received
+  uint32_t m_rxBytes;         //!< Bytes received
+  SequenceNumber32 m_nextRx;  //!< Next sequence number expected by the receiver
+  SequenceNumber32 m_lastAck; //!< Last ACK number sent by the receiver
+};
+
+TcpGroTransferTest::TcpGroTransferTest (const std::string &desc)
+  : TcpGeneralTest (desc),
+    m_superSegments (0),
+    m_rxBytes (0),
+    m_nextRx (1),
+    m_lastAck (1)
+{
+}
+
+void
+TcpGroTransferTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (100);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+Ptr<SimpleChannel>
+TcpGroTransferTest::CreateChannel ()
+{
+  Ptr<SimpleChannel> ch = CreateObject<GroChannel> ();
+  ch->SetAttribute ("Delay", TimeValue (GetPropagationDelay ()));
+  return ch;
+}
+
+void
+TcpGroTransferTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == RECEIVER && (h.GetFlags () & TcpHeader::ACK) && h.GetAckNumber () > m_lastAck)
+    { // One ACK at least every two segments, as without GRO
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (static_cast<uint32_t> (h.GetAckNumber () - m_lastAck), 2 * GetSegSize (SENDER) + 1,
+                                   "ACK of more than two segments");
+      m_lastAck = h.GetAckNumber ();
+    }
+}
+
+void
+TcpGroTransferTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == RECEIVER && p->GetSize () > 0)
+    {
+      if (p->GetSize () > GetSegSize (SENDER))
+        {
+          ++m_superSegments;
+        }
+      NS_TEST_ASSERT_MSG_EQ (h.GetSequenceNumber (), m_nextRx, "Segment out of order");
+      m_nextRx = h.GetSequenceNumber () + SequenceNumber32 (p->GetSize ());
+      m_rxBytes += p->GetSize ();
+    }
+}
+
+void
+TcpGroTransferTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_superSegments, 0, "No super-segment received");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, GetPktSize () * GetPktCount (), "Data lost");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the generic segmentation and receive offloads of TCP
+ */
+static class TcpGsoTestSuite : public TestSuite
+{
+public:
+  TcpGsoTestSuite ()
+    : TestSuite ("tcp-gso-test", UNIT)
+  {
+    AddTestCase (new TcpGsoTransferTest (0, "Transfer without GSO"), TestCase::QUICK);
+    AddTestCase (new TcpGsoTransferTest (4000, "Transfer with super-segments split by IPv4"), TestCase::QUICK);
+    AddTestCase (new TcpGsoTransferTest (65000, "Transfer with the largest super-segments"), TestCase::QUICK);
+    AddTestCase (new TcpGsoSegmentTestCase (), TestCase::QUICK);
+    AddTestCase (new TcpGroCoalesceTestCase (), TestCase::QUICK);
+    AddTestCase (new TcpGroTransferTest ("Transfer with segments coalesced on receive"), TestCase::QUICK);
+  }
+} g_tcpGsoTestSuite;
+
+} // namespace ns3
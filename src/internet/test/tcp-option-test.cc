@@ -22,6 +22,8 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/private/tcp-option-sack-permitted.h"
+#include "ns3/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +166,59 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t nBlocks);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_nBlocks;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t nBlocks)
+  : TestCase (name),
+    m_nBlocks (nBlocks)
+{
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+
+  TcpOptionSack opt;
+  for (uint32_t i = 0; i < m_nBlocks; ++i)
+    {
+      SequenceNumber32 left = SequenceNumber32 (x->GetInteger ());
+      opt.AddSackBlock (TcpOptionSack::SackBlock (left, left + SequenceNumber32 (1 + x->GetInteger (0, 65535))));
+    }
+  NS_TEST_EXPECT_MSG_EQ (opt.GetNumSackBlocks (), m_nBlocks, "Blocks aren't saved correctly");
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_nBlocks, "Wrong serialized size");
+
+  Buffer buffer;
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  Buffer::Iterator start = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (start.PeekU8 (), TcpOption::SACK, "Different kind found");
+
+  TcpOptionSack read;
+  NS_TEST_EXPECT_MSG_EQ (read.Deserialize (start), opt.GetSerializedSize (), "Wrong deserialized size");
+  TcpOptionSack::SackList written = opt.GetSackList ();
+  TcpOptionSack::SackList readList = read.GetSackList ();
+  NS_TEST_EXPECT_MSG_EQ ((written == readList), true, "Different blocks found");
+
+  TcpOptionSackPermitted perm;
+  Buffer permBuffer;
+  permBuffer.AddAtStart (perm.GetSerializedSize ());
+  perm.Serialize (permBuffer.Begin ());
+  NS_TEST_EXPECT_MSG_EQ (permBuffer.Begin ().PeekU8 (), TcpOption::SACKPERMITTED, "Different kind found");
+  NS_TEST_EXPECT_MSG_EQ (perm.Deserialize (permBuffer.Begin ()), 2, "Wrong SACK-permitted size");
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +231,10 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= 4; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing serialization of SACK blocks", i), TestCase::QUICK);
+      }
   }
 
 } g_TcpOptionTestSuite;
@@ -0,0 +1,443 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-option-sack.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the SACK scoreboard of the Tx buffer and the SACK blocks of the Rx buffer
+ */
+class TcpSackScoreboardTestCase : public TestCase
+{
+public:
+  TcpSackScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** \brief Check the scoreboard after SACK blocks and retransmissions */
+  void TestScoreboard (void);
+  /** \brief Check the SACK blocks generated by the Rx buffer */
+  void TestSackBlocks (void);
+};
+
+TcpSackScoreboardTestCase::TcpSackScoreboardTestCase ()
+  : TestCase ("Check the SACK scoreboard and the SACK blocks")
+{
+}
+
+void
+TcpSackScoreboardTestCase::DoRun ()
+{
+  TestScoreboard ();
+  TestSackBlocks ();
+}
+
+void
+TcpSackScoreboardTestCase::TestScoreboard ()
+{
+  Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer> ();
+  txBuf->SetHeadSequence (SequenceNumber32 (1));
+  txBuf->SetMaxBufferSize (20000);
+  txBuf->Add (Create<Packet> (10000));
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      txBuf->MarkSent (SequenceNumber32 (1 + i * 1000), 1000);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 10000, "All the data is in flight");
+
+  // The segment [1;1001) is acknowledged, [3001;5001) and [6001;8001) are SACKed
+  TcpOptionSack::SackList list;
+  list.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (6001), SequenceNumber32 (8001)));
+  list.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (3001), SequenceNumber32 (5001)));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->Update (list, SequenceNumber32 (1001)), 4000, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->Update (list, SequenceNumber32 (1001)), 0, "Blocks SACKed twice");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSackedBytes (), 4000, "Wrong SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsSacked (SequenceNumber32 (3500)), true, "Byte should be SACKed");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsSacked (SequenceNumber32 (5500)), false, "Byte should not be SACKed");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 5000, "Wrong pipe");
+
+  // More than 2 segments are SACKed above [1001;3001) only
+  Time timeout;
+  NS_TEST_ASSERT_MSG_EQ (txBuf->DetectLosses (3, 1000, timeout), 2000, "Wrong lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostBytes (), 2000, "Wrong lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 3000, "Wrong pipe");
+
+  SequenceNumber32 seq;
+  uint32_t size;
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (seq, size), true, "A segment is lost");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (1001), "Wrong first lost segment");
+  NS_TEST_ASSERT_MSG_EQ (size, 1000, "Wrong lost segment size");
+
+  // The retransmission is in flight, and is not lost again by the DupThresh rule
+  txBuf->MarkSent (seq, size);
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 4000, "Wrong pipe after retransmission");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->DetectLosses (3, 1000, timeout), 0, "Retransmission marked lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (seq, size), true, "A segment is still lost");
+  NS_TEST_ASSERT_MSG_EQ (seq, SequenceNumber32 (2001), "Wrong next lost segment");
+
+  // The cumulative ACK removes the lost and the retransmitted segments
+  txBuf->DiscardUpTo (SequenceNumber32 (3001));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLostBytes (), 0, "Wrong lost bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSackedBytes (), 4000, "Wrong SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 3000, "Wrong pipe");
+
+  // A partial block splits the segments of the scoreboard
+  list.clear ();
+  list.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (8001), SequenceNumber32 (8501)));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->Update (list, SequenceNumber32 (3001)), 500, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 2500, "Wrong pipe");
+
+  // On timeout, the SACK information is forgotten
+  txBuf->ResetScoreboard ();
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 0, "Wrong pipe after timeout");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSackedBytes (), 0, "Wrong SACKed bytes after timeout");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsSacked (SequenceNumber32 (6500)), false, "Byte should not be SACKed after timeout");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextLost (seq, size), false, "No segment is marked lost after timeout");
+
+  // The retransmissions rebuild the scoreboard
+  txBuf->MarkSent (SequenceNumber32 (3001), 1000);
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 1000, "Wrong pipe after the retransmission");
+}
+
+void
+TcpSackScoreboardTestCase::TestSackBlocks ()
+{
+  Ptr<TcpRxBuffer> rxBuf = CreateObject<TcpRxBuffer> (1);
+  TcpHeader h;
+  uint32_t seqs[] = { 1001, 2001, 6001, 4001 };
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (seqs[i]));
+      rxBuf->Add (Create<Packet> (1000), h);
+    }
+
+  TcpOptionSack::SackList list = rxBuf->GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (list.size (), 3, "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (list.front ().first, SequenceNumber32 (4001), "The last segment received is not first");
+  NS_TEST_ASSERT_MSG_EQ (list.front ().second, SequenceNumber32 (5001), "Wrong right edge");
+  list.pop_front ();
+  NS_TEST_ASSERT_MSG_EQ (list.front ().first, SequenceNumber32 (1001), "Blocks are not in sequence order");
+  NS_TEST_ASSERT_MSG_EQ (list.front ().second, SequenceNumber32 (3001), "Contiguous segments are not merged");
+
+  // Filling the hole merges the blocks; filling the head empties the list
+  h.SetSequenceNumber (SequenceNumber32 (5001));
+  rxBuf->Add (Create<Packet> (1000), h);
+  list = rxBuf->GetSackList (1);
+  NS_TEST_ASSERT_MSG_EQ (list.size (), 1, "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (list.front ().first, SequenceNumber32 (4001), "Wrong left edge");
+  NS_TEST_ASSERT_MSG_EQ (list.front ().second, SequenceNumber32 (7001), "Wrong right edge");
+
+  h.SetSequenceNumber (SequenceNumber32 (1));
+  rxBuf->Add (Create<Packet> (1000), h);
+  h.SetSequenceNumber (SequenceNumber32 (3001));
+  rxBuf->Add (Create<Packet> (1000), h);
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->GetSackList (4).size (), 0, "No block without a hole");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf->NextRxSequence (), SequenceNumber32 (7001), "Wrong next sequence");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that RACK marks a segment lost a reordering window after
+ * a segment sent later is delivered
+ */
+class TcpRackTestCase : public TestCase
+{
+public:
+  TcpRackTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Send a segment
+   * \param seq the sequence number of the segment
+   */
+  void Send (uint32_t seq);
+  /**
+   * \brief SACK a segment
+   * \param seq the sequence number of the segment
+   */
+  void Sack (uint32_t seq);
+  /**
+   * \brief Check the output of the loss detection
+   * \param lost the expected number of lost bytes
+   * \param timeout the expected reordering timeout
+   */
+  void Check (uint32_t lost, Time timeout);
+
+  Ptr<TcpTxBuffer> m_txBuf; //!< The Tx buffer
+};
+
+TcpRackTestCase::TcpRackTestCase ()
+  : TestCase ("Check the RACK loss detection")
+{
+}
+
+void
+TcpRackTestCase::Send (uint32_t seq)
+{
+  m_txBuf->MarkSent (SequenceNumber32 (seq), 1000);
+}
+
+void
+TcpRackTestCase::Sack (uint32_t seq)
+{
+  TcpOptionSack::SackList list;
+  list.push_back (TcpOptionSack::SackBlock (SequenceNumber32 (seq), SequenceNumber32 (seq + 1000)));
+  m_txBuf->Update (list, SequenceNumber32 (1));
+}
+
+void
+TcpRackTestCase::Check (uint32_t lost, Time timeout)
+{
+  Time left;
+  m_txBuf->DetectLosses (3, 1000, left);
+  NS_TEST_ASSERT_MSG_EQ (m_txBuf->GetLostBytes (), lost, "Wrong lost bytes at " << Simulator::Now ());
+  NS_TEST_ASSERT_MSG_EQ (left, timeout, "Wrong reordering timeout at " << Simulator::Now ());
+}
+
+void
+TcpRackTestCase::DoRun ()
+{
+  m_txBuf = CreateObject<TcpTxBuffer> ();
+  m_txBuf->SetHeadSequence (SequenceNumber32 (1));
+  m_txBuf->Add (Create<Packet> (3000));
+
+  // The first segment is sent 10 ms before the second one, SACKed after 80 ms:
+  // the reordering window is 20 ms, the first segment is lost at 100 ms
+  Simulator::Schedule (MilliSeconds (0), &TcpRackTestCase::Send, this, 1);
+  Simulator::Schedule (MilliSeconds (10), &TcpRackTestCase::Send, this, 1001);
+  Simulator::Schedule (MilliSeconds (20), &TcpRackTestCase::Send, this, 2001);
+  Simulator::Schedule (MilliSeconds (90), &TcpRackTestCase::Sack, this, 1001);
+  Simulator::Schedule (MilliSeconds (90), &TcpRackTestCase::Check, this, 0, MilliSeconds (10));
+  Simulator::Schedule (MilliSeconds (95), &TcpRackTestCase::Check, this, 0, MilliSeconds (5));
+  Simulator::Schedule (MilliSeconds (100), &TcpRackTestCase::Check, this, 1000, Time (0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_txBuf->IsSacked (SequenceNumber32 (2001)), false, "The last segment is not SACKed");
+  NS_TEST_ASSERT_MSG_EQ (m_txBuf->BytesInFlight (), 1000, "Only the last segment is in flight");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that a burst of losses is repaired within one RTT with SACK
+ *
+ * Four consecutive segments are dropped.  With SACK, the sender must
+ * retransmit all of them within one RTT, without retransmission timeout
+ * and without retransmitting data that has been received.
+ */
+class TcpSackRecoveryTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param firstSeqToKill the sequence number of the first segment dropped
+   * \param nToKill the number of consecutive segments dropped
+   * \param desc the test description
+   */
+  TcpSackRecoveryTest (uint32_t firstSeqToKill, uint32_t nToKill, const std::string &desc);
+
+protected:
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue);
+  virtual void FinalChecks ();
+
+  uint32_t m_firstSeqToKill;  //!< First sequence number dropped
+  uint32_t m_nToKill;         //!< Number of segments dropped
+  uint32_t m_segmentSize;     //!< Segment size
+  uint32_t m_retransmissions; //!< Number of retransmitted segments
+  uint32_t m_recoveries;      //!< Number of entries in recovery
+  uint32_t m_sackSent;        //!< Number of ACKs carrying a SACK option
+  Time m_firstRetransmission; //!< Time of the first retransmission
+  Time m_lastRetransmission;  //!< Time of the last retransmission
+  SequenceNumber32 m_highTx;  //!< Highest sequence number sent
+};
+
+TcpSackRecoveryTest::TcpSackRecoveryTest (uint32_t firstSeqToKill, uint32_t nToKill,
+                                          const std::string &desc)
+  : TcpGeneralTest (desc),
+    m_firstSeqToKill (firstSeqToKill),
+    m_nToKill (nToKill),
+    m_segmentSize (500),
+    m_retransmissions (0),
+    m_recoveries (0),
+    m_sackSent (0),
+    m_highTx (0)
+{
+}
+
+void
+TcpSackRecoveryTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  // A bulk transfer: the sender is limited by its congestion window
+  SetAppPktCount (200);
+  SetAppPktInterval (MicroSeconds (100));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpSackRecoveryTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetSegmentSize (SENDER, m_segmentSize);
+  SetSegmentSize (RECEIVER, m_segmentSize);
+}
+
+Ptr<ErrorModel>
+TcpSackRecoveryTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  for (uint32_t i = 0; i < m_nToKill; ++i)
+    {
+      errorModel->AddSeqToKill (SequenceNumber32 (m_firstSeqToKill + i * m_segmentSize));
+    }
+  return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+void
+TcpSackRecoveryTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == RECEIVER)
+    {
+      if (h.HasOption (TcpOption::SACK))
+        {
+          ++m_sackSent;
+        }
+      return;
+    }
+  if (h.GetFlags () & TcpHeader::SYN)
+    {
+      NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACKPERMITTED), true,
+                             "SYN without SACK-permitted option");
+      return;
+    }
+  if (p->GetSize () == 0)
+    {
+      return;
+    }
+  if (h.GetSequenceNumber () < m_highTx)
+    {
+      uint32_t seq = h.GetSequenceNumber ().GetValue ();
+      NS_TEST_ASSERT_MSG_EQ ((seq >= m_firstSeqToKill
+                              && seq < m_firstSeqToKill + m_nToKill * m_segmentSize),
+                             true, "Retransmission of a segment not lost: " << seq);
+      if (m_retransmissions == 0)
+        {
+          m_firstRetransmission = Simulator::Now ();
+        }
+      m_lastRetransmission = Simulator::Now ();
+      ++m_retransmissions;
+    }
+  else
+    {
+      m_highTx = h.GetSequenceNumber () + SequenceNumber32 (p->GetSize ());
+    }
+}
+
+void
+TcpSackRecoveryTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  NS_TEST_ASSERT_MSG_EQ (true, false, "The retransmission timer expired");
+}
+
+void
+TcpSackRecoveryTest::CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                                     const TcpSocketState::TcpCongState_t newValue)
+{
+  if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+      ++m_recoveries;
+    }
+}
+
+void
+TcpSackRecoveryTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_sackSent, 0, "The receiver never sent a SACK option");
+  NS_TEST_ASSERT_MSG_EQ (m_recoveries, 1, "A single recovery repairs the burst");
+  NS_TEST_ASSERT_MSG_EQ (m_retransmissions, m_nToKill, "Each lost segment is retransmitted once");
+  // The RTT is 100 ms: NewReno would repair one lost segment per RTT
+  NS_TEST_ASSERT_MSG_LT (m_lastRetransmission - m_firstRetransmission, MilliSeconds (200),
+                         "The burst is not repaired within two RTTs");
+  NS_TEST_ASSERT_MSG_EQ (GetCongStateFrom (GetTcb (SENDER)), TcpSocketState::CA_OPEN,
+                         "The sender did not leave the recovery");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for SACK and SACK-based loss recovery
+ */
+static class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ()
+    : TestSuite ("tcp-sack-test", UNIT)
+  {
+    // The general tests enable the packet metadata, before any packet is created
+    AddTestCase (new TcpSackRecoveryTest (30001, 1, "SACK recovery of a single loss"), TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTest (30001, 4, "SACK recovery of a burst of losses"), TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTest (30001, 8, "SACK recovery of a long burst of losses"), TestCase::QUICK);
+    AddTestCase (new TcpSackScoreboardTestCase (), TestCase::QUICK);
+    AddTestCase (new TcpRackTestCase (), TestCase::QUICK);
+  }
+} g_tcpSackTestSuite;
+
+} // namespace ns3
@@ -38,6 +38,7 @@ NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_fileFactory.SetTypeId ("ns3::PcapFileWrapper");
 }
 
 PcapHelper::~PcapHelper ()
@@ -55,7 +56,7 @@ PcapHelper::CreateFile (
 {
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
-  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  Ptr<PcapFileWrapper> file = m_fileFactory.Create<PcapFileWrapper> ();
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +77,22 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::SetFileAttribute (std::string name, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (name);
+  m_fileFactory.Set (name, value);
+}
+
+void
+PcapHelper::SetFileFactory (const ObjectFactory &factory)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT (factory.GetTypeId ().IsChildOf (PcapFileWrapper::GetTypeId ())
+             || factory.GetTypeId () == PcapFileWrapper::GetTypeId ());
+  m_fileFactory = factory;
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -23,6 +23,7 @@
 #include "ns3/net-device-container.h"
 #include "ns3/node-container.h"
 #include "ns3/simulator.h"
+#include "ns3/object-factory.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
 
@@ -109,6 +110,25 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+
+  /**
+   * @brief Set an attribute of the PcapFileWrapper objects created by CreateFile.
+   *
+   * This is how helpers select the buffered writer ("WriteBufferSize",
+   * "BackgroundFlush"), compressed output ("Compression") or a default
+   * snapshot length ("CaptureSize") for the files they create.
+   *
+   * @param name the name of the attribute to set
+   * @param value the value of the attribute to set
+   */
+  void SetFileAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Replace the factory used by CreateFile to create PcapFileWrapper objects.
+   *
+   * @param factory a factory for ns3::PcapFileWrapper objects
+   */
+  void SetFileFactory (const ObjectFactory &factory);
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -141,6 +161,8 @@ private:
    * @see DefaultSink
    */
   static void SinkWithHeader (Ptr<PcapFileWrapper> file, const Header& header, Ptr<const Packet> p);
+
+  ObjectFactory m_fileFactory; //!< factory for the pcap file wrappers
 };
 
 template <typename T> void
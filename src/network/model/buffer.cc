@@ -20,6 +20,7 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -51,6 +52,12 @@ NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
 uint32_t Buffer::g_recommendedStart = 0;
+/* Room for the A-MPDU subframe, QoS data MAC, LLC/SNAP, IPv4 and TCP
+ * headers with options before the data, and for the FCS after it. */
+uint32_t Buffer::g_reservedHeadroom = 128;
+uint32_t Buffer::g_reservedTailroom = 16;
+uint64_t Buffer::g_nAllocations = 0;
+uint64_t Buffer::g_nReallocations = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -159,6 +166,11 @@ Buffer::Create (uint32_t size)
 }
 #endif /* BUFFER_FREE_LIST */
 
+/// Memory accounting category of the buffer data, created on first use.
+static uint32_t g_dataCategory = 0;
+/// Whether g_dataCategory was created.
+static bool g_dataCategoryCreated = false;
+
 struct Buffer::Data *
 Buffer::Allocate (uint32_t reqSize)
 {
@@ -170,9 +182,20 @@ Buffer::Allocate (uint32_t reqSize)
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
   uint8_t *b = new uint8_t [size];
+  g_nAllocations++;
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
+  data->m_accounted = MemoryAccounting::IsEnabled ();
+  if (data->m_accounted)
+    {
+      if (!g_dataCategoryCreated)
+        {
+          g_dataCategory = MemoryAccounting::GetCategory ("ns3::Buffer::Data");
+          g_dataCategoryCreated = true;
+        }
+      MemoryAccounting::NotifyAllocation (g_dataCategory, size);
+    }
   return data;
 }
 
@@ -181,10 +204,54 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  if (data->m_accounted)
+    {
+      MemoryAccounting::NotifyDeallocation (g_dataCategory, data->m_size - 1 + sizeof (struct Buffer::Data));
+    }
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
   delete [] buf;
 }
 
+void
+Buffer::SetReservedSpace (uint32_t headroom, uint32_t tailroom)
+{
+  NS_LOG_FUNCTION (headroom << tailroom);
+  g_reservedHeadroom = headroom;
+  g_reservedTailroom = tailroom;
+}
+
+uint32_t
+Buffer::GetReservedHeadroom (void)
+{
+  return g_reservedHeadroom;
+}
+
+uint32_t
+Buffer::GetReservedTailroom (void)
+{
+  return g_reservedTailroom;
+}
+
+uint64_t
+Buffer::GetAllocations (void)
+{
+  return g_nAllocations;
+}
+
+uint64_t
+Buffer::GetReallocations (void)
+{
+  return g_nReallocations;
+}
+
+void
+Buffer::ResetCounters (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_nAllocations = 0;
+  g_nReallocations = 0;
+}
+
 Buffer::Buffer ()
 {
   NS_LOG_FUNCTION (this);
@@ -244,8 +311,9 @@ void
 Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
-  m_data = Buffer::Create (0);
-  m_start = std::min (m_data->m_size, g_recommendedStart);
+  m_data = Buffer::Create (g_reservedHeadroom + g_reservedTailroom);
+  m_start = std::min (m_data->m_size - g_reservedTailroom,
+                      std::max (g_recommendedStart, g_reservedHeadroom));
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
   m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
@@ -325,9 +393,10 @@ Buffer::AddAtStart (uint32_t start)
     } 
   else
     {
-      uint32_t newSize = GetInternalSize () + start;
+      g_nReallocations++;
+      uint32_t newSize = g_reservedHeadroom + start + GetInternalSize () + g_reservedTailroom;
       struct Buffer::Data *newData = Buffer::Create (newSize);
-      memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
+      memcpy (newData->m_data + g_reservedHeadroom + start, m_data->m_data + m_start, GetInternalSize ());
       m_data->m_count--;
       if (m_data->m_count == 0)
         {
@@ -335,7 +404,7 @@ Buffer::AddAtStart (uint32_t start)
         }
       m_data = newData;
 
-      int32_t delta = start - m_start;
+      int32_t delta = g_reservedHeadroom + start - m_start;
       m_start += delta;
       m_zeroAreaStart += delta;
       m_zeroAreaEnd += delta;
@@ -370,9 +439,10 @@ Buffer::AddAtEnd (uint32_t end)
     } 
   else
     {
-      uint32_t newSize = GetInternalSize () + end;
+      g_nReallocations++;
+      uint32_t newSize = g_reservedHeadroom + GetInternalSize () + end + g_reservedTailroom;
       struct Buffer::Data *newData = Buffer::Create (newSize);
-      memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
+      memcpy (newData->m_data + g_reservedHeadroom, m_data->m_data + m_start, GetInternalSize ());
       m_data->m_count--;
       if (m_data->m_count == 0) 
         {
@@ -380,7 +450,7 @@ Buffer::AddAtEnd (uint32_t end)
         }
       m_data = newData;
 
-      int32_t delta = -m_start;
+      int32_t delta = g_reservedHeadroom - m_start;
       m_zeroAreaStart += delta;
       m_zeroAreaEnd += delta;
       m_end += delta;
@@ -641,6 +641,42 @@ private:
    */
   Buffer (uint32_t dataSize, bool initialize);
   ~Buffer ();
+
+  /**
+   * \brief Reserve space before and after the data of new buffers.
+   *
+   * The headroom is reserved when a buffer is created and whenever its
+   * data has to be reallocated, so that the headers added at the start
+   * of a packet by the protocol stack are written in place.  The
+   * tailroom does the same for the trailers added at the end.
+   *
+   * \param headroom the number of bytes reserved before the data
+   * \param tailroom the number of bytes reserved after the data
+   */
+  static void SetReservedSpace (uint32_t headroom, uint32_t tailroom);
+  /**
+   * \returns the number of bytes reserved before the data of new buffers
+   */
+  static uint32_t GetReservedHeadroom (void);
+  /**
+   * \returns the number of bytes reserved after the data of new buffers
+   */
+  static uint32_t GetReservedTailroom (void);
+  /**
+   * \returns the number of buffer data storages allocated from the
+   * heap since the last call to ResetCounters
+   */
+  static uint64_t GetAllocations (void);
+  /**
+   * \returns the number of times data was copied to a new storage by
+   * AddAtStart or AddAtEnd because the current storage lacked room or
+   * was shared, since the last call to ResetCounters
+   */
+  static uint64_t GetReallocations (void);
+  /**
+   * \brief Reset the allocation and reallocation counters.
+   */
+  static void ResetCounters (void);
 private:
   /**
    * This data structure is variable-sized through its last member whose size
@@ -677,6 +713,10 @@ private:
      * end of the area in which user bytes were written.
      */
     uint32_t m_dirtyEnd;
+    /**
+     * True if this instance is counted by the MemoryAccounting.
+     */
+    bool m_accounted;
     /**
      * The real data buffer holds _at least_ one byte.
      * Its real size is stored in the m_size field.
@@ -768,6 +808,11 @@ private:
    */
   static uint32_t g_recommendedStart;
 
+  static uint32_t g_reservedHeadroom; //!< bytes reserved before the data
+  static uint32_t g_reservedTailroom; //!< bytes reserved after the data
+  static uint64_t g_nAllocations;     //!< number of data storages allocated
+  static uint64_t g_nReallocations;   //!< number of data copies to a new storage
+
   /**
    * offset to the start of the virtual zero area from the start
    * of m_data->m_data
@@ -669,6 +669,16 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this device splits the super-segments tagged with a
+   * GsoTag itself, false otherwise (the default).
+   *
+   * The network layer hands the super-segments to a device supporting
+   * generic segmentation offload whatever their size, and splits them
+   * before handing them to the other devices.
+   */
+  virtual bool SupportsGso (void) const;
+
 };
 
 } // namespace ns3
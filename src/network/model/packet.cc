@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/memory-accounting.h"
 #include <string>
 #include <cstdarg>
 
@@ -30,6 +31,31 @@ NS_LOG_COMPONENT_DEFINE ("Packet");
 
 uint32_t Packet::m_globalUid = 0;
 
+/// Memory accounting category of the packets, created on first use.
+static uint32_t g_packetCategory = 0;
+/// Whether g_packetCategory was created.
+static bool g_packetCategoryCreated = false;
+
+/**
+ * Account the creation of a packet if memory accounting is enabled.
+ * \return true if the packet was accounted
+ */
+static bool
+NotifyPacketCreated (void)
+{
+  if (MemoryAccounting::IsEnabled ())
+    {
+      if (!g_packetCategoryCreated)
+        {
+          g_packetCategory = MemoryAccounting::GetCategory ("ns3::Packet");
+          g_packetCategoryCreated = true;
+        }
+      MemoryAccounting::NotifyAllocation (g_packetCategory, sizeof (Packet));
+      return true;
+    }
+  return false;
+}
+
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
 {
@@ -141,6 +167,7 @@ Packet::Packet ()
     m_nixVector (0)
 {
   m_globalUid++;
+  m_accounted = NotifyPacketCreated ();
 }
 
 Packet::Packet (const Packet &o)
@@ -151,6 +178,15 @@ Packet::Packet (const Packet &o)
 {
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
+  m_accounted = NotifyPacketCreated ();
+}
+
+Packet::~Packet ()
+{
+  if (m_accounted)
+    {
+      MemoryAccounting::NotifyDeallocation (g_packetCategory, sizeof (Packet));
+    }
 }
 
 Packet &
@@ -183,6 +219,7 @@ Packet::Packet (uint32_t size)
     m_nixVector (0)
 {
   m_globalUid++;
+  m_accounted = NotifyPacketCreated ();
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -193,6 +230,7 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
 {
   NS_ASSERT (magic);
   Deserialize (buffer, size);
+  m_accounted = NotifyPacketCreated ();
 }
 
 Packet::Packet (uint8_t const*buffer, uint32_t size)
@@ -209,6 +247,7 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
     m_nixVector (0)
 {
   m_globalUid++;
+  m_accounted = NotifyPacketCreated ();
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -222,6 +261,7 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_metadata (metadata),
     m_nixVector (0)
 {
+  m_accounted = NotifyPacketCreated ();
 }
 
 Ptr<Packet>
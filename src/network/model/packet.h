@@ -238,6 +238,10 @@ public:
    * \param o object to copy
    */
   Packet (const Packet &o);
+  /**
+   * \brief Destructor
+   */
+  ~Packet ();
   /**
    * \brief Basic assignment
    * \param o object to copy
@@ -727,6 +731,8 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+  bool m_accounted; //!< True if the packet is counted by the MemoryAccounting
+
   static uint32_t m_globalUid; //!< Global counter of packets Uid
 };
 
@@ -361,6 +361,71 @@ BufferTest::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
 }
 //-----------------------------------------------------------------------------
+/**
+ * Check that the headers and trailers which fit in the reserved space
+ * are written without reallocating the buffer data.
+ */
+class BufferReservedSpaceTest : public TestCase
+{
+public:
+  BufferReservedSpaceTest ();
+private:
+  virtual void DoRun (void);
+};
+
+BufferReservedSpaceTest::BufferReservedSpaceTest ()
+  : TestCase ("Reserved headroom and tailroom")
+{
+}
+
+void
+BufferReservedSpaceTest::DoRun (void)
+{
+  uint32_t headroom = Buffer::GetReservedHeadroom ();
+  uint32_t tailroom = Buffer::GetReservedTailroom ();
+  Buffer::SetReservedSpace (64, 8);
+  Buffer::ResetCounters ();
+
+  Buffer buffer = Buffer (100);
+  buffer.AddAtStart (20);
+  buffer.Begin ().WriteU8 (0x11, 20);
+  buffer.AddAtStart (40);
+  buffer.Begin ().WriteU8 (0x22, 40);
+  buffer.AddAtEnd (8);
+  Buffer::Iterator i = buffer.End ();
+  i.Prev (8);
+  i.WriteU8 (0x33, 8);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetReallocations (), 0, "Reallocation within the reserved space");
+
+  // a copy which overwrites the start of the shared data moves it once,
+  // with a new headroom
+  Buffer copy = buffer;
+  copy.RemoveAtStart (1);
+  copy.AddAtStart (1);
+  copy.Begin ().WriteU8 (0x44);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetReallocations (), 1, "Missing reallocation");
+  copy.AddAtStart (64);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetReallocations (), 1, "Headroom not reserved on reallocation");
+  copy.AddAtStart (1);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetReallocations (), 2, "Missing reallocation");
+
+  NS_TEST_ASSERT_MSG_EQ (copy.GetSize (), 233, "Unexpected size");
+  i = copy.Begin ();
+  i.Next (65);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)i.ReadU8 (), 0x44, "Header lost on reallocation");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)i.ReadU8 (), 0x22, "Header lost on reallocation");
+  i.Next (38);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)i.ReadU8 (), 0x11, "Header lost on reallocation");
+  i.Next (19);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)i.ReadU8 (), 0x00, "Zero area lost on reallocation");
+  i = copy.End ();
+  i.Prev (1);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)i.ReadU8 (), 0x33, "Trailer lost on reallocation");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)buffer.Begin ().ReadU8 (), 0x22, "Original buffer modified");
+
+  Buffer::SetReservedSpace (headroom, tailroom);
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -371,6 +436,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferReservedSpaceTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite;
@@ -1121,6 +1121,107 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that a file written through the write-behind buffer,
+// with or without the background writer, is identical to a file written
+// record by record.
+// ===========================================================================
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write the known packets a number of times to a file.
+   * \param f the file, opened for writing
+   * \param filename the name of the file
+   */
+  void WritePackets (PcapFile &f, std::string filename);
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check that buffered and background-flushed PcapFile writes produce the same file")
+{
+}
+
+void
+BufferedWriteTestCase::WritePackets (PcapFile &f, std::string filename)
+{
+  f.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  f.Init (1, N_PACKET_BYTES);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Init (1, " << N_PACKET_BYTES << ") returns error");
+
+  for (uint32_t round = 0; round < 100; ++round)
+    {
+      for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+          PacketEntry const & p = knownPackets[i];
+          f.Write (p.tsSec + round, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+          NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Write must not fail");
+        }
+    }
+  f.Close ();
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Close must not fail");
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  std::string plainFilename = CreateTempDirFilename ("plain.pcap");
+  std::string bufferedFilename = CreateTempDirFilename ("buffered.pcap");
+  std::string backgroundFilename = CreateTempDirFilename ("background.pcap");
+
+  PcapFile plain;
+  WritePackets (plain, plainFilename);
+
+  //
+  // A buffer smaller than a record forces a block per record.
+  //
+  PcapFile buffered;
+  buffered.SetWriteBuffer (100, false);
+  WritePackets (buffered, bufferedFilename);
+
+  PcapFile background;
+  background.SetWriteBuffer (512, true);
+  WritePackets (background, backgroundFilename);
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (plainFilename, bufferedFilename, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Buffered file differs from the plain file at packet " << packets);
+  NS_TEST_EXPECT_MSG_EQ (packets, 100 * N_KNOWN_PACKETS, "Buffered file has the wrong number of packets");
+
+  packets = 0;
+  diff = PcapFile::Diff (plainFilename, backgroundFilename, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Background-flushed file differs from the plain file at packet " << packets);
+  NS_TEST_EXPECT_MSG_EQ (packets, 100 * N_KNOWN_PACKETS, "Background-flushed file has the wrong number of packets");
+
+  if (PcapFile::IsCompressionSupported (PcapFile::COMPRESSION_GZIP))
+    {
+      std::string gzipFilename = CreateTempDirFilename ("compressed.pcap.gz");
+      PcapFile compressed;
+      compressed.SetCompression (PcapFile::COMPRESSION_GZIP);
+      WritePackets (compressed, gzipFilename);
+
+      FILE *p = std::fopen (gzipFilename.c_str (), "rb");
+      NS_TEST_ASSERT_MSG_NE (p, 0, "Compressed file was not created");
+      uint8_t magic[2] = { 0, 0 };
+      size_t result = std::fread (magic, 1, 2, p);
+      std::fclose (p);
+      NS_TEST_EXPECT_MSG_EQ (result, 2, "Compressed file is empty");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)magic[0], 0x1f, "Compressed file has no gzip magic number");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)magic[1], 0x8b, "Compressed file has no gzip magic number");
+      remove (gzipFilename.c_str ());
+    }
+
+  remove (plainFilename.c_str ());
+  remove (bufferedFilename.c_str ());
+  remove (backgroundFilename.c_str ());
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1239,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
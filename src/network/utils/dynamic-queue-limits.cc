@@ -90,6 +90,7 @@ DynamicQueueLimits::Reset ()
   m_limit = 0;
   m_numQueued = 0;
   m_numCompleted = 0;
+  m_adjLimit = 0;
   m_lastObjCnt = 0;
   m_prevNumQueued = 0;
   m_prevLastObjCnt = 0;
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <map>
+#include "gso-tag.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GsoTag");
+
+NS_OBJECT_ENSURE_REGISTERED (GsoTag);
+
+/**
+ * \returns the functions splitting the super-segments, indexed by protocol number
+ */
+static std::map<uint16_t, GsoTag::SegmentCallback> &
+GetSegmentCallbacks (void)
+{
+  static std::map<uint16_t, GsoTag::SegmentCallback> callbacks;
+  return callbacks;
+}
+
+/**
+ * \returns the functions coalescing the packets, indexed by protocol number
+ */
+static std::map<uint16_t, GsoTag::CoalesceCallback> &
+GetCoalesceCallbacks (void)
+{
+  static std::map<uint16_t, GsoTag::CoalesceCallback> callbacks;
+  return callbacks;
+}
+
+TypeId
+GsoTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GsoTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Network")
+    .AddConstructor<GsoTag> ()
+  ;
+  return tid;
+}
+TypeId
+GsoTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t
+GsoTag::GetSerializedSize (void) const
+{
+  return 2;
+}
+void
+GsoTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU16 (m_segmentSize);
+}
+void
+GsoTag::Deserialize (TagBuffer buf)
+{
+  m_segmentSize = buf.ReadU16 ();
+}
+void
+GsoTag::Print (std::ostream &os) const
+{
+  os << "GsoSegmentSize=" << m_segmentSize;
+}
+GsoTag::GsoTag ()
+  : Tag (),
+    m_segmentSize (0)
+{
+}
+
+GsoTag::GsoTag (uint16_t segmentSize)
+  : Tag (),
+    m_segmentSize (segmentSize)
+{
+}
+
+void
+GsoTag::SetSegmentSize (uint16_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+uint16_t
+GsoTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+void
+GsoTag::SetSegmentCallback (uint16_t protocol, SegmentCallback cb)
+{
+  NS_LOG_FUNCTION (protocol);
+  GetSegmentCallbacks ()[protocol] = cb;
+}
+
+bool
+GsoTag::Segment (Ptr<const Packet> packet, uint16_t protocol, std::list<Ptr<Packet> > &segments)
+{
+  NS_LOG_FUNCTION (packet << protocol);
+  GsoTag tag;
+  if (!packet->PeekPacketTag (tag) || tag.GetSegmentSize () == 0)
+    {
+      return false;
+    }
+  std::map<uint16_t, SegmentCallback>::const_iterator it = GetSegmentCallbacks ().find (protocol);
+  if (it == GetSegmentCallbacks ().end () || it->second.IsNull ())
+    {
+      NS_LOG_WARN ("No function splits the super-segments of protocol " << protocol);
+      return false;
+    }
+  std::list<Ptr<Packet> > split = it->second (packet, tag.GetSegmentSize ());
+  for (std::list<Ptr<Packet> >::iterator i = split.begin (); i != split.end (); ++i)
+    {
+      (*i)->RemovePacketTag (tag);
+      segments.push_back (*i);
+    }
+  NS_LOG_LOGIC ("Split a super-segment of " << packet->GetSize () << " bytes into " << split.size () << " segments");
+  return true;
+}
+
+void
+GsoTag::SetCoalesceCallback (uint16_t protocol, CoalesceCallback cb)
+{
+  NS_LOG_FUNCTION (protocol);
+  GetCoalesceCallbacks ()[protocol] = cb;
+}
+
+std::list<Ptr<Packet> >
+GsoTag::Coalesce (const std::list<Ptr<Packet> > &packets, uint16_t protocol)
+{
+  NS_LOG_FUNCTION (packets.size () << protocol);
+  std::map<uint16_t, CoalesceCallback>::const_iterator it = GetCoalesceCallbacks ().find (protocol);
+  if (packets.size () < 2 || it == GetCoalesceCallbacks ().end () || it->second.IsNull ())
+    {
+      return packets;
+    }
+  std::list<Ptr<Packet> > coalesced = it->second (packets);
+  NS_LOG_LOGIC ("Coalesced " << packets.size () << " packets into " << coalesced.size ());
+  return coalesced;
+}
+
+} // namespace ns3
@@ -19,8 +19,10 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
+#include "ns3/simulator.h"
 #include "pcap-file-wrapper.h"
 
 namespace ns3 {
@@ -46,6 +48,26 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size in bytes of the write-behind buffer used for files opened for writing. "
+                   "Records are written to disk in blocks of this size; zero writes every record "
+                   "directly to the file stream.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BackgroundFlush",
+                   "Whether full write buffers are written to disk by a helper thread "
+                   "instead of the simulation thread. Requires a non-zero WriteBufferSize "
+                   "or compression.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_backgroundFlush),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Compression",
+                   "Compression applied to files opened for writing.",
+                   EnumValue (PcapFile::COMPRESSION_NONE),
+                   MakeEnumAccessor (&PcapFileWrapper::m_compression),
+                   MakeEnumChecker (PcapFile::COMPRESSION_NONE, "None",
+                                    PcapFile::COMPRESSION_GZIP, "Gzip"))
   ;
   return tid;
 }
@@ -93,7 +115,26 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  if ((mode & std::ios::in) == 0)
+    {
+      m_file.SetWriteBuffer (m_writeBufferSize, m_backgroundFlush);
+      m_file.SetCompression (m_compression);
+    }
   m_file.Open (filename, mode);
+  if ((mode & std::ios::in) == 0 && !m_file.Fail ()
+      && (m_writeBufferSize > 0 || m_compression != PcapFile::COMPRESSION_NONE))
+    {
+      // The trace sources the file is connected to may outlive the
+      // simulation: write the buffered records out when it ends.
+      Simulator::ScheduleDestroy (&PcapFileWrapper::Close, Ptr<PcapFileWrapper> (this));
+    }
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Flush ();
 }
 
 void
@@ -220,10 +220,21 @@ public:
    */ 
   uint32_t GetDataLinkType (void);
 
+  /**
+   * \brief Write any buffered record out to the file.
+   *
+   * Only useful when the WriteBufferSize attribute is set, e.g. to look at
+   * the file while the simulation is still running.
+   */
+  void Flush (void);
+
 private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_writeBufferSize; //!< size of the write-behind buffer, zero if unbuffered
+  bool     m_backgroundFlush; //!< write the buffer out from a helper thread
+  PcapFile::Compression m_compression; //!< output compression
 };
 
 } // namespace ns3
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <cstring>
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/fatal-impl.h"
@@ -29,6 +30,15 @@
 #include "pcap-file.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
 // adding any ns-3 specific constructs such as Packet to this file.
@@ -47,10 +57,26 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+const uint32_t COMPRESSED_BUFFER_DEFAULT = 1 << 16; /**< Write block size used for compressed output when none is set */
+const uint32_t MAX_PENDING_BLOCKS = 4;        /**< Blocks the background writer may lag behind before writes block */
+const uint64_t WRITER_WAIT_TIMEOUT = 1000000; /**< Bound in ns of the waits between the writer and the simulation */
+
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_bufferSize (0),
+    m_backgroundFlush (false),
+    m_compression (COMPRESSION_NONE),
+    m_gzFile (0),
+    m_writing (false),
+    m_writeFailed (false),
+    m_writerBusy (false),
+    m_stopWriter (false),
+    m_writerThread (0),
+    m_blocksMutex (0),
+    m_blocksQueued (0),
+    m_blockWritten (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,7 +94,16 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.fail ();
+  if (m_writerThread != 0)
+    {
+      // the stream belongs to the background writer, which reports errors
+      // through m_writeFailed
+      m_blocksMutex->Lock ();
+      bool failed = m_writeFailed;
+      m_blocksMutex->Unlock ();
+      return failed;
+    }
+  return m_file.fail () || m_writeFailed;
 }
 bool 
 PcapFile::Eof (void) const
@@ -88,9 +123,277 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writing)
+    {
+      FlushBuffer ();
+      StopBackgroundWriter ();
+      m_writeBuffer.clear ();
+      m_freeBlocks.clear ();
+      m_writing = false;
+    }
+#ifdef HAVE_ZLIB_H
+  if (m_gzFile != 0)
+    {
+      if (gzclose (static_cast<gzFile> (m_gzFile)) != Z_OK)
+        {
+          m_writeFailed = true;
+        }
+      m_gzFile = 0;
+      return;
+    }
+#endif
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBuffer (uint32_t bufferSize, bool backgroundFlush)
+{
+  NS_LOG_FUNCTION (this << bufferSize << backgroundFlush);
+  NS_ASSERT_MSG (!m_file.is_open () && m_gzFile == 0, "PcapFile::SetWriteBuffer(): file already open");
+  m_bufferSize = bufferSize;
+  m_backgroundFlush = backgroundFlush;
+}
+
+void
+PcapFile::SetCompression (Compression compression)
+{
+  NS_LOG_FUNCTION (this << compression);
+  NS_ASSERT_MSG (!m_file.is_open () && m_gzFile == 0, "PcapFile::SetCompression(): file already open");
+  NS_ABORT_MSG_UNLESS (IsCompressionSupported (compression),
+                       "PcapFile::SetCompression(): compression " << compression << " not supported by this build");
+  m_compression = compression;
+}
+
+bool
+PcapFile::IsCompressionSupported (Compression compression)
+{
+  NS_LOG_FUNCTION (compression);
+  switch (compression)
+    {
+    case COMPRESSION_NONE:
+      return true;
+    case COMPRESSION_GZIP:
+#ifdef HAVE_ZLIB_H
+      return true;
+#else
+      return false;
+#endif
+    default:
+      return false;
+    }
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_writing)
+    {
+      return;
+    }
+  FlushBuffer ();
+#ifdef HAVE_PTHREAD_H
+  if (m_writerThread != 0)
+    {
+      //
+      // Wait for the background writer to drain its queue.  The condition is
+      // reset before the queue is checked and TimedWait () does not reset
+      // it again, so a signal sent in between is not lost.
+      //
+      while (true)
+        {
+          m_blockWritten->SetCondition (false);
+          m_blocksMutex->Lock ();
+          bool drained = m_pendingBlocks.empty () && !m_writerBusy;
+          m_blocksMutex->Unlock ();
+          if (drained)
+            {
+              break;
+            }
+          m_blockWritten->TimedWait (WRITER_WAIT_TIMEOUT);
+        }
+    }
+#endif
+  if (m_writerThread == 0 && m_gzFile == 0)
+    {
+      m_file.flush ();
+    }
+}
+
+bool
+PcapFile::IsBuffered (void) const
+{
+  return m_writing && (m_bufferSize > 0 || m_gzFile != 0);
+}
+
+void
+PcapFile::WriteBytes (uint8_t const *data, uint32_t size)
+{
+  if (IsBuffered ())
+    {
+      std::memcpy (ReserveBytes (size), data, size);
+    }
+  else
+    {
+      m_file.write ((const char *)data, size);
+    }
+}
+
+uint8_t *
+PcapFile::ReserveBytes (uint32_t size)
+{
+  NS_ASSERT (IsBuffered ());
+  if (!m_writeBuffer.empty () && m_writeBuffer.size () + size > m_bufferSize)
+    {
+      FlushBuffer ();
+    }
+  std::size_t offset = m_writeBuffer.size ();
+  m_writeBuffer.resize (offset + size);
+  return &m_writeBuffer[offset];
+}
+
+void
+PcapFile::FlushBuffer (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writeBuffer.empty ())
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_writerThread != 0)
+    {
+      //
+      // Queue the block for the background writer, waiting for it to catch up
+      // if too many blocks are already pending, then pick up a recycled block
+      // to keep filling.
+      //
+      std::vector<uint8_t> next;
+      while (true)
+        {
+          m_blockWritten->SetCondition (false);
+          m_blocksMutex->Lock ();
+          if (m_pendingBlocks.size () < MAX_PENDING_BLOCKS)
+            {
+              m_pendingBlocks.push_back (std::vector<uint8_t> ());
+              m_pendingBlocks.back ().swap (m_writeBuffer);
+              if (!m_freeBlocks.empty ())
+                {
+                  next.swap (m_freeBlocks.front ());
+                  m_freeBlocks.pop_front ();
+                }
+              m_blocksMutex->Unlock ();
+              break;
+            }
+          m_blocksMutex->Unlock ();
+          m_blockWritten->TimedWait (WRITER_WAIT_TIMEOUT);
+        }
+      m_blocksQueued->SetCondition (true);
+      m_blocksQueued->Signal ();
+      next.clear ();
+      next.reserve (m_bufferSize);
+      m_writeBuffer.swap (next);
+      return;
+    }
+#endif
+  if (!WriteBlock (m_writeBuffer))
+    {
+      m_writeFailed = true;
+    }
+  m_writeBuffer.clear ();
+}
+
+bool
+PcapFile::WriteBlock (std::vector<uint8_t> const &block)
+{
+  if (block.empty ())
+    {
+      return true;
+    }
+#ifdef HAVE_ZLIB_H
+  if (m_gzFile != 0)
+    {
+      int written = gzwrite (static_cast<gzFile> (m_gzFile), &block[0], block.size ());
+      return written == static_cast<int> (block.size ());
+    }
+#endif
+  m_file.write ((const char *)&block[0], block.size ());
+  return !m_file.fail ();
+}
+
+void
+PcapFile::BackgroundWriter (void)
+{
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_blocksQueued->SetCondition (false);
+      m_blocksMutex->Lock ();
+      if (m_pendingBlocks.empty ())
+        {
+          bool stop = m_stopWriter;
+          m_blocksMutex->Unlock ();
+          if (stop)
+            {
+              break;
+            }
+          m_blocksQueued->TimedWait (WRITER_WAIT_TIMEOUT);
+          continue;
+        }
+      std::vector<uint8_t> block;
+      block.swap (m_pendingBlocks.front ());
+      m_pendingBlocks.pop_front ();
+      m_writerBusy = true;
+      m_blocksMutex->Unlock ();
+
+      bool written = WriteBlock (block);
+
+      m_blocksMutex->Lock ();
+      if (!written)
+        {
+          m_writeFailed = true;
+        }
+      m_writerBusy = false;
+      if (m_freeBlocks.size () < MAX_PENDING_BLOCKS)
+        {
+          m_freeBlocks.push_back (std::vector<uint8_t> ());
+          m_freeBlocks.back ().swap (block);
+        }
+      m_blocksMutex->Unlock ();
+      m_blockWritten->SetCondition (true);
+      m_blockWritten->Signal ();
+    }
+#endif
+}
+
+void
+PcapFile::StopBackgroundWriter (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_writerThread == 0)
+    {
+      return;
+    }
+  m_blocksMutex->Lock ();
+  m_stopWriter = true;
+  m_blocksMutex->Unlock ();
+  m_blocksQueued->SetCondition (true);
+  m_blocksQueued->Signal ();
+  m_writerThread->Join ();
+  delete m_writerThread;
+  m_writerThread = 0;
+  delete m_blocksMutex;
+  delete m_blocksQueued;
+  delete m_blockWritten;
+  m_blocksMutex = 0;
+  m_blocksQueued = 0;
+  m_blockWritten = 0;
+  m_pendingBlocks.clear ();
+  m_stopWriter = false;
+#endif
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -204,9 +507,17 @@ PcapFile::WriteFileHeader (void)
   NS_LOG_FUNCTION (this);
   //
   // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
+  // at the start of the file.  A buffered file is always initialized right
+  // after it is opened, so the header simply goes first in the buffer.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (IsBuffered ())
+    {
+      NS_ASSERT_MSG (m_writeBuffer.empty (), "PcapFile::Init(): buffered file must be initialized before writing packets");
+    }
+  else
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +545,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteBytes ((const uint8_t *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteBytes ((const uint8_t *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteBytes ((const uint8_t *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteBytes ((const uint8_t *)&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteBytes ((const uint8_t *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteBytes ((const uint8_t *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteBytes ((const uint8_t *)&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -333,12 +644,55 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   mode |= std::ios::binary;
 
   m_filename=filename;
-  m_file.open (filename.c_str (), mode);
+  m_writeFailed = false;
+  if ((mode & std::ios::in) == 0 && m_compression == COMPRESSION_GZIP)
+    {
+#ifdef HAVE_ZLIB_H
+      m_gzFile = gzopen (filename.c_str (), "wb");
+      if (m_gzFile == 0)
+        {
+          m_file.setstate (std::ios::failbit);
+          return;
+        }
+      gzbuffer (static_cast<gzFile> (m_gzFile), 1 << 17);
+#endif
+    }
+  else
+    {
+      m_file.open (filename.c_str (), mode);
+    }
   if (mode & std::ios::in)
     {
       // will set the fail bit if file header is invalid.
       ReadAndVerifyFileHeader ();
+      return;
     }
+  if (m_file.fail ())
+    {
+      return;
+    }
+
+  m_writing = true;
+  if (m_gzFile != 0 && m_bufferSize == 0)
+    {
+      m_bufferSize = COMPRESSED_BUFFER_DEFAULT;
+    }
+  if (IsBuffered ())
+    {
+      m_writeBuffer.reserve (m_bufferSize);
+    }
+#ifdef HAVE_PTHREAD_H
+  if (IsBuffered () && m_backgroundFlush)
+    {
+      m_blocksMutex = new SystemMutex ();
+      m_blocksQueued = new SystemCondition ();
+      m_blockWritten = new SystemCondition ();
+      m_stopWriter = false;
+      m_writerBusy = false;
+      m_writerThread = new SystemThread (MakeCallback (&PcapFile::BackgroundWriter, this));
+      m_writerThread->Start ();
+    }
+#endif
 }
 
 void
@@ -418,6 +772,16 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
       Swap (&header, &header);
     }
 
+  if (IsBuffered ())
+    {
+      //
+      // The record header goes into the buffer in one piece; the fields are
+      // plain uint32_t so the struct has no padding.
+      //
+      std::memcpy (ReserveBytes (sizeof (header)), &header, sizeof (header));
+      return inclLen;
+    }
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
@@ -435,6 +799,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
+  if (IsBuffered ())
+    {
+      WriteBytes (data, inclLen);
+      return;
+    }
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -444,6 +813,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (IsBuffered ())
+    {
+      p->CopyData (ReserveBytes (inclLen), inclLen);
+      return;
+    }
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -460,6 +834,13 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (IsBuffered ())
+    {
+      uint8_t *data = ReserveBytes (inclLen);
+      headerBuffer.CopyData (data, toCopy);
+      p->CopyData (data + toCopy, inclLen - toCopy);
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
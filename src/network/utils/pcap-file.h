@@ -23,6 +23,8 @@
 
 #include <string>
 #include <fstream>
+#include <list>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -30,6 +32,9 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class SystemThread;
+class SystemMutex;
+class SystemCondition;
 
 
 /**
@@ -45,6 +50,15 @@ public:
   static const int32_t  ZONE_DEFAULT    = 0;           /**< Time zone offset for current location */
   static const uint32_t SNAPLEN_DEFAULT = 65535;       /**< Default value for maximum octets to save per packet */
 
+  /**
+   * Compression applied to the output of files opened for writing.
+   */
+  enum Compression
+  {
+    COMPRESSION_NONE = 0,   /**< Plain libpcap file */
+    COMPRESSION_GZIP        /**< gzip-compressed libpcap file, readable by wireshark and tcpdump */
+  };
+
 public:
   PcapFile ();
   ~PcapFile ();
@@ -81,10 +95,53 @@ public:
   void Open (std::string const &filename, std::ios::openmode mode);
 
   /**
-   * Close the underlying file.
+   * Close the underlying file.  Any buffered record is written out and the
+   * background writer, if any, is stopped before the file is closed.
    */
   void Close (void);
 
+  /**
+   * \brief Configure write-behind buffering of the records written to the file.
+   *
+   * When buffering is enabled, file and record headers and packet bytes are
+   * accumulated in memory and handed to the file in blocks of \p bufferSize
+   * bytes instead of through one stream write per field.  If
+   * \p backgroundFlush is true, full blocks are written to disk by a helper
+   * thread so that the simulation thread never waits on disk I/O unless the
+   * writer falls more than a few blocks behind.
+   *
+   * This method must be called before Open ().  It has no effect on files
+   * opened for reading.
+   *
+   * \param bufferSize size in bytes of a write block; zero disables buffering.
+   * \param backgroundFlush write full blocks from a helper thread.
+   */
+  void SetWriteBuffer (uint32_t bufferSize, bool backgroundFlush);
+
+  /**
+   * \brief Select the compression applied to the file.
+   *
+   * Compressed output is always buffered.  This method must be called
+   * before Open ().  It has no effect on files opened for reading.
+   *
+   * \param compression the compression to apply.
+   */
+  void SetCompression (Compression compression);
+
+  /**
+   * \param compression a compression type
+   * \returns true if this build is able to write files with this compression.
+   */
+  static bool IsCompressionSupported (Compression compression);
+
+  /**
+   * \brief Write any buffered record out to the file.
+   *
+   * Returns once the data has been handed to the underlying stream, including
+   * data queued to the background writer.
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -366,11 +423,62 @@ private:
    */
   void ReadAndVerifyFileHeader (void);
 
+  /**
+   * \brief Write raw bytes to the file, through the write buffer if enabled
+   * \param data the bytes to write
+   * \param size the number of bytes to write
+   */
+  void WriteBytes (uint8_t const *data, uint32_t size);
+  /**
+   * \brief Reserve room at the end of the write buffer
+   * \param size the number of bytes to reserve
+   * \returns a pointer to the reserved area, to be filled by the caller
+   */
+  uint8_t *ReserveBytes (uint32_t size);
+  /**
+   * \return true if records go through the write buffer
+   */
+  bool IsBuffered (void) const;
+  /**
+   * \brief Hand the current write buffer over to the file or the background writer
+   */
+  void FlushBuffer (void);
+  /**
+   * \brief Write a block of bytes to the underlying (possibly compressed) stream
+   * \param block the block to write
+   * \return false if the write failed
+   */
+  bool WriteBlock (std::vector<uint8_t> const &block);
+  /**
+   * \brief Body of the background writer thread
+   */
+  void BackgroundWriter (void);
+  /**
+   * \brief Stop and join the background writer thread
+   */
+  void StopBackgroundWriter (void);
+
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+
+  uint32_t m_bufferSize;                  //!< write block size, zero if unbuffered
+  bool m_backgroundFlush;                 //!< write blocks from a helper thread
+  Compression m_compression;              //!< output compression
+  void *m_gzFile;                         //!< zlib stream when writing compressed output
+  bool m_writing;                         //!< file is open for writing
+  bool m_writeFailed;                     //!< a buffered write to the file failed
+  std::vector<uint8_t> m_writeBuffer;     //!< block being filled by the simulation thread
+  std::list<std::vector<uint8_t> > m_pendingBlocks; //!< blocks waiting for the background writer
+  std::list<std::vector<uint8_t> > m_freeBlocks;    //!< blocks recycled by the background writer
+  bool m_writerBusy;                      //!< background writer is writing a block
+  bool m_stopWriter;                      //!< background writer must exit
+  SystemThread *m_writerThread;           //!< background writer thread
+  SystemMutex *m_blocksMutex;             //!< protects the block lists and writer flags
+  SystemCondition *m_blocksQueued;        //!< signalled when a block is queued
+  SystemCondition *m_blockWritten;        //!< signalled when a block has been written
 };
 
 } // namespace ns3
@@ -0,0 +1,444 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "blockage-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BlockagePropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (BlockagePropagationLossModel);
+
+/**
+ * \param a a position
+ * \param b another position
+ * \return whether both positions are the same
+ */
+static bool
+IsSamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/**
+ * Clip the parameter interval of a segment to a slab of an axis.
+ *
+ * \param origin the coordinate of the start of the segment
+ * \param direction the length of the segment along the axis
+ * \param low the lower bound of the slab
+ * \param high the upper bound of the slab
+ * \param t0 the start of the parameter interval
+ * \param t1 the end of the parameter interval
+ * \return whether the clipped interval is not empty
+ */
+static bool
+ClipToSlab (double origin, double direction, double low, double high, double &t0, double &t1)
+{
+  if (direction == 0)
+    {
+      return origin >= low && origin <= high;
+    }
+  double ta = (low - origin) / direction;
+  double tb = (high - origin) / direction;
+  if (ta > tb)
+    {
+      std::swap (ta, tb);
+    }
+  t0 = std::max (t0, ta);
+  t1 = std::min (t1, tb);
+  return t0 <= t1;
+}
+
+TypeId
+BlockagePropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BlockagePropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<BlockagePropagationLossModel> ()
+    .AddAttribute ("CellSize",
+                   "The side (m) of the square cells in which the obstacles are registered.",
+                   DoubleValue (2.0),
+                   MakeDoubleAccessor (&BlockagePropagationLossModel::m_cellSize),
+                   MakeDoubleChecker<double> (0.01))
+    .AddAttribute ("UpdateInterval",
+                   "The interval between two samples of the position of the moving obstacles.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&BlockagePropagationLossModel::m_updateInterval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+BlockagePropagationLossModel::BlockagePropagationLossModel ()
+  : m_update (0),
+    m_nextUpdate (Seconds (0)),
+    m_nLinks (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BlockagePropagationLossModel::~BlockagePropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BlockagePropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_blockers.size (); i++)
+    {
+      m_blockers[i].mobility->TraceDisconnectWithoutContext ("CourseChange",
+        MakeCallback (&BlockagePropagationLossModel::CourseChange, this).Bind (i));
+    }
+  m_blockers.clear ();
+  m_grid.clear ();
+  m_links.clear ();
+  m_nLinks = 0;
+  m_dirty.clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+uint32_t
+BlockagePropagationLossModel::AddCylinder (Ptr<MobilityModel> mobility, double radius, double height, double attenuation)
+{
+  NS_LOG_FUNCTION (this << mobility << radius << height << attenuation);
+  struct Blocker blocker;
+  blocker.mobility = mobility;
+  blocker.box = false;
+  blocker.size = Vector (radius, radius, height);
+  blocker.attenuation = attenuation;
+  return AddBlocker (blocker);
+}
+
+uint32_t
+BlockagePropagationLossModel::AddBox (Ptr<MobilityModel> mobility, Vector size, double attenuation)
+{
+  NS_LOG_FUNCTION (this << mobility << size << attenuation);
+  struct Blocker blocker;
+  blocker.mobility = mobility;
+  blocker.box = true;
+  blocker.size = size;
+  blocker.attenuation = attenuation;
+  return AddBlocker (blocker);
+}
+
+uint32_t
+BlockagePropagationLossModel::AddBlocker (struct Blocker blocker)
+{
+  NS_ASSERT (blocker.mobility != 0);
+  uint32_t index = m_blockers.size ();
+  // not registered in any cell yet
+  blocker.xMin = 0;
+  blocker.xMax = -1;
+  blocker.yMin = 0;
+  blocker.yMax = -1;
+  blocker.moving = false;
+  blocker.dirty = false;
+  m_blockers.push_back (blocker);
+  SampleBlocker (index);
+  blocker.mobility->TraceConnectWithoutContext ("CourseChange",
+    MakeCallback (&BlockagePropagationLossModel::CourseChange, this).Bind (index));
+  return index;
+}
+
+uint32_t
+BlockagePropagationLossModel::GetNBlockers (void) const
+{
+  return m_blockers.size ();
+}
+
+void
+BlockagePropagationLossModel::CourseChange (uint32_t index, Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << index << mobility);
+  if (!m_blockers[index].dirty)
+    {
+      m_blockers[index].dirty = true;
+      m_dirty.push_back (index);
+    }
+}
+
+int32_t
+BlockagePropagationLossModel::GetCellIndex (double x) const
+{
+  return static_cast<int32_t> (std::floor (x / m_cellSize));
+}
+
+void
+BlockagePropagationLossModel::SampleBlocker (uint32_t index) const
+{
+  struct Blocker &blocker = m_blockers[index];
+  Vector position = blocker.mobility->GetPosition ();
+  Vector velocity = blocker.mobility->GetVelocity ();
+  blocker.moving = velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+  blocker.dirty = false;
+  if (blocker.xMin <= blocker.xMax && IsSamePosition (position, blocker.position))
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("obstacle " << index << " moved from " << blocker.position << " to " << position);
+  m_update++;
+  for (int32_t x = blocker.xMin; x <= blocker.xMax; x++)
+    {
+      for (int32_t y = blocker.yMin; y <= blocker.yMax; y++)
+        {
+          struct Cell &cell = m_grid[std::make_pair (x, y)];
+          cell.blockers.erase (std::find (cell.blockers.begin (), cell.blockers.end (), index));
+          cell.changed = m_update;
+        }
+    }
+  double halfX = blocker.box ? blocker.size.x / 2 : blocker.size.x;
+  double halfY = blocker.box ? blocker.size.y / 2 : blocker.size.x;
+  blocker.position = position;
+  blocker.xMin = GetCellIndex (position.x - halfX);
+  blocker.xMax = GetCellIndex (position.x + halfX);
+  blocker.yMin = GetCellIndex (position.y - halfY);
+  blocker.yMax = GetCellIndex (position.y + halfY);
+  for (int32_t x = blocker.xMin; x <= blocker.xMax; x++)
+    {
+      for (int32_t y = blocker.yMin; y <= blocker.yMax; y++)
+        {
+          struct Cell &cell = m_grid[std::make_pair (x, y)];
+          cell.blockers.push_back (index);
+          cell.changed = m_update;
+        }
+    }
+}
+
+void
+BlockagePropagationLossModel::Update (void) const
+{
+  if (Simulator::Now () >= m_nextUpdate)
+    {
+      for (uint32_t i = 0; i < m_blockers.size (); i++)
+        {
+          if (m_blockers[i].moving || m_blockers[i].dirty)
+            {
+              SampleBlocker (i);
+            }
+        }
+      m_dirty.clear ();
+      m_nextUpdate = Simulator::Now () + m_updateInterval;
+    }
+  else if (!m_dirty.empty ())
+    {
+      for (std::vector<uint32_t>::const_iterator i = m_dirty.begin (); i != m_dirty.end (); ++i)
+        {
+          SampleBlocker (*i);
+        }
+      m_dirty.clear ();
+    }
+}
+
+bool
+BlockagePropagationLossModel::Intersects (const struct Blocker &blocker, const Vector &a, const Vector &b)
+{
+  const Vector &c = blocker.position;
+  double t0 = 0;
+  double t1 = 1;
+  if (blocker.box)
+    {
+      return ClipToSlab (a.x, b.x - a.x, c.x - blocker.size.x / 2, c.x + blocker.size.x / 2, t0, t1)
+             && ClipToSlab (a.y, b.y - a.y, c.y - blocker.size.y / 2, c.y + blocker.size.y / 2, t0, t1)
+             && ClipToSlab (a.z, b.z - a.z, c.z, c.z + blocker.size.z, t0, t1);
+    }
+  // the part of the segment within the infinite vertical cylinder...
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+  double fx = a.x - c.x;
+  double fy = a.y - c.y;
+  double radius = blocker.size.x;
+  double qa = dx * dx + dy * dy;
+  double qb = 2 * (fx * dx + fy * dy);
+  double qc = fx * fx + fy * fy - radius * radius;
+  if (qa == 0)
+    {
+      if (qc > 0)
+        {
+          return false;
+        }
+    }
+  else
+    {
+      double discriminant = qb * qb - 4 * qa * qc;
+      if (discriminant < 0)
+        {
+          return false;
+        }
+      double root = std::sqrt (discriminant);
+      t0 = std::max (t0, (-qb - root) / (2 * qa));
+      t1 = std::min (t1, (-qb + root) / (2 * qa));
+      if (t0 > t1)
+        {
+          return false;
+        }
+    }
+  // ...must be within its height
+  return ClipToSlab (a.z, b.z - a.z, c.z, c.z + blocker.size.z, t0, t1);
+}
+
+void
+BlockagePropagationLossModel::ComputeAttenuation (struct LinkAttenuation *link) const
+{
+  const Vector &a = link->positionA;
+  const Vector &b = link->positionB;
+  // walk the cells crossed by the horizontal projection of the link
+  int32_t x = GetCellIndex (a.x);
+  int32_t y = GetCellIndex (a.y);
+  int32_t xEnd = GetCellIndex (b.x);
+  int32_t yEnd = GetCellIndex (b.y);
+  int32_t stepX = (xEnd >= x) ? 1 : -1;
+  int32_t stepY = (yEnd >= y) ? 1 : -1;
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+  double tMaxX = (dx != 0) ? ((x + (stepX > 0 ? 1 : 0)) * m_cellSize - a.x) / dx : 0;
+  double tMaxY = (dy != 0) ? ((y + (stepY > 0 ? 1 : 0)) * m_cellSize - a.y) / dy : 0;
+  double tDeltaX = (dx != 0) ? m_cellSize / std::abs (dx) : 0;
+  double tDeltaY = (dy != 0) ? m_cellSize / std::abs (dy) : 0;
+  std::vector<uint32_t> candidates;
+  link->cells.clear ();
+  while (true)
+    {
+      struct Cell *cell = &m_grid[std::make_pair (x, y)];
+      link->cells.push_back (cell);
+      candidates.insert (candidates.end (), cell->blockers.begin (), cell->blockers.end ());
+      if (x == xEnd && y == yEnd)
+        {
+          break;
+        }
+      // a step along each axis remains until its last cell is reached
+      if (y == yEnd || (x != xEnd && tMaxX < tMaxY))
+        {
+          x += stepX;
+          tMaxX += tDeltaX;
+        }
+      else
+        {
+          y += stepY;
+          tMaxY += tDeltaY;
+        }
+    }
+  std::sort (candidates.begin (), candidates.end ());
+  candidates.erase (std::unique (candidates.begin (), candidates.end ()), candidates.end ());
+
+  link->attenuation = 0;
+  for (std::vector<uint32_t>::const_iterator i = candidates.begin (); i != candidates.end (); ++i)
+    {
+      const struct Blocker &blocker = m_blockers[*i];
+      // an obstacle does not block the links of its own node
+      if (blocker.mobility != link->a && blocker.mobility != link->b && Intersects (blocker, a, b))
+        {
+          NS_LOG_LOGIC ("obstacle " << *i << " blocks the link from " << a << " to " << b);
+          link->attenuation += blocker.attenuation;
+        }
+    }
+  link->computed = m_update;
+}
+
+uint32_t
+BlockagePropagationLossModel::HashLink (MobilityModel *a, MobilityModel *b)
+{
+  uint64_t h = reinterpret_cast<uintptr_t> (a) * 0x9e3779b97f4a7c15ULL;
+  h ^= reinterpret_cast<uintptr_t> (b) + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2);
+  return static_cast<uint32_t> (h ^ (h >> 32));
+}
+
+struct BlockagePropagationLossModel::LinkAttenuation *
+BlockagePropagationLossModel::FindLink (MobilityModel *a, MobilityModel *b) const
+{
+  if ((m_nLinks + 1) * 2 > m_links.size ())
+    {
+      std::vector<struct LinkAttenuation> links;
+      links.swap (m_links);
+      m_links.resize (std::max<std::size_t> (16, links.size () * 2));
+      for (std::vector<struct LinkAttenuation>::iterator i = links.begin (); i != links.end (); ++i)
+        {
+          if (i->a != 0)
+            {
+              *FindLink (PeekPointer (i->a), PeekPointer (i->b)) = *i;
+            }
+        }
+    }
+  uint32_t mask = m_links.size () - 1;
+  for (uint32_t i = HashLink (a, b) & mask; ; i = (i + 1) & mask)
+    {
+      struct LinkAttenuation *link = &m_links[i];
+      if (link->a == 0 || (PeekPointer (link->a) == a && PeekPointer (link->b) == b))
+        {
+          return link;
+        }
+    }
+}
+
+double
+BlockagePropagationLossModel::GetAttenuation (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this << a << b);
+  Update ();
+  if (PeekPointer (a) > PeekPointer (b))
+    {
+      std::swap (a, b);
+    }
+  struct LinkAttenuation *link = FindLink (PeekPointer (a), PeekPointer (b));
+  Vector positionA = a->GetPosition ();
+  Vector positionB = b->GetPosition ();
+  bool valid = false;
+  if (link->a == 0)
+    {
+      link->a = a;
+      link->b = b;
+      m_nLinks++;
+    }
+  else if (IsSamePosition (positionA, link->positionA) && IsSamePosition (positionB, link->positionB))
+    {
+      valid = true;
+      for (std::vector<struct Cell *>::const_iterator i = link->cells.begin (); valid && i != link->cells.end (); ++i)
+        {
+          valid = (*i)->changed <= link->computed;
+        }
+    }
+  if (!valid)
+    {
+      link->positionA = positionA;
+      link->positionB = positionB;
+      ComputeAttenuation (link);
+    }
+  return link->attenuation;
+}
+
+double
+BlockagePropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+  return txPowerDbm - GetAttenuation (a, b);
+}
+
+int64_t
+BlockagePropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BLOCKAGE_PROPAGATION_LOSS_MODEL_H
+#define BLOCKAGE_PROPAGATION_LOSS_MODEL_H
+
+#include <map>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "propagation-loss-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Attenuation of the links crossed by moving obstacles
+ *
+ * This model tracks obstacles (e.g. humans or furniture), each with its
+ * own MobilityModel, modelled as vertical cylinders or axis-aligned
+ * boxes standing on the position of their MobilityModel.  The signal of
+ * a link is attenuated by the attenuation of every obstacle crossing
+ * the segment between the two ends of the link.  It is meant to be
+ * chained after a path loss model, e.g. to model human blockage of
+ * 60 GHz links.
+ *
+ * The obstacles are registered in a grid of square cells of the
+ * horizontal plane, so only the obstacles in the cells crossed by a
+ * link are intersected with it.  The attenuation of each link is
+ * cached, along with the cells it crosses, and only recomputed when an
+ * end of the link moved or an obstacle moved in or out of one of its
+ * cells.
+ *
+ * The positions of the obstacles are sampled every UpdateInterval,
+ * which bounds the time an obstacle moving at a constant velocity can
+ * remain unnoticed; the obstacles whose mobility model reports a
+ * course change (e.g. a new position or velocity) are sampled again
+ * on the next call.  Obstacles with a null velocity are not sampled
+ * until they report a course change.
+ */
+class BlockagePropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  BlockagePropagationLossModel ();
+  virtual ~BlockagePropagationLossModel ();
+
+  /**
+   * Add a vertical cylinder whose base is centered on the position of
+   * the given mobility model.
+   *
+   * \param mobility the mobility model of the obstacle
+   * \param radius the radius of the cylinder (m)
+   * \param height the height of the cylinder (m)
+   * \param attenuation the attenuation (dB) of the links crossing it
+   * \return the index of the obstacle
+   */
+  uint32_t AddCylinder (Ptr<MobilityModel> mobility, double radius, double height, double attenuation);
+  /**
+   * Add an axis-aligned box whose base is centered on the position of
+   * the given mobility model.
+   *
+   * \param mobility the mobility model of the obstacle
+   * \param size the length along the x and y axes and the height of the box (m)
+   * \param attenuation the attenuation (dB) of the links crossing it
+   * \return the index of the obstacle
+   */
+  uint32_t AddBox (Ptr<MobilityModel> mobility, Vector size, double attenuation);
+  /**
+   * \return the number of obstacles
+   */
+  uint32_t GetNBlockers (void) const;
+  /**
+   * \param a the mobility model of one end of the link
+   * \param b the mobility model of the other end of the link
+   * \return the attenuation (dB) of the link by the obstacles
+   */
+  double GetAttenuation (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+private:
+  BlockagePropagationLossModel (const BlockagePropagationLossModel &o);
+  BlockagePropagationLossModel & operator = (const BlockagePropagationLossModel &o);
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /// A cell of the grid.
+  struct Cell
+  {
+    std::vector<uint32_t> blockers;  //!< The obstacles overlapping the cell
+    uint64_t changed;                //!< The update during which an obstacle last moved in the cell
+  };
+
+  /// The grid, indexed by the (x, y) coordinates of the cells.
+  typedef std::map<std::pair<int32_t, int32_t>, struct Cell> Grid;
+
+  /// An obstacle.
+  struct Blocker
+  {
+    Ptr<MobilityModel> mobility;  //!< The mobility model of the obstacle
+    bool box;                     //!< Whether the obstacle is a box or a cylinder
+    Vector size;                  //!< The size of a box, or the radius (x) and height (z) of a cylinder
+    double attenuation;           //!< The attenuation (dB)
+    Vector position;              //!< The position at the last sample
+    int32_t xMin;                 //!< The first column of the cells overlapped
+    int32_t xMax;                 //!< The last column of the cells overlapped
+    int32_t yMin;                 //!< The first row of the cells overlapped
+    int32_t yMax;                 //!< The last row of the cells overlapped
+    bool moving;                  //!< Whether the obstacle had a velocity at the last sample
+    bool dirty;                   //!< Whether a course change was reported since the last sample
+  };
+
+  /// The cached attenuation of a link.
+  struct LinkAttenuation
+  {
+    Ptr<MobilityModel> a;       //!< The end with the lower address, or 0 if the slot is free
+    Ptr<MobilityModel> b;       //!< The end with the higher address
+    Vector positionA;           //!< The position of a when the attenuation was computed
+    Vector positionB;           //!< The position of b when the attenuation was computed
+    uint64_t computed;          //!< The update after which the attenuation was computed
+    double attenuation;         //!< The attenuation (dB)
+    std::vector<struct Cell *> cells; //!< The cells crossed by the link
+  };
+
+  /**
+   * Add an obstacle.
+   * \param blocker the obstacle
+   * \return the index of the obstacle
+   */
+  uint32_t AddBlocker (struct Blocker blocker);
+  /**
+   * Record a course change of an obstacle.
+   * \param index the index of the obstacle
+   * \param mobility the mobility model of the obstacle
+   */
+  void CourseChange (uint32_t index, Ptr<const MobilityModel> mobility);
+  /**
+   * Sample the position of the moving obstacles if the update interval
+   * elapsed, and of the obstacles which reported a course change.
+   */
+  void Update (void) const;
+  /**
+   * Sample the position of an obstacle and move it in the grid.
+   * \param index the index of the obstacle
+   */
+  void SampleBlocker (uint32_t index) const;
+  /**
+   * \param x a coordinate (m)
+   * \return the index of the cell containing the coordinate
+   */
+  int32_t GetCellIndex (double x) const;
+  /**
+   * Compute the attenuation of a link and the cells it crosses.
+   * \param link the link, whose positions are up to date
+   */
+  void ComputeAttenuation (struct LinkAttenuation *link) const;
+  /**
+   * \param blocker the obstacle
+   * \param a one end of the segment
+   * \param b the other end of the segment
+   * \return whether the segment crosses the obstacle
+   */
+  static bool Intersects (const struct Blocker &blocker, const Vector &a, const Vector &b);
+  /**
+   * Look up the attenuation of a link, inserting a free slot if it is not found.
+   * \param a the end with the lower address
+   * \param b the end with the higher address
+   * \returns the slot of the link
+   */
+  struct LinkAttenuation * FindLink (MobilityModel *a, MobilityModel *b) const;
+  /**
+   * \param a the end with the lower address
+   * \param b the end with the higher address
+   * \returns the hash of the link
+   */
+  static uint32_t HashLink (MobilityModel *a, MobilityModel *b);
+
+  double m_cellSize;              //!< The side of the cells (m)
+  Time m_updateInterval;          //!< The interval between two samples of the moving obstacles
+
+  mutable std::vector<struct Blocker> m_blockers; //!< The obstacles
+  mutable Grid m_grid;            //!< The cells holding obstacles or crossed by a link
+  mutable uint64_t m_update;      //!< The number of samples in which an obstacle moved
+  mutable Time m_nextUpdate;      //!< The time of the next sample of the moving obstacles
+  mutable std::vector<uint32_t> m_dirty; //!< The obstacles which reported a course change since the last sample
+  mutable std::vector<struct LinkAttenuation> m_links; //!< The open-addressed link table
+  mutable uint32_t m_nLinks;      //!< The number of links in m_links
+};
+
+} // namespace ns3
+
+#endif /* BLOCKAGE_PROPAGATION_LOSS_MODEL_H */
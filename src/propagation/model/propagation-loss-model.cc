@@ -26,10 +26,12 @@
 #include "ns3/mobility-model.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include <cmath>
+#include <algorithm>
 
 
 
@@ -944,6 +946,7 @@ MmWavePropagationLossModel::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::MmWavePropagationLossModel")
     .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
     .AddConstructor<MmWavePropagationLossModel> ()
     .AddAttribute ("Frequency",
                    "The carrier frequency (in Hz) at which propagation occurs  (default is 28 GHz).",
@@ -957,11 +960,36 @@ MmWavePropagationLossModel::GetTypeId (void)
                    MakeDoubleAccessor (&MmWavePropagationLossModel::SetMinLoss,
                                        &MmWavePropagationLossModel::GetMinLoss),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("ChannelState",
+                   "The state of every link, or All to draw the state of each link "
+                   "from the distance-dependent probabilities of LOS, NLOS and outage.",
+                   EnumValue (MmWavePropagationLossModel::LOS),
+                   MakeEnumAccessor (&MmWavePropagationLossModel::SetChannelState,
+                                     &MmWavePropagationLossModel::GetChannelState),
+                   MakeEnumChecker (MmWavePropagationLossModel::LOS, "Los",
+                                    MmWavePropagationLossModel::NLOS, "Nlos",
+                                    MmWavePropagationLossModel::OUTAGE, "Outage",
+                                    MmWavePropagationLossModel::ALL, "All"))
     .AddAttribute ("ChannelStates",
-                   "'l' for LOS, 'n' for NLOS, 'o' for outage, 'a' for all",
-                   StringValue ("l"), 
-                   MakeStringAccessor (&MmWavePropagationLossModel::m_channelStates),
+                   "'l' for LOS, 'n' for NLOS, 'o' for outage, 'a' for all. "
+                   "Same as ChannelState, kept for the existing scripts.",
+                   StringValue (""),
+                   MakeStringAccessor (&MmWavePropagationLossModel::SetChannelStates),
                    MakeStringChecker ())
+    .AddAttribute ("CorrelationDistance",
+                   "The distance (m) over which the state and the shadowing of a link "
+                   "decorrelate as its ends move.  0 keeps them at their first draw.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&MmWavePropagationLossModel::m_correlationDistance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("ShadowingStandardDeviation",
+                   "If true, the shadowing standard deviation is 5.8 dB for LOS links and "
+                   "8.7 dB (28 GHz) or 7.7 dB (73 GHz) for NLOS links.  If false, as in the "
+                   "original implementation of this model, these values are the variances "
+                   "of the shadowing (standard deviations of about 2.4 dB and 2.9 or 2.8 dB).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWavePropagationLossModel::m_shadowingStdDev),
+                   MakeBooleanChecker ())
     .AddAttribute ("LossFixedDb",
                    "",
                    DoubleValue (0.0), 
@@ -973,14 +1001,19 @@ MmWavePropagationLossModel::GetTypeId (void)
                    MakeBooleanAccessor (&MmWavePropagationLossModel::m_fixedLossTst),
                    MakeBooleanChecker ())
   ;
-
-//std::cout << "channel state: " << MmWavePropagationLossModel::m_channelStates << std::endl;
   return tid;
 }
 
 MmWavePropagationLossModel::MmWavePropagationLossModel ()
+  : m_nLinks (0)
+{
+  m_normal = CreateObject<NormalRandomVariable> ();
+  m_normal->SetAttribute ("Mean", DoubleValue (0.0));
+  m_normal->SetAttribute ("Variance", DoubleValue (1.0));
+}
+
+MmWavePropagationLossModel::~MmWavePropagationLossModel ()
 {
-  m_channelScenarioMap.clear ();
 }
 
 void
@@ -998,10 +1031,30 @@ MmWavePropagationLossModel::GetMinLoss (void) const
 void
 MmWavePropagationLossModel::SetFrequency (double frequency)
 {
-  //NS_ASSERT (m_frequency = frequency);
   m_frequency = frequency;
   static const double C = 299792458.0; // speed of light in vacuum
   m_lambda = C / frequency;
+  m_frequencySupported = true;
+  m_sigmaLos = 5.8;
+  m_betaLos = 2;
+  if (frequency == 28e9)
+    {
+      m_alphaLos = 61.4;
+      m_alphaNlos = 72.0;
+      m_betaNlos = 2.92;
+      m_sigmaNlos = 8.7;
+    }
+  else if (frequency == 73e9)
+    {
+      m_alphaLos = 69.8;
+      m_alphaNlos = 82.7;
+      m_betaNlos = 2.69;
+      m_sigmaNlos = 7.7;
+    }
+  else
+    {
+      m_frequencySupported = false;
+    }
 }
 
 double
@@ -1015,6 +1068,128 @@ void MmWavePropagationLossModel::SetLossFixedDb (double loss)
         m_lossFixedDb = loss;
 }
 
+void
+MmWavePropagationLossModel::SetChannelState (enum ChannelState state)
+{
+  m_channelState = state;
+  // the links are drawn again with the new state
+  m_links.clear ();
+  m_nLinks = 0;
+}
+
+enum MmWavePropagationLossModel::ChannelState
+MmWavePropagationLossModel::GetChannelState (void) const
+{
+  return m_channelState;
+}
+
+void
+MmWavePropagationLossModel::SetChannelStates (std::string states)
+{
+  if (states.empty ())
+    {
+      // the default: ChannelState is used
+      return;
+    }
+  if (states == "l")
+    {
+      SetChannelState (LOS);
+    }
+  else if (states == "n")
+    {
+      SetChannelState (NLOS);
+    }
+  else if (states == "o")
+    {
+      SetChannelState (OUTAGE);
+    }
+  else if (states == "a")
+    {
+      SetChannelState (ALL);
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown channel states \"" << states << "\"");
+    }
+}
+
+uint32_t
+MmWavePropagationLossModel::HashLink (MobilityModel *a, MobilityModel *b)
+{
+  uint64_t h = reinterpret_cast<uintptr_t> (a) * 0x9e3779b97f4a7c15ULL;
+  h ^= reinterpret_cast<uintptr_t> (b) + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2);
+  return static_cast<uint32_t> (h ^ (h >> 32));
+}
+
+struct MmWavePropagationLossModel::LinkState *
+MmWavePropagationLossModel::FindLink (MobilityModel *a, MobilityModel *b) const
+{
+  if ((m_nLinks + 1) * 2 > m_links.size ())
+    {
+      std::vector<struct LinkState> links;
+      links.swap (m_links);
+      m_links.resize (std::max<std::size_t> (16, links.size () * 2));
+      for (std::vector<struct LinkState>::iterator i = links.begin (); i != links.end (); ++i)
+        {
+          if (i->a != 0)
+            {
+              *FindLink (PeekPointer (i->a), PeekPointer (i->b)) = *i;
+            }
+        }
+    }
+  uint32_t mask = m_links.size () - 1;
+  for (uint32_t i = HashLink (a, b) & mask; ; i = (i + 1) & mask)
+    {
+      struct LinkState *link = &m_links[i];
+      if (link->a == 0 || (PeekPointer (link->a) == a && PeekPointer (link->b) == b))
+        {
+          return link;
+        }
+    }
+}
+
+void
+MmWavePropagationLossModel::DrawLinkState (struct LinkState *link, double distance) const
+{
+  if (m_channelState != ALL)
+    {
+      link->state = m_channelState;
+      return;
+    }
+  double aOut = 0.0334;
+  double bOut = 5.2;
+  double aLos = 0.0149;
+  double pOut = std::max (0.0, 1 - std::exp (-aOut * distance + bOut));
+  double pLos = (1 - pOut) * std::exp (-aLos * distance);
+  // uniform variable of the link
+  double u = 0.5 * std::erfc (-link->stateVariable / std::sqrt (2.0));
+  if (u < pLos)
+    {
+      link->state = LOS;
+    }
+  else if (u < 1 - pOut)
+    {
+      link->state = NLOS;
+    }
+  else
+    {
+      link->state = OUTAGE;
+    }
+  NS_LOG_DEBUG ("distance=" << distance << " POut=" << pOut << " PLos=" << pLos
+                << " u=" << u << " state=" << link->state);
+}
+
+enum MmWavePropagationLossModel::ChannelState
+MmWavePropagationLossModel::GetLinkState (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  if (PeekPointer (b) < PeekPointer (a))
+    {
+      std::swap (a, b);
+    }
+  struct LinkState *link = FindLink (PeekPointer (a), PeekPointer (b));
+  return link->a == 0 ? ALL : link->state;
+}
+
 double
 MmWavePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                           Ptr<MobilityModel> a,
@@ -1031,158 +1206,92 @@ MmWavePropagationLossModel::DoCalcRxPower (double txPowerDbm,
    * Xi: Xi~N(0,sigma^2)
    *
    */
+  if (m_fixedLossTst)
+    {
+      return txPowerDbm - m_lossFixedDb;
+    }
 
-        if(!m_fixedLossTst)
-        {
-                double distance = a->GetDistanceFrom (b);
-                if (distance < 3*m_lambda)
-                {
-                        //NS_LOG_WARN ("distance not within the far field region => inaccurate propagation loss value");
-                }
-                if (distance <= 0)
-                {
-                        return txPowerDbm - m_minLoss;
-                }
-
-                double aOut = 0.0334;
-                double bOut = 5.2;
-                double aLos = 0.0149;
-                double POut = fmax (0, 1-exp(((-1)*aOut*distance)+bOut));
-                double PLos = (1-POut)*exp((-1)*aLos*distance);
-                double PNlos = 1-POut - PLos;
-                double alpha, beta, sigma;
-
-std::cout << "POut: " << POut << " PLos: " << PLos << " PNlos: " << PNlos << " channelstates: " << m_channelStates << " sally-init" << std::endl;
-
-                channelScenarioMap_t::const_iterator it;
-                it = m_channelScenarioMap.find(std::make_pair(a,b));
-                if (it == m_channelScenarioMap.end ())
-                {
-                        channelScenario scenario;
-                        Ptr<UniformRandomVariable> uniformVariable = CreateObject <UniformRandomVariable> ();
-                        Ptr<NormalRandomVariable> normalVariable = CreateObject <NormalRandomVariable> ();
-                        normalVariable->SetAntithetic(true);
-                        double PRef = uniformVariable->GetValue(0,1);
-
-                        std::cout << "PRef: " << PRef << " channelStates: " << m_channelStates <<" sally-propagation-testPRef&channel" << std::endl;
-
-
-                        if ( m_channelStates.compare("l")==0 || ((PRef < PLos) && m_channelStates.compare("a")==0) )
-                        {
-                                scenario.m_channelScenario = 'l';
-                                sigma = 5.8;
-                        }
-                        else if ( m_channelStates.compare("n")==0 || ((PRef < (1-POut)) && m_channelStates.compare("a")==0) )
-                        {
-                                scenario.m_channelScenario = 'n';
-                                if (m_frequency ==28e9)
-                                {
-                                        sigma = 8.7;
-                                }
-                                else if (m_frequency == 73e9)
-                                {
-                                        sigma = 7.7;
-                                }
-                                else
-                                {
-                                        NS_FATAL_ERROR ("The model currently supports only 28 GHz and 73 GHz carrier frequencies.");
-                                }
-                        }
-                        else
-                        {
-                                scenario.m_channelScenario = 'o';
-                                return (txPowerDbm - 500.00);
-                        }
-                        scenario.m_shadowing = normalVariable->GetValue(0,sigma);
-                        m_channelScenarioMap.insert (std::make_pair(std::make_pair (a,b), scenario));
-                        m_channelScenarioMap.insert (std::make_pair(std::make_pair (b,a), scenario));
-                        it = m_channelScenarioMap.find(std::make_pair(a,b));
-               
-                        std::cout << "test channel scenario after first selection: " << scenario.m_channelScenario << " sigma: " << sigma << " sally-channelScenario" << std::endl;
-    
-                }
-                switch ((*it).second.m_channelScenario)
-                {
-                        case 'l':
-                        {
-                                if (m_frequency == 28e9)
-                                {
-                                        alpha = 61.4;
-                                        beta = 2;
-                                }
-                                else if (m_frequency == 73e9)
-                                {
-                                        alpha = 69.8;
-                                        beta = 2;
-                                }
-                                else
-                                {
-                                        NS_FATAL_ERROR ("Other frequency is not impletmented.");
-                                }
-                                break;
-                        }
-
-                        case 'n':
-                        {
-                                if (m_frequency == 28e9)
-                                {
-                                        alpha = 72.0;
-                                        beta = 2.92;
-                                }
-                                else if (m_frequency == 73e9)
-                                {
-                                        alpha = 82.7;
-                                        beta = 2.69;
-                                }
-                                else
-                                {
-                                        NS_FATAL_ERROR ("Other frequency is not impletmented.");
-                                }
-                                break;
-                        }
-                        case 'o':
-                        {
-                                return (txPowerDbm - 500.00);
-                                break;
-                        }
-                        default:
-                                NS_FATAL_ERROR ("Programming Error.");
-                
-                }
-
-
-                std::cout << "alpha: " << alpha << "beta: " << beta << " sally-alphabeta" << std::endl;
-
-
-                NS_LOG_DEBUG ("distance=" << distance<< ", scenario=" << (*it).second.m_channelScenario<<", shadowing"<<(*it).second.m_shadowing);
-
-                std::cout << "distance=" << distance<< ", scenario=" << (*it).second.m_channelScenario<<", shadowing"<<(*it).second.m_shadowing << " sally-propagation1 " << std::endl;
-
-                double lossDb = alpha + beta * 10 * log10(distance) + (*it).second.m_shadowing;
-                NS_LOG_DEBUG ("time="<<Simulator::Now ().GetSeconds ()<<" POut="<<POut<<" PLos="<<PLos<<" PNlos="<<PNlos<<" lossDb="<<lossDb);
-
-                std::cout << "time="<<Simulator::Now ().GetSeconds ()<<" POut="<<POut<<" PLos="<<PLos<<" PNlos="<<PNlos<<" lossDb="<<lossDb << " sally-propagation2 " << std::endl;
-
-                return txPowerDbm - std::max (lossDb, m_minLoss);
-        }
-        else
+  // the state of a link does not depend on its direction
+  if (PeekPointer (b) < PeekPointer (a))
+    {
+      std::swap (a, b);
+    }
+  Vector positionA = a->GetPosition ();
+  Vector positionB = b->GetPosition ();
+  double distance = CalculateDistance (positionA, positionB);
+  if (distance <= 0)
+    {
+      return txPowerDbm - m_minLoss;
+    }
+  if (!m_frequencySupported)
+    {
+      NS_FATAL_ERROR ("The model currently supports only 28 GHz and 73 GHz carrier frequencies.");
+    }
+
+  struct LinkState *link = FindLink (PeekPointer (a), PeekPointer (b));
+  if (link->a == 0)
+    {
+      link->a = a;
+      link->b = b;
+      link->positionA = positionA;
+      link->positionB = positionB;
+      link->stateVariable = m_normal->GetValue ();
+      link->shadowingVariable = m_normal->GetValue ();
+      m_nLinks++;
+      DrawLinkState (link, distance);
+    }
+  else if (m_correlationDistance > 0)
+    {
+      double displacement = CalculateDistance (positionA, link->positionA)
+        + CalculateDistance (positionB, link->positionB);
+      if (displacement > 0)
         {
-                //std::cout << "RX power changing to " << (txPowerDbm - m_lossFixedDb << std::endl;
-                return txPowerDbm - m_lossFixedDb;
+          // Gauss-Markov update: the variables keep their N(0,1) distribution
+          double r = std::exp (-displacement / m_correlationDistance);
+          double innovation = std::sqrt (1 - r * r);
+          link->stateVariable = r * link->stateVariable + innovation * m_normal->GetValue ();
+          link->shadowingVariable = r * link->shadowingVariable + innovation * m_normal->GetValue ();
+          link->positionA = positionA;
+          link->positionB = positionB;
+          DrawLinkState (link, distance);
         }
+    }
+
+  double alpha, beta, sigma;
+  switch (link->state)
+    {
+    case LOS:
+      alpha = m_alphaLos;
+      beta = m_betaLos;
+      sigma = m_sigmaLos;
+      break;
+    case NLOS:
+      alpha = m_alphaNlos;
+      beta = m_betaNlos;
+      sigma = m_sigmaNlos;
+      break;
+    case OUTAGE:
+      return txPowerDbm - 500.0;
+    default:
+      NS_FATAL_ERROR ("Programming Error.");
+      return 0;
+    }
+
+  if (!m_shadowingStdDev)
+    {
+      sigma = std::sqrt (sigma);
+    }
+  double lossDb = alpha + beta * 10 * std::log10 (distance) + sigma * link->shadowingVariable;
+  NS_LOG_DEBUG ("time=" << Simulator::Now ().GetSeconds () << " distance=" << distance
+                << " state=" << link->state << " lossDb=" << lossDb);
+  return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
 int64_t
 MmWavePropagationLossModel::DoAssignStreams (int64_t stream)
 {
-  return 0;
-}
-
-void
-MmWavePropagationLossModel::UpDataScenarioMap ()
-{
-        m_channelScenarioMap.clear ();
-        Simulator::Schedule(Seconds(1), &MmWavePropagationLossModel::UpDataScenarioMap,this);
+  m_normal->SetStream (stream);
+  return 1;
 }
 
 // ----------------------------------------------------------------------------------------------- //
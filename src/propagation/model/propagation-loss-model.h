@@ -27,7 +27,9 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -858,20 +860,50 @@ private:
 
 
 
-struct channelScenario
-{
-          char m_channelScenario;
-          double m_shadowing;
-};
-
-// map store the path loss scenario(LOS,NLOS,OUTAGE) of each propapgation channel
-typedef std::map< std::pair< Ptr<MobilityModel>, Ptr<MobilityModel> >, channelScenario> channelScenarioMap_t;
-
+/**
+ * \ingroup propagation
+ *
+ * \brief Millimeter wave LOS/NLOS/outage path loss model.
+ *
+ * The path loss of a link is
+ * \f$ PL = \alpha + \beta \cdot 10 \log_{10}(d) + \xi \f$
+ * where \f$\alpha\f$ and \f$\beta\f$ depend on the carrier frequency
+ * (28 GHz or 73 GHz) and on the state of the link, and \f$\xi\f$ is a
+ * zero-mean Gaussian shadowing.  A link in outage loses 500 dB.  The
+ * shadowing sigma of the state is the variance of \f$\xi\f$, as in the
+ * original implementation of the model, unless ShadowingStandardDeviation
+ * is set.
+ *
+ * The state of each link is drawn by comparing a uniform variable
+ * \f$ u \f$ of the link with the distance-dependent probabilities of
+ * outage and LOS.  The variable \f$ u \f$ and the standard normal
+ * variable of the shadowing are kept per link, in a hash table keyed on
+ * the pair of mobility models, and are updated as the ends of the link
+ * move, with the exponential correlation
+ * \f$ R = e^{-\Delta / d_{corr}} \f$ of the displacement \f$\Delta\f$:
+ * the state and the shadowing thus evolve consistently with the
+ * distance travelled rather than being frozen at their first draw.
+ * A CorrelationDistance of 0 freezes them.
+ */
 class MmWavePropagationLossModel : public PropagationLossModel
 {
 public:
+  /// The states of a link.
+  enum ChannelState
+  {
+    LOS,          //!< Line of sight
+    NLOS,         //!< No line of sight
+    OUTAGE,       //!< Outage
+    ALL           //!< Draw the state from the distance-dependent probabilities
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
   static TypeId GetTypeId (void);
   MmWavePropagationLossModel ();
+  virtual ~MmWavePropagationLossModel ();
   /**
    * \param frequency (Hz)
    *
@@ -898,8 +930,29 @@ public:
    */
   double GetFrequency (void) const;
 
+  /**
+   * \param loss the loss (dB) of every link when FixedLossTst is set
+   */
   void SetLossFixedDb (double loss);
 
+  /**
+   * \param state the state of every link, or ALL to draw it per link
+   */
+  void SetChannelState (enum ChannelState state);
+
+  /**
+   * \returns the state of every link, or ALL if it is drawn per link
+   */
+  enum ChannelState GetChannelState (void) const;
+
+  /**
+   * \param a the mobility model of one end of the link
+   * \param b the mobility model of the other end of the link
+   * \returns the current state of the link, or ALL if its path loss
+   *          was not computed yet
+   */
+  enum ChannelState GetLinkState (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
 private:
   MmWavePropagationLossModel (const MmWavePropagationLossModel &o);
   MmWavePropagationLossModel & operator = (const MmWavePropagationLossModel &o);
@@ -907,21 +960,66 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
-  void UpDataScenarioMap ();
-
-  double m_lambda;
-  mutable double m_frequency;
-  double m_minLoss;
-  mutable channelScenarioMap_t m_channelScenarioMap;
-  std::string m_channelStates;
-  double m_lossFixedDb;
-  bool  m_fixedLossTst;
-};
-
-
-
 
+  /**
+   * Set the state of every link from its former single-letter name.
+   * \param states 'l' for LOS, 'n' for NLOS, 'o' for outage, 'a' for all
+   */
+  void SetChannelStates (std::string states);
+
+  /// The state of a link.
+  struct LinkState
+  {
+    Ptr<MobilityModel> a;   //!< The end with the lower address, or 0 if the slot is free
+    Ptr<MobilityModel> b;   //!< The end with the higher address
+    Vector positionA;       //!< The position of a at the last update
+    Vector positionB;       //!< The position of b at the last update
+    double stateVariable;   //!< Standard normal variable drawing the state
+    double shadowingVariable; //!< Standard normal variable of the shadowing
+    enum ChannelState state; //!< The current state
+  };
 
+  /**
+   * Look up the state of a link, inserting a free slot if it is not found.
+   * \param a the end with the lower address
+   * \param b the end with the higher address
+   * \returns the slot of the link
+   */
+  struct LinkState * FindLink (MobilityModel *a, MobilityModel *b) const;
+  /**
+   * \param a the end with the lower address
+   * \param b the end with the higher address
+   * \returns the hash of the link
+   */
+  static uint32_t HashLink (MobilityModel *a, MobilityModel *b);
+  /**
+   * Draw the state of a link from its state variable.
+   * \param link the link
+   * \param distance the distance between the ends of the link (m)
+   */
+  void DrawLinkState (struct LinkState *link, double distance) const;
+
+  double m_lambda;                //!< the carrier wavelength
+  mutable double m_frequency;     //!< the carrier frequency
+  double m_minLoss;               //!< the minimum loss (dB)
+  enum ChannelState m_channelState; //!< the state of every link, or ALL
+  double m_correlationDistance;   //!< the correlation distance of the link states (m)
+  bool m_shadowingStdDev;         //!< whether the sigmas are standard deviations rather than variances
+  double m_lossFixedDb;           //!< the loss of every link when m_fixedLossTst is set
+  bool  m_fixedLossTst;           //!< whether every link loses m_lossFixedDb
+
+  bool m_frequencySupported;      //!< whether m_frequency has parameters
+  double m_alphaLos;              //!< LOS floating intercept (dB)
+  double m_betaLos;               //!< LOS path loss exponent
+  double m_sigmaLos;              //!< LOS shadowing sigma (dB)
+  double m_alphaNlos;             //!< NLOS floating intercept (dB)
+  double m_betaNlos;              //!< NLOS path loss exponent
+  double m_sigmaNlos;             //!< NLOS shadowing sigma (dB)
+
+  Ptr<NormalRandomVariable> m_normal; //!< the variable shared by all the links
+  mutable std::vector<struct LinkState> m_links; //!< the open-addressed link table
+  mutable uint32_t m_nLinks;      //!< the number of links in m_links
+};
 
 } // namespace ns3
 
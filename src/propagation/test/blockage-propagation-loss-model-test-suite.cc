@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/blockage-propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/random-variable-stream.h>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \param x the x coordinate (m)
+ * \param y the y coordinate (m)
+ * \param z the z coordinate (m)
+ * \return a mobility model standing at the given position
+ */
+static Ptr<MobilityModel>
+CreatePosition (double x, double y, double z)
+{
+  Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (Vector (x, y, z));
+  return mobility;
+}
+
+/**
+ * Check the attenuation of links crossed by cylinders and boxes.
+ */
+class BlockageShapesTestCase : public TestCase
+{
+public:
+  BlockageShapesTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+BlockageShapesTestCase::BlockageShapesTestCase ()
+  : TestCase ("Check the intersection of links with cylinders and boxes")
+{
+}
+
+void
+BlockageShapesTestCase::DoRun (void)
+{
+  Ptr<BlockagePropagationLossModel> model = CreateObject<BlockagePropagationLossModel> ();
+  Ptr<MobilityModel> a = CreatePosition (0, 0, 1);
+  Ptr<MobilityModel> b = CreatePosition (10, 0, 1);
+  Ptr<MobilityModel> c = CreatePosition (10, 10, 1);
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (10, a, b), 10, 1e-9, "No obstacle, no attenuation");
+
+  model->AddCylinder (CreatePosition (5, 0.2, 0), 0.3, 1.8, 20);
+  model->AddCylinder (CreatePosition (5, 2, 0), 0.3, 1.8, 30);
+  model->AddBox (CreatePosition (3, 0, 0), Vector (1, 1, 0.5), 40);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetAttenuation (a, b), 20, 1e-9, "Only the first cylinder crosses the link");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetAttenuation (b, a), 20, 1e-9, "Links are symmetric");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetAttenuation (a, c), 0, 1e-9, "The diagonal link is clear");
+
+  model->AddBox (CreatePosition (7, -1, 0), Vector (0.5, 4, 2), 15);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (10, a, b), -25, 1e-9, "The new box is not accounted");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetAttenuation (a, c), 0, 1e-9, "The diagonal link is clear");
+
+  // a cylinder above the link does not block it
+  model->AddCylinder (CreatePosition (1, 1, 1.5), 2, 1, 50);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetAttenuation (a, b), 35, 1e-9, "Obstacle above the link");
+
+  // an obstacle carried by a node does not block its own links
+  model->AddCylinder (c, 0.3, 1.8, 50);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetAttenuation (a, c), 0, 1e-9, "A node blocks its own link");
+  NS_TEST_ASSERT_MSG_EQ (model->GetNBlockers (), 6, "Wrong number of obstacles");
+}
+
+/**
+ * Check that the cached attenuation follows the moving obstacles.
+ */
+class BlockageMovingTestCase : public TestCase
+{
+public:
+  BlockageMovingTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the attenuation of the link.
+   * \param expected the expected attenuation (dB)
+   */
+  void Check (double expected);
+
+  Ptr<BlockagePropagationLossModel> m_model; //!< The model
+  Ptr<MobilityModel> m_a;   //!< One end of the link
+  Ptr<MobilityModel> m_b;   //!< The other end of the link
+};
+
+BlockageMovingTestCase::BlockageMovingTestCase ()
+  : TestCase ("Check the attenuation of links crossed by moving obstacles")
+{
+}
+
+void
+BlockageMovingTestCase::Check (double expected)
+{
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_model->GetAttenuation (m_a, m_b), expected, 1e-9,
+                             "Wrong attenuation at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+BlockageMovingTestCase::DoRun (void)
+{
+  m_model = CreateObject<BlockagePropagationLossModel> ();
+  m_a = CreatePosition (0, 0, 1);
+  m_b = CreatePosition (10, 0, 1);
+
+  // walks across the link between 4.7 s and 5.3 s
+  Ptr<ConstantVelocityMobilityModel> walker = CreateObject<ConstantVelocityMobilityModel> ();
+  walker->SetPosition (Vector (5, -5, 0));
+  walker->SetVelocity (Vector (0, 1, 0));
+  m_model->AddCylinder (walker, 0.3, 1.8, 20);
+  // teleported onto the link at 2 s
+  Ptr<MobilityModel> stander = CreatePosition (2, 5, 0);
+  m_model->AddCylinder (stander, 0.3, 1.8, 10);
+
+  Simulator::Schedule (Seconds (1), &BlockageMovingTestCase::Check, this, 0);
+  Simulator::Schedule (Seconds (2), &MobilityModel::SetPosition, stander, Vector (2, 0, 0));
+  Simulator::Schedule (Seconds (2), &BlockageMovingTestCase::Check, this, 10);
+  Simulator::Schedule (Seconds (4.5), &BlockageMovingTestCase::Check, this, 10);
+  Simulator::Schedule (Seconds (5), &BlockageMovingTestCase::Check, this, 30);
+  Simulator::Schedule (Seconds (5.005), &BlockageMovingTestCase::Check, this, 30);
+  Simulator::Schedule (Seconds (6), &BlockageMovingTestCase::Check, this, 10);
+  // the link end moves away from the stander
+  Simulator::Schedule (Seconds (7), &MobilityModel::SetPosition, m_a, Vector (0, 3, 1));
+  Simulator::Schedule (Seconds (7), &BlockageMovingTestCase::Check, this, 0);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Check the cached attenuations against freshly computed ones while
+ * obstacles move among many links.
+ */
+class BlockageCacheTestCase : public TestCase
+{
+public:
+  BlockageCacheTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+BlockageCacheTestCase::BlockageCacheTestCase ()
+  : TestCase ("Check the cached attenuations against fresh computations")
+{
+}
+
+void
+BlockageCacheTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+  u->SetStream (1);
+  std::vector<Ptr<MobilityModel> > nodes;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      nodes.push_back (CreatePosition (u->GetValue (0, 20), u->GetValue (0, 20), u->GetValue (0.5, 2.5)));
+    }
+  std::vector<Ptr<MobilityModel> > blockers;
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      blockers.push_back (CreatePosition (u->GetValue (0, 20), u->GetValue (0, 20), 0));
+    }
+  Ptr<BlockagePropagationLossModel> cached = CreateObject<BlockagePropagationLossModel> ();
+  for (uint32_t i = 0; i < blockers.size (); i++)
+    {
+      if (i % 2)
+        {
+          cached->AddCylinder (blockers[i], 0.3, 1.8, 1 + i);
+        }
+      else
+        {
+          cached->AddBox (blockers[i], Vector (0.5, 1, 1), 1 + i);
+        }
+    }
+
+  uint32_t blocked = 0;
+  for (uint32_t round = 0; round < 10; round++)
+    {
+      for (uint32_t i = 0; i < 5; i++)
+        {
+          blockers[u->GetInteger (0, blockers.size () - 1)]->SetPosition (Vector (u->GetValue (0, 20), u->GetValue (0, 20), 0));
+        }
+      Ptr<BlockagePropagationLossModel> fresh = CreateObject<BlockagePropagationLossModel> ();
+      for (uint32_t i = 0; i < blockers.size (); i++)
+        {
+          if (i % 2)
+            {
+              fresh->AddCylinder (blockers[i], 0.3, 1.8, 1 + i);
+            }
+          else
+            {
+              fresh->AddBox (blockers[i], Vector (0.5, 1, 1), 1 + i);
+            }
+        }
+      for (uint32_t i = 0; i < nodes.size (); i++)
+        {
+          for (uint32_t j = i + 1; j < nodes.size (); j++)
+            {
+              double attenuation = cached->GetAttenuation (nodes[i], nodes[j]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (attenuation, fresh->GetAttenuation (nodes[i], nodes[j]), 1e-9,
+                                         "Stale attenuation for link " << i << "-" << j << " in round " << round);
+              blocked += (attenuation > 0);
+            }
+        }
+      fresh->Dispose ();
+    }
+  NS_TEST_ASSERT_MSG_GT (blocked, 0, "No link was ever blocked");
+}
+
+/**
+ * BlockagePropagationLossModel TestSuite
+ */
+class BlockagePropagationLossModelTestSuite : public TestSuite
+{
+public:
+  BlockagePropagationLossModelTestSuite ();
+};
+
+BlockagePropagationLossModelTestSuite::BlockagePropagationLossModelTestSuite ()
+  : TestSuite ("blockage-propagation-loss-model", UNIT)
+{
+  AddTestCase (new BlockageShapesTestCase, TestCase::QUICK);
+  AddTestCase (new BlockageMovingTestCase, TestCase::QUICK);
+  AddTestCase (new BlockageCacheTestCase, TestCase::QUICK);
+}
+
+static BlockagePropagationLossModelTestSuite g_blockagePropagationLossModelTestSuite;
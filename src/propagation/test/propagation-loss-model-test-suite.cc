@@ -16,11 +16,14 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cmath>
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
@@ -436,6 +439,114 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class MmWavePropagationLossModelTestCase : public TestCase
+{
+public:
+  MmWavePropagationLossModelTestCase ();
+  virtual ~MmWavePropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmWavePropagationLossModelTestCase::MmWavePropagationLossModelTestCase ()
+  : TestCase ("Test MmWavePropagationLossModel")
+{
+}
+
+MmWavePropagationLossModelTestCase::~MmWavePropagationLossModelTestCase ()
+{
+}
+
+void
+MmWavePropagationLossModelTestCase::DoRun (void)
+{
+  double tolerance = 1e-6;
+  std::vector<Ptr<MobilityModel> > m;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (5.0 * i, 0, 0));
+      m.push_back (mobility);
+    }
+
+  Ptr<MmWavePropagationLossModel> lossModel = CreateObject<MmWavePropagationLossModel> ();
+  lossModel->SetAttribute ("Frequency", DoubleValue (28e9));
+  lossModel->SetAttribute ("ChannelState", StringValue ("Los"));
+  lossModel->SetAttribute ("CorrelationDistance", DoubleValue (0));
+  lossModel->AssignStreams (1);
+
+  // the shadowing of a link is drawn once and does not depend on the direction
+  double rx = lossModel->CalcRxPower (0, m[0], m[1]);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, m[1], m[0]), rx, tolerance, "Asymmetric link");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLinkState (m[1], m[0]), MmWavePropagationLossModel::LOS, "Unexpected state");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLinkState (m[0], m[2]), MmWavePropagationLossModel::ALL, "Unknown link has a state");
+
+  // fill the link table beyond its initial size
+  std::vector<double> rxs;
+  for (uint32_t i = 1; i < m.size (); i++)
+    {
+      rxs.push_back (lossModel->CalcRxPower (0, m[i - 1], m[i]));
+    }
+  for (uint32_t i = 0; i < m.size (); i++)
+    {
+      lossModel->CalcRxPower (0, m[0], m[i]);
+    }
+  for (uint32_t i = 1; i < m.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, m[i], m[i - 1]), rxs[i - 1], tolerance,
+                                 "Link state lost when the table grew");
+    }
+
+  // without correlation, moving only changes the distance term
+  m[1]->SetPosition (Vector (50, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, m[0], m[1]), rx - 20, tolerance,
+                             "Unexpected loss after moving");
+
+  // far away links are in outage
+  lossModel->SetAttribute ("ChannelState", StringValue ("All"));
+  m[2]->SetPosition (Vector (2000, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, m[0], m[2]), -500, tolerance, "Link not in outage");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetLinkState (m[0], m[2]), MmWavePropagationLossModel::OUTAGE, "Unexpected state");
+
+  // with correlation, the state is updated as the link gets shorter
+  lossModel->SetAttribute ("CorrelationDistance", DoubleValue (10));
+  m[2]->SetPosition (Vector (0.5, 0, 0));
+  lossModel->CalcRxPower (0, m[0], m[2]);
+  NS_TEST_EXPECT_MSG_NE (lossModel->GetLinkState (m[0], m[2]), MmWavePropagationLossModel::OUTAGE, "State not updated");
+
+  // the LOS shadowing sigma is a variance unless ShadowingStandardDeviation is set
+  std::vector<Ptr<MobilityModel> > ring;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (10 * std::cos (i * 0.001), 10 * std::sin (i * 0.001), 0));
+      ring.push_back (mobility);
+    }
+  for (uint32_t stdDev = 0; stdDev < 2; stdDev++)
+    {
+      Ptr<MmWavePropagationLossModel> spreadModel = CreateObject<MmWavePropagationLossModel> ();
+      spreadModel->SetAttribute ("ChannelState", StringValue ("Los"));
+      spreadModel->SetAttribute ("ShadowingStandardDeviation", BooleanValue (stdDev == 1));
+      spreadModel->AssignStreams (2);
+      double sum = 0;
+      double sumSquares = 0;
+      for (uint32_t i = 0; i < ring.size (); i++)
+        {
+          double loss = -spreadModel->CalcRxPower (0, m[0], ring[i]);
+          sum += loss;
+          sumSquares += loss * loss;
+        }
+      double mean = sum / ring.size ();
+      double deviation = std::sqrt (sumSquares / ring.size () - mean * mean);
+      double expected = stdDev ? 5.8 : std::sqrt (5.8);
+      NS_TEST_EXPECT_MSG_EQ_TOL (mean, 61.4 + 20, 0.5, "Unexpected mean LOS loss");
+      NS_TEST_EXPECT_MSG_EQ_TOL (deviation, expected, expected * 0.1, "Unexpected LOS shadowing spread");
+    }
+
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +561,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new MmWavePropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -22,6 +22,7 @@
 
 #include <map>
 #include <cmath>
+#include <algorithm>
 #include "wifi-spectrum-value-helper.h"
 #include "ns3/log.h"
 #include "ns3/fatal-error.h"
@@ -53,6 +54,44 @@ operator < (const WifiSpectrumModelId& a, const WifiSpectrumModelId& b)
 
 static std::map<WifiSpectrumModelId, Ptr<SpectrumModel> > g_wifiSpectrumModelMap;
 
+static const uint32_t DMG_CHANNEL_WIDTH = 2160;     //!< The width (MHz) of a DMG channel
+static const double DMG_BAND_BANDWIDTH = 60e6;      //!< The width (Hz) of the bands of the DMG spectrum model
+
+/**
+ * \param offset the offset (MHz) from the center frequency
+ * \param occupiedBandwidth the bandwidth (MHz) occupied by the signal
+ * \return the power (linear, relative to the occupied band) allowed by
+ * the DMG transmit spectrum mask at the given offset
+ */
+static double
+GetDmgSpectrumMask (double offset, double occupiedBandwidth)
+{
+  double edge = occupiedBandwidth / 2;
+  double dbr;
+  offset = std::abs (offset);
+  if (offset <= edge)
+    {
+      return 1;
+    }
+  else if (offset <= 1200)
+    {
+      dbr = -17 * (offset - edge) / (1200 - edge);
+    }
+  else if (offset <= 2700)
+    {
+      dbr = -17 - 5 * (offset - 1200) / 1500;
+    }
+  else if (offset <= 3060)
+    {
+      dbr = -22 - 8 * (offset - 2700) / 360;
+    }
+  else
+    {
+      return 0;
+    }
+  return std::pow (10.0, dbr / 10.0);
+}
+
 Ptr<SpectrumModel>
 WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint32_t channelWidth)
 {
@@ -68,10 +107,23 @@ WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint32_t ch
     {
       Bands bands;
       double centerFrequencyHz = centerFrequency * 1e6;
-      // Overall bandwidth will be channelWidth plus 10 MHz guards on each side
-      double bandwidth = (channelWidth + 20) * 1e6;
-      // Use OFDM subcarrier width of 312.5 KHz as band granularity
-      double bandBandwidth = 312500;
+      double bandwidth;
+      double bandBandwidth;
+      if (channelWidth == DMG_CHANNEL_WIDTH)
+        {
+          // Overall bandwidth will cover both adjacent DMG channels, where
+          // the transmit spectrum mask extends, with coarse bands to keep
+          // the SpectrumValues small
+          bandwidth = 3 * channelWidth * 1e6;
+          bandBandwidth = DMG_BAND_BANDWIDTH;
+        }
+      else
+        {
+          // Overall bandwidth will be channelWidth plus 10 MHz guards on each side
+          bandwidth = (channelWidth + 20) * 1e6;
+          // Use OFDM subcarrier width of 312.5 KHz as band granularity
+          bandBandwidth = 312500;
+        }
       // For OFDM, the center subcarrier is null (at center frequency)
       uint32_t numBands = static_cast<uint32_t> (bandwidth / bandBandwidth + 0.5);
       NS_ASSERT (numBands > 0);
@@ -79,7 +131,7 @@ WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint32_t ch
         {
           // round up to the nearest odd number of subbands so that bands
           // are symmetric around center frequency
-          NS_LOG_DEBUG ("Total bandwidth evenly divided by 312.5 KHz");
+          NS_LOG_DEBUG ("Total bandwidth evenly divided by " << bandBandwidth << " Hz");
           numBands += 1;    
         }
       NS_ASSERT_MSG (numBands % 2 == 1, "Number of bands should be odd");
@@ -304,6 +356,42 @@ WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFreque
   return c;
 }
 
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateDmgScTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW)
+{
+  NS_LOG_FUNCTION (centerFrequency << txPowerW);
+  // The single carrier PHYs occupy the chip rate of 1760 MHz
+  return CreateDmgTxPowerSpectralDensity (centerFrequency, txPowerW, 1760);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateDmgOfdmTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW)
+{
+  NS_LOG_FUNCTION (centerFrequency << txPowerW);
+  // 336 data, 16 pilot and 3 DC subcarriers spaced by 5.15625 MHz
+  return CreateDmgTxPowerSpectralDensity (centerFrequency, txPowerW, 355 * 5.15625);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateDmgTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, double occupiedBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << txPowerW << occupiedBandwidth);
+  Ptr<SpectrumValue> c = Create<SpectrumValue> (GetSpectrumModel (centerFrequency, DMG_CHANNEL_WIDTH));
+  Values::iterator vit = c->ValuesBegin ();
+  Bands::const_iterator bit = c->ConstBandsBegin ();
+  double centerFrequencyHz = centerFrequency * 1e6;
+  // Shape the power with the spectrum mask, then scale it so that the
+  // whole transmit power is allocated
+  double txPower = 0;
+  for (size_t i = 0; i < c->GetSpectrumModel ()->GetNumBands (); i++, vit++, bit++)
+    {
+      *vit = GetDmgSpectrumMask ((bit->fc - centerFrequencyHz) / 1e6, occupiedBandwidth);
+      txPower += *vit * (bit->fh - bit->fl);
+    }
+  (*c) *= txPowerW / txPower;
+  return c;
+}
+
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateNoisePowerSpectralDensity (uint32_t centerFrequency, uint32_t channelWidth, double noiseFigure)
 {
@@ -337,6 +425,19 @@ WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint32_t chan
   size_t numBands = c->GetSpectrumModel ()->GetNumBands ();
   Bands::const_iterator bit = c->ConstBandsBegin ();
   Values::iterator vit = c->ValuesBegin ();
+  if (channelWidth == DMG_CHANNEL_WIDTH)
+    {
+      // The edges of a DMG channel fall in the middle of a band: weigh each
+      // band by the part of it lying within the channel
+      double lowFrequency = (centerFrequency - channelWidth / 2.0) * 1e6;
+      double highFrequency = (centerFrequency + channelWidth / 2.0) * 1e6;
+      for (size_t i = 0; i < numBands; i++, vit++, bit++)
+        {
+          double overlap = std::min (bit->fh, highFrequency) - std::max (bit->fl, lowFrequency);
+          *vit = std::max (overlap, 0.0) / (bit->fh - bit->fl);
+        }
+      return c;
+    }
   uint32_t bandBandwidth = static_cast<uint32_t> (((bit->fh - bit->fl) + 0.5));
   NS_LOG_DEBUG ("Band bandwidth: " << bandBandwidth);
   size_t numBandsInFilter = static_cast<size_t> (channelWidth * 1e6 / bandBandwidth); 
@@ -32,6 +32,10 @@ namespace ns3 {
  *  This class defines all functions to create a spectrum model for 
  *  Wi-Fi based on a a spectral model aligned with an OFDM subcarrier
  *  spacing of 312.5 KHz (model also reused for DSSS modulations)
+ *
+ *  The 2160 MHz wide DMG (802.11ad) channels use a coarser spectral model
+ *  made of 60 MHz bands, so that the SpectrumValue of a DMG signal holds
+ *  about a hundred bands instead of several thousands.
  */
 class WifiSpectrumValueHelper
 {
@@ -46,6 +50,12 @@ public:
    * and channel width.  The model includes +/- 10 MHz of guard bands
    * (i.e. the model will span (channelWidth + 20) MHz of bandwidth).
    *
+   * For the 2160 MHz DMG channels, the model is made of 60 MHz bands and
+   * spans the channel and its two adjacent channels, which covers the
+   * whole DMG transmit spectrum mask.  The channel spacing being a
+   * multiple of the band width, the bands of adjacent channels are
+   * aligned with each other.
+   *
    * \param centerFrequency center frequency (MHz)
    * \param channelWidth channel width (MHz)
    * \return the static SpectrumModel instance corresponding to the
@@ -85,6 +95,30 @@ public:
    */
   static Ptr<SpectrumValue> CreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW);
 
+  /**
+   * Create a transmit power spectral density corresponding to DMG single
+   * carrier (802.11ad control, SC and low-power SC PHYs), which occupies
+   * 1760 MHz (the chip rate) of the 2160 MHz channel.  Out of the occupied
+   * band, the power follows the DMG transmit spectrum mask: -17 dBr at
+   * 1.2 GHz, -22 dBr at 2.7 GHz and -30 dBr at 3.06 GHz from the center
+   * frequency, linearly interpolated in dB in between.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   */
+  static Ptr<SpectrumValue> CreateDmgScTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW);
+
+  /**
+   * Create a transmit power spectral density corresponding to DMG OFDM
+   * (802.11ad), which occupies 355 subcarriers of 5.15625 MHz (1830 MHz)
+   * of the 2160 MHz channel.  Out of the occupied band, the power follows
+   * the DMG transmit spectrum mask as for the single carrier PHY.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   */
+  static Ptr<SpectrumValue> CreateDmgOfdmTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW);
+
   /**
    *
    * \param centerFrequency center frequency (MHz)
@@ -108,6 +142,17 @@ public:
    * to an received power spectral density
    */
   static Ptr<SpectrumValue> CreateRfFilter (uint32_t centerFrequency, uint32_t channelWidth);
+
+private:
+  /**
+   * Create a DMG transmit power spectral density, flat over the occupied
+   * band and following the DMG transmit spectrum mask out of it.
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param occupiedBandwidth the bandwidth (MHz) occupied by the signal
+   */
+  static Ptr<SpectrumValue> CreateDmgTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, double occupiedBandwidth);
 };
 
 /**
@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "log-linear-histogram.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LogLinearHistogram");
+
+/**
+ * \param value a non-zero value
+ * \return the index of the most significant bit set in the value
+ */
+static uint8_t
+FloorLog2 (uint64_t value)
+{
+  uint8_t log = 0;
+  for (uint8_t shift = 32; shift > 0; shift >>= 1)
+    {
+      if (value >> shift)
+        {
+          value >>= shift;
+          log += shift;
+        }
+    }
+  return log;
+}
+
+LogLinearHistogram::LogLinearHistogram (uint8_t subBucketBits)
+  : m_subBucketBits (subBucketBits),
+    m_count (0),
+    m_min (std::numeric_limits<uint64_t>::max ()),
+    m_max (0),
+    m_sum (0)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (subBucketBits));
+  NS_ABORT_MSG_IF (subBucketBits < 1 || subBucketBits > 16,
+                   "The number of sub-bucket bits must be between 1 and 16");
+  m_counts.resize ((1 << m_subBucketBits) + (64 - m_subBucketBits) * (1 << (m_subBucketBits - 1)), 0);
+}
+
+uint32_t
+LogLinearHistogram::GetBucketIndex (uint64_t value) const
+{
+  uint64_t full = 1 << m_subBucketBits;
+  if (value < full)
+    {
+      return value;
+    }
+  uint64_t half = full >> 1;
+  uint8_t log = FloorLog2 (value);
+  uint8_t shift = log - (m_subBucketBits - 1);
+  return full + (log - m_subBucketBits) * half + ((value >> shift) - half);
+}
+
+uint64_t
+LogLinearHistogram::GetBucketLowerBound (uint32_t index) const
+{
+  NS_ASSERT (index < m_counts.size ());
+  uint64_t full = 1 << m_subBucketBits;
+  if (index < full)
+    {
+      return index;
+    }
+  uint64_t half = full >> 1;
+  uint32_t group = (index - full) / half;
+  uint64_t sub = (index - full) % half;
+  return (half + sub) << (group + 1);
+}
+
+uint64_t
+LogLinearHistogram::GetBucketUpperBound (uint32_t index) const
+{
+  NS_ASSERT (index < m_counts.size ());
+  uint64_t full = 1 << m_subBucketBits;
+  if (index < full)
+    {
+      return index;
+    }
+  uint32_t group = (index - full) / (full >> 1);
+  return GetBucketLowerBound (index) + ((static_cast<uint64_t> (1) << (group + 1)) - 1);
+}
+
+uint32_t
+LogLinearHistogram::GetNBuckets (void) const
+{
+  return m_counts.size ();
+}
+
+uint64_t
+LogLinearHistogram::GetBucketCount (uint32_t index) const
+{
+  NS_ASSERT (index < m_counts.size ());
+  return m_counts[index];
+}
+
+void
+LogLinearHistogram::Add (uint64_t value, uint64_t count)
+{
+  NS_LOG_FUNCTION (this << value << count);
+  if (count == 0)
+    {
+      return;
+    }
+  m_counts[GetBucketIndex (value)] += count;
+  m_count += count;
+  m_min = std::min (m_min, value);
+  m_max = std::max (m_max, value);
+  m_sum += static_cast<double> (value) * count;
+}
+
+void
+LogLinearHistogram::Merge (const LogLinearHistogram &other)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (other.m_subBucketBits != m_subBucketBits,
+                   "Cannot merge histograms with different numbers of sub-bucket bits");
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      m_counts[i] += other.m_counts[i];
+    }
+  m_count += other.m_count;
+  m_min = std::min (m_min, other.m_min);
+  m_max = std::max (m_max, other.m_max);
+  m_sum += other.m_sum;
+}
+
+void
+LogLinearHistogram::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::fill (m_counts.begin (), m_counts.end (), 0);
+  m_count = 0;
+  m_min = std::numeric_limits<uint64_t>::max ();
+  m_max = 0;
+  m_sum = 0;
+}
+
+uint64_t
+LogLinearHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+uint64_t
+LogLinearHistogram::GetMin (void) const
+{
+  return m_count == 0 ? 0 : m_min;
+}
+
+uint64_t
+LogLinearHistogram::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+LogLinearHistogram::GetMean (void) const
+{
+  return m_count == 0 ? 0 : m_sum / m_count;
+}
+
+uint64_t
+LogLinearHistogram::GetPercentile (double percentile) const
+{
+  NS_LOG_FUNCTION (this << percentile);
+  NS_ASSERT (percentile >= 0 && percentile <= 100);
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  // The rank of the value, starting from 1
+  uint64_t rank = std::max (static_cast<uint64_t> (std::ceil (percentile / 100 * m_count)),
+                            static_cast<uint64_t> (1));
+  uint64_t seen = 0;
+  uint32_t index = GetBucketIndex (m_min);
+  for (uint32_t last = GetBucketIndex (m_max); index < last; index++)
+    {
+      seen += m_counts[index];
+      if (seen >= rank)
+        {
+          break;
+        }
+    }
+  uint64_t lower = GetBucketLowerBound (index);
+  uint64_t value = lower + (GetBucketUpperBound (index) - lower) / 2;
+  return std::min (std::max (value, m_min), m_max);
+}
+
+} // namespace ns3
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOG_LINEAR_HISTOGRAM_H
+#define LOG_LINEAR_HISTOGRAM_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup stats
+ *
+ * \brief Histogram of unsigned integer values with a bounded relative error.
+ *
+ * The values below 2^SubBucketBits have a bucket each.  Above, every
+ * power of two range [2^e, 2^(e+1)) is divided into 2^(SubBucketBits-1)
+ * buckets of equal width, so that the width of a bucket is at most
+ * 2^(1-SubBucketBits) times the values it holds.  The histogram covers
+ * every 64-bit value with a fixed number of buckets, allocated once: its
+ * memory does not depend on the number of values added.
+ *
+ * The percentiles are computed from the buckets: they are exact below
+ * 2^SubBucketBits, and within half a bucket width above.
+ */
+class LogLinearHistogram
+{
+public:
+  /**
+   * \param subBucketBits the log2 of the number of linear buckets per power
+   * of two range, between 1 and 16 (the default value, 7, bounds the relative
+   * error to 1/128)
+   */
+  LogLinearHistogram (uint8_t subBucketBits = 7);
+
+  /**
+   * \brief Add values to the histogram.
+   * \param value the value
+   * \param count the number of times the value is added
+   */
+  void Add (uint64_t value, uint64_t count = 1);
+  /**
+   * \brief Add the values of another histogram.
+   * \param other a histogram with the same number of sub-bucket bits
+   */
+  void Merge (const LogLinearHistogram &other);
+  /**
+   * \brief Remove all the values.
+   */
+  void Reset (void);
+
+  /**
+   * \return the number of values added
+   */
+  uint64_t GetCount (void) const;
+  /**
+   * \return the smallest value added, or 0 if none
+   */
+  uint64_t GetMin (void) const;
+  /**
+   * \return the largest value added, or 0 if none
+   */
+  uint64_t GetMax (void) const;
+  /**
+   * \return the mean of the values added (exact), or 0 if none
+   */
+  double GetMean (void) const;
+  /**
+   * \brief Get a percentile of the values added.
+   *
+   * \param percentile the percentile, between 0 and 100
+   * \return the middle of the bucket holding the value of the given rank,
+   * bounded by the minimum and the maximum, or 0 if no value was added
+   */
+  uint64_t GetPercentile (double percentile) const;
+
+  /**
+   * \return the number of buckets
+   */
+  uint32_t GetNBuckets (void) const;
+  /**
+   * \param index the index of a bucket
+   * \return the number of values in the bucket
+   */
+  uint64_t GetBucketCount (uint32_t index) const;
+  /**
+   * \param index the index of a bucket
+   * \return the smallest value of the bucket
+   */
+  uint64_t GetBucketLowerBound (uint32_t index) const;
+  /**
+   * \param index the index of a bucket
+   * \return the largest value of the bucket
+   */
+  uint64_t GetBucketUpperBound (uint32_t index) const;
+  /**
+   * \param value a value
+   * \return the index of the bucket of the value
+   */
+  uint32_t GetBucketIndex (uint64_t value) const;
+
+private:
+  uint8_t m_subBucketBits;        //!< log2 of the number of values with a bucket each
+  std::vector<uint64_t> m_counts; //!< the number of values in each bucket
+  uint64_t m_count;               //!< the number of values
+  uint64_t m_min;                 //!< the smallest value
+  uint64_t m_max;                 //!< the largest value
+  double m_sum;                   //!< the sum of the values
+};
+
+} // namespace ns3
+
+#endif /* LOG_LINEAR_HISTOGRAM_H */
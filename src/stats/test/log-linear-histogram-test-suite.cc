@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/log-linear-histogram.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case for the layout of the buckets.
+// ===========================================================================
+
+class LogLinearHistogramBucketsTestCase : public TestCase
+{
+public:
+  LogLinearHistogramBucketsTestCase ();
+  virtual ~LogLinearHistogramBucketsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogLinearHistogramBucketsTestCase::LogLinearHistogramBucketsTestCase ()
+  : TestCase ("Check that the buckets cover every 64-bit value with a bounded relative width")
+{
+}
+
+LogLinearHistogramBucketsTestCase::~LogLinearHistogramBucketsTestCase ()
+{
+}
+
+void
+LogLinearHistogramBucketsTestCase::DoRun (void)
+{
+  for (uint8_t bits = 1; bits <= 10; bits++)
+    {
+      LogLinearHistogram histogram (bits);
+      NS_TEST_ASSERT_MSG_EQ (histogram.GetBucketLowerBound (0), 0, "First bucket");
+      NS_TEST_ASSERT_MSG_EQ (histogram.GetBucketUpperBound (histogram.GetNBuckets () - 1),
+                             std::numeric_limits<uint64_t>::max (), "Last bucket");
+      for (uint32_t i = 0; i < histogram.GetNBuckets (); i++)
+        {
+          uint64_t lower = histogram.GetBucketLowerBound (i);
+          uint64_t upper = histogram.GetBucketUpperBound (i);
+          NS_TEST_ASSERT_MSG_EQ (histogram.GetBucketIndex (lower), i, "Bucket of the lower bound");
+          NS_TEST_ASSERT_MSG_EQ (histogram.GetBucketIndex (upper), i, "Bucket of the upper bound");
+          if (i > 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (histogram.GetBucketUpperBound (i - 1) + 1, lower,
+                                     "Buckets " << i - 1 << " and " << i << " are not contiguous");
+            }
+          NS_TEST_ASSERT_MSG_LT_OR_EQ ((upper - lower) / static_cast<double> (std::max (lower, static_cast<uint64_t> (1))),
+                                       1.0 / (1 << (bits - 1)), "Bucket " << i << " is too wide");
+        }
+    }
+}
+
+// ===========================================================================
+// Test case for the statistics and the percentiles.
+// ===========================================================================
+
+class LogLinearHistogramPercentilesTestCase : public TestCase
+{
+public:
+  LogLinearHistogramPercentilesTestCase ();
+  virtual ~LogLinearHistogramPercentilesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogLinearHistogramPercentilesTestCase::LogLinearHistogramPercentilesTestCase ()
+  : TestCase ("Check the percentiles of random values against the exact ones")
+{
+}
+
+LogLinearHistogramPercentilesTestCase::~LogLinearHistogramPercentilesTestCase ()
+{
+}
+
+void
+LogLinearHistogramPercentilesTestCase::DoRun (void)
+{
+  Ptr<ExponentialRandomVariable> random = CreateObject<ExponentialRandomVariable> ();
+  random->SetStream (1);
+  random->SetAttribute ("Mean", DoubleValue (100000));
+  random->SetAttribute ("Bound", DoubleValue (0));
+
+  LogLinearHistogram histogram;
+  LogLinearHistogram first;
+  LogLinearHistogram second;
+  std::vector<uint64_t> values;
+  double sum = 0;
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      uint64_t value = random->GetInteger ();
+      values.push_back (value);
+      sum += value;
+      histogram.Add (value);
+      if (i % 2)
+        {
+          first.Add (value);
+        }
+      else
+        {
+          second.Add (value);
+        }
+    }
+  std::sort (values.begin (), values.end ());
+
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetCount (), values.size (), "Count");
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetMin (), values.front (), "Minimum");
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetMax (), values.back (), "Maximum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (histogram.GetMean (), sum / values.size (), 1e-6, "Mean");
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetPercentile (0), values.front (), "Percentile 0");
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetPercentile (100), values.back (), "Percentile 100");
+
+  first.Merge (second);
+  const double percentiles[] = { 1, 10, 25, 50, 75, 90, 99, 99.9 };
+  for (uint32_t i = 0; i < sizeof (percentiles) / sizeof (percentiles[0]); i++)
+    {
+      uint64_t exact = values[std::ceil (percentiles[i] / 100 * values.size ()) - 1];
+      NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (histogram.GetPercentile (percentiles[i])),
+                                 static_cast<double> (exact), exact / 128.0 + 1,
+                                 "Percentile " << percentiles[i]);
+      NS_TEST_ASSERT_MSG_EQ (first.GetPercentile (percentiles[i]), histogram.GetPercentile (percentiles[i]),
+                             "Percentile " << percentiles[i] << " of the merged histograms");
+    }
+
+  histogram.Reset ();
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetCount (), 0, "Count after a reset");
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetPercentile (50), 0, "Percentile after a reset");
+  histogram.Add (3, 4);
+  histogram.Add (std::numeric_limits<uint64_t>::max ());
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetPercentile (80), 3, "Small values are exact");
+  NS_TEST_ASSERT_MSG_EQ (histogram.GetBucketIndex (histogram.GetPercentile (81)),
+                         histogram.GetNBuckets () - 1, "Largest value");
+}
+
+class LogLinearHistogramTestSuite : public TestSuite
+{
+public:
+  LogLinearHistogramTestSuite ();
+};
+
+LogLinearHistogramTestSuite::LogLinearHistogramTestSuite ()
+  : TestSuite ("log-linear-histogram", UNIT)
+{
+  AddTestCase (new LogLinearHistogramBucketsTestCase, TestCase::QUICK);
+  AddTestCase (new LogLinearHistogramPercentilesTestCase, TestCase::QUICK);
+}
+
+static LogLinearHistogramTestSuite logLinearHistogramTestSuite;
@@ -52,25 +52,16 @@ static inline uint32_t ReciprocalDivide (uint32_t A, uint32_t R)
 
 /* end kernel borrowings */
 
-/**
- * Returns the current time translated in CoDel time representation
- * \return the current time
- */
-static uint32_t CoDelGetTime (void)
-{
-  Time time = Simulator::Now ();
-  uint64_t ns = time.GetNanoSeconds ();
-
-  return ns >> CODEL_SHIFT;
-}
-
 /**
  * CoDel time stamp, used to carry CoDel time informations.
  */
 class CoDelTimestampTag : public Tag
 {
 public:
-  CoDelTimestampTag ();
+  /**
+   * \param creationTime the time of the CoDel clock at the enqueue
+   */
+  CoDelTimestampTag (Time creationTime = Seconds (0));
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -92,8 +83,8 @@ private:
   uint64_t m_creationTime; //!< Tag creation time
 };
 
-CoDelTimestampTag::CoDelTimestampTag ()
-  : m_creationTime (Simulator::Now ().GetTimeStep ())
+CoDelTimestampTag::CoDelTimestampTag (Time creationTime)
+  : m_creationTime (creationTime.GetTimeStep ())
 {
 }
 
@@ -294,7 +285,7 @@ CoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
     }
 
   // Tag packet with current time for DoDequeue() to compute sojourn time
-  CoDelTimestampTag tag;
+  CoDelTimestampTag tag (GetClock ());
   p->AddPacketTag (tag);
 
   bool retval = GetInternalQueue (0)->Enqueue (item);
@@ -318,7 +309,7 @@ CoDelQueueDisc::OkToDrop (Ptr<Packet> p, uint32_t now)
   bool found = p->RemovePacketTag (tag);
   NS_ASSERT_MSG (found, "found a packet without an input timestamp tag");
   NS_UNUSED (found);    //silence compiler warning
-  Time delta = Simulator::Now () - tag.GetTxTime ();
+  Time delta = GetClock () - tag.GetTxTime ();
   NS_LOG_INFO ("Sojourn time " << delta.GetSeconds ());
   m_sojourn = delta;
   uint32_t sojournTime = Time2CoDel (delta);
@@ -363,7 +354,7 @@ CoDelQueueDisc::DoDequeue (void)
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
-  uint32_t now = CoDelGetTime ();
+  uint32_t now = Time2CoDel (GetClock ());
   Ptr<QueueDiscItem> item = StaticCast<QueueDiscItem> (GetInternalQueue (0)->Dequeue ());
   Ptr<Packet> p = item->GetPacket ();
 
@@ -581,6 +572,12 @@ CoDelQueueDisc::CoDelTimeBeforeEq (uint32_t a, uint32_t b)
   return ((int)(a) - (int)(b) <= 0);
 }
 
+Time
+CoDelQueueDisc::GetClock (void) const
+{
+  return Simulator::Now ();
+}
+
 uint32_t
 CoDelQueueDisc::Time2CoDel (Time t)
 {
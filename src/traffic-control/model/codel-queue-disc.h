@@ -135,9 +135,18 @@ public:
    */
   uint32_t GetDropNext (void);
 
-private:
-  friend class::CoDelQueueDiscNewtonStepTest;  // Test code
-  friend class::CoDelQueueDiscControlLawTest;  // Test code
+protected:
+  /**
+   * \brief Get the time of the clock CoDel runs on.
+   *
+   * The sojourn times and the drop schedule are measured on this clock.
+   * Subclasses override it to run CoDel on a clock which does not advance
+   * while the device cannot transmit.
+   *
+   * \returns The current time (by default, the simulation time)
+   */
+  virtual Time GetClock (void) const;
+
   /**
    * \brief Add a packet to the queue
    *
@@ -160,6 +169,10 @@ private:
   virtual Ptr<const QueueDiscItem> DoPeek (void) const;
   virtual bool CheckConfig (void);
 
+private:
+  friend class::CoDelQueueDiscNewtonStepTest;  // Test code
+  friend class::CoDelQueueDiscControlLawTest;  // Test code
+
   /**
    * \brief Calculate the reciprocal square root of m_count by using Newton's method
    *  http://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Iterative_methods_for_reciprocal_square_roots
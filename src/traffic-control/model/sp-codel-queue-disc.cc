@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/net-device.h"
+#include "sp-codel-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpCoDelQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (SpCoDelQueueDisc);
+
+TypeId SpCoDelQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SpCoDelQueueDisc")
+    .SetParent<CoDelQueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<SpCoDelQueueDisc> ()
+  ;
+
+  return tid;
+}
+
+SpCoDelQueueDisc::SpCoDelQueueDisc ()
+  : CoDelQueueDisc (),
+    m_allocationKnown (false),
+    m_inAllocation (true)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SpCoDelQueueDisc::~SpCoDelQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SpCoDelQueueDisc::NotifyAllocationStarted (Time duration)
+{
+  NS_LOG_FUNCTION (this << duration);
+  if (!m_inAllocation)
+    {
+      m_outsideTime += Simulator::Now () - m_outsideSince;
+    }
+  m_allocationKnown = true;
+  m_inAllocation = true;
+  // Pass the packets queued since the previous allocation to the device
+  if (GetNetDevice () != 0 && GetNPackets () > 0)
+    {
+      Run ();
+    }
+}
+
+void
+SpCoDelQueueDisc::NotifyAllocationEnded (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_allocationKnown = true;
+  if (m_inAllocation)
+    {
+      m_inAllocation = false;
+      m_outsideSince = Simulator::Now ();
+    }
+}
+
+bool
+SpCoDelQueueDisc::IsInAllocation (void) const
+{
+  return m_inAllocation;
+}
+
+Time
+SpCoDelQueueDisc::GetAllocationTime (void) const
+{
+  Time outside = m_outsideTime;
+  if (!m_inAllocation)
+    {
+      outside += Simulator::Now () - m_outsideSince;
+    }
+  return Simulator::Now () - outside;
+}
+
+Time
+SpCoDelQueueDisc::GetClock (void) const
+{
+  return GetAllocationTime ();
+}
+
+Ptr<QueueDiscItem>
+SpCoDelQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_allocationKnown && !m_inAllocation)
+    {
+      NS_LOG_LOGIC ("Outside of an allocation");
+      return 0;
+    }
+  return CoDelQueueDisc::DoDequeue ();
+}
+
+Ptr<const QueueDiscItem>
+SpCoDelQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_allocationKnown && !m_inAllocation)
+    {
+      NS_LOG_LOGIC ("Outside of an allocation");
+      return 0;
+    }
+  return CoDelQueueDisc::DoPeek ();
+}
+
+} // namespace ns3
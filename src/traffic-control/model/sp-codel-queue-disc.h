@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SP_CODEL_QUEUE_DISC_H
+#define SP_CODEL_QUEUE_DISC_H
+
+#include "ns3/codel-queue-disc.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A CoDel queue disc for devices which transmit only during
+ * allocations, such as the service periods (SPs) and contention based
+ * access periods (CBAPs) of a DMG STA.
+ *
+ * CoDel assumes that the device drains the queue continuously: between
+ * two allocations, the sojourn time of the queued packets grows above the
+ * target, and CoDel drops packets the device could not have sent anyway.
+ * This queue disc is told when the allocations start and end (see
+ * NotifyAllocationStarted and NotifyAllocationEnded, which match the
+ * AllocationStarted and AllocationEnded trace sources of the DmgWifiMac),
+ * and runs CoDel on a clock which only advances during the allocations:
+ * the sojourn time of a packet is the allocation time it waited.
+ *
+ * Between the allocations, no packet is dequeued.  During an allocation,
+ * the packets are paced by the queue limits of the device queue (see
+ * TrafficControlHelper::SetQueueLimits): the device queue is stopped once
+ * it holds the bytes the device can send, and the queue disc runs again
+ * as the device sends them.  The WifiMacQueue reports its bytes as sent
+ * when the MAC dequeues them, hence the MinLimit of the DynamicQueueLimits
+ * should be the size of an A-MPDU, so that the MAC can aggregate.  Without
+ * queue limits, the device queue is filled at the start of each
+ * allocation.  Until the first allocation is notified, this queue disc
+ * behaves as a CoDel queue disc.
+ */
+class SpCoDelQueueDisc : public CoDelQueueDisc
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  SpCoDelQueueDisc ();
+
+  virtual ~SpCoDelQueueDisc ();
+
+  /**
+   * \brief Notify the start of an allocation in which the device transmits.
+   * \param duration the duration of the allocation
+   */
+  void NotifyAllocationStarted (Time duration);
+  /**
+   * \brief Notify the end of the current allocation.
+   */
+  void NotifyAllocationEnded (void);
+  /**
+   * \return true if the device may transmit now
+   */
+  bool IsInAllocation (void) const;
+  /**
+   * \brief Get the time of the clock CoDel runs on.
+   * \return the time elapsed during the allocations (or since the start of
+   * the simulation until the first allocation is notified)
+   */
+  Time GetAllocationTime (void) const;
+
+protected:
+  virtual Time GetClock (void) const;
+
+private:
+  /**
+   * \brief Remove a packet from queue, if the device is in an allocation,
+   * and apply the CoDel algorithm to it.
+   *
+   * \returns The packet to send
+   */
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  /**
+   * \brief Return a copy of the next packet the queue disc will extract,
+   * if the device is in an allocation.
+   *
+   * \returns The packet to send next
+   */
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+
+  bool m_allocationKnown;                 //!< True once an allocation has been notified
+  bool m_inAllocation;                    //!< True during an allocation
+  Time m_outsideSince;                    //!< End of the last allocation
+  Time m_outsideTime;                     //!< Time spent outside the allocations before then
+};
+
+} // namespace ns3
+
+#endif /* SP_CODEL_QUEUE_DISC_H */
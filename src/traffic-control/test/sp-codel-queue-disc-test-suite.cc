@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/sp-codel-queue-disc.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+class SpCodelQueueDiscTestItem : public QueueDiscItem {
+public:
+  SpCodelQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~SpCodelQueueDiscTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  SpCodelQueueDiscTestItem ();
+  SpCodelQueueDiscTestItem (const SpCodelQueueDiscTestItem &);
+  SpCodelQueueDiscTestItem &operator = (const SpCodelQueueDiscTestItem &);
+};
+
+SpCodelQueueDiscTestItem::SpCodelQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+SpCodelQueueDiscTestItem::~SpCodelQueueDiscTestItem ()
+{
+}
+
+void
+SpCodelQueueDiscTestItem::AddHeader (void)
+{
+}
+
+// Test 1: packets queued between two allocations
+class SpCoDelQueueDiscGapTestCase : public TestCase
+{
+public:
+  SpCoDelQueueDiscGapTestCase (bool notify);
+  virtual void DoRun (void);
+
+private:
+  void Enqueue (Ptr<SpCoDelQueueDisc> queue, uint32_t nPackets);
+  void Dequeue (Ptr<SpCoDelQueueDisc> queue);
+  void CheckGap (Ptr<SpCoDelQueueDisc> queue);
+  void SojournTrace (Time oldValue, Time newValue);
+
+  bool m_notify;        //!< True if the allocations are notified to the queue disc
+  uint32_t m_dequeued;  //!< Number of packets dequeued
+  Time m_maxSojourn;    //!< Maximum sojourn time
+};
+
+SpCoDelQueueDiscGapTestCase::SpCoDelQueueDiscGapTestCase (bool notify)
+  : TestCase (notify ? "Packets queued between two allocations are not dropped"
+                     : "Without allocations, the time between them counts in the sojourn time"),
+    m_notify (notify),
+    m_dequeued (0)
+{
+}
+
+void
+SpCoDelQueueDiscGapTestCase::Enqueue (Ptr<SpCoDelQueueDisc> queue, uint32_t nPackets)
+{
+  Address dest;
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      queue->Enqueue (Create<SpCodelQueueDiscTestItem> (Create<Packet> (1000), dest, 0));
+    }
+}
+
+void
+SpCoDelQueueDiscGapTestCase::Dequeue (Ptr<SpCoDelQueueDisc> queue)
+{
+  if (queue->Dequeue () != 0)
+    {
+      m_dequeued++;
+    }
+}
+
+void
+SpCoDelQueueDiscGapTestCase::CheckGap (Ptr<SpCoDelQueueDisc> queue)
+{
+  NS_TEST_EXPECT_MSG_EQ (queue->IsInAllocation (), false, "The allocation has ended");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAllocationTime (), MilliSeconds (1), "The allocation clock stops between the allocations");
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek (), 0, "There should be no packet to peek between the allocations");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), 0, "There should be no dequeue between the allocations");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 50, "The queue should hold the packets");
+}
+
+void
+SpCoDelQueueDiscGapTestCase::SojournTrace (Time oldValue, Time newValue)
+{
+  m_maxSojourn = Max (m_maxSojourn, newValue);
+}
+
+void
+SpCoDelQueueDiscGapTestCase::DoRun (void)
+{
+  Ptr<SpCoDelQueueDisc> queue = CreateObject<SpCoDelQueueDisc> ();
+  queue->TraceConnectWithoutContext ("Sojourn", MakeCallback (&SpCoDelQueueDiscGapTestCase::SojournTrace, this));
+  queue->Initialize ();
+
+  if (m_notify)
+    {
+      Simulator::Schedule (Seconds (0), &SpCoDelQueueDisc::NotifyAllocationStarted, queue, MilliSeconds (1));
+      Simulator::Schedule (MilliSeconds (1), &SpCoDelQueueDisc::NotifyAllocationEnded, queue);
+      Simulator::Schedule (MilliSeconds (100), &SpCoDelQueueDiscGapTestCase::CheckGap, this, queue);
+      Simulator::Schedule (MilliSeconds (202), &SpCoDelQueueDisc::NotifyAllocationStarted, queue, MilliSeconds (100));
+    }
+  Simulator::Schedule (MilliSeconds (2), &SpCoDelQueueDiscGapTestCase::Enqueue, this, queue, 50);
+  // Dequeue a packet every 100 us in the second allocation
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      Simulator::Schedule (MilliSeconds (202) + MicroSeconds (100 * i), &SpCoDelQueueDiscGapTestCase::Dequeue, this, queue);
+    }
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_dequeued, 50, "All the packets should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetDropCount (), 0, "There should be no CoDel drop");
+  if (m_notify)
+    {
+      NS_TEST_EXPECT_MSG_LT (m_maxSojourn, MilliSeconds (5), "The sojourn time should exclude the time between the allocations");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (m_maxSojourn, MilliSeconds (200), "The sojourn time should include the whole wait");
+    }
+
+  Simulator::Destroy ();
+}
+
+// Test 2: standing queue during an allocation
+class SpCoDelQueueDiscStandingQueueTestCase : public TestCase
+{
+public:
+  SpCoDelQueueDiscStandingQueueTestCase ();
+  virtual void DoRun (void);
+
+private:
+  void Dequeue (Ptr<SpCoDelQueueDisc> queue);
+};
+
+SpCoDelQueueDiscStandingQueueTestCase::SpCoDelQueueDiscStandingQueueTestCase ()
+  : TestCase ("A standing queue during an allocation is controlled by CoDel")
+{
+}
+
+void
+SpCoDelQueueDiscStandingQueueTestCase::Dequeue (Ptr<SpCoDelQueueDisc> queue)
+{
+  queue->Dequeue ();
+}
+
+void
+SpCoDelQueueDiscStandingQueueTestCase::DoRun (void)
+{
+  Ptr<SpCoDelQueueDisc> queue = CreateObject<SpCoDelQueueDisc> ();
+  queue->Initialize ();
+
+  Address dest;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      queue->Enqueue (Create<SpCodelQueueDiscTestItem> (Create<Packet> (1000), dest, 0));
+    }
+
+  Simulator::Schedule (Seconds (0), &SpCoDelQueueDisc::NotifyAllocationStarted, queue, Seconds (2));
+  // The device sends a packet every 10 ms: the sojourn time stays above target
+  for (uint32_t i = 1; i <= 40; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i), &SpCoDelQueueDiscStandingQueueTestCase::Dequeue, this, queue);
+    }
+  Simulator::Schedule (MilliSeconds (405), &SpCoDelQueueDisc::NotifyAllocationEnded, queue);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAllocationTime (), MilliSeconds (405), "The allocation clock stops at the end of the allocation");
+  NS_TEST_EXPECT_MSG_GT (queue->GetDropCount (), 0, "CoDel should drop packets from the standing queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets () + queue->GetDropCount (), 60, "Unexpected number of queued packets");
+
+  Simulator::Destroy ();
+}
+
+static class SpCoDelQueueDiscTestSuite : public TestSuite
+{
+public:
+  SpCoDelQueueDiscTestSuite ()
+    : TestSuite ("sp-codel-queue-disc", UNIT)
+  {
+    AddTestCase (new SpCoDelQueueDiscGapTestCase (true), TestCase::QUICK);
+    AddTestCase (new SpCoDelQueueDiscGapTestCase (false), TestCase::QUICK);
+    AddTestCase (new SpCoDelQueueDiscStandingQueueTestCase (), TestCase::QUICK);
+  }
+} g_spCoDelQueueTestSuite;
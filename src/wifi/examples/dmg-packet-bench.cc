@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/buffer.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/ampdu-subframe-header.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+/**
+ * Microbenchmark of the header operations of a TCP segment crossing
+ * the DMG stack: the segment is a fragment of the data held by the TCP
+ * send buffer, to which the TCP, IPv4 and LLC/SNAP headers are added at
+ * the sender; a copy is kept by the MAC queue, the QoS data header, the
+ * FCS trailer and the A-MPDU subframe header are added, then the
+ * reverse operations are done at the receiver.
+ *
+ * For each reserved headroom and tailroom configuration, the number of
+ * packets processed per second and the number of Buffer data
+ * allocations and reallocations per packet are reported, e.g.:
+ * \code
+ *   ./waf --run "dmg-packet-bench --n=1000000"
+ * \endcode
+ */
+
+using namespace ns3;
+
+static void
+RunDmgStack (uint32_t n, uint32_t payloadSize)
+{
+  TcpHeader tcp;
+  tcp.SetSourcePort (49153);
+  tcp.SetDestinationPort (5001);
+  Ipv4Header ipv4;
+  ipv4.SetSource (Ipv4Address ("10.0.0.1"));
+  ipv4.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipv4.SetProtocol (6);
+  LlcSnapHeader llc;
+  llc.SetType (0x0800);
+  WifiMacHeader mac;
+  mac.SetType (WIFI_MAC_QOSDATA);
+  mac.SetAddr1 (Mac48Address ("00:00:00:00:00:02"));
+  mac.SetAddr2 (Mac48Address ("00:00:00:00:00:01"));
+  mac.SetAddr3 (Mac48Address ("00:00:00:00:00:02"));
+  mac.SetQosTid (0);
+  WifiMacTrailer fcs;
+  AmpduSubframeHeader ampdu;
+
+  std::vector<uint8_t> data (64 * payloadSize, 0x5a);
+  Ptr<Packet> sendBuffer = Create<Packet> (&data[0], data.size ());
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = sendBuffer->CreateFragment ((i % 63) * payloadSize, payloadSize);
+      p->AddHeader (tcp);
+      ipv4.SetPayloadSize (p->GetSize ());
+      p->AddHeader (ipv4);
+      p->AddHeader (llc);
+      // the copy kept by the MAC queue until the block ack
+      Ptr<Packet> mpdu = p->Copy ();
+      mpdu->AddHeader (mac);
+      mpdu->AddTrailer (fcs);
+      ampdu.SetLength (mpdu->GetSize ());
+      mpdu->AddHeader (ampdu);
+
+      Ptr<Packet> rx = mpdu->Copy ();
+      rx->RemoveHeader (ampdu);
+      rx->RemoveTrailer (fcs);
+      rx->RemoveHeader (mac);
+      rx->RemoveHeader (llc);
+      rx->RemoveHeader (ipv4);
+      rx->RemoveHeader (tcp);
+    }
+}
+
+static void
+RunBench (uint32_t n, uint32_t payloadSize, uint32_t headroom, uint32_t tailroom)
+{
+  Buffer::SetReservedSpace (headroom, tailroom);
+  // warm up the free list of the buffers
+  RunDmgStack (1000, payloadSize);
+  Buffer::ResetCounters ();
+
+  SystemWallClockMs time;
+  time.Start ();
+  RunDmgStack (n, payloadSize);
+  uint64_t deltaMs = std::max<uint64_t> (time.End (), 1);
+
+  std::cout << "headroom=" << headroom << " tailroom=" << tailroom << ": "
+            << n * 1000.0 / deltaMs << " packets/s, "
+            << static_cast<double> (Buffer::GetAllocations ()) / n << " allocations/packet, "
+            << static_cast<double> (Buffer::GetReallocations ()) / n << " reallocations/packet"
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+  uint32_t payloadSize = 1448;
+  uint32_t headroom = Buffer::GetReservedHeadroom ();
+  uint32_t tailroom = Buffer::GetReservedTailroom ();
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the packet header operations of the DMG stack");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.AddValue ("payloadSize", "TCP payload size in bytes", payloadSize);
+  cmd.AddValue ("headroom", "reserved headroom in bytes", headroom);
+  cmd.AddValue ("tailroom", "reserved tailroom in bytes", tailroom);
+  cmd.Parse (argc, argv);
+
+  RunBench (n, payloadSize, 0, 0);
+  RunBench (n, payloadSize, headroom, tailroom);
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/dmg-snr-wifi-manager.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/packet.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+/**
+ * Microbenchmark of the per-MPDU station lookups of the
+ * WifiRemoteStationManager of a DMG PCP/AP: for each MPDU, the TX vector
+ * is requested and the transmission status is reported, as done by
+ * MacLow, for a station picked among the associated stations in bursts
+ * of consecutive MPDUs to the same station and TID.
+ *
+ * For each number of associated stations, the cost of an MPDU is
+ * reported, e.g.:
+ * \code
+ *   ./waf --run "dmg-station-lookup-bench --n=1000000 --burst=1"
+ * \endcode
+ */
+
+using namespace ns3;
+
+static void
+TxOk (Mac48Address address)
+{
+}
+
+static void
+RunBench (uint32_t nStations, uint32_t nTids, uint32_t n, uint32_t burst)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ad);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<DmgSnrWifiManager> ();
+  manager->SetupPhy (phy);
+  manager->RegisterTxOkCallback (MakeCallback (&TxOk));
+  manager->Initialize ();
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+      manager->RecordGotAssocTxOk (addresses.back ());
+    }
+  std::vector<WifiMacHeader> headers (nTids);
+  for (uint32_t tid = 0; tid < nTids; tid++)
+    {
+      headers[tid].SetType (WIFI_MAC_QOSDATA);
+      headers[tid].SetQosTid (tid);
+    }
+  Ptr<Packet> packet = Create<Packet> (1400);
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t peer = (i / burst) * 7919;
+      Mac48Address address = addresses[peer % nStations];
+      const WifiMacHeader *hdr = &headers[(peer / nStations) % nTids];
+      WifiTxVector txVector = manager->GetDataTxVector (address, hdr, packet);
+      manager->NeedRts (address, hdr, packet, txVector);
+      manager->ReportDataOk (address, hdr, 100.0, txVector.GetMode (), 100.0);
+    }
+  uint64_t deltaMs = std::max<uint64_t> (time.End (), 1);
+
+  std::cout << "stations=" << nStations << " tids=" << nTids << " burst=" << burst << ": "
+            << deltaMs * 1e6 / n << " ns/MPDU" << std::endl;
+  manager->Dispose ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t nTids = 4;
+  uint32_t burst = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the per-MPDU station lookups of the WifiRemoteStationManager");
+  cmd.AddValue ("n", "number of MPDUs", n);
+  cmd.AddValue ("tids", "number of TIDs used per station", nTids);
+  cmd.AddValue ("burst", "number of consecutive MPDUs sent to the same station and TID", burst);
+  cmd.Parse (argc, argv);
+
+  RunBench (1, nTids, n, burst);
+  RunBench (10, nTids, n, burst);
+  RunBench (100, nTids, n, burst);
+  RunBench (500, nTids, n, burst);
+
+  return 0;
+}
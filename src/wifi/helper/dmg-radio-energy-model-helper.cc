@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dmg-radio-energy-model-helper.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+
+namespace ns3 {
+
+DmgRadioEnergyModelHelper::DmgRadioEnergyModelHelper ()
+{
+  m_radioEnergy.SetTypeId ("ns3::DmgRadioEnergyModel");
+  m_depletionCallback.Nullify ();
+  m_rechargedCallback.Nullify ();
+}
+
+DmgRadioEnergyModelHelper::~DmgRadioEnergyModelHelper ()
+{
+}
+
+void
+DmgRadioEnergyModelHelper::Set (std::string name, const AttributeValue &v)
+{
+  m_radioEnergy.Set (name, v);
+}
+
+void
+DmgRadioEnergyModelHelper::SetDepletionCallback (
+  WifiRadioEnergyModel::WifiRadioEnergyDepletionCallback callback)
+{
+  m_depletionCallback = callback;
+}
+
+void
+DmgRadioEnergyModelHelper::SetRechargedCallback (
+  WifiRadioEnergyModel::WifiRadioEnergyRechargedCallback callback)
+{
+  m_rechargedCallback = callback;
+}
+
+/*
+ * Private function starts here.
+ */
+
+Ptr<DeviceEnergyModel>
+DmgRadioEnergyModelHelper::DoInstall (Ptr<NetDevice> device,
+                                      Ptr<EnergySource> source) const
+{
+  NS_ASSERT (device != NULL);
+  NS_ASSERT (source != NULL);
+  // check if device is WifiNetDevice
+  std::string deviceName = device->GetInstanceTypeId ().GetName ();
+  if (deviceName.compare ("ns3::WifiNetDevice") != 0)
+    {
+      NS_FATAL_ERROR ("NetDevice type is not WifiNetDevice!");
+    }
+  Ptr<DmgRadioEnergyModel> model = m_radioEnergy.Create ()->GetObject<DmgRadioEnergyModel> ();
+  NS_ASSERT (model != NULL);
+  // set energy source pointer
+  model->SetEnergySource (source);
+  // set energy depletion callback
+  // if none is specified, make a callback to WifiPhy::SetSleepMode
+  Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+  Ptr<WifiPhy> wifiPhy = wifiDevice->GetPhy ();
+  if (m_depletionCallback.IsNull ())
+    {
+      model->SetEnergyDepletionCallback (MakeCallback (&WifiPhy::SetSleepMode, wifiPhy));
+    }
+  else
+    {
+      model->SetEnergyDepletionCallback (m_depletionCallback);
+    }
+  // set energy recharged callback
+  // if none is specified, make a callback to WifiPhy::ResumeFromSleep
+  if (m_rechargedCallback.IsNull ())
+    {
+      model->SetEnergyRechargedCallback (MakeCallback (&WifiPhy::ResumeFromSleep, wifiPhy));
+    }
+  else
+    {
+      model->SetEnergyRechargedCallback (m_rechargedCallback);
+    }
+  // add model to device model list in energy source
+  source->AppendDeviceEnergyModel (model);
+  // create and register energy model phy listener
+  wifiPhy->RegisterListener (model->GetPhyListener ());
+  // the PHY fires these traces just before it notifies its listeners of the TX and RX states
+  wifiPhy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeCallback (&DmgRadioEnergyModel::NotifyTx, model));
+  wifiPhy->TraceConnectWithoutContext ("PhyRxSync", MakeCallback (&DmgRadioEnergyModel::NotifyRxSync, model));
+  wifiPhy->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&DmgRadioEnergyModel::NotifyRxEnd, model));
+  // only the data frames addressed to the device are counted in the traffic bits
+  model->SetAddress (Mac48Address::ConvertFrom (wifiDevice->GetAddress ()));
+  return model;
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dmg-snapshot-helper.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/dmg-wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include <fstream>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgSnapshotHelper");
+
+/**
+ * \param device a device
+ * \return the DMG MAC of the device, or 0 if it is not a DMG device
+ */
+static Ptr<DmgWifiMac>
+GetDmgWifiMac (Ptr<NetDevice> device)
+{
+  Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+  if (wifiDevice == 0)
+    {
+      return 0;
+    }
+  return DynamicCast<DmgWifiMac> (wifiDevice->GetMac ());
+}
+
+DmgSnapshotHelper::DmgSnapshotHelper ()
+{
+}
+
+void
+DmgSnapshotHelper::Save (std::string filename, NetDeviceContainer devices) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ofstream os (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (os.is_open (), "Cannot open snapshot file " << filename);
+  os.precision (std::numeric_limits<double>::digits10 + 2);
+  for (NetDeviceContainer::Iterator it = devices.Begin (); it != devices.End (); it++)
+    {
+      Ptr<DmgWifiMac> mac = GetDmgWifiMac (*it);
+      if (mac != 0)
+        {
+          os << "device " << mac->GetAddress () << std::endl;
+          mac->SaveSnapshot (os);
+        }
+    }
+}
+
+void
+DmgSnapshotHelper::Restore (std::string filename, NetDeviceContainer devices) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (is.is_open (), "Cannot open snapshot file " << filename);
+  std::string key, address;
+  while (is >> key >> address)
+    {
+      NS_ABORT_MSG_UNLESS (key == "device", "Malformed snapshot " << filename << ": unexpected \"" << key << "\"");
+      Ptr<DmgWifiMac> mac;
+      for (NetDeviceContainer::Iterator it = devices.Begin (); it != devices.End () && mac == 0; it++)
+        {
+          mac = GetDmgWifiMac (*it);
+          if (mac != 0 && mac->GetAddress () != Mac48Address (address.c_str ()))
+            {
+              mac = 0;
+            }
+        }
+      NS_ABORT_MSG_IF (mac == 0, "No DMG device with address " << address << " to restore");
+      NS_LOG_DEBUG ("Restoring DMG device " << address);
+      mac->RestoreSnapshot (is);
+    }
+}
+
+} // namespace ns3
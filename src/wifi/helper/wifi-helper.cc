@@ -102,6 +102,7 @@ AsciiPhyReceiveSinkWithoutContext (
 WifiPhyHelper::WifiPhyHelper ()
   : m_pcapDlt (PcapHelper::DLT_IEEE802_11)
 {
+  m_pcapFile.SetTypeId ("ns3::PcapFileWrapper");
 }
 
 WifiPhyHelper::~WifiPhyHelper ()
@@ -162,7 +163,9 @@ WifiPhyHelper::PcapSniffTxEvent (
       }
     case PcapHelper::DLT_IEEE802_11_RADIO:
       {
-        Ptr<Packet> p = packet->Copy ();
+        //The radiotap header is written in front of the frame by the pcap
+        //file itself, so the frame does not need to be copied.
+        Ptr<const Packet> p = packet;
         RadiotapHeader header;
         uint8_t frameFlags = RadiotapHeader::FRAME_FLAG_NONE;
         header.SetTsft (Simulator::Now ().GetMicroSeconds ());
@@ -264,9 +267,9 @@ WifiPhyHelper::PcapSniffTxEvent (
             /* For PCAP file, MPDU Delimiter and Padding should be removed by the MAC Driver */
             AmpduSubframeHeader hdr;
             uint32_t extractedLength;
-            p->RemoveHeader (hdr);
+            p->PeekHeader (hdr);
             extractedLength = hdr.GetLength ();
-            p = p->CreateFragment (0, static_cast<uint32_t> (extractedLength));
+            p = p->CreateFragment (hdr.GetSerializedSize (), static_cast<uint32_t> (extractedLength));
             if (aMpdu.type == LAST_MPDU_IN_AGGREGATE || (hdr.GetEof () == true && hdr.GetLength () > 0))
               {
                 ampduStatusFlags |= RadiotapHeader::A_MPDU_STATUS_LAST;
@@ -320,8 +323,7 @@ WifiPhyHelper::PcapSniffTxEvent (
             header.SetVhtFields (vhtKnown, vhtFlags, vhtBandwidth, vhtMcsNss, vhtCoding, vhtGroupId, vhtPartialAid);
           }
 
-        p->AddHeader (header);
-        file->Write (Simulator::Now (), p);
+        file->Write (Simulator::Now (), header, p);
         return;
       }
     default:
@@ -355,7 +357,9 @@ WifiPhyHelper::PcapSniffRxEvent (
       }
     case PcapHelper::DLT_IEEE802_11_RADIO:
       {
-        Ptr<Packet> p = packet->Copy ();
+        //The radiotap header is written in front of the frame by the pcap
+        //file itself, so the frame does not need to be copied.
+        Ptr<const Packet> p = packet;
         RadiotapHeader header;
         uint8_t frameFlags = RadiotapHeader::FRAME_FLAG_NONE;
         header.SetTsft (Simulator::Now ().GetMicroSeconds ());
@@ -461,9 +465,9 @@ WifiPhyHelper::PcapSniffRxEvent (
             /* For PCAP file, MPDU Delimiter and Padding should be removed by the MAC Driver */
             AmpduSubframeHeader hdr;
             uint32_t extractedLength;
-            p->RemoveHeader (hdr);
+            p->PeekHeader (hdr);
             extractedLength = hdr.GetLength ();
-            p = p->CreateFragment (0, static_cast<uint32_t> (extractedLength));
+            p = p->CreateFragment (hdr.GetSerializedSize (), static_cast<uint32_t> (extractedLength));
             if (aMpdu.type == LAST_MPDU_IN_AGGREGATE || (hdr.GetEof () == true && hdr.GetLength () > 0))
               {
                 ampduStatusFlags |= RadiotapHeader::A_MPDU_STATUS_LAST;
@@ -517,8 +521,7 @@ WifiPhyHelper::PcapSniffRxEvent (
             header.SetVhtFields (vhtKnown, vhtFlags, vhtBandwidth, vhtMcsNss, vhtCoding, vhtGroupId, vhtPartialAid);
           }
 
-        p->AddHeader (header);
-        file->Write (Simulator::Now (), p);
+        file->Write (Simulator::Now (), header, p);
         return;
       }
     default:
@@ -551,6 +554,12 @@ WifiPhyHelper::GetPcapDataLinkType (void) const
   return m_pcapDlt;
 }
 
+void
+WifiPhyHelper::SetPcapFileAttribute (std::string name, const AttributeValue &v)
+{
+  m_pcapFile.Set (name, v);
+}
+
 void
 WifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -568,6 +577,7 @@ WifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool p
   NS_ABORT_MSG_IF (phy == 0, "WifiPhyHelper::EnablePcapInternal(): Phy layer in WifiNetDevice must be set");
 
   PcapHelper pcapHelper;
+  pcapHelper.SetFileFactory (m_pcapFile);
 
   std::string filename;
   if (explicitFilename)
@@ -138,6 +138,18 @@ public:
   PcapHelper::DataLinkType GetPcapDataLinkType (void) const;
   PcapHelper::DataLinkType m_pcapDlt;
 
+  /**
+   * \param name the name of the attribute to set
+   * \param v the value of the attribute
+   *
+   * Set an attribute of the ns3::PcapFileWrapper objects created by
+   * EnablePcap().  Use "WriteBufferSize" and "BackgroundFlush" to select
+   * the buffered pcap writer, "Compression" for gzip output and
+   * "CaptureSize" to truncate the captured frames to their headers.  This
+   * function has to be called before EnablePcap().
+   */
+  void SetPcapFileAttribute (std::string name, const AttributeValue &v);
+
 protected:
   /**
    * \param file the pcap file wrapper
@@ -184,6 +196,7 @@ protected:
     
   ObjectFactory m_phy;
   ObjectFactory m_errorRateModel;
+  ObjectFactory m_pcapFile;
     
 private:
   /**
@@ -150,7 +150,9 @@ YansWifiChannelHelper::AssignStreams (Ptr<YansWifiChannel> c, int64_t stream)
 }
 
 YansWifiPhyHelper::YansWifiPhyHelper ()
-  : m_channel (0)
+  : m_channel (0),
+    m_enableAntenna (false),
+    m_directionalAntenna (false)
 {
   m_phy.SetTypeId ("ns3::YansWifiPhy");
 }
@@ -222,6 +224,7 @@ YansWifiPhyHelper::EnableMultiBandPcap (std::string prefix, Ptr<NetDevice> nd, P
   NS_ABORT_MSG_IF (phy == 0, "YansWifiPhyHelper::EnablePcapInternal(): Phy layer in MultiBandNetDevice must be set");
 
   PcapHelper pcapHelper;
+  pcapHelper.SetFileFactory (m_pcapFile);
 
   std::string filename;
   filename = pcapHelper.GetFilenameFromDevice (prefix, device);
@@ -243,6 +243,49 @@ BlockAckManager::UpdateAgreement (const MgtAddBaResponseHeader *respHdr, Mac48Ad
   m_unblockPackets (recipient, tid);
 }
 
+std::list<OriginatorBlockAckAgreement>
+BlockAckManager::GetEstablishedAgreements (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::list<OriginatorBlockAckAgreement> agreements;
+  for (AgreementsCI it = m_agreements.begin (); it != m_agreements.end (); it++)
+    {
+      if (it->second.first.IsEstablished ())
+        {
+          agreements.push_back (it->second.first);
+        }
+    }
+  return agreements;
+}
+
+void
+BlockAckManager::RestoreAgreement (const OriginatorBlockAckAgreement &agreement)
+{
+  NS_LOG_FUNCTION (this << agreement.GetPeer () << static_cast<uint32_t> (agreement.GetTid ()));
+  MgtAddBaRequestHeader reqHdr;
+  MgtAddBaResponseHeader respHdr;
+  reqHdr.SetTid (agreement.GetTid ());
+  reqHdr.SetStartingSequence (agreement.GetStartingSequence ());
+  reqHdr.SetTimeout (agreement.GetTimeout ());
+  reqHdr.SetAmsduSupport (agreement.IsAmsduSupported ());
+  respHdr.SetTid (agreement.GetTid ());
+  respHdr.SetBufferSize (agreement.GetBufferSize () - 1);
+  respHdr.SetTimeout (agreement.GetTimeout ());
+  respHdr.SetAmsduSupport (agreement.IsAmsduSupported ());
+  if (agreement.IsImmediateBlockAck ())
+    {
+      reqHdr.SetImmediateBlockAck ();
+      respHdr.SetImmediateBlockAck ();
+    }
+  else
+    {
+      reqHdr.SetDelayedBlockAck ();
+      respHdr.SetDelayedBlockAck ();
+    }
+  CreateAgreement (&reqHdr, agreement.GetPeer ());
+  UpdateAgreement (&respHdr, agreement.GetPeer ());
+}
+
 void
 BlockAckManager::StorePacket (Ptr<const Packet> packet, const WifiMacHeader &hdr, Time tStamp)
 {
@@ -141,6 +141,17 @@ public:
    * Invoked upon receipt of a ADDBA response frame from <i>recipient</i>.
    */
   void UpdateAgreement (const MgtAddBaResponseHeader *respHdr, Mac48Address recipient);
+  /**
+   * \return the block ack agreements established with any recipient.
+   */
+  std::list<OriginatorBlockAckAgreement> GetEstablishedAgreements (void) const;
+  /**
+   * \param agreement the agreement to establish.
+   *
+   * Establishes a block ack agreement with the peer of <i>agreement</i> without
+   * the exchange of ADDBA frames, e.g. to restore the state of a previous simulation.
+   */
+  void RestoreAgreement (const OriginatorBlockAckAgreement &agreement);
   /**
    * \param packet Packet to store.
    * \param hdr 802.11 header for packet.
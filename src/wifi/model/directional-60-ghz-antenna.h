@@ -27,6 +27,8 @@ public:
   /* Virtual Functions */
   double GetTxGainDbi (double angle) const;
   double GetRxGainDbi (double angle) const;
+  using DirectionalAntenna::GetTxGainDbi;
+  using DirectionalAntenna::GetRxGainDbi;
 
   virtual bool IsPeerNodeInTheCurrentSector (double angle) const;
 
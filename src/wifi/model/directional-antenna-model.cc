@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "directional-antenna-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DirectionalAntennaModel");
+
+NS_OBJECT_ENSURE_REGISTERED (DirectionalAntennaModel);
+
+TypeId
+DirectionalAntennaModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DirectionalAntennaModel")
+    .SetParent<AntennaModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<DirectionalAntennaModel> ()
+  ;
+  return tid;
+}
+
+DirectionalAntennaModel::DirectionalAntennaModel ()
+  : m_transmit (true)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DirectionalAntennaModel::~DirectionalAntennaModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+DirectionalAntennaModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_antenna = 0;
+  AntennaModel::DoDispose ();
+}
+
+void
+DirectionalAntennaModel::SetDirectionalAntenna (Ptr<DirectionalAntenna> antenna, bool transmit)
+{
+  NS_LOG_FUNCTION (this << antenna << transmit);
+  m_antenna = antenna;
+  m_transmit = transmit;
+}
+
+Ptr<DirectionalAntenna>
+DirectionalAntennaModel::GetDirectionalAntenna (void) const
+{
+  return m_antenna;
+}
+
+double
+DirectionalAntennaModel::GetGainDb (Angles a)
+{
+  NS_LOG_FUNCTION (this << a);
+  // theta is the inclination from the z axis
+  double elevation = M_PI / 2 - a.theta;
+  if (m_transmit)
+    {
+      return m_antenna->GetTxGainDbi (a.phi, elevation);
+    }
+  return m_antenna->GetRxGainDbi (a.phi, elevation);
+}
+
+} //namespace ns3
@@ -9,6 +9,7 @@
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
 #include "directional-antenna.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -32,10 +33,106 @@ DirectionalAntenna::GetTypeId (void)
                    MakeUintegerAccessor (&DirectionalAntenna::SetNumberOfSectors,
                                          &DirectionalAntenna::GetNumberOfSectors),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("ElevationBeamWidth",
+                   "The half-power beam width (radians) of the elevation pattern of the sectors,"
+                   " or 0 if the gain does not depend on the elevation.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&DirectionalAntenna::SetElevationBeamWidth),
+                   MakeDoubleChecker<double> (0, M_PI))
+    .AddAttribute ("Tilt",
+                   "The elevation (radians) towards which the sectors are steered,"
+                   " e.g. negative for a ceiling-mounted antenna.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&DirectionalAntenna::SetTilt),
+                   MakeDoubleChecker<double> (-M_PI / 2, M_PI / 2))
+    .AddAttribute ("ElevationSideLobeAttenuation",
+                   "The maximum attenuation (dB) of the elevation pattern.",
+                   DoubleValue (20),
+                   MakeDoubleAccessor (&DirectionalAntenna::SetElevationSideLobeAttenuation),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
 
+DirectionalAntenna::DirectionalAntenna ()
+  : m_elevationBeamWidth (0),
+    m_tilt (0),
+    m_elevationSideLobeAttenuation (20)
+{
+}
+
+void
+DirectionalAntenna::SetElevationBeamWidth (double beamWidth)
+{
+  m_elevationBeamWidth = beamWidth;
+  UpdateElevationGains ();
+}
+
+void
+DirectionalAntenna::SetTilt (double tilt)
+{
+  m_tilt = tilt;
+  UpdateElevationGains ();
+}
+
+void
+DirectionalAntenna::SetElevationSideLobeAttenuation (double attenuation)
+{
+  m_elevationSideLobeAttenuation = attenuation;
+  UpdateElevationGains ();
+}
+
+void
+DirectionalAntenna::UpdateElevationGains (void)
+{
+  m_elevationGains.clear ();
+  if (m_elevationBeamWidth == 0)
+    {
+      return;
+    }
+  /* Parabolic pattern of 3GPP TR 38.901 Table 7.3-1, sampled every degree */
+  for (int32_t degree = -90; degree <= 90; degree++)
+    {
+      double offset = (degree * M_PI / 180 - m_tilt) / m_elevationBeamWidth;
+      m_elevationGains.push_back (-std::min (12 * offset * offset, m_elevationSideLobeAttenuation));
+    }
+}
+
+double
+DirectionalAntenna::GetElevationGainDbi (double elevation) const
+{
+  if (m_elevationGains.empty ())
+    {
+      return 0;
+    }
+  double position = std::max (0.0, std::min (180.0, elevation * 180 / M_PI + 90));
+  uint32_t index = std::min (static_cast<uint32_t> (position), 179u);
+  double fraction = position - index;
+  return m_elevationGains[index] + fraction * (m_elevationGains[index + 1] - m_elevationGains[index]);
+}
+
+double
+DirectionalAntenna::GetTxGainDbi (double azimuth, double elevation) const
+{
+  return GetTxGainDbi (azimuth) + GetElevationGainDbi (elevation);
+}
+
+double
+DirectionalAntenna::GetSectorTxGainDbi (double azimuth, double elevation, uint8_t sectorId, uint8_t antennaId) const
+{
+  return GetGainDbi (azimuth, sectorId, antennaId) + GetElevationGainDbi (elevation);
+}
+
+double
+DirectionalAntenna::GetRxGainDbi (double azimuth, double elevation) const
+{
+  if (m_omniAntenna)
+    {
+      return GetRxGainDbi (azimuth);
+    }
+  return GetRxGainDbi (azimuth) + GetElevationGainDbi (elevation);
+}
+
 void
 DirectionalAntenna::SetNumberOfAntennas (uint8_t antennas)
 {
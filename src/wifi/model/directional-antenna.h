@@ -10,6 +10,7 @@
 #include "ns3/object.h"
 #include <stdlib.h>
 #include <cmath>
+#include <vector>
 
 namespace ns3 {
 
@@ -19,6 +20,7 @@ namespace ns3 {
 class DirectionalAntenna : public Object {
 public:
   static TypeId GetTypeId (void);
+  DirectionalAntenna ();
   /**
    * Set number of sectors supported by the station.
    * \param sectors Number of sectors.
@@ -124,6 +126,41 @@ public:
    * \return the antenna gain at the specified angle.
    */
   virtual double GetRxGainDbi (double angle) const = 0;
+  /**
+   * Obtain the transmit antenna gain towards the specified direction,
+   * i.e. the gain of the current Tx sector at the azimuth plus the gain
+   * of the elevation pattern.
+   * \param azimuth The azimuth of the receiver seen from the transmitter.
+   * \param elevation The elevation of the receiver seen from the transmitter.
+   * \return the antenna gain towards the specified direction.
+   */
+  double GetTxGainDbi (double azimuth, double elevation) const;
+  /**
+   * Obtain the receive antenna gain towards the specified direction,
+   * i.e. the gain of the current Rx sector at the azimuth plus the gain
+   * of the elevation pattern, unless the antenna receives in omni mode.
+   * \param azimuth The azimuth of the transmitter seen from the receiver.
+   * \param elevation The elevation of the transmitter seen from the receiver.
+   * \return the antenna gain towards the specified direction.
+   */
+  double GetRxGainDbi (double azimuth, double elevation) const;
+  /**
+   * Obtain the gain of the elevation pattern, relative to the gain in the
+   * direction of the tilt, interpolated from the elevation gain table.
+   * \param elevation The elevation.
+   * \return the relative gain at the specified elevation.
+   */
+  double GetElevationGainDbi (double elevation) const;
+  /**
+   * Obtain the transmit antenna gain of a given sector towards the specified
+   * direction, regardless of the current Tx sector.
+   * \param azimuth The azimuth of the receiver seen from the transmitter.
+   * \param elevation The elevation of the receiver seen from the transmitter.
+   * \param sectorId The ID of the sector.
+   * \param antennaId The ID of the antenna.
+   * \return the antenna gain of the sector towards the specified direction.
+   */
+  double GetSectorTxGainDbi (double azimuth, double elevation, uint8_t sectorId, uint8_t antennaId) const;
 
   virtual bool IsPeerNodeInTheCurrentSector (double angle) const = 0;
 
@@ -147,6 +184,29 @@ protected:
   uint8_t m_antennas;                 /* Number of antennas. */
   uint8_t m_sectors;                  /* Number of sectors per antenna. */
 
+private:
+  /**
+   * Fill the elevation gain table from the elevation pattern attributes.
+   */
+  void UpdateElevationGains (void);
+  /**
+   * \param beamWidth The half-power beam width of the elevation pattern.
+   */
+  void SetElevationBeamWidth (double beamWidth);
+  /**
+   * \param tilt The elevation towards which the sectors are steered.
+   */
+  void SetTilt (double tilt);
+  /**
+   * \param attenuation The maximum attenuation (dB) of the elevation pattern.
+   */
+  void SetElevationSideLobeAttenuation (double attenuation);
+
+  double m_elevationBeamWidth;        /* Half-power beam width of the elevation pattern (0 for none). */
+  double m_tilt;                      /* Elevation towards which the sectors are steered. */
+  double m_elevationSideLobeAttenuation; /* Maximum attenuation (dB) of the elevation pattern. */
+  std::vector<double> m_elevationGains;  /* Elevation gains (dB) per degree from -90 to 90 degrees. */
+
 };
 
 } // namespace ns3
@@ -18,7 +18,11 @@
 #include "mac-rx-middle.h"
 #include "mac-tx-middle.h"
 #include "msdu-aggregator.h"
+#include "dmg-sta-wifi-mac.h"
+#include "yans-wifi-channel.h"
+#include "yans-wifi-phy.h"
 #include "wifi-phy.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -73,6 +77,14 @@ DmgApWifiMac::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&DmgApWifiMac::m_isResponderTXSS),
                    MakeBooleanChecker ())
+    .AddAttribute ("AbftFastForward",
+                   "Resolve the slot selection, the collisions and the retries of the DMG STAs in each"
+                   " A-BFT analytically instead of simulating every SSW frame. The A-BFT keeps its duration"
+                   " and the SNR tables are filled as if the SSW frames were received. Only used when the"
+                   " A-BFT is TxSS and with a YansWifiChannel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DmgApWifiMac::m_abftFastForward),
+                   MakeBooleanChecker ())
     .AddAttribute ("ATIPresent", "The BI period contains ATI access period.",
                    BooleanValue (true),
                    MakeBooleanAccessor (&DmgApWifiMac::m_atiPresent),
@@ -94,6 +106,9 @@ DmgApWifiMac::GetTypeId (void)
       .AddTraceSource ("DTIStarted", "The Data Transmission Interval access period started.",
                        MakeTraceSourceAccessor (&DmgApWifiMac::m_dtiStarted),
                        "ns3::DmgApWifiMac::DtiStartedTracedCallback")
+      .AddTraceSource ("AbftResolved", "An A-BFT was resolved analytically.",
+                       MakeTraceSourceAccessor (&DmgApWifiMac::m_abftResolved),
+                       "ns3::DmgApWifiMac::AbftResolvedCallback")
   ;
   return tid;
 }
@@ -114,9 +129,9 @@ DmgApWifiMac::DmgApWifiMac ()
 
   /* Constant Values */
   m_receivedOneSSW = false;
+  m_abftFastForward = false;
   m_aidCounter = 0;
   m_btiPeriodicity = 0;
-  m_nextAbft = m_abftPeriodicity;
 
   // Let the lower layers know that we are acting as an AP.
   SetTypeOfStation (DMG_AP);
@@ -133,6 +148,7 @@ DmgApWifiMac::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_beaconDca = 0;
   m_beaconEvent.Cancel ();
+  m_abftResponders.clear ();
   DmgWifiMac::DoDispose ();
 }
 
@@ -453,7 +469,7 @@ DmgApWifiMac::AddAllocationPeriod (AllocationID allocationID,
                                    uint32_t allocationStart, uint16_t blockDuration)
 {
   NS_LOG_FUNCTION (this << allocationID << allocationType << staticAllocation << sourceAid << destAid);
-std::cout << "sally test dmgapmac -> AddAllocationPeriod, allocationID=" << allocationID << ", allocationType=" << allocationType << ", staticAllocation=" << staticAllocation << ", sourceAid=" << (uint8_t) sourceAid << ", destAid=" << (uint8_t) destAid << ", allocationStart=" << allocationStart << ", blockDuration=" << blockDuration << std::endl;
+std::cout << "sally test dmgapmac -> AddAllocationPeriod, allocationID=" << allocationID << ", allocationType=" << allocationType << ", staticAllocation=" << staticAllocation << ", sourceAid=" << uint32_t (sourceAid) << ", destAid=" << uint32_t (destAid) << ", allocationStart=" << allocationStart << ", blockDuration=" << blockDuration << std::endl;
   AllocationField field;
   /* Allocation Control Field */
   field.SetAllocationID (allocationID);
@@ -479,7 +495,7 @@ DmgApWifiMac::AllocateBeamformingServicePeriod (uint8_t sourceAid, uint8_t destA
                                                 uint32_t allocationStart, bool isTxss)
 {
   NS_LOG_FUNCTION (this << sourceAid << destAid << allocationStart << isTxss);
-std::cout << "sally test dmgapmac -> AllocateBeamformingServicePeriod, sourceAid=" << (uint8_t) sourceAid << ", destAid=" << (uint8_t) destAid << ", allocationStart=" << allocationStart << ", isTxss=" << isTxss << std::endl;
+std::cout << "sally test dmgapmac -> AllocateBeamformingServicePeriod, sourceAid=" << uint32_t (sourceAid) << ", destAid=" << uint32_t (destAid) << ", allocationStart=" << allocationStart << ", isTxss=" << isTxss << std::endl;
   AllocationField field;
   /* Allocation Control Field */
   field.SetAllocationType (SERVICE_PERIOD_ALLOCATION);
@@ -507,7 +523,7 @@ void
 DmgApWifiMac::SendOneDMGBeacon (uint8_t sectorID, uint8_t antennaID, uint16_t count)
 {
   NS_LOG_FUNCTION (this);
-std::cout << "sally test dmgapmac -> SendOneDMGBeacon, sectorID=" << sectorID << ", antennaID=" << antennaID << ", count=" << count << std::endl;
+std::cout << "sally test dmgapmac -> SendOneDMGBeacon, sectorID=" << uint32_t (sectorID) << ", antennaID=" << uint32_t (antennaID) << ", count=" << count << std::endl;
   WifiMacHeader hdr;
   hdr.SetDMGBeacon ();                /* Set frame type to DMG beacon i.e. Change Frame Control Format. */
   hdr.SetAddr1 (GetBssid ());         /* BSSID */
@@ -786,11 +802,198 @@ std::cout << "sally test dmgapmac -> StartAssociationBeamformTraining" << std::e
       Simulator::Schedule (m_abftDuration + m_mbifs, &DmgApWifiMac::StartDataTransmissionInterval, this);
     }
 
+  if (GetAbftFastForward ())
+    {
+      /* The DMG STAs register at the start of the A-BFT, resolve it once the first slot is over */
+      Simulator::Schedule (m_low->GetSectorSweepSlotTime (m_ssFramesPerSlot), &DmgApWifiMac::ResolveAbft, this);
+      return;
+    }
+
   /* Schedule the beginning of the first A-BFT Slot */
   m_remainingSlots = m_ssSlotsPerABFT;
   Simulator::ScheduleNow (&DmgApWifiMac::StartSectorSweepSlot, this);
 }
 
+bool
+DmgApWifiMac::GetAbftFastForward (void) const
+{
+  return m_abftFastForward && m_isResponderTXSS;
+}
+
+void
+DmgApWifiMac::AddAbftResponder (Ptr<DmgStaWifiMac> station)
+{
+  NS_LOG_FUNCTION (this << station->GetAddress ());
+  m_abftResponders.push_back (station);
+}
+
+void
+DmgApWifiMac::SaveSnapshot (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  DmgWifiMac::SaveSnapshot (os);
+  std::vector<Mac48Address> stations;
+  for (MAC_MAP::const_iterator it = m_macMap.begin (); it != m_macMap.end (); it++)
+    {
+      if (m_stationManager->IsAssociated (it->first))
+        {
+          stations.push_back (it->first);
+        }
+    }
+  os << "ap " << m_aidCounter << " " << stations.size () << std::endl;
+  for (std::vector<Mac48Address>::const_iterator it = stations.begin (); it != stations.end (); it++)
+    {
+      STATION_BRP_MAP::const_iterator brp = m_stationBrpMap.find (*it);
+      os << *it << " " << (brp != m_stationBrpMap.end () && brp->second) << std::endl;
+    }
+
+  /* The information elements of the association requests */
+  std::vector<std::pair<Mac48Address, StationInformation> > information;
+  for (AssociatedStationsInfoByAddress::const_iterator it = m_associatedStationsInfoByAddress.begin ();
+       it != m_associatedStationsInfoByAddress.end (); it++)
+    {
+      WifiInformationElementMap::const_iterator capabilities = it->second.find (IE_DMG_CAPABILITIES);
+      if (capabilities != it->second.end () && capabilities->second != 0)
+        {
+          information.push_back (std::make_pair (it->first, std::make_pair (StaticCast<DmgCapabilities> (capabilities->second),
+                                                                            it->second)));
+        }
+    }
+  os << "stations " << information.size () << std::endl;
+  for (std::vector<std::pair<Mac48Address, StationInformation> >::const_iterator it = information.begin ();
+       it != information.end (); it++)
+    {
+      WriteSnapshotInformation (os, it->first, it->second);
+    }
+}
+
+void
+DmgApWifiMac::RestoreSnapshot (std::istream &is)
+{
+  NS_LOG_FUNCTION (this);
+  DmgWifiMac::RestoreSnapshot (is);
+  uint32_t n;
+  ReadSnapshotKey (is, "ap");
+  is >> m_aidCounter >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Mac48Address address = ReadSnapshotAddress (is);
+      bool brp;
+      is >> brp;
+      m_stationManager->RecordWaitAssocTxOk (address);
+      m_stationManager->RecordGotAssocTxOk (address);
+      m_stationBrpMap[address] = brp;
+    }
+
+  ReadSnapshotKey (is, "stations");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Mac48Address address;
+      WifiInformationElementMap infoMap = ReadSnapshotInformation (is, address).second;
+      MAC_MAP::const_iterator aid = m_macMap.find (address);
+      NS_ABORT_MSG_IF (aid == m_macMap.end (), "Malformed snapshot: no AID for " << address);
+      m_associatedStationsInfoByAddress[address] = infoMap;
+      m_associatedStationsInfoByAid[aid->second] = infoMap;
+
+      /* Check if the DMG STA supports RDS, as on its association */
+      Ptr<RelayCapabilitiesElement> relayElement = DynamicCast<RelayCapabilitiesElement> (infoMap[IE_RELAY_CAPABILITIES]);
+      if (relayElement != 0 && relayElement->GetRelayCapabilitiesInfo ().GetRelaySupportability ())
+        {
+          m_rdsList[aid->second] = relayElement->GetRelayCapabilitiesInfo ();
+        }
+    }
+}
+
+void
+DmgApWifiMac::ResolveAbft (void)
+{
+  NS_LOG_FUNCTION (this << m_abftResponders.size ());
+  Ptr<YansWifiPhy> phy = DynamicCast<YansWifiPhy> (m_phy);
+  NS_ABORT_MSG_IF (phy == 0, "The A-BFT can only be resolved analytically with a YansWifiPhy");
+  Ptr<YansWifiChannel> channel = DynamicCast<YansWifiChannel> (phy->GetChannel ());
+  Time slotTime = m_low->GetSectorSweepSlotTime (m_ssFramesPerSlot);
+  double noiseW = m_phy->GetNoiseFloorW ();
+
+  /* The DMG STAs drawing each slot */
+  std::vector<std::vector<Ptr<DmgStaWifiMac> > > slots (m_ssSlotsPerABFT);
+  for (std::vector<Ptr<DmgStaWifiMac> >::const_iterator it = m_abftResponders.begin (); it != m_abftResponders.end (); it++)
+    {
+      slots[(*it)->SelectAbftSlot ()].push_back (*it);
+    }
+  m_abftResponders.clear ();
+
+  uint32_t trained = 0;
+  uint32_t collisions = 0;
+  uint8_t usedSlots = 0;
+  for (uint8_t slot = 0; slot < m_ssSlotsPerABFT; slot++)
+    {
+      if (slots[slot].empty ())
+        {
+          continue;
+        }
+      usedSlots++;
+      if (slots[slot].size () > 1)
+        {
+          /* The SSW frames collide, none of the DMG STAs gets an SSW-FBCK frame */
+          collisions += slots[slot].size ();
+          for (std::vector<Ptr<DmgStaWifiMac> >::const_iterator it = slots[slot].begin (); it != slots[slot].end (); it++)
+            {
+              if ((*it)->ReportAbftCollision ())
+                {
+                  uint8_t next = (*it)->SelectAbftSlot ();
+                  NS_ASSERT ((next > slot) && (next < m_ssSlotsPerABFT));
+                  slots[next].push_back (*it);
+                }
+            }
+          continue;
+        }
+
+      /* The DMG STA sweeps its first sectors, each SSW frame feeding back our best sector */
+      Ptr<DmgStaWifiMac> station = slots[slot].front ();
+      Mac48Address address = station->GetAddress ();
+      ANTENNA_CONFIGURATION_TX antennaConfigTx = station->GetAbftFeedback ();
+      Ptr<YansWifiPhy> stationPhy = StaticCast<YansWifiPhy> (station->GetWifiPhy ());
+      Ptr<DirectionalAntenna> antenna = stationPhy->GetDirectionalAntenna ();
+      uint16_t frames = std::min<uint16_t> (antenna->GetNumberOfSectors () * antenna->GetNumberOfAntennas (),
+                                            m_ssFramesPerSlot);
+      double txPowerDbm = stationPhy->GetTxPowerStart () + stationPhy->GetTxGain ();
+      for (uint16_t i = 0; i < frames; i++)
+        {
+          SECTOR_ID sectorId = i % antenna->GetNumberOfSectors () + 1;
+          ANTENNA_ID antennaId = i / antenna->GetNumberOfSectors () + 1;
+          double rxPowerDbm = channel->GetSectorRxPowerDbm (stationPhy, phy, txPowerDbm, sectorId, antennaId)
+            + phy->GetRxGain ();
+          MapTxSnr (address, sectorId, antennaId, std::pow (10.0, (rxPowerDbm - 30) / 10.0) / noiseW);
+        }
+      ANTENNA_CONFIGURATION_RX antennaConfigRx = std::make_pair (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG);
+      m_bestAntennaConfig[address] = std::make_pair (antennaConfigTx, antennaConfigRx);
+      m_sectorFeedbackSent[address] = true;
+
+      /* Indicate this DMG-STA as waiting for Beam Refinement Phase */
+      m_stationBrpMap[address] = true;
+      trained++;
+      Simulator::Schedule (slot * slotTime, &DmgApWifiMac::CompleteAbftResponder, this, station);
+    }
+  NS_LOG_DEBUG ("A-BFT resolved: trained=" << trained << ", collisions=" << collisions
+                << ", slots=" << uint32_t (usedSlots));
+  m_abftResolved (GetAddress (), trained, collisions, usedSlots);
+}
+
+void
+DmgApWifiMac::CompleteAbftResponder (Ptr<DmgStaWifiMac> station)
+{
+  NS_LOG_FUNCTION (this << station->GetAddress ());
+  Mac48Address address = station->GetAddress ();
+  /* Obtain antenna configuration for the highest received SNR from DMG STA to feed it back */
+  m_feedbackAntennaConfig = GetBestAntennaConfiguration (address, true);
+  station->ReceiveAbftFeedback (GetAddress (), m_feedbackAntennaConfig);
+
+  /* Raise an event that we selected the best sector to the DMG STA */
+  ANTENNA_CONFIGURATION antennaConfig = m_bestAntennaConfig[address].first;
+  m_slsCompleted (address, CHANNEL_ACCESS_BHI, antennaConfig.first, antennaConfig.second);
+}
+
 void
 DmgApWifiMac::StartSectorSweepSlot (void)
 {
@@ -902,7 +1105,7 @@ std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, spStart=" <<
                 {
                   uint8_t destAid = field.GetDestinationAid ();
                   Mac48Address destAddress = m_aidMap[destAid];
-std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, case1, destAid=" << destAid << ", destAddress=" << destAddress << std::endl;
+std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, case1, destAid=" << uint32_t (destAid) << ", destAddress=" << destAddress << std::endl;
                   Simulator::Schedule (spStart, &DmgApWifiMac::StartServicePeriod,
                                        this, field.GetAllocationID (), servicePeriodLength, destAid, destAddress, true);
                   Simulator::Schedule (spStart + servicePeriodLength, &DmgApWifiMac::EndServicePeriod, this);
@@ -924,7 +1127,7 @@ std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, case2, No tr
                    * transmissions from the source DMG STA. */
                   uint8_t sourceAid = field.GetSourceAid ();
                   Mac48Address sourceAddress = m_aidMap[sourceAid];
-std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, case3, sourceAid=" << sourceAid << ", sourceAddress=" << sourceAddress << std::endl;
+std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, case3, sourceAid=" << uint32_t (sourceAid) << ", sourceAddress=" << sourceAddress << std::endl;
                   Simulator::Schedule (spStart, &DmgApWifiMac::StartServicePeriod, this,
                                        field.GetAllocationID (), servicePeriodLength, sourceAid, sourceAddress, true);
                 }
@@ -933,7 +1136,7 @@ std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, case3, sourc
                   ((field.GetSourceAid () == AID_BROADCAST) || (field.GetSourceAid () == AID_AP) || (field.GetDestinationAid () == AID_AP)))
 
             {
-std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, AllocationType=" << field.GetAllocationType () << ", SourceAid=" << field.GetSourceAid () << ", DestinationAid=" << field.GetDestinationAid () << std::endl;
+std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, AllocationType=" << field.GetAllocationType () << ", SourceAid=" << uint32_t (field.GetSourceAid ()) << ", DestinationAid=" << uint32_t (field.GetDestinationAid ()) << std::endl;
               Time cbapEnd = MicroSeconds (field.GetAllocationStart ()) + MicroSeconds (field.GetAllocationBlockDuration ());
               /* Schedule two events for the beginning of the relay mode */
 std::cout << "sally test dmgapmac -> StartDataTransmissionInterval, cbapEnd=" << cbapEnd << std::endl;
@@ -1119,7 +1322,7 @@ std::cout << "sally test dmgapmac -> Receive, case13, !m_receivedOneSSW" << std:
           CtrlDMG_SSW sswFrame;
           packet->RemoveHeader (sswFrame);
           DMG_SSW_Field ssw = sswFrame.GetSswField ();
-std::cout << "sally test dmgapmac -> Receive, case14, " << "next MapTxSnr, from=" << from << ", sectorID=" << ssw.GetSectorID () << ", antennaID=" << ssw.GetDMGAntennaID () << ", rxSnr=" << m_stationManager->GetRxSnr () << std::endl;
+std::cout << "sally test dmgapmac -> Receive, case14, " << "next MapTxSnr, from=" << from << ", sectorID=" << uint32_t (ssw.GetSectorID ()) << ", antennaID=" << uint32_t (ssw.GetDMGAntennaID ()) << ", rxSnr=" << m_stationManager->GetRxSnr () << std::endl;
           /* Map the antenna Tx configuration for the frame received by SLS of the DMG-STA */
           MapTxSnr (from, ssw.GetSectorID (), ssw.GetDMGAntennaID (), m_stationManager->GetRxSnr ());
 
@@ -1365,6 +1568,7 @@ std::cout << "sally test dmgapmac -> DoInitialize" << std::endl;
   /* Calculate A-BFT Duration (Constant during the entire simulation) */
   m_abftDuration = NanoSeconds (m_ssSlotsPerABFT * m_low->GetSectorSweepSlotTime (m_ssFramesPerSlot));
   m_abftDuration = MicroSeconds (ceil ((double) m_abftDuration.GetNanoSeconds () / 1000));
+  m_nextAbft = m_abftPeriodicity;
 
   /* Generate Antenna Configuration Table */
   m_antennaConfigurationOffset = 0;
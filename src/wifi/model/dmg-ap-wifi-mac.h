@@ -21,6 +21,8 @@ namespace ns3 {
 #define aSSFramesPerSlot        8               /* Number of SSW Frames per Sector Sweep Slot */
 #define aDMGPPMinListeningTime  150             /* The minimum time between two adjacent SPs with the same source or destination AIDs*/
 
+class DmgStaWifiMac;
+
 /**
  * \brief Wi-Fi DMG AP state machine
  * \ingroup wifi
@@ -119,6 +121,27 @@ public:
    */
   uint32_t AllocateBeamformingServicePeriod (uint8_t sourceAid, uint8_t destAid,
                                              uint32_t allocationStart, bool isTxss);
+  /**
+   * \return Whether the A-BFT is resolved analytically instead of simulating its SSW frames.
+   */
+  bool GetAbftFastForward (void) const;
+  /**
+   * Register a DMG STA starting RSS in the current A-BFT, when the A-BFT
+   * is resolved analytically.
+   * \param station The DMG STA.
+   */
+  void AddAbftResponder (Ptr<DmgStaWifiMac> station);
+  /**
+   * Write the state of the DMG AP, including its associated DMG STAs and
+   * the information elements of their association requests.
+   * \param os The output stream.
+   */
+  virtual void SaveSnapshot (std::ostream &os) const;
+  /**
+   * Restore the state written by SaveSnapshot.
+   * \param is The input stream.
+   */
+  virtual void RestoreSnapshot (std::istream &is);
 
 protected:
   friend class DmgBeaconDca;
@@ -175,6 +198,19 @@ private:
    * Start A-BFT Sector Sweep Slot.
    */
   void StartSectorSweepSlot (void);
+  /**
+   * Resolve the slot selection, the collisions and the retries of the
+   * DMG STAs in the current A-BFT, fill the SNR table from the SSW frames
+   * the winners would send, and schedule the completion of their RSS at
+   * the end of their slots.
+   */
+  void ResolveAbft (void);
+  /**
+   * Complete the RSS of a DMG STA in an A-BFT resolved analytically, as
+   * upon the transmission of the SSW-FBCK frame.
+   * \param station The DMG STA.
+   */
+  void CompleteAbftResponder (Ptr<DmgStaWifiMac> station);
   /**
    * Establish BRP Setup Subphase
    */
@@ -268,6 +304,8 @@ private:
   Mac48Address m_peerAbftStation;       //!< The MAC address of the station we received SSW from.
   uint8_t m_remainingSlots;
   Time m_atiStartTime;                  //!< The start time of ATI Period.
+  bool m_abftFastForward;               //!< Flag to indicate if the A-BFT is resolved analytically.
+  std::vector<Ptr<DmgStaWifiMac> > m_abftResponders; //!< The DMG STAs starting RSS in the current A-BFT.
 
   /** BRP Phase Variables **/
   typedef std::map<Mac48Address, bool> STATION_BRP_MAP;
@@ -288,9 +326,19 @@ private:
    * \param duration The duration of the DTI period.
    */
   typedef void (* DtiStartedCallback)(Mac48Address address, Time duration);
+  /**
+   * TracedCallback signature for the outcome of an A-BFT resolved analytically.
+   *
+   * \param address The MAC address of the DMG AP.
+   * \param trained The number of DMG STAs which completed RSS.
+   * \param collisions The number of RSS attempts lost in collisions.
+   * \param slots The number of slots in which at least one DMG STA attempted RSS.
+   */
+  typedef void (* AbftResolvedCallback)(Mac48Address address, uint32_t trained, uint32_t collisions, uint8_t slots);
 
   TracedCallback<Mac48Address> m_biStarted;         //!< New BI Started has started.
   TracedCallback<Mac48Address, Time> m_dtiStarted;  //!< DTI Started has started.
+  TracedCallback<Mac48Address, uint32_t, uint32_t, uint8_t> m_abftResolved;  //!< A-BFT resolved analytically.
 
 };
 
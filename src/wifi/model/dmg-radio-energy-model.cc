@@ -0,0 +1,473 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/energy-source.h"
+#include "ampdu-subframe-header.h"
+#include "ampdu-tag.h"
+#include "dmg-radio-energy-model.h"
+#include "wifi-mac-header.h"
+#include "wifi-mac-trailer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgRadioEnergyModel");
+
+NS_OBJECT_ENSURE_REGISTERED (DmgRadioEnergyModel);
+
+TypeId
+DmgRadioEnergyModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DmgRadioEnergyModel")
+    .SetParent<DeviceEnergyModel> ()
+    .SetGroupName ("Energy")
+    .AddConstructor<DmgRadioEnergyModel> ()
+    .AddAttribute ("IdleCurrentA",
+                   "The radio Idle current in Ampere.",
+                   DoubleValue (0.35),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_idleCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("CcaBusyCurrentA",
+                   "The radio CCA Busy State current in Ampere.",
+                   DoubleValue (0.35),  // default to be the same as idle mode
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_ccaBusyCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("SwitchingCurrentA",
+                   "The radio Channel Switch current in Ampere.",
+                   DoubleValue (0.35),  // default to be the same as idle mode
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_switchingCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("SleepCurrentA",
+                   "The radio Sleep (doze) current in Ampere.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_sleepCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ControlTxCurrentA",
+                   "The radio Tx current with the DMG Control PHY in Ampere.",
+                   DoubleValue (0.60),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_ctrlTxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ControlRxCurrentA",
+                   "The radio Rx current with the DMG Control PHY in Ampere.",
+                   DoubleValue (0.50),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_ctrlRxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ScTxCurrentA",
+                   "The radio Tx current with the DMG SC PHY in Ampere.",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_scTxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ScRxCurrentA",
+                   "The radio Rx current with the DMG SC PHY in Ampere.",
+                   DoubleValue (0.60),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_scRxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("OfdmTxCurrentA",
+                   "The radio Tx current with the DMG OFDM PHY in Ampere.",
+                   DoubleValue (0.90),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_ofdmTxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("OfdmRxCurrentA",
+                   "The radio Rx current with the DMG OFDM PHY in Ampere.",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_ofdmRxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("LpScTxCurrentA",
+                   "The radio Tx current with the DMG low power SC PHY in Ampere.",
+                   DoubleValue (0.65),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_lpScTxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("LpScRxCurrentA",
+                   "The radio Rx current with the DMG low power SC PHY in Ampere.",
+                   DoubleValue (0.55),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_lpScRxCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("BeamformingCurrentA",
+                   "The additional current drawn by the antenna array while transmitting "
+                   "or receiving a frame of beamforming training, in Ampere.",
+                   DoubleValue (0.10),
+                   MakeDoubleAccessor (&DmgRadioEnergyModel::m_beamformingCurrentA),
+                   MakeDoubleChecker<double> (0))
+    .AddTraceSource ("TotalEnergyConsumption",
+                     "Total energy consumption of the radio device.",
+                     MakeTraceSourceAccessor (&DmgRadioEnergyModel::m_totalEnergyConsumption),
+                     "ns3::TracedValueCallback::Double")
+    .AddTraceSource ("BeamformingEnergyConsumption",
+                     "Energy consumption of the radio device in beamforming training frames.",
+                     MakeTraceSourceAccessor (&DmgRadioEnergyModel::m_beamformingEnergyConsumption),
+                     "ns3::TracedValueCallback::Double")
+    .AddTraceSource ("EnergyPerBit",
+                     "Total energy consumption per bit of the data frames transmitted or received.",
+                     MakeTraceSourceAccessor (&DmgRadioEnergyModel::m_energyPerBit),
+                     "ns3::TracedValueCallback::Double")
+  ;
+  return tid;
+}
+
+DmgRadioEnergyModel::DmgRadioEnergyModel ()
+  : m_txCurrentA (0),
+    m_rxCurrentA (0),
+    m_txBeamforming (false),
+    m_rxBeamforming (false),
+    m_trafficBits (0),
+    m_currentState (WifiPhy::IDLE),
+    m_lastUpdateTime (Seconds (0.0)),
+    m_nPendingChangeState (0),
+    m_isSupersededChangeState (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_source = NULL;
+  // set callback for WifiPhy listener
+  m_listener = new WifiRadioEnergyModelPhyListener;
+  m_listener->SetChangeStateCallback (MakeCallback (&DeviceEnergyModel::ChangeState, this));
+  m_listener->SetUpdateTxCurrentCallback (MakeCallback (&DmgRadioEnergyModel::UpdateTxCurrent, this));
+}
+
+DmgRadioEnergyModel::~DmgRadioEnergyModel ()
+{
+  NS_LOG_FUNCTION (this);
+  delete m_listener;
+}
+
+void
+DmgRadioEnergyModel::SetEnergySource (Ptr<EnergySource> source)
+{
+  NS_LOG_FUNCTION (this << source);
+  NS_ASSERT (source != NULL);
+  m_source = source;
+}
+
+double
+DmgRadioEnergyModel::GetTotalEnergyConsumption (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_totalEnergyConsumption;
+}
+
+double
+DmgRadioEnergyModel::GetBeamformingEnergyConsumption (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_beamformingEnergyConsumption;
+}
+
+uint64_t
+DmgRadioEnergyModel::GetTrafficBits (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_trafficBits;
+}
+
+double
+DmgRadioEnergyModel::GetEnergyPerBit (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_energyPerBit;
+}
+
+void
+DmgRadioEnergyModel::SetAddress (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_address = address;
+}
+
+void
+DmgRadioEnergyModel::SetMcsCurrentA (WifiMode mode, double txCurrentA, double rxCurrentA)
+{
+  NS_LOG_FUNCTION (this << mode << txCurrentA << rxCurrentA);
+  m_mcsCurrents[mode.GetUniqueName ()] = std::make_pair (txCurrentA, rxCurrentA);
+}
+
+double
+DmgRadioEnergyModel::GetTxCurrentA (WifiMode mode) const
+{
+  NS_LOG_FUNCTION (this << mode);
+  std::map<std::string, std::pair<double, double> >::const_iterator it = m_mcsCurrents.find (mode.GetUniqueName ());
+  if (it != m_mcsCurrents.end ())
+    {
+      return it->second.first;
+    }
+  switch (mode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_DMG_CTRL:
+      return m_ctrlTxCurrentA;
+    case WIFI_MOD_CLASS_DMG_SC:
+      return m_scTxCurrentA;
+    case WIFI_MOD_CLASS_DMG_OFDM:
+      return m_ofdmTxCurrentA;
+    case WIFI_MOD_CLASS_DMG_LP_SC:
+      return m_lpScTxCurrentA;
+    default:
+      NS_FATAL_ERROR ("DmgRadioEnergyModel:Not a DMG mode: " << mode);
+      return 0;
+    }
+}
+
+double
+DmgRadioEnergyModel::GetRxCurrentA (WifiMode mode) const
+{
+  NS_LOG_FUNCTION (this << mode);
+  std::map<std::string, std::pair<double, double> >::const_iterator it = m_mcsCurrents.find (mode.GetUniqueName ());
+  if (it != m_mcsCurrents.end ())
+    {
+      return it->second.second;
+    }
+  switch (mode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_DMG_CTRL:
+      return m_ctrlRxCurrentA;
+    case WIFI_MOD_CLASS_DMG_SC:
+      return m_scRxCurrentA;
+    case WIFI_MOD_CLASS_DMG_OFDM:
+      return m_ofdmRxCurrentA;
+    case WIFI_MOD_CLASS_DMG_LP_SC:
+      return m_lpScRxCurrentA;
+    default:
+      NS_FATAL_ERROR ("DmgRadioEnergyModel:Not a DMG mode: " << mode);
+      return 0;
+    }
+}
+
+WifiPhy::State
+DmgRadioEnergyModel::GetCurrentState (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_currentState;
+}
+
+void
+DmgRadioEnergyModel::SetEnergyDepletionCallback (WifiRadioEnergyModel::WifiRadioEnergyDepletionCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  if (callback.IsNull ())
+    {
+      NS_LOG_DEBUG ("DmgRadioEnergyModel:Setting NULL energy depletion callback!");
+    }
+  m_energyDepletionCallback = callback;
+}
+
+void
+DmgRadioEnergyModel::SetEnergyRechargedCallback (WifiRadioEnergyModel::WifiRadioEnergyRechargedCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  if (callback.IsNull ())
+    {
+      NS_LOG_DEBUG ("DmgRadioEnergyModel:Setting NULL energy recharged callback!");
+    }
+  m_energyRechargedCallback = callback;
+}
+
+void
+DmgRadioEnergyModel::ChangeState (int newState)
+{
+  NS_LOG_FUNCTION (this << newState);
+
+  Time duration = Simulator::Now () - m_lastUpdateTime;
+  NS_ASSERT (duration.GetNanoSeconds () >= 0); // check if duration is valid
+
+  // energy to decrease = current * voltage * time
+  double supplyVoltage = m_source->GetSupplyVoltage ();
+  double energyToDecrease = duration.GetSeconds () * DoGetCurrentA () * supplyVoltage;
+  if (((m_currentState == WifiPhy::TX) && m_txBeamforming)
+      || ((m_currentState == WifiPhy::RX) && m_rxBeamforming))
+    {
+      m_beamformingEnergyConsumption += energyToDecrease;
+    }
+
+  // update total energy consumption
+  m_totalEnergyConsumption += energyToDecrease;
+  if (m_trafficBits > 0)
+    {
+      m_energyPerBit = m_totalEnergyConsumption / m_trafficBits;
+    }
+
+  // update last update time stamp
+  m_lastUpdateTime = Simulator::Now ();
+
+  m_nPendingChangeState++;
+
+  // notify energy source
+  m_source->UpdateEnergySource ();
+
+  // as in WifiRadioEnergyModel, a state change caused by an energy depletion
+  // during the update above supersedes this one.
+  if (!m_isSupersededChangeState)
+    {
+      m_currentState = (WifiPhy::State) newState;
+      NS_LOG_DEBUG ("DmgRadioEnergyModel:Switching to state: " << m_currentState <<
+                    " at time = " << Simulator::Now () <<
+                    ", total energy consumption is " << m_totalEnergyConsumption << "J");
+    }
+
+  m_isSupersededChangeState = (m_nPendingChangeState > 1);
+
+  m_nPendingChangeState--;
+}
+
+void
+DmgRadioEnergyModel::HandleEnergyDepletion (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG ("DmgRadioEnergyModel:Energy is depleted!");
+  // invoke energy depletion callback, if set.
+  if (!m_energyDepletionCallback.IsNull ())
+    {
+      m_energyDepletionCallback ();
+    }
+}
+
+void
+DmgRadioEnergyModel::HandleEnergyRecharged (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG ("DmgRadioEnergyModel:Energy is recharged!");
+  // invoke energy recharged callback, if set.
+  if (!m_energyRechargedCallback.IsNull ())
+    {
+      m_energyRechargedCallback ();
+    }
+}
+
+WifiRadioEnergyModelPhyListener *
+DmgRadioEnergyModel::GetPhyListener (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_listener;
+}
+
+void
+DmgRadioEnergyModel::NotifyTx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                               uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu)
+{
+  NS_LOG_FUNCTION (this << packet << txVector.GetMode ());
+  /* The PHY notifies its listeners of the TX state right after this trace */
+  uint64_t dataBits;
+  Mac48Address receiver;
+  m_txBeamforming = ClassifyFrame (packet, txVector, dataBits, receiver);
+  m_txCurrentA = GetTxCurrentA (txVector.GetMode ());
+  AddTrafficBits (dataBits);
+}
+
+void
+DmgRadioEnergyModel::NotifyRxSync (Ptr<const Packet> packet, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << packet << txVector.GetMode ());
+  /* The PHY notifies its listeners of the RX state right after this trace */
+  uint64_t dataBits;
+  Mac48Address receiver;
+  m_rxBeamforming = ClassifyFrame (packet, txVector, dataBits, receiver);
+  m_rxCurrentA = GetRxCurrentA (txVector.GetMode ());
+}
+
+void
+DmgRadioEnergyModel::NotifyRxEnd (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  uint64_t dataBits;
+  Mac48Address receiver;
+  ClassifyFrame (packet, WifiTxVector (), dataBits, receiver);
+  /* The PHY also decodes the frames overheard from the other stations */
+  if (receiver == m_address || receiver.IsGroup ())
+    {
+      AddTrafficBits (dataBits);
+    }
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+DmgRadioEnergyModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_source = NULL;
+  m_energyDepletionCallback.Nullify ();
+  m_energyRechargedCallback.Nullify ();
+}
+
+double
+DmgRadioEnergyModel::DoGetCurrentA (void) const
+{
+  NS_LOG_FUNCTION (this);
+  switch (m_currentState)
+    {
+    case WifiPhy::IDLE:
+      return m_idleCurrentA;
+    case WifiPhy::CCA_BUSY:
+      return m_ccaBusyCurrentA;
+    case WifiPhy::TX:
+      return m_txCurrentA + (m_txBeamforming ? m_beamformingCurrentA : 0);
+    case WifiPhy::RX:
+      return m_rxCurrentA + (m_rxBeamforming ? m_beamformingCurrentA : 0);
+    case WifiPhy::SWITCHING:
+      return m_switchingCurrentA;
+    case WifiPhy::SLEEP:
+      return m_sleepCurrentA;
+    default:
+      NS_FATAL_ERROR ("DmgRadioEnergyModel:Undefined radio state:" << m_currentState);
+    }
+}
+
+void
+DmgRadioEnergyModel::UpdateTxCurrent (double txPowerDbm)
+{
+  NS_LOG_FUNCTION (this << txPowerDbm);
+}
+
+bool
+DmgRadioEnergyModel::ClassifyFrame (Ptr<const Packet> packet, WifiTxVector txVector, uint64_t &dataBits,
+                                    Mac48Address &receiver)
+{
+  dataBits = 0;
+  Ptr<Packet> copy = packet->Copy ();
+  AmpduTag ampduTag;
+  if (copy->PeekPacketTag (ampduTag))
+    {
+      AmpduSubframeHeader subframeHeader;
+      copy->RemoveHeader (subframeHeader);
+    }
+  WifiMacHeader hdr;
+  if (copy->GetSize () < WIFI_MAC_FCS_LENGTH + 2 || copy->PeekHeader (hdr) == 0)
+    {
+      return false;
+    }
+  receiver = hdr.GetAddr1 ();
+  if (hdr.IsData () && (copy->GetSize () > hdr.GetSerializedSize () + WIFI_MAC_FCS_LENGTH))
+    {
+      dataBits = (copy->GetSize () - hdr.GetSerializedSize () - WIFI_MAC_FCS_LENGTH) * 8;
+    }
+  return hdr.IsDMGBeacon () || hdr.IsSSW () || hdr.IsSSW_FBCK () || hdr.IsSSW_ACK ()
+         || (txVector.GetTrainngFieldLength () > 0);
+}
+
+void
+DmgRadioEnergyModel::AddTrafficBits (uint64_t bits)
+{
+  NS_LOG_FUNCTION (this << bits);
+  if (bits == 0)
+    {
+      return;
+    }
+  m_trafficBits += bits;
+  m_energyPerBit = m_totalEnergyConsumption / m_trafficBits;
+}
+
+} // namespace ns3
@@ -0,0 +1,341 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dmg-snr-wifi-manager.h"
+#include "wifi-phy.h"
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace ns3 {
+
+/**
+ * \brief hold per-remote-station state for DMG SNR Wifi manager.
+ *
+ * This struct extends from WifiRemoteStation struct to hold additional
+ * information required by the DMG SNR Wifi manager
+ */
+struct DmgSnrWifiRemoteStation : public WifiRemoteStation
+{
+  double m_snr;             //!< Estimated SNR (linear) of the link, 0 if unknown
+  uint32_t m_index;         //!< Index of the mode used in the thresholds
+  uint32_t m_backoff;       //!< Number of steps below the mode allowed by the SNR
+  uint32_t m_nSuccess;      //!< Number of MPDUs acknowledged in the current window
+  uint32_t m_nFailed;       //!< Number of MPDUs lost in the current window
+  uint32_t m_goodWindows;   //!< Number of consecutive windows below the maximum loss ratio
+};
+
+NS_OBJECT_ENSURE_REGISTERED (DmgSnrWifiManager);
+
+NS_LOG_COMPONENT_DEFINE ("DmgSnrWifiManager");
+
+/**
+ * Receiver sensitivity (dBm) of the DMG MCSs 1 to 24, 802.11ad-2012
+ * Table 21-3 and Table 21-18.
+ */
+static const double g_dmgSensitivity[25] = {
+  -78,                                                            // Control PHY
+  -68, -66, -65, -64, -62, -63, -62, -61, -59, -55, -54, -53,     // SC PHY
+  -66, -64, -63, -62, -60, -58, -56, -54, -53, -51, -49, -47      // OFDM PHY
+};
+
+TypeId
+DmgSnrWifiManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DmgSnrWifiManager")
+    .SetParent<WifiRemoteStationManager> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<DmgSnrWifiManager> ()
+    .AddAttribute ("SnrMargin",
+                   "The margin (dB) by which the estimated SNR must exceed the SNR threshold of a mode.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&DmgSnrWifiManager::m_snrMargin),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("OfdmEnabled",
+                   "Whether the OFDM MCSs (DMG_MCS13 to DMG_MCS24) can be selected in addition to the SC MCSs.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DmgSnrWifiManager::m_ofdmEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LossWindow",
+                   "The number of MPDUs over which the loss ratio is computed.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&DmgSnrWifiManager::m_lossWindow),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxLossRatio",
+                   "The MPDU loss ratio of a window above which the MCS is lowered by one step.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&DmgSnrWifiManager::m_maxLossRatio),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("RecoveryWindows",
+                   "The number of consecutive windows below MaxLossRatio after which the MCS is raised back by one step.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&DmgSnrWifiManager::m_recoveryWindows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Rate",
+                     "Traced value for rate changes (b/s)",
+                     MakeTraceSourceAccessor (&DmgSnrWifiManager::m_currentRate),
+                     "ns3::TracedValueCallback::Uint64")
+    .AddTraceSource ("RateChange",
+                     "The mode used to transmit data to a remote station changed.",
+                     MakeTraceSourceAccessor (&DmgSnrWifiManager::m_rateChange),
+                     "ns3::DmgSnrWifiManager::RateChangeTracedCallback")
+  ;
+  return tid;
+}
+
+DmgSnrWifiManager::DmgSnrWifiManager ()
+  : m_currentRate (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DmgSnrWifiManager::~DmgSnrWifiManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+double
+DmgSnrWifiManager::GetSnrThreshold (WifiMode mode) const
+{
+  NS_LOG_FUNCTION (this << mode.GetUniqueName ());
+  std::string name = mode.GetUniqueName ();
+  NS_ASSERT_MSG (name.compare (0, 7, "DMG_MCS") == 0, "Not a DMG mode: " << name);
+  uint32_t mcs = std::atoi (name.c_str () + 7);
+  NS_ASSERT_MSG (mcs <= 24, "No sensitivity defined for " << name);
+  double noiseDbm = 10 * std::log10 (GetPhy ()->GetNoiseFloorW ()) + 30;
+  return std::pow (10.0, (g_dmgSensitivity[mcs] - noiseDbm) / 10.0);
+}
+
+void
+DmgSnrWifiManager::DoInitialize ()
+{
+  NS_LOG_FUNCTION (this);
+  Thresholds candidates;
+  for (uint32_t i = 0; i < GetPhy ()->GetNModes (); i++)
+    {
+      WifiMode mode = GetPhy ()->GetMode (i);
+      if (mode.GetModulationClass () == WIFI_MOD_CLASS_DMG_SC
+          || (m_ofdmEnabled && mode.GetModulationClass () == WIFI_MOD_CLASS_DMG_OFDM))
+        {
+          candidates.push_back (std::make_pair (GetSnrThreshold (mode), mode));
+        }
+    }
+  NS_ASSERT_MSG (!candidates.empty (), "DmgSnrWifiManager requires a DMG PHY");
+
+  /* Keep, from the fastest mode down, only the modes which need less SNR
+     than all the faster ones, so that every step down is more robust */
+  m_thresholds.clear ();
+  while (!candidates.empty ())
+    {
+      Thresholds::iterator fastest = candidates.begin ();
+      for (Thresholds::iterator i = candidates.begin (); i != candidates.end (); i++)
+        {
+          if (i->second.GetDataRate () > fastest->second.GetDataRate ())
+            {
+              fastest = i;
+            }
+        }
+      if (m_thresholds.empty () || fastest->first < m_thresholds.back ().first)
+        {
+          NS_LOG_DEBUG ("Initialize, adding mode = " << fastest->second.GetUniqueName () <<
+                        " threshold " << 10 * std::log10 (fastest->first) << " dB");
+          m_thresholds.push_back (*fastest);
+        }
+      candidates.erase (fastest);
+    }
+  std::reverse (m_thresholds.begin (), m_thresholds.end ());
+}
+
+WifiRemoteStation *
+DmgSnrWifiManager::DoCreateStation (void) const
+{
+  NS_LOG_FUNCTION (this);
+  DmgSnrWifiRemoteStation *station = new DmgSnrWifiRemoteStation ();
+  station->m_snr = 0.0;
+  station->m_index = 0;
+  station->m_backoff = 0;
+  station->m_nSuccess = 0;
+  station->m_nFailed = 0;
+  station->m_goodWindows = 0;
+  return station;
+}
+
+void
+DmgSnrWifiManager::UpdateLossStatistics (WifiRemoteStation *st, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus)
+{
+  NS_LOG_FUNCTION (this << st << nSuccessfulMpdus << nFailedMpdus);
+  DmgSnrWifiRemoteStation *station = (DmgSnrWifiRemoteStation *)st;
+  station->m_nSuccess += nSuccessfulMpdus;
+  station->m_nFailed += nFailedMpdus;
+  uint32_t total = station->m_nSuccess + station->m_nFailed;
+  if (total < m_lossWindow)
+    {
+      return;
+    }
+  double lossRatio = static_cast<double> (station->m_nFailed) / total;
+  NS_LOG_DEBUG ("Loss ratio " << lossRatio << " over " << total << " MPDUs, backoff " << station->m_backoff);
+  if (lossRatio > m_maxLossRatio)
+    {
+      station->m_backoff++;
+      station->m_goodWindows = 0;
+    }
+  else if (station->m_backoff > 0 && ++station->m_goodWindows >= m_recoveryWindows)
+    {
+      station->m_backoff--;
+      station->m_goodWindows = 0;
+    }
+  station->m_nSuccess = 0;
+  station->m_nFailed = 0;
+}
+
+void
+DmgSnrWifiManager::UpdateMode (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  DmgSnrWifiRemoteStation *station = (DmgSnrWifiRemoteStation *)st;
+  NS_ASSERT_MSG (!m_thresholds.empty (), "DmgSnrWifiManager used before being initialized");
+  double snr = station->m_snr / std::pow (10.0, m_snrMargin / 10.0);
+  uint32_t index = 0;
+  for (uint32_t i = 0; i < m_thresholds.size (); i++)
+    {
+      if (m_thresholds[i].first <= snr)
+        {
+          index = i;
+        }
+    }
+  /* Steps below the slowest mode do not accumulate */
+  station->m_backoff = std::min (station->m_backoff, index);
+  index -= station->m_backoff;
+  if (index != station->m_index)
+    {
+      WifiMode oldMode = m_thresholds[station->m_index].second;
+      WifiMode newMode = m_thresholds[index].second;
+      NS_LOG_DEBUG ("Station " << station->m_state->m_address << " switches from " << oldMode.GetUniqueName ()
+                    << " to " << newMode.GetUniqueName () << ", snr " << station->m_snr
+                    << ", backoff " << station->m_backoff);
+      station->m_index = index;
+      m_currentRate = newMode.GetDataRate ();
+      m_rateChange (station->m_state->m_address, oldMode, newMode);
+    }
+}
+
+void
+DmgSnrWifiManager::DoReportRxOk (WifiRemoteStation *station,
+                                 double rxSnr, WifiMode txMode)
+{
+  // Frames from the remote station may be received with a quasi-omni
+  // pattern, so their SNR does not estimate the SNR of the trained link.
+}
+
+void
+DmgSnrWifiManager::DoReportRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+DmgSnrWifiManager::DoReportDataFailed (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  UpdateLossStatistics (st, 0, 1);
+  UpdateMode (st);
+}
+
+void
+DmgSnrWifiManager::DoReportRtsOk (WifiRemoteStation *st,
+                                  double ctsSnr, WifiMode ctsMode, double rtsSnr)
+{
+}
+
+void
+DmgSnrWifiManager::DoReportDataOk (WifiRemoteStation *st,
+                                   double ackSnr, WifiMode ackMode, double dataSnr)
+{
+  NS_LOG_FUNCTION (this << st << ackSnr << ackMode.GetUniqueName () << dataSnr);
+  DmgSnrWifiRemoteStation *station = (DmgSnrWifiRemoteStation *)st;
+  if (dataSnr > 0)
+    {
+      station->m_snr = dataSnr;
+    }
+  UpdateLossStatistics (st, 1, 0);
+  UpdateMode (st);
+}
+
+void
+DmgSnrWifiManager::DoReportAmpduTxStatus (WifiRemoteStation *st, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus, double rxSnr, double dataSnr)
+{
+  NS_LOG_FUNCTION (this << st << nSuccessfulMpdus << nFailedMpdus << rxSnr << dataSnr);
+  DmgSnrWifiRemoteStation *station = (DmgSnrWifiRemoteStation *)st;
+  if (dataSnr > 0)
+    {
+      station->m_snr = dataSnr;
+    }
+  UpdateLossStatistics (st, nSuccessfulMpdus, nFailedMpdus);
+  UpdateMode (st);
+}
+
+void
+DmgSnrWifiManager::DoReportBeamformingSnr (WifiRemoteStation *st, double snr)
+{
+  NS_LOG_FUNCTION (this << st << snr);
+  DmgSnrWifiRemoteStation *station = (DmgSnrWifiRemoteStation *)st;
+  station->m_snr = snr;
+  station->m_backoff = 0;
+  station->m_nSuccess = 0;
+  station->m_nFailed = 0;
+  station->m_goodWindows = 0;
+  UpdateMode (st);
+}
+
+void
+DmgSnrWifiManager::DoReportFinalRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+DmgSnrWifiManager::DoReportFinalDataFailed (WifiRemoteStation *station)
+{
+}
+
+WifiTxVector
+DmgSnrWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  DmgSnrWifiRemoteStation *station = (DmgSnrWifiRemoteStation *)st;
+  NS_ASSERT_MSG (!m_thresholds.empty (), "DmgSnrWifiManager used before being initialized");
+  return WifiTxVector (m_thresholds[station->m_index].second, GetDefaultTxPowerLevel (), GetLongRetryCount (station),
+                       false, 1, 0, GetChannelWidth (station), GetAggregation (station), false);
+}
+
+WifiTxVector
+DmgSnrWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  return WifiTxVector (WifiPhy::GetDMG_MCS0 (), GetDefaultTxPowerLevel (), GetShortRetryCount (st),
+                       false, 1, 0, GetChannelWidth (st), GetAggregation (st), false);
+}
+
+bool
+DmgSnrWifiManager::IsLowLatency (void) const
+{
+  return true;
+}
+
+} //namespace ns3
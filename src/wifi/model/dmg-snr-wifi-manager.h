@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_SNR_WIFI_MANAGER_H
+#define DMG_SNR_WIFI_MANAGER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/traced-value.h"
+#include "ns3/traced-callback.h"
+#include "wifi-mode.h"
+#include "wifi-remote-station-manager.h"
+
+namespace ns3 {
+
+/**
+ * \brief SNR-driven rate control algorithm for DMG stations
+ * \ingroup wifi
+ *
+ * This class selects the DMG MCS used to transmit data to a remote
+ * station among the SC MCSs (DMG_MCS1 to DMG_MCS12) and, optionally, the
+ * OFDM MCSs (DMG_MCS13 to DMG_MCS24) supported by the PHY.
+ *
+ * The SNR of the link is estimated from the SNR of the best antenna
+ * configuration found by the last beamforming training (SLS or BRP),
+ * reported by DmgWifiMac through ReportBeamformingSnr(), and is then
+ * refined by the data SNR fed back by the receiver in the ACK and
+ * Block ACK frames.  The fastest MCS whose SNR threshold, derived from
+ * the receiver sensitivity of the MCS defined by the standard and the
+ * noise floor of the PHY, is below the estimated SNR minus a margin is
+ * selected.
+ *
+ * Since the SNR measured during the training does not account for
+ * interference and for the changes of the channel since then, the
+ * MPDU loss ratio reported by the Block ACKs is monitored over windows
+ * of MPDUs: the MCS is lowered by one step every window whose loss
+ * ratio exceeds MaxLossRatio, and raised back by one step after
+ * RecoveryWindows consecutive windows below it.  A new beamforming
+ * measurement cancels the steps taken down.
+ */
+class DmgSnrWifiManager : public WifiRemoteStationManager
+{
+public:
+  static TypeId GetTypeId (void);
+  DmgSnrWifiManager ();
+  virtual ~DmgSnrWifiManager ();
+
+  /**
+   * Return the minimum SNR needed to successfully receive data
+   * transmitted with the given DMG mode.
+   *
+   * \param mode the DMG mode
+   *
+   * \return the minimum SNR (linear) for the given mode, without margin
+   */
+  double GetSnrThreshold (WifiMode mode) const;
+
+  /**
+   * TracedCallback signature for rate change events.
+   *
+   * \param [in] address The address of the remote station.
+   * \param [in] oldMode The mode used until now.
+   * \param [in] newMode The mode used from now on.
+   */
+  typedef void (* RateChangeTracedCallback)
+    (Mac48Address address, WifiMode oldMode, WifiMode newMode);
+
+
+private:
+  //overriden from base class
+  virtual void DoInitialize (void);
+  virtual WifiRemoteStation* DoCreateStation (void) const;
+  virtual void DoReportRxOk (WifiRemoteStation *station,
+                             double rxSnr, WifiMode txMode);
+  virtual void DoReportRtsFailed (WifiRemoteStation *station);
+  virtual void DoReportDataFailed (WifiRemoteStation *station);
+  virtual void DoReportRtsOk (WifiRemoteStation *station,
+                              double ctsSnr, WifiMode ctsMode, double rtsSnr);
+  virtual void DoReportDataOk (WifiRemoteStation *station,
+                               double ackSnr, WifiMode ackMode, double dataSnr);
+  virtual void DoReportAmpduTxStatus (WifiRemoteStation *station, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus, double rxSnr, double dataSnr);
+  virtual void DoReportBeamformingSnr (WifiRemoteStation *station, double snr);
+  virtual void DoReportFinalRtsFailed (WifiRemoteStation *station);
+  virtual void DoReportFinalDataFailed (WifiRemoteStation *station);
+  virtual WifiTxVector DoGetDataTxVector (WifiRemoteStation *station);
+  virtual WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
+  virtual bool IsLowLatency (void) const;
+
+  /**
+   * Account the transmission status of MPDUs sent to a station and
+   * step the MCS down or up at the end of each window.
+   *
+   * \param station the remote station
+   * \param nSuccessfulMpdus the number of MPDUs acknowledged
+   * \param nFailedMpdus the number of MPDUs not acknowledged
+   */
+  void UpdateLossStatistics (WifiRemoteStation *station, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus);
+  /**
+   * Select the mode for the current SNR estimate and loss back-off of
+   * a station and fire the traces if it changed.
+   *
+   * \param station the remote station
+   */
+  void UpdateMode (WifiRemoteStation *station);
+
+  /**
+   * A vector of <snr, WifiMode> pairs holding the minimum SNR for each
+   * DMG mode, sorted by increasing data rate and restricted to the modes
+   * which need less SNR than all the slower ones.
+   */
+  typedef std::vector<std::pair<double, WifiMode> > Thresholds;
+
+  Thresholds m_thresholds;     //!< The candidate modes and their SNR threshold
+  double m_snrMargin;          //!< The margin (dB) applied on the SNR estimate
+  bool m_ofdmEnabled;          //!< Whether the OFDM MCSs are candidates
+  uint32_t m_lossWindow;       //!< The number of MPDUs of a loss window
+  double m_maxLossRatio;       //!< The loss ratio above which the MCS is lowered
+  uint32_t m_recoveryWindows;  //!< The number of good windows before raising the MCS back
+
+  TracedValue<uint64_t> m_currentRate; //!< Trace rate changes
+  TracedCallback<Mac48Address, WifiMode, WifiMode> m_rateChange; //!< Trace per-station mode changes
+};
+
+} //namespace ns3
+
+#endif /* DMG_SNR_WIFI_MANAGER_H */
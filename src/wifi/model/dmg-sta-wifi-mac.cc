@@ -14,6 +14,7 @@
 
 #include "amsdu-subframe-header.h"
 #include "dcf-manager.h"
+#include "dmg-ap-wifi-mac.h"
 #include "dmg-capabilities.h"
 #include "dmg-sta-wifi-mac.h"
 #include "ext-headers.h"
@@ -22,6 +23,8 @@
 #include "msdu-aggregator.h"
 #include "wifi-mac-header.h"
 #include "random-stream.h"
+#include "wifi-net-device.h"
+#include <algorithm>
 #include <cmath>
 
 namespace ns3 {
@@ -83,6 +86,14 @@ DmgStaWifiMac::GetTypeId (void)
                     MakeUintegerAccessor (&DmgStaWifiMac::m_relayDataSensingTime),
                     MakeUintegerChecker<uint8_t> (1, std::numeric_limits<uint8_t>::max ()))
 
+    /* Power Save */
+    .AddAttribute ("DozeOutsideAllocations",
+                   "If true, the DMG STA puts its PHY in doze state during the DTI outside "
+                   "the SPs and the CBAPs in which it may take part.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DmgStaWifiMac::m_dozeOutsideAllocations),
+                   MakeBooleanChecker ())
+
     .AddTraceSource ("Assoc", "Associated with an access point.",
                      MakeTraceSourceAccessor (&DmgStaWifiMac::m_assocLogger),
                      "ns3::Mac48Address::TracedCallback")
@@ -110,6 +121,7 @@ DmgStaWifiMac::DmgStaWifiMac ()
     m_assocRequestEvent (),
     m_beaconWatchdogEnd (Seconds (0.0)),
     m_abftEvent (),
+    m_dozing (false),
     m_linkChangeInterval ()
 {
   NS_LOG_FUNCTION (this);
@@ -123,6 +135,7 @@ DmgStaWifiMac::DmgStaWifiMac ()
   m_failedRssAttemptsCounter = 0;
   m_rssBackoffRemaining = 0;
   m_nextBeacon = 0;
+  m_receivedDmgBeacon = false;
 
   /* Relay Variables */
   m_relayMode = false;
@@ -152,6 +165,12 @@ DmgStaWifiMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
 std::cout << "sally test dmgstamac -> DoDispose" << std::endl;
+  m_abftFastForwardAp = 0;
+  for (std::vector<EventId>::iterator it = m_dozeEvents.begin (); it != m_dozeEvents.end (); it++)
+    {
+      it->Cancel ();
+    }
+  m_dozeEvents.clear ();
   DmgWifiMac::DoDispose ();
 }
 
@@ -574,6 +593,9 @@ DmgStaWifiMac::StartBeaconInterval (void)
   NS_LOG_FUNCTION (this << "DMG AP Starting BI at " << Simulator::Now ());
 std::cout << "sally test dmgstamac -> StartBeaconInterval" << std::endl;
 
+  /* Wake up to receive the DMG Beacons */
+  CancelDozePeriods ();
+
   /* Disable Channel Access by CBAP */
   EndContentionPeriod ();
 
@@ -645,25 +667,26 @@ std::cout << "sally test dmgstamac -> DoAssociationBeamformingTraining" << std::
 
   if ((m_rssBackoffRemaining == 0))
     {
-      /* Choose a random SSW Slot to transmit SSW Frames in it */
-      a_bftSlot->SetAttribute ("Min", DoubleValue (0));
-      a_bftSlot->SetAttribute ("Max", DoubleValue (m_remainingSlotsPerABFT - 1));
-      m_slotIndex = a_bftSlot->GetInteger ();
+      if (m_abftFastForwardAp != 0)
+        {
+          /* The DMG AP draws our slots and resolves the collisions of the whole A-BFT */
+          m_abftFastForwardAp->AddAbftResponder (this);
+          return;
+        }
 
+      /* Choose a random SSW Slot to transmit SSW Frames in it */
+      uint8_t slot = SelectAbftSlot ();
       Time rssTime = m_slotIndex * m_low->GetSectorSweepSlotTime (m_ssFramesPerSlot);
       Simulator::Schedule (rssTime, &DmgStaWifiMac::StartAbftResponderSectorSweep, this, GetBssid (), m_isResponderTXSS);
-      NS_LOG_DEBUG ("Selected Sector Slot Index=" << uint (m_slotOffset + m_slotIndex)
+      NS_LOG_DEBUG ("Selected Sector Slot Index=" << uint (slot)
                     << ", Start RSS at " << Simulator::Now () + rssTime);
 
-      /* Update upper bound of slots */
-      m_remainingSlotsPerABFT -= (m_slotIndex + 1);
       if (m_remainingSlotsPerABFT > 0)
         {
           /* Schedule SSW FBCK Timeout to detect a collision i.e. missing SSW-FBCK */
           Time timeout = (m_slotIndex + 1) * m_low->GetSectorSweepSlotTime (m_ssFramesPerSlot);
           NS_LOG_DEBUG ("Scheduled SSW-FBCK Timeout Event at " << Simulator::Now () + timeout);
           m_sswFbckTimeout = Simulator::Schedule (timeout, &DmgStaWifiMac::MissedSswFeedback, this);
-          m_slotOffset += (m_slotIndex + 1);
         }
     }
   else
@@ -685,18 +708,137 @@ DmgStaWifiMac::MissedSswFeedback (void)
    * count becomes zero. The STA shall set FailedRSSAttempts to 0 upon successfully receiving an SSW-
    * Feedback frame during the A-BFT. */
 std::cout << "sally test dmgstamac -> MissedSswFeedback" << std::endl;
-  m_failedRssAttemptsCounter++;
-  if (m_failedRssAttemptsCounter < m_rssAttemptsLimit)
+  if (ReportAbftCollision ())
     {
       DoAssociationBeamformingTraining ();
     }
-  else
+}
+
+void
+DmgStaWifiMac::SaveSnapshot (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  DmgWifiMac::SaveSnapshot (os);
+  os << "sta " << (m_state == ASSOCIATED) << " " << GetBssid () << " " << m_aid << std::endl;
+}
+
+void
+DmgStaWifiMac::RestoreSnapshot (std::istream &is)
+{
+  NS_LOG_FUNCTION (this);
+  DmgWifiMac::RestoreSnapshot (is);
+  bool associated;
+  ReadSnapshotKey (is, "sta");
+  is >> associated;
+  Mac48Address bssid = ReadSnapshotAddress (is);
+  is >> m_aid;
+  if (associated)
     {
-      /* Extract random backoff for backing-off */
-      m_rssBackoffRemaining = m_rssBackoffVariable->GetInteger ();
+      SetBssid (bssid);
+      SetState (ASSOCIATED);
+      if (!m_linkUp.IsNull ())
+        {
+          m_linkUp ();
+        }
     }
 }
 
+Ptr<DmgApWifiMac>
+DmgStaWifiMac::LookupAbftFastForwardAp (Mac48Address bssid)
+{
+  NS_LOG_FUNCTION (this << bssid);
+  if (bssid == m_abftLookupBssid)
+    {
+      return m_abftFastForwardAp;
+    }
+  m_abftLookupBssid = bssid;
+  m_abftFastForwardAp = 0;
+  Ptr<WifiChannel> channel = m_phy->GetChannel ();
+  for (uint32_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (channel->GetDevice (i));
+      if (device == 0)
+        {
+          continue;
+        }
+      Ptr<DmgApWifiMac> mac = DynamicCast<DmgApWifiMac> (device->GetMac ());
+      if ((mac != 0) && (mac->GetAddress () == bssid))
+        {
+          if (mac->GetAbftFastForward ())
+            {
+              m_abftFastForwardAp = mac;
+            }
+          break;
+        }
+    }
+  return m_abftFastForwardAp;
+}
+
+uint8_t
+DmgStaWifiMac::SelectAbftSlot (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_remainingSlotsPerABFT > 0);
+  a_bftSlot->SetAttribute ("Min", DoubleValue (0));
+  a_bftSlot->SetAttribute ("Max", DoubleValue (m_remainingSlotsPerABFT - 1));
+  m_slotIndex = a_bftSlot->GetInteger ();
+  uint8_t slot = m_slotOffset + m_slotIndex;
+
+  /* Update upper bound of slots */
+  m_remainingSlotsPerABFT -= (m_slotIndex + 1);
+  m_slotOffset += (m_slotIndex + 1);
+  return slot;
+}
+
+bool
+DmgStaWifiMac::ReportAbftCollision (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* No SSW-FBCK timeout is armed in the last slot of the A-BFT */
+  if (m_remainingSlotsPerABFT == 0)
+    {
+      return false;
+    }
+  m_failedRssAttemptsCounter++;
+  if (m_failedRssAttemptsCounter < m_rssAttemptsLimit)
+    {
+      return true;
+    }
+  /* Extract random backoff for backing-off */
+  m_rssBackoffRemaining = m_rssBackoffVariable->GetInteger ();
+  return false;
+}
+
+DmgWifiMac::ANTENNA_CONFIGURATION
+DmgStaWifiMac::GetAbftFeedback (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_isIssInitiator = false;
+  /* Obtain antenna configuration for the highest received SNR from the DMG AP to feed it back */
+  m_feedbackAntennaConfig = GetBestAntennaConfiguration (GetBssid (), true);
+  return m_feedbackAntennaConfig;
+}
+
+void
+DmgStaWifiMac::ReceiveAbftFeedback (Mac48Address address, ANTENNA_CONFIGURATION_TX antennaConfigTx)
+{
+  NS_LOG_FUNCTION (this << address);
+  NS_LOG_LOGIC ("Best TX Antenna Sector Config by this DMG STA to DMG AP=" << address
+                << ": SectorID=" << uint32_t (antennaConfigTx.first)
+                << ", AntennaID=" << uint32_t (antennaConfigTx.second));
+
+  ANTENNA_CONFIGURATION_RX antennaConfigRx = std::make_pair (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG);
+  m_bestAntennaConfig[address] = std::make_pair (antennaConfigTx, antennaConfigRx);
+
+  /* Raise an event that we selected the best sector to the DMG AP */
+  m_slsCompleted (address, CHANNEL_ACCESS_BHI, antennaConfigTx.first, antennaConfigTx.second);
+
+  /* We received SSW-FBCK so we cancel the timeout event */
+  m_slotIndex = 0;
+  m_failedRssAttemptsCounter = 0;
+  m_sswFbckTimeout.Cancel ();
+}
+
 void
 DmgStaWifiMac::StartAnnouncementTransmissionInterval (void)
 {
@@ -752,6 +894,10 @@ std::cout << "sally test dmgstamac -> StartDataTransmissionInterval, CBAP alloca
     }
   else
     {
+      if (m_dozeOutsideAllocations && IsAssociated ())
+        {
+          ScheduleDozePeriods (nextBeaconInterval);
+        }
       AllocationField field;
       for (AllocationFieldList::iterator iter = m_allocationList.begin (); iter != m_allocationList.end (); iter++)
         {
@@ -950,6 +1096,101 @@ std::cout << "sally test dmgstamac -> StartDataTransmissionInterval, case18" <<
     }
 }
 
+void
+DmgStaWifiMac::ScheduleDozePeriods (Time dtiDuration)
+{
+  NS_LOG_FUNCTION (this << dtiDuration);
+  /* The periods in which we must stay awake, following the allocations scheduled in the DTI */
+  std::vector<std::pair<Time, Time> > awakePeriods;
+  for (AllocationFieldList::iterator iter = m_allocationList.begin (); iter != m_allocationList.end (); iter++)
+    {
+      bool awake = false;
+      if (iter->GetAllocationType () == SERVICE_PERIOD_ALLOCATION)
+        {
+          uint8_t sourceAid = iter->GetSourceAid ();
+          uint8_t destinationAid = iter->GetDestinationAid ();
+          if ((sourceAid == AID_BROADCAST) && (destinationAid == AID_BROADCAST))
+            {
+              awake = false;
+            }
+          else if ((sourceAid == m_aid) || (destinationAid == m_aid) || (destinationAid == AID_BROADCAST))
+            {
+              awake = true;
+            }
+          else
+            {
+              /* We protect this service period as an RDS */
+              awake = (m_relayLinkMap.find (std::make_pair (sourceAid, destinationAid)) != m_relayLinkMap.end ());
+            }
+        }
+      else if (iter->GetAllocationType () == CBAP_ALLOCATION)
+        {
+          awake = (iter->GetSourceAid () == AID_BROADCAST) || (iter->GetSourceAid () == m_aid)
+            || (iter->GetDestinationAid () == m_aid);
+        }
+      if (awake)
+        {
+          Time start = MicroSeconds (iter->GetAllocationStart ());
+          awakePeriods.push_back (std::make_pair (start, start + MicroSeconds (iter->GetAllocationBlockDuration ())));
+        }
+    }
+  std::sort (awakePeriods.begin (), awakePeriods.end ());
+
+  /* Doze between the awake periods; we wake up at the next BI in StartBeaconInterval */
+  Time dozeStart = Seconds (0);
+  for (std::vector<std::pair<Time, Time> >::const_iterator it = awakePeriods.begin (); it != awakePeriods.end (); it++)
+    {
+      if (it->first > dozeStart)
+        {
+          m_dozeEvents.push_back (Simulator::Schedule (dozeStart, &DmgStaWifiMac::Doze, this));
+          m_dozeEvents.push_back (Simulator::Schedule (it->first, &DmgStaWifiMac::WakeUp, this));
+        }
+      dozeStart = std::max (dozeStart, it->second);
+    }
+  if (dozeStart < dtiDuration)
+    {
+      m_dozeEvents.push_back (Simulator::Schedule (dozeStart, &DmgStaWifiMac::Doze, this));
+    }
+}
+
+void
+DmgStaWifiMac::CancelDozePeriods (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<EventId>::iterator it = m_dozeEvents.begin (); it != m_dozeEvents.end (); it++)
+    {
+      it->Cancel ();
+    }
+  m_dozeEvents.clear ();
+  WakeUp ();
+}
+
+void
+DmgStaWifiMac::Doze (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* The PHY postpones the sleep until the end of an ongoing transmission or
+   * reception, which we could not cancel when waking up, so skip this period. */
+  if (!m_dozing && (m_phy->IsStateIdle () || m_phy->IsStateCcaBusy ()))
+    {
+      NS_LOG_DEBUG ("Doze until the next allocation");
+      m_dozing = true;
+      m_phy->SetSleepMode ();
+    }
+}
+
+void
+DmgStaWifiMac::WakeUp (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_dozing)
+    {
+      NS_LOG_DEBUG ("Wake up from doze");
+      m_dozing = false;
+      m_phy->ResumeFromSleep ();
+    }
+}
+
 void
 DmgStaWifiMac::InitiateRelayPeriods (RELAY_LINK_INFO &info)
 {
@@ -2540,6 +2781,7 @@ std::cout << "sally test dmgstamac -> Receive, case19, Received DMG Beacon frame
                     {
                       /* Schedule A-BFT following the end of the BTI Period */
                       SetBssid (hdr->GetAddr1 ());
+                      m_abftFastForwardAp = LookupAbftFastForwardAp (hdr->GetAddr1 ());
                       m_slotIndex = 0;
                       m_remainingSlotsPerABFT = m_ssSlotsPerABFT;
                       m_abftEvent = Simulator::Schedule (startTime, &DmgStaWifiMac::StartAssociationBeamformTraining, this);
@@ -2674,6 +2916,8 @@ std::cout << "sally test dmgstamac -> SetState, value=" << value << std::endl;
     }
   else if (value != ASSOCIATED && previousState == ASSOCIATED)
     {
+      /* The doze periods follow the allocations of the BSS we have left */
+      CancelDozePeriods ();
       m_deAssocLogger (GetBssid ());
     }
 }
@@ -19,6 +19,7 @@ namespace ns3  {
 
 class MgtAddBaRequestHeader;
 class UniformRandomVariable;
+class DmgApWifiMac;
 
 typedef enum {
   DIRECT_LINK = 0,
@@ -176,9 +177,21 @@ public:
    * \param elem The DMG TSPEC information element.
    */
   void CreateAllocation (Mac48Address to, DmgTspecElement &elem);
+  /**
+   * Write the state of the DMG STA, including its association.
+   * \param os The output stream.
+   */
+  virtual void SaveSnapshot (std::ostream &os) const;
+  /**
+   * Restore the state written by SaveSnapshot. An associated DMG STA is
+   * associated again and brings its link up.
+   * \param is The input stream.
+   */
+  virtual void RestoreSnapshot (std::istream &is);
 
 protected:
   friend class MultiBandNetDevice;
+  friend class DmgApWifiMac;
 
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
@@ -328,6 +341,27 @@ protected:
    * Relay Operation Timeout.
    */
   void RelayOperationTimeout (void);
+  /**
+   * Schedule the doze periods of the DTI, i.e. the periods outside the SPs
+   * and the CBAPs in which this DMG STA may take part.  This function must be
+   * called before the allocations are scheduled so that the DMG STA wakes up
+   * before the beginning of each allocation.
+   * \param dtiDuration The remaining duration of the DTI.
+   */
+  void ScheduleDozePeriods (Time dtiDuration);
+  /**
+   * Cancel the doze periods scheduled by ScheduleDozePeriods and resume the
+   * PHY if it is dozing.
+   */
+  void CancelDozePeriods (void);
+  /**
+   * Put the PHY in doze (sleep) state if it is not busy.
+   */
+  void Doze (void);
+  /**
+   * Resume the PHY from the doze state.
+   */
+  void WakeUp (void);
 
 private:
   /**
@@ -395,6 +429,33 @@ private:
    * Missed SSW-Feedback from PCP/AP during A-BFT.
    */
   void MissedSswFeedback (void);
+  /**
+   * Find the DMG AP of a BSS if it resolves its A-BFT analytically.
+   * \param bssid The BSSID of the DMG AP.
+   * \return The DMG AP, or 0 if it simulates its A-BFT frame by frame.
+   */
+  Ptr<DmgApWifiMac> LookupAbftFastForwardAp (Mac48Address bssid);
+  /**
+   * Draw the slot of the next RSS attempt in the current A-BFT.
+   * \return The index of the slot in the A-BFT.
+   */
+  uint8_t SelectAbftSlot (void);
+  /**
+   * Account for an RSS attempt which did not get any SSW-FBCK frame.
+   * \return Whether we attempt RSS again in a later slot of the current A-BFT.
+   */
+  bool ReportAbftCollision (void);
+  /**
+   * Start the RSS of an A-BFT resolved analytically by the DMG AP.
+   * \return The best Tx antenna configuration of the DMG AP to feed back.
+   */
+  ANTENNA_CONFIGURATION GetAbftFeedback (void);
+  /**
+   * Complete the RSS in the A-BFT upon the SSW-FBCK of the DMG AP.
+   * \param address The MAC address of the DMG AP.
+   * \param antennaConfigTx Our best Tx antenna configuration towards the DMG AP.
+   */
+  void ReceiveAbftFeedback (Mac48Address address, ANTENNA_CONFIGURATION_TX antennaConfigTx);
   /**
    * Return the DMG capability of the current STA.
    *
@@ -510,6 +571,13 @@ private:
   uint32_t m_rssBackoffRemaining;               //!< Remaining BTIs for the RSS in A-BFT.
   uint32_t m_rssBackoffLimit;                   //!< Maximum RSS Backoff value.
   Ptr<UniformRandomVariable> m_rssBackoffVariable;//!< Random variable for the RSS Backoff value.
+  Ptr<DmgApWifiMac> m_abftFastForwardAp;       //!< The DMG AP resolving the A-BFT analytically, if any.
+  Mac48Address m_abftLookupBssid;               //!< The BSSID for which m_abftFastForwardAp was looked up.
+
+  /* Power Save */
+  bool m_dozeOutsideAllocations;                //!< Flag to indicate whether to doze outside the allocations of the DTI.
+  bool m_dozing;                                //!< Flag to indicate that we put the PHY in doze state.
+  std::vector<EventId> m_dozeEvents;           //!< The Doze and WakeUp events of the current DTI.
 
   /* DMG Relay Support Variables */
   bool m_relayMode;                             //!< Flag to indicate if we are in relay mode (For RDS).
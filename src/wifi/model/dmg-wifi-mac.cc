@@ -9,6 +9,11 @@
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
 #include "ns3/boolean.h"
+#include "ns3/abort.h"
+#include "ns3/packet.h"
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
 
 #include "dmg-wifi-mac.h"
 #include "mgt-headers.h"
@@ -16,6 +21,7 @@
 #include "dcf-manager.h"
 #include "msdu-standard-aggregator.h"
 #include "mpdu-standard-aggregator.h"
+#include "wifi-mac-queue.h"
 
 namespace ns3 {
 
@@ -64,6 +70,15 @@ DmgWifiMac::GetTypeId (void)
     .AddTraceSource ("ServicePeriodEnded", "A service period between two DMG STAs has ended.",
                      MakeTraceSourceAccessor (&DmgWifiMac::m_servicePeriodEndedCallback),
                      "ns3::DmgWifiMac::ServicePeriodTracedCallback")
+    .AddTraceSource ("AllocationStarted",
+                     "An allocation in which the DMG STA may transmit (a CBAP, or a SP "
+                     "the DMG STA is the source of) has started or resumed.",
+                     MakeTraceSourceAccessor (&DmgWifiMac::m_allocationStartedCallback),
+                     "ns3::DmgWifiMac::AllocationStartedCallback")
+    .AddTraceSource ("AllocationEnded",
+                     "An allocation in which the DMG STA may transmit has ended or has been suspended.",
+                     MakeTraceSourceAccessor (&DmgWifiMac::m_allocationEndedCallback),
+                     "ns3::DmgWifiMac::AllocationEndedCallback")
 
     .AddTraceSource ("SLSCompleted", "SLS phase is completed",
                      MakeTraceSourceAccessor (&DmgWifiMac::m_slsCompleted),
@@ -147,6 +162,14 @@ DmgWifiMac::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> stationMa
   RegularWifiMac::SetWifiRemoteStationManager (stationManager);
 }
 
+void
+DmgWifiMac::SetNetDeviceQueueInterface (Ptr<NetDeviceQueueInterface> queueInterface)
+{
+  NS_LOG_FUNCTION (this << queueInterface);
+  m_sp->GetQueue ()->SetNetDeviceQueueInterface (queueInterface);
+  RegularWifiMac::SetNetDeviceQueueInterface (queueInterface);
+}
+
 void
 DmgWifiMac::SetSbifs (Time sbifs)
 {
@@ -295,6 +318,270 @@ DmgWifiMac::SetupBlockAck (uint8_t tid, Mac48Address recipient)
   m_sp->SetupBlockAck (tid, recipient);
 }
 
+void
+DmgWifiMac::SaveSnapshot (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  os << "aids " << m_aidMap.size () << std::endl;
+  for (AID_MAP::const_iterator it = m_aidMap.begin (); it != m_aidMap.end (); it++)
+    {
+      os << it->first << " " << it->second << std::endl;
+    }
+
+  /* The SNR tables, the TX one followed by the RX one */
+  os << "snr " << m_stationSnrMap.size () << std::endl;
+  for (STATION_SNR_PAIR_MAP::const_iterator it = m_stationSnrMap.begin (); it != m_stationSnrMap.end (); it++)
+    {
+      const SNR_MAP *maps[2] = {&it->second.first, &it->second.second};
+      os << it->first;
+      for (uint32_t i = 0; i < 2; i++)
+        {
+          os << " " << maps[i]->size ();
+          for (SNR_MAP::const_iterator snr = maps[i]->begin (); snr != maps[i]->end (); snr++)
+            {
+              os << " " << uint32_t (snr->first.first) << " " << uint32_t (snr->first.second) << " " << snr->second;
+            }
+        }
+      os << std::endl;
+    }
+
+  os << "best " << m_bestAntennaConfig.size () << std::endl;
+  for (STATION_ANTENNA_CONFIG_MAP::const_iterator it = m_bestAntennaConfig.begin (); it != m_bestAntennaConfig.end (); it++)
+    {
+      os << it->first
+         << " " << uint32_t (it->second.first.first) << " " << uint32_t (it->second.first.second)
+         << " " << uint32_t (it->second.second.first) << " " << uint32_t (it->second.second.second) << std::endl;
+    }
+
+  /* Block ack agreements as originator, in CBAPs (EDCA) or in SPs */
+  std::list<std::pair<bool, OriginatorBlockAckAgreement> > originators;
+  for (EdcaQueues::const_iterator it = m_edca.begin (); it != m_edca.end (); it++)
+    {
+      std::list<OriginatorBlockAckAgreement> agreements = it->second->GetBlockAckAgreements ();
+      for (std::list<OriginatorBlockAckAgreement>::const_iterator agreement = agreements.begin ();
+           agreement != agreements.end (); agreement++)
+        {
+          originators.push_back (std::make_pair (false, *agreement));
+        }
+    }
+  std::list<OriginatorBlockAckAgreement> agreements = m_sp->GetBlockAckAgreements ();
+  for (std::list<OriginatorBlockAckAgreement>::const_iterator agreement = agreements.begin ();
+       agreement != agreements.end (); agreement++)
+    {
+      originators.push_back (std::make_pair (true, *agreement));
+    }
+  os << "originators " << originators.size () << std::endl;
+  for (std::list<std::pair<bool, OriginatorBlockAckAgreement> >::const_iterator it = originators.begin ();
+       it != originators.end (); it++)
+    {
+      const OriginatorBlockAckAgreement &agreement = it->second;
+      os << it->first << " " << agreement.GetPeer () << " " << uint32_t (agreement.GetTid ())
+         << " " << agreement.GetBufferSize () << " " << agreement.GetTimeout ()
+         << " " << agreement.IsAmsduSupported () << " " << agreement.IsImmediateBlockAck () << std::endl;
+    }
+
+  /* Block ack agreements as recipient */
+  std::list<BlockAckAgreement> recipients = m_low->GetBlockAckAgreements ();
+  os << "recipients " << recipients.size () << std::endl;
+  for (std::list<BlockAckAgreement>::const_iterator it = recipients.begin (); it != recipients.end (); it++)
+    {
+      os << it->GetPeer () << " " << uint32_t (it->GetTid ())
+         << " " << it->GetBufferSize () << " " << it->GetTimeout ()
+         << " " << it->IsAmsduSupported () << " " << it->IsImmediateBlockAck () << std::endl;
+    }
+
+  /* The information obtained by Information Request frames */
+  os << "information " << m_informationMap.size () << std::endl;
+  for (InformationMap::const_iterator it = m_informationMap.begin (); it != m_informationMap.end (); it++)
+    {
+      WriteSnapshotInformation (os, it->first, it->second);
+    }
+}
+
+void
+DmgWifiMac::RestoreSnapshot (std::istream &is)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n;
+  ReadSnapshotKey (is, "aids");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint16_t aid;
+      is >> aid;
+      MapAidToMacAddress (aid, ReadSnapshotAddress (is));
+    }
+
+  ReadSnapshotKey (is, "snr");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SNR_PAIR &snrPair = m_stationSnrMap[ReadSnapshotAddress (is)];
+      SNR_MAP *maps[2] = {&snrPair.first, &snrPair.second};
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          uint32_t entries, sectorId, antennaId;
+          is >> entries;
+          maps[j]->clear ();
+          for (uint32_t k = 0; k < entries; k++)
+            {
+              double snr;
+              is >> sectorId >> antennaId >> snr;
+              (*maps[j])[std::make_pair (sectorId, antennaId)] = snr;
+            }
+        }
+    }
+
+  ReadSnapshotKey (is, "best");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Mac48Address address = ReadSnapshotAddress (is);
+      uint32_t txSector, txAntenna, rxSector, rxAntenna;
+      is >> txSector >> txAntenna >> rxSector >> rxAntenna;
+      m_bestAntennaConfig[address] = std::make_pair (std::make_pair (txSector, txAntenna),
+                                                     std::make_pair (rxSector, rxAntenna));
+    }
+
+  ReadSnapshotKey (is, "originators");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      bool servicePeriod, amsdu, immediate;
+      uint32_t tid;
+      uint16_t bufferSize, timeout;
+      is >> servicePeriod;
+      Mac48Address recipient = ReadSnapshotAddress (is);
+      is >> tid >> bufferSize >> timeout >> amsdu >> immediate;
+      OriginatorBlockAckAgreement agreement (recipient, tid);
+      agreement.SetBufferSize (bufferSize);
+      agreement.SetTimeout (timeout);
+      agreement.SetAmsduSupport (amsdu);
+      if (immediate)
+        {
+          agreement.SetImmediateBlockAck ();
+        }
+      else
+        {
+          agreement.SetDelayedBlockAck ();
+        }
+      if (servicePeriod)
+        {
+          m_sp->RestoreBlockAckAgreement (agreement);
+        }
+      else
+        {
+          m_edca[QosUtilsMapTidToAc (tid)]->RestoreBlockAckAgreement (agreement);
+        }
+    }
+
+  ReadSnapshotKey (is, "recipients");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      bool amsdu, immediate;
+      uint32_t tid;
+      uint16_t bufferSize, timeout;
+      Mac48Address originator = ReadSnapshotAddress (is);
+      is >> tid >> bufferSize >> timeout >> amsdu >> immediate;
+      MgtAddBaResponseHeader respHdr;
+      respHdr.SetTid (tid);
+      respHdr.SetBufferSize (bufferSize - 1);
+      respHdr.SetTimeout (timeout);
+      respHdr.SetAmsduSupport (amsdu);
+      if (immediate)
+        {
+          respHdr.SetImmediateBlockAck ();
+        }
+      else
+        {
+          respHdr.SetDelayedBlockAck ();
+        }
+      /* The originator has not sent any QoS data frame yet */
+      m_low->CreateBlockAckAgreement (&respHdr, originator, 0);
+    }
+
+  ReadSnapshotKey (is, "information");
+  is >> n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Mac48Address address;
+      StationInformation information = ReadSnapshotInformation (is, address);
+      m_informationMap[address] = information;
+    }
+}
+
+void
+DmgWifiMac::WriteSnapshotInformation (std::ostream &os, Mac48Address address, const StationInformation &information)
+{
+  /* The Information Response frame carries the DMG Capabilities and the
+   * information elements of a DMG STA, and knows how to deserialize them */
+  ExtInformationResponse responseHdr;
+  responseHdr.SetSubjectAddress (address);
+  responseHdr.SetRequestInformationElement (Create<RequestElement> ());
+  responseHdr.AddDmgCapabilitiesElement (information.first);
+  for (WifiInformationElementMap::const_iterator it = information.second.begin (); it != information.second.end (); it++)
+    {
+      /* Lookups of absent elements leave null entries in the map */
+      if (it->second != 0)
+        {
+          responseHdr.AddWifiInformationElement (it->second);
+        }
+    }
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (responseHdr);
+  std::vector<uint8_t> buffer (packet->GetSize ());
+  packet->CopyData (&buffer[0], buffer.size ());
+  std::ostringstream oss;
+  oss << std::hex << std::setfill ('0');
+  for (std::vector<uint8_t>::const_iterator it = buffer.begin (); it != buffer.end (); it++)
+    {
+      oss << std::setw (2) << uint32_t (*it);
+    }
+  os << address << " " << oss.str () << std::endl;
+}
+
+DmgWifiMac::StationInformation
+DmgWifiMac::ReadSnapshotInformation (std::istream &is, Mac48Address &address)
+{
+  address = ReadSnapshotAddress (is);
+  std::string value;
+  is >> value;
+  NS_ABORT_MSG_UNLESS (is && !value.empty () && value.size () % 2 == 0,
+                       "Malformed snapshot: expected information elements, got \"" << value << "\"");
+  std::vector<uint8_t> buffer (value.size () / 2);
+  for (uint32_t i = 0; i < buffer.size (); i++)
+    {
+      buffer[i] = std::strtoul (value.substr (2 * i, 2).c_str (), 0, 16);
+    }
+  Ptr<Packet> packet = Create<Packet> (&buffer[0], static_cast<uint32_t> (buffer.size ()));
+  ExtInformationResponse responseHdr;
+  packet->RemoveHeader (responseHdr);
+  NS_ABORT_MSG_IF (responseHdr.GetDmgCapabilitiesList ().empty (),
+                   "Malformed snapshot: no DMG Capabilities for " << address);
+  StationInformation information;
+  information.first = responseHdr.GetDmgCapabilitiesList ()[0];
+  information.second = responseHdr.GetListOfInformationElement ();
+  return information;
+}
+
+void
+DmgWifiMac::ReadSnapshotKey (std::istream &is, std::string key)
+{
+  std::string value;
+  is >> value;
+  NS_ABORT_MSG_UNLESS (is && value == key, "Malformed snapshot: expected \"" << key << "\", got \"" << value << "\"");
+}
+
+Mac48Address
+DmgWifiMac::ReadSnapshotAddress (std::istream &is)
+{
+  std::string value;
+  is >> value;
+  NS_ABORT_MSG_UNLESS (is && value.size () == 17, "Malformed snapshot: expected a MAC address, got \"" << value << "\"");
+  return Mac48Address (value.c_str ());
+}
+
 ChannelAccessPeriod
 DmgWifiMac::GetCurrentAccessPeriod (void) const
 {
@@ -324,6 +611,7 @@ std::cout << "sally test DmgWifiMac -> StartContentionPeriod, allocationID=" <<
     {
       i->second->InitiateTransmission (allocationID, contentionDuration);
     }
+  m_allocationStartedCallback (contentionDuration);
 }
 
 void
@@ -331,6 +619,7 @@ DmgWifiMac::EndContentionPeriod (void)
 {
   NS_LOG_FUNCTION (this);
 std::cout << "sally test DmgWifiMac -> EndContentionPeriod" << std::endl;
+  m_allocationEndedCallback ();
   m_dcfManager->DisableChannelAccess ();
   /* Signal Management DCA to suspend current transmission */
   m_dca->EndCurrentContentionPeriod ();
@@ -363,6 +652,7 @@ std::cout << "sally test DmgWifiMac -> StartServicePeriod, allocationID=" << all
   m_sp->StartServicePeriod (allocationID, peerAddress, length);
   if (isSource)
     {
+      m_allocationStartedCallback (length);
       m_sp->InitiateTransmission ();
     }
 }
@@ -374,6 +664,10 @@ DmgWifiMac::ResumeServicePeriodTransmission (void)
 std::cout << "sally test DmgWifiMac -> ResumeServicePeriodTransmission" << std::endl;
   NS_ASSERT (m_currentAllocation == SERVICE_PERIOD_ALLOCATION);
   m_currentAllocationLength = GetRemainingAllocationTime ();
+  if (m_spSource)
+    {
+      m_allocationStartedCallback (m_currentAllocationLength);
+    }
   m_sp->ResumeTransmission (m_currentAllocationLength);
 }
 
@@ -383,6 +677,10 @@ DmgWifiMac::SuspendServicePeriodTransmission (void)
   NS_LOG_FUNCTION (this);
 std::cout << "sally test DmgWifiMac -> SuspendServicePeriodTransmission" << std::endl;
   NS_ASSERT (m_currentAllocation == SERVICE_PERIOD_ALLOCATION);
+  if (m_spSource)
+    {
+      m_allocationEndedCallback ();
+    }
   m_sp->DisableChannelAccess ();
   m_suspendedPeriodDuration = GetRemainingAllocationTime ();
 }
@@ -394,6 +692,10 @@ DmgWifiMac::EndServicePeriod (void)
 std::cout << "sally test DmgWifiMac -> EndServicePeriod" << std::endl;
   NS_ASSERT (m_currentAllocation == SERVICE_PERIOD_ALLOCATION);
   m_servicePeriodEndedCallback (GetAddress (), m_peerStationAddress);
+  if (m_spSource)
+    {
+      m_allocationEndedCallback ();
+    }
   m_sp->DisableChannelAccess ();
   m_sp->EndCurrentServicePeriod ();
 }
@@ -1062,7 +1364,7 @@ DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool
 DmgWifiMac::ANTENNA_CONFIGURATION
 DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool isTxConfiguration, double &maxSnr)
 {
-std::cout << "sally test DmgWifiMac -> GetBestAntennaConfiguration, stationAddress=" << stationAddress << ", isTxConfiguration=" << isTxConfiguration << ", maxSnr=" << maxSnr << std::endl;
+  NS_LOG_FUNCTION (this << stationAddress << isTxConfiguration);
   SNR_PAIR snrPair = m_stationSnrMap [stationAddress];
   SNR_MAP snrMap;
   if (isTxConfiguration)
@@ -1073,6 +1375,7 @@ std::cout << "sally test DmgWifiMac -> GetBestAntennaConfiguration, stationAddre
     {
       snrMap = snrPair.second;
     }
+  NS_ASSERT_MSG (!snrMap.empty (), "No SNR recorded for " << stationAddress);
 
   SNR_MAP::iterator highIter = snrMap.begin ();
   SNR snr = highIter->second;
@@ -1082,10 +1385,13 @@ std::cout << "sally test DmgWifiMac -> GetBestAntennaConfiguration, stationAddre
         {
           highIter = iter;
           snr = highIter->second;
-          maxSnr = snr;
         }
     }
-std::cout << "sally test DmgWifiMac -> GetBestAntennaConfiguration, maxSnr=" << maxSnr << std::endl;
+  maxSnr = snr;
+
+  /* The best configuration is looked up once the sector sweep or the TRN
+     fields have been received, so this SNR estimates the trained link. */
+  m_stationManager->ReportBeamformingSnr (stationAddress, maxSnr);
   return highIter->first;
 }
 
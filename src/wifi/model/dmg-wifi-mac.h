@@ -9,6 +9,8 @@
 #include "regular-wifi-mac.h"
 #include "dmg-ati-dca.h"
 #include "dmg-capabilities.h"
+#include <istream>
+#include <ostream>
 
 namespace ns3 {
 
@@ -79,6 +81,10 @@ public:
    * \param stationManager the station manager attached to this MAC.
    */
   virtual void SetWifiRemoteStationManager(Ptr<WifiRemoteStationManager> stationManager);
+  /**
+   * \param queueInterface the NetDeviceQueueInterface of the device
+   */
+  virtual void SetNetDeviceQueueInterface (Ptr<NetDeviceQueueInterface> queueInterface);
   /**
    * Steer the directional antenna towards specific station.
    * \param address The MAC address of the peer station.
@@ -88,6 +94,21 @@ public:
   /* Temporary Function to store AID mapping */
   void MapAidToMacAddress (uint16_t aid, Mac48Address address);
   void SetupBlockAck (uint8_t tid, Mac48Address recipient);
+  /**
+   * Write the state set up by the association, the beamforming training,
+   * the block ack negotiations and the Information Response frames
+   * received by this DMG STA, to restore it in another simulation of the
+   * same network.
+   * \param os The output stream.
+   */
+  virtual void SaveSnapshot (std::ostream &os) const;
+  /**
+   * Restore the state written by SaveSnapshot. It must be called before
+   * any frame is exchanged, as the block ack windows restart at the first
+   * sequence number.
+   * \param is The input stream.
+   */
+  virtual void RestoreSnapshot (std::istream &is);
 
 protected:
   friend class MacLow;
@@ -211,6 +232,17 @@ protected:
    * This function is called by dervied call to notify that BRP Phase has completed.
    */
   virtual void NotifyBrpPhaseCompleted (void) = 0;
+  /**
+   * Read the next key of a snapshot, aborting if it is not the one expected.
+   * \param is The input stream.
+   * \param key The expected key.
+   */
+  static void ReadSnapshotKey (std::istream &is, std::string key);
+  /**
+   * \param is The input stream.
+   * \return The next MAC address of a snapshot.
+   */
+  static Mac48Address ReadSnapshotAddress (std::istream &is);
 
   /* Typedefs for Recording SNR Value per Antenna Configuration */
   typedef double SNR;                                                   /* Typedef SNR */
@@ -403,6 +435,22 @@ protected:
   typedef InformationMap::iterator InformationMapIterator;
   InformationMap m_informationMap;
 
+  /**
+   * Write the information elements known about a DMG STA, serialized as the
+   * body of an Information Response frame in hexadecimal.
+   * \param os The output stream.
+   * \param address The MAC address of the DMG STA.
+   * \param information The DMG Capabilities and the information elements of the DMG STA.
+   */
+  static void WriteSnapshotInformation (std::ostream &os, Mac48Address address, const StationInformation &information);
+  /**
+   * Read the information elements written by WriteSnapshotInformation.
+   * \param is The input stream.
+   * \param address Set to the MAC address of the DMG STA.
+   * \return The DMG Capabilities and the information elements of the DMG STA.
+   */
+  static StationInformation ReadSnapshotInformation (std::istream &is, Mac48Address &address);
+
   /* DMG Parameteres */
   bool m_isCbapOnly;                            //!< Flag to indicate whether the DTI is allocated to CBAP.
   bool m_isCbapSource;                          //!< Flag to indicate that PCP/AP has higher priority for transmission.
@@ -448,6 +496,21 @@ protected:
   TracedCallback<Mac48Address, Mac48Address> m_servicePeriodStartedCallback;
   TracedCallback<Mac48Address, Mac48Address> m_servicePeriodEndedCallback;
 
+  /**
+   * TracedCallback signature for the start of an allocation in which the
+   * station may transmit.
+   *
+   * \param duration The duration of the allocation.
+   */
+  typedef void (* AllocationStartedCallback)(Time duration);
+  TracedCallback<Time> m_allocationStartedCallback;
+  /**
+   * TracedCallback signature for the end or the suspension of an allocation
+   * in which the station may transmit.
+   */
+  typedef void (* AllocationEndedCallback)(void);
+  TracedCallback<> m_allocationEndedCallback;
+
 private:
   /**
    * This function is called upon transmission of a 802.11 Management frame.
@@ -349,6 +349,20 @@ EdcaTxopN::CopyBlockAckAgreements (Mac48Address recipient, Ptr<EdcaTxopN> target
   m_baManager->CopyAgreements (recipient, target->m_baManager);
 }
 
+std::list<OriginatorBlockAckAgreement>
+EdcaTxopN::GetBlockAckAgreements (void) const
+{
+  return m_baManager->GetEstablishedAgreements ();
+}
+
+void
+EdcaTxopN::RestoreBlockAckAgreement (OriginatorBlockAckAgreement agreement)
+{
+  NS_LOG_FUNCTION (this << agreement.GetPeer () << static_cast<uint32_t> (agreement.GetTid ()));
+  agreement.SetStartingSequence (m_txMiddle->GetNextSeqNumberByTidAndAddress (agreement.GetTid (), agreement.GetPeer ()));
+  m_baManager->RestoreAgreement (agreement);
+}
+
 void
 EdcaTxopN::SetManager (DcfManager *manager)
 {
@@ -203,6 +203,16 @@ public:
    * \param target
    */
   void CopyBlockAckAgreements (Mac48Address recipient, Ptr<EdcaTxopN> target);
+  /**
+   * \return the block ack agreements established as originator.
+   */
+  std::list<OriginatorBlockAckAgreement> GetBlockAckAgreements (void) const;
+  /**
+   * Establish a block ack agreement without the ADDBA handshake. The window
+   * starts at the next sequence number towards the recipient.
+   * \param agreement the agreement.
+   */
+  void RestoreBlockAckAgreement (OriginatorBlockAckAgreement agreement);
 
   /* dcf notifications forwarded here */
   /**
@@ -24,6 +24,7 @@
 #include "error-rate-model.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
 #include <algorithm>
 
 namespace ns3 {
@@ -34,6 +35,31 @@ NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
  *       Phy event class
  ****************************************************************/
 
+/// Memory accounting category of the events, created on first use.
+static uint32_t g_eventCategory = 0;
+/// Whether g_eventCategory was created.
+static bool g_eventCategoryCreated = false;
+
+/**
+ * Account the creation of an event if memory accounting is enabled.
+ * \return true if the event was accounted
+ */
+static bool
+NotifyEventCreated (void)
+{
+  if (MemoryAccounting::IsEnabled ())
+    {
+      if (!g_eventCategoryCreated)
+        {
+          g_eventCategory = MemoryAccounting::GetCategory ("ns3::InterferenceHelper::Event");
+          g_eventCategoryCreated = true;
+        }
+      MemoryAccounting::NotifyAllocation (g_eventCategory, sizeof (InterferenceHelper::Event));
+      return true;
+    }
+  return false;
+}
+
 InterferenceHelper::Event::Event (uint32_t size, WifiTxVector txVector,
                                   enum WifiPreamble preamble,
                                   Time duration, double rxPower)
@@ -44,6 +70,7 @@ InterferenceHelper::Event::Event (uint32_t size, WifiTxVector txVector,
     m_endTime (m_startTime + duration),
     m_rxPowerW (rxPower)
 {
+  m_accounted = NotifyEventCreated ();
 }
 
 InterferenceHelper::Event::Event (WifiTxVector txVector,
@@ -56,10 +83,15 @@ InterferenceHelper::Event::Event (WifiTxVector txVector,
     m_endTime (m_startTime + duration),
     m_rxPowerW (rxPower)
 {
+  m_accounted = NotifyEventCreated ();
 }
 
 InterferenceHelper::Event::~Event ()
 {
+  if (m_accounted)
+    {
+      MemoryAccounting::NotifyDeallocation (g_eventCategory, sizeof (InterferenceHelper::Event));
+    }
 }
 
 Time
@@ -287,14 +319,20 @@ std::cout << "sally test AppendEvent in rx state" << std::endl;
 
 
 double
-InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint32_t channelWidth) const
+InterferenceHelper::GetNoiseFloorW (uint32_t channelWidth) const
 {
   //thermal noise at 290K in J/s = W
   static const double BOLTZMANN = 1.3803e-23;
   //Nt is the power of thermal noise in W
   double Nt = BOLTZMANN * 290.0 * channelWidth * 1000000;
   //receiver noise Floor (W) which accounts for thermal noise and non-idealities of the receiver
-  double noiseFloor = m_noiseFigure * Nt;
+  return m_noiseFigure * Nt;
+}
+
+double
+InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint32_t channelWidth) const
+{
+  double noiseFloor = GetNoiseFloorW (channelWidth);
   if (noiseInterference < 0) noiseInterference = -noiseInterference;  //sally add
   double noise = noiseFloor + noiseInterference;
   double snr = signal / noise; //linear scale
@@ -896,18 +934,23 @@ std::cout << "sally test noiseInterference20: " << noiseInterferenceW << " delta
   return per;
 }
 
-double
-InterferenceHelper::CalculatePlcpTrnSnr (Ptr<InterferenceHelper::Event> event)
+std::vector<double>
+InterferenceHelper::CalculatePlcpTrnSnrs (Ptr<InterferenceHelper::Event> event, const std::vector<double> &rxPowersW)
 {
-  NS_LOG_FUNCTION (this << event);
+  NS_LOG_FUNCTION (this << event << rxPowersW.size ());
   NiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
 std::cout << "sally test noiseInterference8: " << noiseInterferenceW << std::endl;
 
-  double snr = CalculateSnr (event->GetRxPowerW (),
-                             noiseInterferenceW,
-                             event->GetTxVector ().GetChannelWidth ());
-  return snr;
+  std::vector<double> snrs;
+  snrs.reserve (rxPowersW.size ());
+  for (std::vector<double>::const_iterator it = rxPowersW.begin (); it != rxPowersW.end (); it++)
+    {
+      snrs.push_back (CalculateSnr (*it,
+                                    noiseInterferenceW,
+                                    event->GetTxVector ().GetChannelWidth ()));
+    }
+  return snrs;
 }
 
 struct InterferenceHelper::SnrPer
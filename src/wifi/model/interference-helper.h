@@ -127,6 +127,7 @@ private:
     Time m_startTime;
     Time m_endTime;
     double m_rxPowerW;
+    bool m_accounted;
   };
 
   /**
@@ -160,6 +161,15 @@ private:
    * \return the noise figure
    */
   double GetNoiseFigure (void) const;
+  /**
+   * Return the receiver noise floor: the thermal noise at 290 K in the
+   * channel, raised by the noise figure.
+   *
+   * \param channelWidth the channel width (MHz)
+   *
+   * \return the noise floor (W)
+   */
+  double GetNoiseFloorW (uint32_t channelWidth) const;
   /**
    * Return the error rate model.
    *
@@ -208,14 +218,16 @@ private:
    */
   void AddForeignSignal (Time duration, double rxPower);
   /**
-   * Calculate the SNIR at the start of the TRN fields and accumulate
-   * all SNIR changes in the snir vector.
+   * Calculate the SNIR of each TRN field of a sequence received as a
+   * single event, the noise and interference being computed only once
+   * for the whole sequence.
    *
-   * \param event the event corresponding to the first time the corresponding packet arrives
+   * \param event the event corresponding to the reception of the TRN fields
+   * \param rxPowersW the received power of each TRN field (W)
    *
-   * \return Signal to Noise Ratio.
+   * \return the Signal to Noise Ratio of each TRN field.
    */
-  double CalculatePlcpTrnSnr (Ptr<InterferenceHelper::Event> event);
+  std::vector<double> CalculatePlcpTrnSnrs (Ptr<InterferenceHelper::Event> event, const std::vector<double> &rxPowersW);
   /**
    * Calculate the SNIR at the start of the plcp payload and accumulate
    * all SNIR changes in the snir vector.
@@ -409,6 +409,7 @@ MacLow::MacLow ()
     m_ampdu (false),
     m_phyMacLowListener (0),
     m_ctsToSelfSupported (false),
+    m_rxAmpduBatching (false),
     m_sentMpdus (0),
     m_nTxMpdus (0),
     m_mac (0),
@@ -473,6 +474,8 @@ MacLow::DoDispose (void)
   m_waitSifsEvent.Cancel ();
   m_endTxNoAckEvent.Cancel ();
   m_waitRifsEvent.Cancel ();
+  m_rxAmpduBatchEvent.Cancel ();
+  m_rxAmpduBatch.clear ();
   m_phy = 0;
   m_stationManager = 0;
   if (m_phyMacLowListener != 0)
@@ -623,6 +626,19 @@ MacLow::GetCtsToSelfSupported () const
   return m_ctsToSelfSupported;
 }
 
+void
+MacLow::SetRxAmpduBatching (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_rxAmpduBatching = enable;
+}
+
+bool
+MacLow::GetRxAmpduBatching () const
+{
+  return m_rxAmpduBatching;
+}
+
 void
 MacLow::SetCtsTimeout (Time ctsTimeout)
 {
@@ -1485,7 +1501,7 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, Wifi
 rxPacket:
   WifiMacTrailer fcs;
   packet->RemoveTrailer (fcs);
-  m_rxCallback (packet, &hdr);
+  ForwardUp (packet, hdr);
   return;
 }
 
@@ -2992,6 +3008,17 @@ MacLow::CreateBlockAckAgreement (const MgtAddBaResponseHeader *respHdr, Mac48Add
     }
 }
 
+std::list<BlockAckAgreement>
+MacLow::GetBlockAckAgreements (void) const
+{
+  std::list<BlockAckAgreement> agreements;
+  for (Agreements::const_iterator it = m_bAckAgreements.begin (); it != m_bAckAgreements.end (); it++)
+    {
+      agreements.push_back (it->second.first);
+    }
+  return agreements;
+}
+
 void
 MacLow::DestroyBlockAckAgreement (Mac48Address originator, uint8_t tid)
 {
@@ -3033,10 +3060,10 @@ MacLow::RxCompleteBufferedPacketsWithSmallerSequence (uint16_t seq, Mac48Address
                 {
                   while (last != i)
                     {
-                      m_rxCallback ((*last).first, &(*last).second);
+                      ForwardUp ((*last).first, (*last).second);
                       last++;
                     }
-                  m_rxCallback ((*last).first, &(*last).second);
+                  ForwardUp ((*last).first, (*last).second);
                   last++;
                   /* go to next packet */
                   while (i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl ())
@@ -3088,10 +3115,10 @@ MacLow::RxCompleteBufferedPacketsUntilFirstLost (Mac48Address originator, uint8_
             {
               while (lastComplete != i)
                 {
-                  m_rxCallback ((*lastComplete).first, &(*lastComplete).second);
+                  ForwardUp ((*lastComplete).first, (*lastComplete).second);
                   lastComplete++;
                 }
-              m_rxCallback ((*lastComplete).first, &(*lastComplete).second);
+              ForwardUp ((*lastComplete).first, (*lastComplete).second);
               lastComplete++;
             }
           guard = (*i).second.IsMoreFragments () ? (guard + 1) : ((guard + 16) & 0xfff0);
@@ -3307,6 +3334,12 @@ MacLow::DeaggregateAmpduAndReceive (Ptr<Packet> aggregatedPacket, double rxSnr,
   if (aggregatedPacket->RemovePacketTag (ampdu))
     {
       ampduSubframe = true;
+      if (m_rxAmpduBatching)
+        { // The MPDUs are held until the end of the A-MPDU, even if its last MPDUs are lost
+          m_rxAmpduBatchEvent.Cancel ();
+          m_rxAmpduBatchEvent = Simulator::Schedule (ampdu.GetRemainingAmpduDuration (),
+                                                     &MacLow::FlushRxAmpduBatch, this);
+        }
       MpduAggregator::DeaggregatedMpdus packets = MpduAggregator::Deaggregate (aggregatedPacket);
       MpduAggregator::DeaggregatedMpdusCI n = packets.begin ();
 
@@ -3379,6 +3412,10 @@ MacLow::DeaggregateAmpduAndReceive (Ptr<Packet> aggregatedPacket, double rxSnr,
                 }
             }
         }
+      if (ampdu.GetRemainingNbOfMpdus () == 0)
+        {
+          FlushRxAmpduBatch ();
+        }
     }
   else
     {
@@ -3386,6 +3423,33 @@ MacLow::DeaggregateAmpduAndReceive (Ptr<Packet> aggregatedPacket, double rxSnr,
     }
 }
 
+void
+MacLow::ForwardUp (Ptr<Packet> packet, const WifiMacHeader &hdr)
+{
+  NS_LOG_FUNCTION (this << packet << &hdr);
+  if (m_rxAmpduBatchEvent.IsRunning ())
+    {
+      m_rxAmpduBatch.push_back (std::make_pair (packet, hdr));
+    }
+  else
+    {
+      m_rxCallback (packet, &hdr);
+    }
+}
+
+void
+MacLow::FlushRxAmpduBatch (void)
+{
+  NS_LOG_FUNCTION (this << m_rxAmpduBatch.size ());
+  m_rxAmpduBatchEvent.Cancel ();
+  std::list<std::pair<Ptr<Packet>, WifiMacHeader> > batch;
+  batch.swap (m_rxAmpduBatch);
+  for (std::list<std::pair<Ptr<Packet>, WifiMacHeader> >::iterator it = batch.begin (); it != batch.end (); ++it)
+    {
+      m_rxCallback (it->first, &it->second);
+    }
+}
+
 bool
 MacLow::StopMpduAggregation (Ptr<const Packet> peekedPacket, WifiMacHeader peekedHdr, Ptr<Packet> aggregatedPacket, uint16_t size) const
 {
@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <ostream>
 #include <map>
+#include <list>
 
 #include "wifi-mode.h"
 #include "wifi-phy.h"
@@ -576,6 +577,14 @@ public:
    * \param enable Enable or disable CTS-to-self capability
    */
   void SetCtsToSelfSupported (bool enable);
+  /**
+   * Enable or disable the batching of the MPDUs received in an A-MPDU.
+   * When enabled, the MPDUs received in an A-MPDU are passed up together
+   * at the end of the A-MPDU, so that the upper layers may coalesce them.
+   *
+   * \param enable Enable or disable the batching of the received MPDUs
+   */
+  void SetRxAmpduBatching (bool enable);
   /**
    * Set CTS timeout of this MacLow.
    *
@@ -646,6 +655,12 @@ public:
    * \return true if CTS-to-self is supported, false otherwise
    */
   bool GetCtsToSelfSupported () const;
+  /**
+   * Return whether the MPDUs received in an A-MPDU are passed up together.
+   *
+   * \return true if the received MPDUs are batched, false otherwise
+   */
+  bool GetRxAmpduBatching () const;
   /**
    * Return the MAC address of this MacLow.
    *
@@ -902,6 +917,10 @@ public:
    * invoked when a DELBA frame is received from <i>originator</i>.
    */
   void DestroyBlockAckAgreement (Mac48Address originator, uint8_t tid);
+  /**
+   * \return the block ack agreements established as recipient.
+   */
+  std::list<BlockAckAgreement> GetBlockAckAgreements (void) const;
   /**
    * \param ac Access class managed by the queue.
    * \param listener The listener for the queue.
@@ -1377,6 +1396,18 @@ private:
    * See section 9.10.4 in IEEE 802.11 standard for more details.
    */
   void RxCompleteBufferedPacketsUntilFirstLost (Mac48Address originator, uint8_t tid);
+  /**
+   * Pass a received MPDU up to WifiMac, or hold it until the end of the
+   * A-MPDU being received if the received MPDUs are batched.
+   *
+   * \param packet the MPDU, without MAC header
+   * \param hdr the MAC header of the MPDU
+   */
+  void ForwardUp (Ptr<Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * Pass up the MPDUs held since the start of the A-MPDU being received.
+   */
+  void FlushRxAmpduBatch (void);
   /**
    * \param seq MPDU sequence number
    * \param winstart sequence number window start
@@ -1563,6 +1594,9 @@ private:
   typedef std::map<AcIndex, MacLowAggregationCapableTransmissionListener*> QueueListeners;
   QueueListeners m_edcaListeners;
   bool m_ctsToSelfSupported;          //!< Flag whether CTS-to-self is supported
+  bool m_rxAmpduBatching;             //!< Flag whether the MPDUs received in an A-MPDU are passed up together
+  std::list<std::pair<Ptr<Packet>, WifiMacHeader> > m_rxAmpduBatch; //!< MPDUs held until the end of the A-MPDU
+  EventId m_rxAmpduBatchEvent;        //!< Event passing up the MPDUs held at the end of the A-MPDU
   uint8_t m_sentMpdus;                //!< Number of transmitted MPDUs in an A-MPDU that have not been acknowledged yet
   Ptr<WifiMacQueue> m_aggregateQueue; //!< Queue used for MPDU aggregation
   WifiTxVector m_currentTxVector;     //!< TXVECTOR used for the current packet transmission
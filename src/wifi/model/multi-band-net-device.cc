@@ -153,6 +153,15 @@ MultiBandNetDevice::NotifyNewAggregate (void)
                       m_queueInterface->SetSelectQueueCallback (MakeCallback (&MultiBandNetDevice::SelectQueue, this));
                     }
                 }
+              // report the bytes queued in the MACs of all the technologies to the device queues
+              for (WifiTechnologyList::iterator item = m_list.begin (); item != m_list.end (); item++)
+                {
+                  Ptr<RegularWifiMac> technologyMac = DynamicCast<RegularWifiMac> (item->second.Mac);
+                  if (technologyMac != 0)
+                    {
+                      technologyMac->SetNetDeviceQueueInterface (m_queueInterface);
+                    }
+                }
             }
         }
     }
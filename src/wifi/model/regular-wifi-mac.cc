@@ -34,6 +34,7 @@
 #include "wifi-phy.h"
 #include "msdu-standard-aggregator.h"
 #include "mpdu-standard-aggregator.h"
+#include "wifi-mac-queue.h"
 #include "ns3/simulator.h"
 
 namespace ns3 {
@@ -193,6 +194,17 @@ RegularWifiMac::GetWifiRemoteStationManager () const
   return m_stationManager;
 }
 
+void
+RegularWifiMac::SetNetDeviceQueueInterface (Ptr<NetDeviceQueueInterface> queueInterface)
+{
+  NS_LOG_FUNCTION (this << queueInterface);
+  m_dca->GetQueue ()->SetNetDeviceQueueInterface (queueInterface);
+  for (EdcaQueues::iterator i = m_edca.begin (); i != m_edca.end (); ++i)
+    {
+      i->second->GetEdcaQueue ()->SetNetDeviceQueueInterface (queueInterface);
+    }
+}
+
 Ptr<HtCapabilities>
 RegularWifiMac::GetHtCapabilities (void) const
 {
@@ -638,6 +650,13 @@ RegularWifiMac::GetCtsToSelfSupported () const
   return m_low->GetCtsToSelfSupported ();
 }
 
+void
+RegularWifiMac::SetRxAmpduBatching (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_low->SetRxAmpduBatching (enable);
+}
+
 void
 RegularWifiMac::SetSlot (Time slotTime)
 {
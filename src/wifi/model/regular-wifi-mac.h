@@ -165,6 +165,14 @@ public:
    *         false otherwise.
    */
   bool GetCtsToSelfSupported () const;
+  /**
+   * Enable or disable the batching of the MPDUs received in an A-MPDU,
+   * which are then passed up together at the end of the A-MPDU.
+   *
+   * \param enable true if the received MPDUs are to be batched,
+   *               false otherwise
+   */
+  void SetRxAmpduBatching (bool enable);
 
   /**
    * Enable or disable short slot time feature.
@@ -262,6 +270,13 @@ public:
    * \return the station manager attached to this MAC.
    */
   virtual Ptr<WifiRemoteStationManager> GetWifiRemoteStationManager (void) const;
+  /**
+   * Report the bytes of the data frames queued by this MAC to the device
+   * transmission queues.
+   *
+   * \param queueInterface the NetDeviceQueueInterface of the device
+   */
+  virtual void SetNetDeviceQueueInterface (Ptr<NetDeviceQueueInterface> queueInterface);
   /**
    * Return the HT capability of the device.
    *
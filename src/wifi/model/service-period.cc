@@ -242,6 +242,20 @@ ServicePeriod::GetBaAgreementExists (Mac48Address address, uint8_t tid)
   return m_baManager->ExistsAgreement (address, tid);
 }
 
+std::list<OriginatorBlockAckAgreement>
+ServicePeriod::GetBlockAckAgreements (void) const
+{
+  return m_baManager->GetEstablishedAgreements ();
+}
+
+void
+ServicePeriod::RestoreBlockAckAgreement (OriginatorBlockAckAgreement agreement)
+{
+  NS_LOG_FUNCTION (this << agreement.GetPeer () << static_cast<uint32_t> (agreement.GetTid ()));
+  agreement.SetStartingSequence (m_txMiddle->GetNextSeqNumberByTidAndAddress (agreement.GetTid (), agreement.GetPeer ()));
+  m_baManager->RestoreAgreement (agreement);
+}
+
 uint32_t
 ServicePeriod::GetNOutstandingPacketsInBa (Mac48Address address, uint8_t tid)
 {
@@ -155,6 +155,16 @@ public:
    * of an A-MPDU with ImmediateBlockAck policy (i.e. no BAR is scheduled)
    */
   void CompleteAmpduTransfer (Mac48Address recipient, uint8_t tid);
+  /**
+   * \return the block ack agreements established as originator.
+   */
+  std::list<OriginatorBlockAckAgreement> GetBlockAckAgreements (void) const;
+  /**
+   * Establish a block ack agreement without the ADDBA handshake. The window
+   * starts at the next sequence number towards the recipient.
+   * \param agreement the agreement.
+   */
+  void RestoreBlockAckAgreement (OriginatorBlockAckAgreement agreement);
 
   /**
    * Check if the EDCAF requires access.
@@ -80,6 +80,8 @@ SpectrumWifiPhy::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_channel = 0;
   m_wifiSpectrumPhyInterface = 0;
+  m_txDirectionalAntennaModel = 0;
+  m_rxDirectionalAntennaModel = 0;
 }
 
 void
@@ -517,6 +519,7 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
 
           NS_LOG_DEBUG ("sync to signal (power=" << rxPowerW << "W)");
           //sync to signal
+          NotifyRxSync (packet, txVector);
           m_state->SwitchToRx (rxDuration);
           NS_ASSERT (m_endPlcpRxEvent.IsExpired ());
           NotifyRxBegin (packet);
@@ -602,9 +605,25 @@ SpectrumWifiPhy::GetSpectrumPhy (void) const
 Ptr<AntennaModel>
 SpectrumWifiPhy::GetRxAntenna (void) const
 {
+  if (m_antenna == 0 && GetDirectionalAntenna () != 0)
+    {
+      return GetDirectionalAntennaModel (false);
+    }
   return m_antenna;
 }
 
+Ptr<AntennaModel>
+SpectrumWifiPhy::GetDirectionalAntennaModel (bool transmit) const
+{
+  Ptr<DirectionalAntennaModel> &model = transmit ? m_txDirectionalAntennaModel : m_rxDirectionalAntennaModel;
+  if (model == 0 || model->GetDirectionalAntenna () != GetDirectionalAntenna ())
+    {
+      model = CreateObject<DirectionalAntennaModel> ();
+      model->SetDirectionalAntenna (GetDirectionalAntenna (), transmit);
+    }
+  return model;
+}
+
 void
 SpectrumWifiPhy::SetAntenna (Ptr<AntennaModel> a)
 {
@@ -628,9 +647,10 @@ SpectrumWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, Wi
 }
 
 Ptr<SpectrumValue>
-SpectrumWifiPhy::GetTxPowerSpectralDensity (uint32_t centerFrequency, uint32_t channelWidth, double txPowerW) const
+SpectrumWifiPhy::GetTxPowerSpectralDensity (uint32_t centerFrequency, uint32_t channelWidth, double txPowerW,
+                                            WifiModulationClass modulationClass) const
 {
-  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW);
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << modulationClass);
   Ptr<SpectrumValue> v;
   switch (GetStandard ())
     {
@@ -649,6 +669,16 @@ SpectrumWifiPhy::GetTxPowerSpectralDensity (uint32_t centerFrequency, uint32_t c
     case WIFI_PHY_STANDARD_80211ac:
       v = WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW);
       break;
+    case WIFI_PHY_STANDARD_80211ad:
+      if (modulationClass == WIFI_MOD_CLASS_DMG_OFDM)
+        {
+          v = WifiSpectrumValueHelper::CreateDmgOfdmTxPowerSpectralDensity (centerFrequency, txPowerW);
+        }
+      else
+        {
+          v = WifiSpectrumValueHelper::CreateDmgScTxPowerSpectralDensity (centerFrequency, txPowerW);
+        }
+      break;
     default:
       NS_FATAL_ERROR ("Standard unknown: " << GetStandard ());
       break;
@@ -718,13 +748,18 @@ SpectrumWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, Wi
   NS_LOG_DEBUG ("Transmission signal power before antenna gain: " << GetPowerDbm (txVector.GetTxPowerLevel ()) << " dBm");
   double txPowerWatts = DbmToW (GetPowerDbm (txVector.GetTxPowerLevel ()) + GetTxGain ());
 
-  Ptr<SpectrumValue> txPowerSpectrum = GetTxPowerSpectralDensity (GetFrequency (), GetChannelWidth (), txPowerWatts);
+  Ptr<SpectrumValue> txPowerSpectrum = GetTxPowerSpectralDensity (GetFrequency (), GetChannelWidth (), txPowerWatts,
+                                                                  txVector.GetMode ().GetModulationClass ());
   Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
   txParams->duration = txDuration;
   txParams->psd = txPowerSpectrum;
   NS_ASSERT_MSG (m_wifiSpectrumPhyInterface, "SpectrumPhy() is not set; maybe forgot to call CreateWifiSpectrumPhyInterface?");
   txParams->txPhy = m_wifiSpectrumPhyInterface->GetObject<SpectrumPhy> ();
   txParams->txAntenna = m_antenna;
+  if (m_antenna == 0 && GetDirectionalAntenna () != 0)
+    {
+      txParams->txAntenna = GetDirectionalAntennaModel (true);
+    }
   txParams->packet = newPacket;
   NS_LOG_DEBUG ("Starting transmission with power " << WToDbm (txPowerWatts) << " dBm on channel " << GetChannelNumber ());
   NS_LOG_DEBUG ("Starting transmission with integrated spectrum power " << WToDbm (Integral (*txPowerSpectrum)) << " dBm; spectrum model Uid: " << txPowerSpectrum->GetSpectrumModel ()->GetUid ());
@@ -29,6 +29,7 @@
 #include "ns3/antenna-model.h"
 #include "wifi-phy.h"
 #include "wifi-spectrum-phy-interface.h"
+#include "directional-antenna-model.h"
 #include "ns3/spectrum-channel.h"
 #include "ns3/spectrum-interference.h"
 
@@ -218,18 +219,28 @@ private:
    * \param centerFrequency center frequency (MHz)
    * \param channelWidth channel width (MHz) of the channel
    * \param txPowerW power in W to spread across the bands
+   * \param modulationClass the modulation class of the transmission
    * \return Ptr to SpectrumValue
    *
    * This is a helper function to create the right Tx PSD corresponding
-   * to the standard in use.
+   * to the standard in use and, for DMG, to the PHY (SC or OFDM).
    */
-  Ptr<SpectrumValue> GetTxPowerSpectralDensity (uint32_t centerFrequency, uint32_t channelWidth, double txPowerW) const;
+  Ptr<SpectrumValue> GetTxPowerSpectralDensity (uint32_t centerFrequency, uint32_t channelWidth, double txPowerW,
+                                                WifiModulationClass modulationClass) const;
+  /**
+   * \param transmit whether the transmit or the receive pattern is requested
+   * \return the AntennaModel reporting the gains of the directional antenna
+   * of the DMG PHY to the spectrum channel
+   */
+  Ptr<AntennaModel> GetDirectionalAntennaModel (bool transmit) const;
 
   Ptr<SpectrumChannel> m_channel;        //!< SpectrumChannel that this SpectrumWifiPhy is connected to
   std::vector<uint16_t> m_operationalChannelList; //!< List of possible channels
 
   Ptr<WifiSpectrumPhyInterface> m_wifiSpectrumPhyInterface;
   Ptr<AntennaModel> m_antenna;
+  mutable Ptr<DirectionalAntennaModel> m_txDirectionalAntennaModel; //!< Transmit gains of the directional antenna
+  mutable Ptr<DirectionalAntennaModel> m_rxDirectionalAntennaModel; //!< Receive gains of the directional antenna
   mutable Ptr<const SpectrumModel> m_rxSpectrumModel;
   RxCallback m_rxCallback;
   bool m_disableWifiReception;          //!< forces this Phy to fail to sync on any signal
@@ -25,8 +25,12 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/enum.h"
+#include "ns3/gso-tag.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/queue-limits.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
+#include "qos-utils.h"
 
 namespace ns3 {
 
@@ -82,6 +86,8 @@ WifiMacQueue::WifiMacQueue ()
 
 WifiMacQueue::~WifiMacQueue ()
 {
+  // The device is being destroyed: do not wake its queue disc
+  m_queueInterface = 0;
   Flush ();
 }
 
@@ -112,13 +118,96 @@ WifiMacQueue::GetMaxDelay (void) const
 void
 WifiMacQueue::Empty (void)
 {
-  m_queue.clear ();
+  PacketQueue removed;
+  removed.swap (m_queue);
+  NotifyTransmittedBytes (removed);
+}
+
+void
+WifiMacQueue::SetNetDeviceQueueInterface (Ptr<NetDeviceQueueInterface> queueInterface)
+{
+  m_queueInterface = queueInterface;
+}
+
+void
+WifiMacQueue::NotifyQueuedBytes (const Item &item)
+{
+  if (m_queueInterface == 0 || !item.hdr.IsData ())
+    {
+      return;
+    }
+  m_queueInterface->GetTxQueue (GetTxQueueIndex (item.hdr))->NotifyQueuedBytes (item.packet->GetSize ());
+}
+
+void
+WifiMacQueue::NotifyTransmittedBytes (const PacketQueue &items)
+{
+  if (m_queueInterface == 0 || items.empty ())
+    {
+      return;
+    }
+  std::vector<uint32_t> bytes (m_queueInterface->GetNTxQueues (), 0);
+  for (PacketQueue::const_iterator it = items.begin (); it != items.end (); ++it)
+    {
+      if (it->hdr.IsData ())
+        {
+          bytes[GetTxQueueIndex (it->hdr)] += it->packet->GetSize ();
+        }
+    }
+  for (uint8_t i = 0; i < bytes.size (); i++)
+    {
+      Ptr<NetDeviceQueue> txq = m_queueInterface->GetTxQueue (i);
+      if (bytes[i] == 0 || txq->GetQueueLimits () == 0)
+        {
+          continue;
+        }
+      // This may wake the queue disc, which passes new frames to the MAC:
+      // report the bytes once the channel access function is done with the
+      // current frame
+      Simulator::ScheduleNow (&NetDeviceQueue::NotifyTransmittedBytes, txq, bytes[i]);
+    }
+}
+
+uint8_t
+WifiMacQueue::GetTxQueueIndex (const WifiMacHeader &hdr) const
+{
+  // The transmission queues of a QoS device are indexed by access category
+  if (m_queueInterface->GetNTxQueues () > 1 && hdr.IsQosData ())
+    {
+      return QosUtilsMapTidToAc (hdr.GetQosTid ());
+    }
+  return 0;
 }
 
 void
 WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+{
+  GsoTag gsoTag;
+  if (hdr.IsData () && packet->PeekPacketTag (gsoTag))
+    {
+      // A super-segment: the MSDUs are built here, below the upper layers
+      Ptr<Packet> p = packet->Copy ();
+      LlcSnapHeader llc;
+      p->RemoveHeader (llc);
+      std::list<Ptr<Packet> > segments;
+      if (GsoTag::Segment (p, llc.GetType (), segments))
+        {
+          for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it)
+            {
+              (*it)->AddHeader (llc);
+              DoEnqueue (*it, hdr);
+            }
+          return;
+        }
+    }
+  DoEnqueue (packet, hdr);
+}
+
+void
+WifiMacQueue::DoEnqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
   Cleanup ();
+  PacketQueue removed;
   if (m_size == m_maxSize)
     {
       if (m_dropPolicy == DROP_NEWEST)
@@ -127,13 +216,15 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
         }
       else if (m_dropPolicy == DROP_OLDEST)
         {
-          m_queue.pop_front ();
+          removed.splice (removed.end (), m_queue, m_queue.begin ());
           m_size--;
         }
     }
   Time now = Simulator::Now ();
   m_queue.push_back (Item (packet, hdr, now));
   m_size++;
+  NotifyQueuedBytes (m_queue.back ());
+  NotifyTransmittedBytes (removed);
 }
 
 void
@@ -146,6 +237,7 @@ WifiMacQueue::Cleanup (void)
 
   Time now = Simulator::Now ();
   uint32_t n = 0;
+  PacketQueue removed;
   for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); )
     {
       if (i->tstamp + m_maxDelay > now)
@@ -156,11 +248,12 @@ WifiMacQueue::Cleanup (void)
         {
           m_queueDropTrace (i->packet, ExcessDelay);
           NS_LOG_DEBUG ("Drop packet in the Wifi MAC Queue because exceeded max delay");
-          i = m_queue.erase (i);
+          removed.splice (removed.end (), m_queue, i++);
           n++;
         }
     }
   m_size -= n;
+  NotifyTransmittedBytes (removed);
 }
 
 Ptr<const Packet>
@@ -169,11 +262,12 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      m_queue.pop_front ();
+      PacketQueue removed;
+      removed.splice (removed.end (), m_queue, m_queue.begin ());
       m_size--;
-      *hdr = i.hdr;
-      return i.packet;
+      NotifyTransmittedBytes (removed);
+      *hdr = removed.front ().hdr;
+      return removed.front ().packet;
     }
   return 0;
 }
@@ -209,8 +303,10 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
+                  PacketQueue removed;
+                  removed.splice (removed.end (), m_queue, it);
                   m_size--;
+                  NotifyTransmittedBytes (removed);
                   break;
                 }
             }
@@ -243,8 +339,10 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                       packet = it->packet;
                       *hdr = it->hdr;
                       *timestamp = it->tstamp;
-                      m_queue.erase (it);
+                      PacketQueue removed;
+                      removed.splice (removed.end (), m_queue, it);
                       m_size--;
+                      NotifyTransmittedBytes (removed);
                       break;
                     }
                 }
@@ -275,8 +373,10 @@ WifiMacQueue::DequeueByAddress (WifiMacHeader *hdr,
                     {
                       packet = it->packet;
                       *hdr = it->hdr;
-                      m_queue.erase (it);
+                      PacketQueue removed;
+                      removed.splice (removed.end (), m_queue, it);
                       m_size--;
+                      NotifyTransmittedBytes (removed);
                       break;
                     }
                 }
@@ -360,15 +460,21 @@ WifiMacQueue::GetSize (void)
 void
 WifiMacQueue::TransferPacketsByAddress (Mac48Address addr, Ptr<WifiMacQueue> destQueue)
 {
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+  PacketQueue removed;
+  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); )
     {
       if ((it->hdr.IsData ()) && (it->hdr.GetAddr1 () == addr))
         {
           destQueue->Enqueue (it->packet, it->hdr);
-          it = m_queue.erase (it);
+          removed.splice (removed.end (), m_queue, it++);
           m_size--;
         }
+      else
+        {
+          it++;
+        }
     }
+  NotifyTransmittedBytes (removed);
 }
 
 void
@@ -406,8 +512,10 @@ WifiMacQueue::PrintPacketsPayload ()
 void
 WifiMacQueue::Flush (void)
 {
-  m_queue.erase (m_queue.begin (), m_queue.end ());
+  PacketQueue removed;
+  removed.swap (m_queue);
   m_size = 0;
+  NotifyTransmittedBytes (removed);
 }
 
 Mac48Address
@@ -436,8 +544,10 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
+          PacketQueue removed;
+          removed.splice (removed.end (), m_queue, it);
           m_size--;
+          NotifyTransmittedBytes (removed);
           return true;
         }
     }
@@ -448,17 +558,20 @@ void
 WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
   Cleanup ();
+  PacketQueue removed;
   if (m_size == m_maxSize)
     {
       /* Change the behaviour for now, isntead of dropping this packet we drop the packet at the back of the queue */
       NS_LOG_DEBUG ("Drop packet at the end since Wifi MAC Queue is full");
-      m_queue.pop_back ();
+      removed.splice (removed.end (), m_queue, --m_queue.end ());
       m_size--;
 //      return;
     }
   Time now = Simulator::Now ();
   m_queue.push_front (Item (packet, hdr, now));
   m_size++;
+  NotifyQueuedBytes (m_queue.front ());
+  NotifyTransmittedBytes (removed);
 }
 
 uint32_t
@@ -517,8 +630,10 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
+          PacketQueue removed;
+          removed.splice (removed.end (), m_queue, it);
           m_size--;
+          NotifyTransmittedBytes (removed);
           return packet;
         }
     }
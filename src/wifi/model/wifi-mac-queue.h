@@ -28,6 +28,7 @@
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
+#include "ns3/net-device.h"
 #include "wifi-mac-header.h"
 #include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
@@ -97,6 +98,9 @@ public:
   /**
    * Enqueue the given packet and its corresponding WifiMacHeader at the <i>end</i> of the queue.
    *
+   * A data packet carrying a GsoTag is a super-segment: it is split, and
+   * each segment is enqueued as a separate MSDU.
+   *
    * \param packet the packet to be euqueued at the end
    * \param hdr the header of the given packet
    */
@@ -298,11 +302,28 @@ public:
 
   virtual void Empty (void);
 
+  /**
+   * Set the interface of the device transmission queues.  The bytes of the
+   * data frames entering and leaving this queue are reported to the
+   * transmission queue of their access category, so that the queue limits
+   * of the device (if any) stop and wake the queue disc.
+   *
+   * \param queueInterface the NetDeviceQueueInterface of the device
+   */
+  void SetNetDeviceQueueInterface (Ptr<NetDeviceQueueInterface> queueInterface);
+
 protected:
   /**
    * Clean up the queue by removing packets that exceeded the maximum delay.
    */
   virtual void Cleanup (void);
+  /**
+   * Enqueue a packet at the end of the queue, dropping a packet if the queue is full.
+   *
+   * \param packet the packet to be euqueued at the end
+   * \param hdr the header of the given packet
+   */
+  void DoEnqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
 
   /**
    * A struct that holds information about a packet for putting
@@ -346,12 +367,35 @@ protected:
    * \return the address
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  /**
+   * Report the bytes of a frame entering the queue to its device
+   * transmission queue.
+   *
+   * \param item the frame entering the queue
+   */
+  void NotifyQueuedBytes (const Item &item);
+  /**
+   * Report the bytes of the frames leaving the queue (dequeued, dropped or
+   * transferred to another queue) to their device transmission queues.
+   * The bytes of each device transmission queue with queue limits are
+   * reported at once in a new event, since the queue disc woken by the
+   * report passes frames to the MAC.
+   *
+   * \param items the frames leaving the queue
+   */
+  void NotifyTransmittedBytes (const PacketQueue &items);
+  /**
+   * \param hdr the header of a data frame
+   * \return the index of the device transmission queue of the frame
+   */
+  uint8_t GetTxQueueIndex (const WifiMacHeader &hdr) const;
 
   PacketQueue m_queue;                //!< Packet (struct Item) queue
   TracedValue<uint32_t> m_size;       //!< Current queue size
   uint32_t m_maxSize;                 //!< Queue capacity
   Time m_maxDelay;                    //!< Time to live for packets in the queue
   enum DropPolicy m_dropPolicy; //!< Drop behavior of queue
+  Ptr<NetDeviceQueueInterface> m_queueInterface; //!< Interface of the device transmission queues
   /**
    * TracedCallback signature for monitor mode transmit events.
    *
@@ -26,8 +26,11 @@
 #include "qos-utils.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/packet.h"
+#include "ns3/gso-tag.h"
 #include "ns3/socket.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
 #include "ns3/pointer.h"
 #include "ns3/node.h"
 #include "ns3/trace-source-accessor.h"
@@ -70,12 +73,20 @@ WifiNetDevice::GetTypeId (void)
                    MakePointerAccessor (&WifiNetDevice::SetRemoteStationManager,
                                         &WifiNetDevice::GetRemoteStationManager),
                    MakePointerChecker<WifiRemoteStationManager> ())
+    .AddAttribute ("Gro",
+                   "If true, the packets received together, e.g., in an A-MPDU, are coalesced "
+                   "(generic receive offload) before being passed up.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiNetDevice::SetGro,
+                                        &WifiNetDevice::GetGro),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 WifiNetDevice::WifiNetDevice ()
-  : m_configComplete (false)
+  : m_configComplete (false),
+    m_gro (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -97,6 +108,7 @@ WifiNetDevice::DoDispose (void)
   m_phy = 0;
   m_stationManager = 0;
   m_queueInterface = 0;
+  m_groBatch.clear ();
   NetDevice::DoDispose ();
 }
 
@@ -128,6 +140,25 @@ WifiNetDevice::CompleteConfig (void)
   m_stationManager->SetupPhy (m_phy);
   m_stationManager->SetupMac (m_mac);
   m_configComplete = true;
+  SetGro (m_gro);
+}
+
+void
+WifiNetDevice::SetGro (bool gro)
+{
+  NS_LOG_FUNCTION (this << gro);
+  m_gro = gro;
+  Ptr<RegularWifiMac> mac = DynamicCast<RegularWifiMac> (m_mac);
+  if (mac != 0)
+    {
+      mac->SetRxAmpduBatching (gro);
+    }
+}
+
+bool
+WifiNetDevice::GetGro (void) const
+{
+  return m_gro;
 }
 
 void
@@ -159,6 +190,8 @@ WifiNetDevice::NotifyNewAggregate (void)
                       // register the select queue callback
                       m_queueInterface->SetSelectQueueCallback (MakeCallback (&WifiNetDevice::SelectQueue, this));
                     }
+                  // report the bytes queued in the MAC to the device queues
+                  mac->SetNetDeviceQueueInterface (m_queueInterface);
                 }
             }
         }
@@ -380,7 +413,22 @@ WifiNetDevice::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address to
     {
       m_mac->NotifyRx (packet);
       packet->RemoveHeader (llc);
-      m_forwardUp (this, packet, llc.GetType (), from);
+      if (m_gro)
+        {
+          if (m_groBatch.empty ())
+            {
+              Simulator::ScheduleNow (&WifiNetDevice::FlushGro, this);
+            }
+          GroEntry entry;
+          entry.packet = packet;
+          entry.protocol = llc.GetType ();
+          entry.from = from;
+          m_groBatch.push_back (entry);
+        }
+      else
+        {
+          m_forwardUp (this, packet, llc.GetType (), from);
+        }
     }
   else
     {
@@ -394,6 +442,30 @@ WifiNetDevice::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address to
     }
 }
 
+void
+WifiNetDevice::FlushGro (void)
+{
+  NS_LOG_FUNCTION (this << m_groBatch.size ());
+  std::list<GroEntry> batch;
+  batch.swap (m_groBatch);
+  std::list<GroEntry>::const_iterator it = batch.begin ();
+  while (it != batch.end ())
+    {
+      uint16_t protocol = it->protocol;
+      Mac48Address from = it->from;
+      std::list<Ptr<Packet> > packets;
+      for (; it != batch.end () && it->protocol == protocol && it->from == from; ++it)
+        {
+          packets.push_back (it->packet);
+        }
+      packets = GsoTag::Coalesce (packets, protocol);
+      for (std::list<Ptr<Packet> >::const_iterator p = packets.begin (); p != packets.end (); ++p)
+        {
+          m_forwardUp (this, *p, protocol, from);
+        }
+    }
+}
+
 void
 WifiNetDevice::LinkUp (void)
 {
@@ -441,6 +513,12 @@ WifiNetDevice::SupportsSendFrom (void) const
   return m_mac->SupportsSendFrom ();
 }
 
+bool
+WifiNetDevice::SupportsGso (void) const
+{
+  return true;
+}
+
 uint8_t
 WifiNetDevice::SelectQueue (Ptr<QueueItem> item) const
 {
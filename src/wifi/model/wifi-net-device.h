@@ -26,6 +26,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/mac48-address.h"
 #include <string>
+#include <list>
 
 namespace ns3 {
 
@@ -109,7 +110,13 @@ public:
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
-
+  /**
+   * The MAC queues split the super-segments into MSDUs, which the MAC
+   * aggregates into A-MSDUs and A-MPDUs.
+   *
+   * \return true
+   */
+  virtual bool SupportsGso (void) const;
 
 
 protected:
@@ -128,6 +135,23 @@ protected:
 
 
 private:
+  /**
+   * Enable or disable the coalescing of the received packets (GRO).
+   *
+   * \param gro true to coalesce the packets received together
+   */
+  void SetGro (bool gro);
+  /**
+   * \return true if the packets received together are coalesced
+   */
+  bool GetGro (void) const;
+  /**
+   * Pass up the packets received since the last call, after coalescing
+   * the consecutive packets of the same protocol and sender with
+   * GsoTag::Coalesce.
+   */
+  void FlushGro (void);
+
   //This value conforms to the 802.11 specification
   static const uint16_t MAX_MSDU_SIZE = 2304;
 
@@ -211,6 +235,16 @@ private:
   TracedCallback<> m_linkChanges;
   mutable uint16_t m_mtu;
   bool m_configComplete;
+
+  /// A packet received, waiting to be coalesced: packet, protocol and sender
+  struct GroEntry
+  {
+    Ptr<Packet> packet;     //!< the packet, without LLC header
+    uint16_t protocol;      //!< the protocol number of the packet
+    Mac48Address from;      //!< the sender of the packet
+  };
+  bool m_gro;                        //!< Flag whether the received packets are coalesced
+  std::list<GroEntry> m_groBatch;    //!< Packets received, waiting to be coalesced
 };
 
 } //namespace ns3
@@ -323,6 +323,12 @@ WifiPhy::GetTypeId (void)
                      "by the device",
                      MakeTraceSourceAccessor (&WifiPhy::m_phyRxBeginTrace),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("PhyRxSync",
+                     "Trace source indicating the PHY synchronized "
+                     "on a packet, before switching to the RX state, "
+                     "with the TXVECTOR of the packet",
+                     MakeTraceSourceAccessor (&WifiPhy::m_phyRxSyncTrace),
+                     "ns3::WifiPhy::RxSyncCallback")
     .AddTraceSource ("PhyRxEnd",
                      "Trace source indicating a packet "
                      "has been completely received from the channel medium "
@@ -476,6 +482,12 @@ WifiPhy::GetRxNoiseFigure (void) const
   return RatioToDb (m_interference.GetNoiseFigure ());
 }
 
+double
+WifiPhy::GetNoiseFloorW (void) const
+{
+  return m_interference.GetNoiseFloorW (GetChannelWidth ());
+}
+
 void
 WifiPhy::SetTxPowerStart (double start)
 {
@@ -2368,6 +2380,12 @@ WifiPhy::NotifyRxBegin (Ptr<const Packet> packet)
   m_phyRxBeginTrace (packet);
 }
 
+void
+WifiPhy::NotifyRxSync (Ptr<const Packet> packet, WifiTxVector txVector)
+{
+  m_phyRxSyncTrace (packet, txVector);
+}
+
 void
 WifiPhy::NotifyRxEnd (Ptr<const Packet> packet)
 {
@@ -1392,6 +1392,14 @@ public:
    * \param packet the packet being received
    */
   void NotifyRxBegin (Ptr<const Packet> packet);
+  /**
+   * Public method used to fire a PhyRxSync trace.
+   * Implemented for encapsulation purposes.
+   *
+   * \param packet the packet being received
+   * \param txVector the TXVECTOR of the packet
+   */
+  void NotifyRxSync (Ptr<const Packet> packet, WifiTxVector txVector);
   /**
    * Public method used to fire a PhyRxEnd trace.
    * Implemented for encapsulation purposes.
@@ -1498,6 +1506,15 @@ public:
                                             uint16_t channelNumber, uint32_t rate, WifiPreamble preamble,
                                             WifiTxVector txVector, struct mpduInfo aMpdu);
 
+  /**
+   * TracedCallback signature for the synchronization of the PHY on an
+   * incoming packet.
+   *
+   * \param packet the packet being received
+   * \param txVector the TXVECTOR of the packet
+   */
+  typedef void (* RxSyncCallback)(Ptr<const Packet> packet, WifiTxVector txVector);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model. Return the number of streams (possibly zero) that
@@ -1554,6 +1571,13 @@ public:
    * \return the RX noise figure in dBm
    */
   double GetRxNoiseFigure (void) const;
+  /**
+   * Return the noise floor of the receiver in the current channel width,
+   * as used to compute the SNR of the received frames.
+   *
+   * \return the noise floor in W
+   */
+  double GetNoiseFloorW (void) const;
   /**
    * Sets the minimum available transmission power level (dBm).
    *
@@ -2017,6 +2041,14 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_phyRxBeginTrace;
 
+  /**
+   * The trace source fired when the PHY synchronizes on a packet, before
+   * it switches to the RX state, with the TXVECTOR of the packet.
+   *
+   * \see class CallBackTraceSource
+   */
+  TracedCallback<Ptr<const Packet>, WifiTxVector> m_phyRxSyncTrace;
+
   /**
    * The trace source fired when a packet ends the reception process from
    * the medium.
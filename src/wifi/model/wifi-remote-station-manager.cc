@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include <iostream>
 #include "wifi-remote-station-manager.h"
 #include "ns3/simulator.h"
@@ -363,7 +364,8 @@ WifiRemoteStationManager::GetTypeId (void)
 }
 
 WifiRemoteStationManager::WifiRemoteStationManager ()
-  : m_htSupported (false),
+  : m_lastStation (0),
+    m_htSupported (false),
     m_vhtSupported (false),
     m_dmgSupported (false),
     m_useNonErpProtection (false),
@@ -385,11 +387,14 @@ std::cout << "sally test WifiRemoteStationManager -> DoDispose" << std::endl;
       delete (*i);
     }
   m_states.clear ();
+  m_stateIndex.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
+  m_lastStation = 0;
 }
 
 void
@@ -964,6 +969,26 @@ WifiRemoteStationManager::ReportAmpduTxStatus (Mac48Address address, uint8_t tid
   DoReportAmpduTxStatus (station, nSuccessfulMpdus, nFailedMpdus, rxSnr, dataSnr);
 }
 
+void
+WifiRemoteStationManager::ReportBeamformingSnr (Mac48Address address, double snr)
+{
+  NS_LOG_FUNCTION (this << address << snr);
+  NS_ASSERT (!address.IsGroup ());
+  bool found = false;
+  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+    {
+      if ((*i)->m_state->m_address == address)
+        {
+          DoReportBeamformingSnr (*i, snr);
+          found = true;
+        }
+    }
+  if (!found)
+    {
+      DoReportBeamformingSnr (Lookup (address, (uint8_t)0), snr);
+    }
+}
+
 bool
 WifiRemoteStationManager::NeedRts (Mac48Address address, const WifiMacHeader *header,
                                    Ptr<const Packet> packet, WifiTxVector txVector)
@@ -1562,12 +1587,16 @@ WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  if (!m_stateIndex.empty ())
     {
-      if ((*i)->m_address == address)
+      uint32_t mask = m_stateIndex.size () - 1;
+      for (uint32_t i = Hash (address, 0xff) & mask; m_stateIndex[i] != 0; i = (i + 1) & mask)
         {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
+          if (m_stateIndex[i]->m_address == address)
+            {
+              NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+              return m_stateIndex[i];
+            }
         }
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
@@ -1586,6 +1615,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_vhtSupported = false;
   state->m_dmgSupported = false;
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->IndexLastState ();
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1609,12 +1639,23 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << (uint16_t)tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  if (m_lastStation != 0
+      && m_lastStation->m_tid == tid
+      && m_lastStation->m_state->m_address == address)
+    {
+      return m_lastStation;
+    }
+  if (!m_stationIndex.empty ())
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
+      uint32_t mask = m_stationIndex.size () - 1;
+      for (uint32_t i = Hash (address, tid) & mask; m_stationIndex[i] != 0; i = (i + 1) & mask)
         {
-          return (*i);
+          if (m_stationIndex[i]->m_tid == tid
+              && m_stationIndex[i]->m_state->m_address == address)
+            {
+              m_lastStation = m_stationIndex[i];
+              return m_lastStation;
+            }
         }
     }
   WifiRemoteStationState *state = LookupState (address);
@@ -1625,9 +1666,69 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_ssrc = 0;
   station->m_slrc = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  const_cast<WifiRemoteStationManager *> (this)->IndexLastStation ();
+  m_lastStation = station;
   return station;
 }
 
+uint32_t
+WifiRemoteStationManager::Hash (Mac48Address address, uint8_t tid)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  /* FNV-1a */
+  uint32_t hash = 2166136261U;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      hash = (hash ^ buffer[i]) * 16777619U;
+    }
+  return (hash ^ tid) * 16777619U;
+}
+
+void
+WifiRemoteStationManager::IndexLastState (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t first = m_states.size () - 1;
+  if (m_states.size () * 2 > m_stateIndex.size ())
+    {
+      m_stateIndex.assign (std::max<uint32_t> (16, m_stateIndex.size () * 2), 0);
+      first = 0;
+    }
+  uint32_t mask = m_stateIndex.size () - 1;
+  for (uint32_t j = first; j < m_states.size (); j++)
+    {
+      uint32_t i = Hash (m_states[j]->m_address, 0xff) & mask;
+      while (m_stateIndex[i] != 0)
+        {
+          i = (i + 1) & mask;
+        }
+      m_stateIndex[i] = m_states[j];
+    }
+}
+
+void
+WifiRemoteStationManager::IndexLastStation (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t first = m_stations.size () - 1;
+  if (m_stations.size () * 2 > m_stationIndex.size ())
+    {
+      m_stationIndex.assign (std::max<uint32_t> (16, m_stationIndex.size () * 2), 0);
+      first = 0;
+    }
+  uint32_t mask = m_stationIndex.size () - 1;
+  for (uint32_t j = first; j < m_stations.size (); j++)
+    {
+      uint32_t i = Hash (m_stations[j]->m_state->m_address, m_stations[j]->m_tid) & mask;
+      while (m_stationIndex[i] != 0)
+        {
+          i = (i + 1) & mask;
+        }
+      m_stationIndex[i] = m_stations[j];
+    }
+}
+
 void
 WifiRemoteStationManager::AddStationHtCapabilities (Mac48Address from, Ptr<HtCapabilities> htCapabilities)
 {
@@ -1701,6 +1802,8 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
+  m_lastStation = 0;
   m_bssBasicRateSet.clear ();
   m_bssBasicRateSet.push_back (m_defaultTxMode);
   m_bssBasicMcsSet.clear ();
@@ -1856,6 +1959,11 @@ WifiRemoteStationManager::DoReportAmpduTxStatus (WifiRemoteStation *station, uin
   NS_LOG_DEBUG ("DoReportAmpduTxStatus received but the manager does not handle A-MPDUs!");
 }
 
+void
+WifiRemoteStationManager::DoReportBeamformingSnr (WifiRemoteStation *station, double snr)
+{
+}
+
 WifiMode
 WifiRemoteStationManager::GetSupported (const WifiRemoteStation *station, uint32_t i) const
 {
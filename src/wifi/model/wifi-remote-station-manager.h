@@ -646,6 +646,14 @@ public:
    * \param dataSnr data SNR reported by remote station
    */
   void ReportAmpduTxStatus (Mac48Address address, uint8_t tid, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus, double rxSnr, double dataSnr);
+  /**
+   * Typically called by DMG stations once a beamforming training (SLS or
+   * BRP) with the remote station has completed.
+   *
+   * \param address the address of the remote station
+   * \param snr the SNR measured with the best antenna configuration
+   */
+  void ReportBeamformingSnr (Mac48Address address, double snr);
 
   /**
    * \param address remote address
@@ -1183,6 +1191,15 @@ private:
    * \param dataSnr data SNR reported by remote station
    */
   virtual void DoReportAmpduTxStatus (WifiRemoteStation *station, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus, double rxSnr, double dataSnr);
+  /**
+   * Typically called when a beamforming training with the station has
+   * completed.  This method is a virtual method that can be implemented
+   * by the sub-classes which use the SNR measured during the training.
+   *
+   * \param station the station trained with
+   * \param snr the SNR measured with the best antenna configuration
+   */
+  virtual void DoReportBeamformingSnr (WifiRemoteStation *station, double snr);
 
   /**
    * Return the state of the station associated with the given address.
@@ -1211,6 +1228,23 @@ private:
    * \return WifiRemoteStation corresponding to the address
    */
   WifiRemoteStation* Lookup (Mac48Address address, const WifiMacHeader *header) const;
+  /**
+   * \param address the address of a station
+   * \param tid the TID of a station, or 0xff for the state of a station
+   *
+   * \return the hash of the address and TID in the station indexes
+   */
+  static uint32_t Hash (Mac48Address address, uint8_t tid);
+  /**
+   * Index the last state added to m_states, rebuilding the index with
+   * room for twice as many states when it is half full.
+   */
+  void IndexLastState (void);
+  /**
+   * Index the last station added to m_stations, rebuilding the index with
+   * room for twice as many stations when it is half full.
+   */
+  void IndexLastStation (void);
 
   /**
    * Return whether the modulation class of the selected mode for the 
@@ -1280,6 +1314,14 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  /**
+   * Open addressing hash tables, with linear probing, of m_states keyed
+   * on the address and of m_stations keyed on the address and TID.  Their
+   * size is a power of two and empty slots are null.
+   */
+  StationStates m_stateIndex;
+  Stations m_stationIndex;   //!< Hash table of m_stations, see m_stateIndex
+  mutable WifiRemoteStation *m_lastStation; //!< Station returned by the last Lookup, consecutive MPDUs usually go to the same peer
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -120,7 +120,6 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
   uint32_t j = 0; /* Phy ID */
-  Vector sender_pos = senderMobility->GetPosition ();
 //  Ptr<AbstractAntenna> senderAnt = sender->GetAntenna();
   Ptr<DirectionalAntenna> senderAnt = sender->GetDirectionalAntenna ();
   double rxPowerDbm;
@@ -146,8 +145,8 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             }
 
           receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          double azimuthTx = CalculateAzimuthAngle (sender_pos, receiverMobility->GetPosition ());
-          double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), sender_pos);
+          double azimuthTx, elevationTx, azimuthRx, elevationRx;
+          GetLinkAngles (senderMobility, receiverMobility, azimuthTx, elevationTx, azimuthRx, elevationRx);
 
           /* Check if the destination node fall within the tx sector */
 //          if (senderAnt->IsPeerNodeInTheCurrentSector (azimuth))
@@ -156,7 +155,7 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 
               if (senderAnt != 0)
                 {
-  //                double elevation = CalculateElevationAngle (sender_pos, receiverMobility->GetPosition());
+  //                double elevation = CalculateElevationAngle (senderMobility->GetPosition (), receiverMobility->GetPosition());
   //                NS_LOG_DEBUG("POWER: txPowerDbm=" << txPowerDbm
   //                          << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
   //                          << ", Gtx=" << sender_ant->GetTxGainDbi (azimuth, elevation)
@@ -166,15 +165,17 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   //                             (*i)->GetAntenna ()->GetRxGainDbi (azimuth + M_PI, -elevation); // Receiver's antenna gain.
 
                   NS_LOG_DEBUG ("POWER: azimuthTx=" << azimuthTx
+                                << ", elevationTx=" << elevationTx
                                 << ", azimuthRx=" << azimuthRx
+                                << ", elevationRx=" << elevationRx
                                 << ", txPowerDbm=" << txPowerDbm
                                 << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
-                                << ", Gtx=" << senderAnt->GetTxGainDbi (azimuthTx)
-                                << ", Grx=" << (*i)->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx));
+                                << ", Gtx=" << senderAnt->GetTxGainDbi (azimuthTx, elevationTx)
+                                << ", Grx=" << (*i)->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx, elevationRx));
 
                   rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) +
-                               senderAnt->GetTxGainDbi (azimuthTx) +                            // Sender's antenna gain.
-                               (*i)->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx);        // Receiver's antenna gain.
+                               senderAnt->GetTxGainDbi (azimuthTx, elevationTx) +                        // Sender's antenna gain.
+                               (*i)->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx, elevationRx);    // Receiver's antenna gain.
 
                   /* External Attenuator */
                   if ((m_blockage != 0) &&
@@ -221,9 +222,9 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 }
 
 void
-YansWifiChannel::SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const
+YansWifiChannel::SendTrnFields (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector) const
 {
-  NS_LOG_FUNCTION (this << sender << txPowerDbm << txVector << uint (fieldsRemaining));
+  NS_LOG_FUNCTION (this << sender << txPowerDbm << txVector);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
   Ptr<MobilityModel> receiverMobility;
@@ -256,8 +257,8 @@ YansWifiChannel::SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVect
               dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
             }
 
-          Simulator::ScheduleWithContext (dstNode, delay, &YansWifiChannel::ReceiveTrn, this, j,
-                                          sender, txVector, txPowerDbm, fieldsRemaining);
+          Simulator::ScheduleWithContext (dstNode, delay, &YansWifiChannel::ReceiveTrnFields, this, j,
+                                          sender, txVector, txPowerDbm);
         }
     }
 }
@@ -271,39 +272,96 @@ YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters para
 }
 
 void
-YansWifiChannel::ReceiveTrn (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector,
-                             double txPowerDbm, uint8_t fieldsRemaining) const
+YansWifiChannel::ReceiveTrnFields (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector, double txPowerDbm) const
 {
-  NS_LOG_FUNCTION (this << i << sender << txVector << txPowerDbm<< uint (fieldsRemaining));
-  /* Calculate SNR upon the receiption of the TRN Field */
+  NS_LOG_FUNCTION (this << i << sender << txVector << txPowerDbm);
+  /* Calculate the received power of the TRN Fields upon the reception of the first one */
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   Ptr<MobilityModel> receiverMobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT ((senderMobility != 0) && (receiverMobility != 0));
   Ptr<DirectionalAntenna> senderAnt = sender->GetDirectionalAntenna ();
-  double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-  double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-  double rxPowerDbm;
+  double azimuthTx, elevationTx, azimuthRx, elevationRx;
+  GetLinkAngles (senderMobility, receiverMobility, azimuthTx, elevationTx, azimuthRx, elevationRx);
+  double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
 
   NS_LOG_DEBUG ("POWER: azimuthTx=" << azimuthTx
+                << ", elevationTx=" << elevationTx
                 << ", azimuthRx=" << azimuthRx
-                << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
-                << ", Gtx=" << senderAnt->GetTxGainDbi (azimuthTx)
-                << ", Grx=" << m_phyList[i]->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx));
-
-  rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) +
-               senderAnt->GetTxGainDbi (azimuthTx) +                                      // Sender's antenna gain.
-               m_phyList[i]->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx);          // Receiver's antenna gain.
+                << ", elevationRx=" << elevationRx
+                << ", RxPower=" << rxPowerDbm);
 
-  /* External Attenuator */
-  if ((m_blockage != 0) && (m_srcWifiPhy == sender) && (m_dstWifiPhy == m_phyList[i]))
+  uint8_t fields = txVector.GetTrainngFieldLength ();
+  std::vector<double> rxPowersDbm;
+  rxPowersDbm.reserve (fields);
+  for (uint8_t fieldsRemaining = fields; fieldsRemaining > 0; fieldsRemaining--)
     {
-      rxPowerDbm += m_blockage ();
+      double fieldPowerDbm = rxPowerDbm;
+      if (txVector.GetPacketType () == TRN_T)
+        {
+          /* The sender switches to the sector numbered by the remaining TRN-T Fields */
+          fieldPowerDbm += senderAnt->GetSectorTxGainDbi (azimuthTx, elevationTx, fieldsRemaining,
+                                                          senderAnt->GetCurrentTxAntennaID ());
+        }
+      else
+        {
+          fieldPowerDbm += senderAnt->GetTxGainDbi (azimuthTx, elevationTx);
+        }
+
+      /* External Attenuator */
+      if ((m_blockage != 0) && (m_srcWifiPhy == sender) && (m_dstWifiPhy == m_phyList[i]))
+        {
+          fieldPowerDbm += m_blockage ();
+        }
+      rxPowersDbm.push_back (fieldPowerDbm);
     }
 
-  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm");
+  m_phyList[i]->StartReceiveTrnFields (txVector, rxPowersDbm, azimuthRx, elevationRx);
+}
+
+double
+YansWifiChannel::GetSectorRxPowerDbm (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver, double txPowerDbm,
+                                      uint8_t sectorId, uint8_t antennaId) const
+{
+  NS_LOG_FUNCTION (this << sender << receiver << txPowerDbm << (uint16_t) sectorId << (uint16_t) antennaId);
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  NS_ASSERT ((senderMobility != 0) && (receiverMobility != 0));
+  Ptr<DirectionalAntenna> senderAnt = sender->GetDirectionalAntenna ();
+  double azimuthTx, elevationTx, azimuthRx, elevationRx;
+  GetLinkAngles (senderMobility, receiverMobility, azimuthTx, elevationTx, azimuthRx, elevationRx);
+  return m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) +
+         senderAnt->GetSectorTxGainDbi (azimuthTx, elevationTx, sectorId, antennaId) +
+         receiver->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx, elevationRx);
+}
 
-  /* Report the received SNR to the higher layers */
-  m_phyList[i]->StartReceiveTrnField (txVector, rxPowerDbm, fieldsRemaining);
+void
+YansWifiChannel::GetLinkAngles (Ptr<MobilityModel> tx, Ptr<MobilityModel> rx,
+                                double &azimuthTx, double &elevationTx,
+                                double &azimuthRx, double &elevationRx) const
+{
+  bool txFirst = PeekPointer (tx) < PeekPointer (rx);
+  Ptr<MobilityModel> a = txFirst ? tx : rx;
+  Ptr<MobilityModel> b = txFirst ? rx : tx;
+  Vector positionA = a->GetPosition ();
+  Vector positionB = b->GetPosition ();
+  std::pair<LinkAnglesMap::iterator, bool> ret;
+  ret = m_linkAngles.insert (std::make_pair (std::make_pair (PeekPointer (a), PeekPointer (b)), LinkAngles ()));
+  struct LinkAngles &link = ret.first->second;
+  if (ret.second
+      || positionA.x != link.positionA.x || positionA.y != link.positionA.y || positionA.z != link.positionA.z
+      || positionB.x != link.positionB.x || positionB.y != link.positionB.y || positionB.z != link.positionB.z)
+    {
+      link.positionA = positionA;
+      link.positionB = positionB;
+      link.azimuthA = CalculateAzimuthAngle (positionA, positionB);
+      link.elevationA = CalculateElevationAngle (positionA, positionB);
+      link.azimuthB = CalculateAzimuthAngle (positionB, positionA);
+      link.elevationB = -link.elevationA;
+    }
+  azimuthTx = txFirst ? link.azimuthA : link.azimuthB;
+  elevationTx = txFirst ? link.elevationA : link.elevationB;
+  azimuthRx = txFirst ? link.azimuthB : link.azimuthA;
+  elevationRx = txFirst ? link.elevationB : link.elevationA;
 }
 
 uint32_t
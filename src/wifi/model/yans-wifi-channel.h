@@ -22,6 +22,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
 #include "wifi-channel.h"
@@ -36,6 +37,7 @@ namespace ns3 {
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class MobilityModel;
 
 struct Parameters
 {
@@ -104,12 +106,27 @@ public:
              WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
 
   /**
-   * Send TRN Field.
+   * Send the TRN Fields appended to a packet as a single event per
+   * receiver, which computes the received power of every TRN Field.
    * \param sender the device from which the packet is originating.
    * \param txPowerDbm the tx power associated to the packet.
    * \param txVector the TXVECTOR associated to the packet.
    */
-  void SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const;
+  void SendTrnFields (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector) const;
+  /**
+   * Compute the power a PHY would receive from a DMG PHY transmitting
+   * through the given sector, with the current receive configuration of
+   * the receiver, without sending anything.
+   *
+   * \param sender the transmitting PHY.
+   * \param receiver the receiving PHY.
+   * \param txPowerDbm the transmitted signal strength [dBm].
+   * \param sectorId the ID of the transmitting sector.
+   * \param antennaId the ID of the transmitting antenna.
+   * \return the received power [dBm], before the receiver gain.
+   */
+  double GetSectorRxPowerDbm (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver, double txPowerDbm,
+                              uint8_t sectorId, uint8_t antennaId) const;
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -149,11 +166,47 @@ private:
    */
   void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
   /**
+   * Compute the power of each TRN Field at the receiver, before its
+   * receive antenna gain, and start receiving the TRN Fields.
    * \param i index of the corresponding YansWifiPhy in the PHY list.
+   * \param sender the transmitting PHY.
    * \param txVector the TXVECTOR of the packet.
    * \param txPowerDbm the transmitted signal strength [dBm].
    */
-  void ReceiveTrn (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector, double txPowerDbm, uint8_t fieldsRemaining) const;
+  void ReceiveTrnFields (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector, double txPowerDbm) const;
+  /**
+   * Get the angles of the link between a transmitter and a receiver,
+   * which are only computed again when one of them moved.
+   *
+   * \param tx the mobility model of the transmitter.
+   * \param rx the mobility model of the receiver.
+   * \param azimuthTx the azimuth of the receiver seen from the transmitter.
+   * \param elevationTx the elevation of the receiver seen from the transmitter.
+   * \param azimuthRx the azimuth of the transmitter seen from the receiver.
+   * \param elevationRx the elevation of the transmitter seen from the receiver.
+   */
+  void GetLinkAngles (Ptr<MobilityModel> tx, Ptr<MobilityModel> rx,
+                      double &azimuthTx, double &elevationTx,
+                      double &azimuthRx, double &elevationRx) const;
+
+  /**
+   * The angles of a link between two mobility models a and b, a having
+   * the lower address.
+   */
+  struct LinkAngles
+  {
+    Vector positionA;   //!< The position of a when the angles were computed
+    Vector positionB;   //!< The position of b when the angles were computed
+    double azimuthA;    //!< The azimuth of b seen from a
+    double elevationA;  //!< The elevation of b seen from a
+    double azimuthB;    //!< The azimuth of a seen from b
+    double elevationB;  //!< The elevation of a seen from b
+  };
+
+  /**
+   * The angles of the links, indexed by their pair of mobility models.
+   */
+  typedef std::map<std::pair<const MobilityModel *, const MobilityModel *>, struct LinkAngles> LinkAnglesMap;
 
   PhyList m_phyList;                    //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;     //!< Propagation loss model
@@ -162,6 +215,7 @@ private:
   bool (*m_packetDropper) ();           //!< Packet Dropper Model.
   Ptr<WifiPhy> m_srcWifiPhy;
   Ptr<WifiPhy> m_dstWifiPhy;
+  mutable LinkAnglesMap m_linkAngles;   //!< The angles of the links
 
 };
 
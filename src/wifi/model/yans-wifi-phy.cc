@@ -431,6 +431,7 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
 
               NS_LOG_DEBUG ("sync to signal (power=" << rxPowerW << "W)");
               //sync to signal
+              NotifyRxSync (packet, txVector);
               m_state->SwitchToRx (totalDuration);
 
               NS_LOG_DEBUG ("SwitchToRx=" << totalDuration);
@@ -622,8 +623,8 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPr
   /* Send TRN Fields if beam refinement or tracking is required */
   if (sendTrnFields)
     {
-      /* Prepare transmission of the first TRN Packet */
-      Simulator::Schedule (frameDuration, &YansWifiPhy::SendTrnField, this, txVector, txVector.GetTrainngFieldLength ());
+      /* Prepare transmission of the TRN Fields */
+      Simulator::Schedule (frameDuration, &YansWifiPhy::SendTrnFields, this, txVector);
     }
 
   /* Accummulate the amount of Tx Duration by this station */
@@ -633,84 +634,80 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPr
 }
 
 void
-YansWifiPhy::SendTrnField (WifiTxVector txVector, uint8_t fieldsRemaining)
+YansWifiPhy::SendTrnFields (WifiTxVector txVector)
 {
-  NS_LOG_FUNCTION (this << txVector.GetMode () << uint (fieldsRemaining));
+  NS_LOG_FUNCTION (this << txVector.GetMode () << uint (txVector.GetTrainngFieldLength ()));
+  m_channel->SendTrnFields (this, GetPowerDbm (txVector.GetTxPowerLevel ()) + GetTxGain (), txVector);
   if (txVector.GetPacketType () == TRN_T)
     {
-      /* Change Sector ID at the begining of each TRN-T field */
-      m_directionalAntenna->SetCurrentTxSectorID (fieldsRemaining);
+      /* The TRN-T Fields sweep the Tx sectors down to the first one */
+      m_directionalAntenna->SetCurrentTxSectorID (1);
     }
-
-  fieldsRemaining--;
-  if (fieldsRemaining != 0)
-    {
-      Simulator::Schedule (TRNUnit, &YansWifiPhy::SendTrnField, this, txVector, fieldsRemaining);
-    }
-
-  m_channel->SendTrn (this, GetPowerDbm (txVector.GetTxPowerLevel ()) + GetTxGain (), txVector, fieldsRemaining);
 }
 
 void
-YansWifiPhy::StartReceiveTrnField (WifiTxVector txVector, double rxPowerDbm, uint8_t fieldsRemaining)
+YansWifiPhy::StartReceiveTrnFields (WifiTxVector txVector, std::vector<double> rxPowersDbm, double azimuth, double elevation)
 {
-  NS_LOG_FUNCTION (this << txVector.GetMode () << rxPowerDbm << fieldsRemaining);
-  double rxPowerW = DbmToW (rxPowerDbm);
+  NS_LOG_FUNCTION (this << txVector.GetMode () << rxPowersDbm.size () << azimuth << elevation);
   if ((m_plcpSuccess && m_state->IsStateRx ())) // || rxPowerW > GetEdThresholdW ()) // sally add one condition
     {
 std::cout << "sally test m_plcpSuccess8: " << m_plcpSuccess << std::endl;
-      /* Add Interference event for TRN field */
+      std::vector<struct TrnField> fields;
+      fields.reserve (rxPowersDbm.size ());
+      double energy = 0;
+      for (std::vector<double>::const_iterator it = rxPowersDbm.begin (); it != rxPowersDbm.end (); it++)
+        {
+          struct TrnField field;
+          field.sectorId = m_directionalAntenna->GetCurrentRxSectorID ();
+          field.antennaId = m_directionalAntenna->GetCurrentRxAntennaID ();
+          field.rxPowerW = DbmToW (*it + m_directionalAntenna->GetRxGainDbi (azimuth, elevation));
+          energy += field.rxPowerW;
+          fields.push_back (field);
+          if (txVector.GetPacketType () == TRN_R)
+            {
+              /* Change Rx Sector for the next TRN Field */
+              m_directionalAntenna->SetCurrentRxSectorID (m_directionalAntenna->GetNextRxSectorID ());
+            }
+        }
+
+      /* Add a single Interference event for the TRN Fields, with the same energy */
+      Time duration = fields.size () * TRNUnit;
       Ptr<InterferenceHelper::Event> event;
       event = m_interference.Add (txVector,
-                                  TRNUnit,
-                                  rxPowerW);
+                                  duration,
+                                  energy / fields.size ());
 std::cout << "sally test m_plcpSuccess23: " << m_plcpSuccess << std::endl;
 
-      /* Schedule an event for the complete reception of this TRN Field */
-      Simulator::Schedule (TRNUnit, &YansWifiPhy::EndReceiveTrnField, this,
-                           m_directionalAntenna->GetCurrentRxSectorID (), m_directionalAntenna->GetCurrentRxAntennaID (),
-                           txVector, fieldsRemaining, event);
-
-      if (txVector.GetPacketType () == TRN_R)
-        {
-std::cout << "sally test m_plcpSuccess24: " << m_plcpSuccess << std::endl;
-          /* Change Rx Sector for the next TRN Field */
-          m_directionalAntenna->SetCurrentRxSectorID (m_directionalAntenna->GetNextRxSectorID ());
-        }
+      /* Schedule an event for the complete reception of the TRN Fields */
+      Simulator::Schedule (duration, &YansWifiPhy::EndReceiveTrnFields, this, txVector, fields, event);
     }
   else
     {
-      NS_LOG_DEBUG ("Drop TRN Field because signal power too Small (" << rxPowerW << "<" << GetEdThresholdW ());
-      std::cout << "sally test m_plcpSuccess20: " << m_plcpSuccess << std::endl; 
-      std::cout << "sally test drop TRN Field because signal power too Small (" << rxPowerW << "<" << GetEdThresholdW () << std::endl << std::endl;  //Sally test
-
+      NS_LOG_DEBUG ("Drop TRN Fields because the PSDU is not being received");
+      std::cout << "sally test m_plcpSuccess20: " << m_plcpSuccess << std::endl;
     }
 }
 
 void
-YansWifiPhy::EndReceiveTrnField (uint8_t sectorId, uint8_t antennaId,
-                                 WifiTxVector txVector, uint8_t fieldsRemaining,
-                                 Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceiveTrnFields (WifiTxVector txVector, std::vector<struct TrnField> fields, Ptr<InterferenceHelper::Event> event)
 {
-  NS_LOG_FUNCTION (this << sectorId << antennaId << txVector.GetMode () << fieldsRemaining << event);
-
-  /* Calculate SNR and report it to the upper layer */
-  double snr;
-  snr = m_interference.CalculatePlcpTrnSnr (event);
-  m_reportSnrCallback (sectorId, antennaId, fieldsRemaining, snr, (txVector.GetPacketType () == TRN_T));
+  NS_LOG_FUNCTION (this << txVector.GetMode () << fields.size () << event);
+  NS_ASSERT (IsStateRx ());
 
-  /* Check if this is the last TRN field in the current transmission */
-  if (fieldsRemaining == 0)
+  /* Calculate the SNR of each TRN Field and report it to the upper layer */
+  std::vector<double> rxPowersW;
+  rxPowersW.reserve (fields.size ());
+  for (std::vector<struct TrnField>::const_iterator it = fields.begin (); it != fields.end (); it++)
     {
-      EndReceiveTrnFields ();
+      rxPowersW.push_back (it->rxPowerW);
+    }
+  std::vector<double> snrs = m_interference.CalculatePlcpTrnSnrs (event, rxPowersW);
+  for (uint32_t i = 0; i < fields.size (); i++)
+    {
+      m_reportSnrCallback (fields[i].sectorId, fields[i].antennaId, fields.size () - i - 1, snrs[i],
+                           (txVector.GetPacketType () == TRN_T));
     }
-}
 
-void
-YansWifiPhy::EndReceiveTrnFields (void)
-{
-  NS_LOG_FUNCTION (this);
-  NS_ASSERT (IsStateRx ());
   m_interference.NotifyRxEnd ();
 
   if (m_plcpSuccess && m_psduSuccess)
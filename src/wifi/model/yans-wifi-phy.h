@@ -96,27 +96,21 @@ public:
   virtual void SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, enum WifiPreamble preamble, enum mpduType mpdutype);
 
   /**
-   * Send TRN Field to the destinated station.
+   * Send the TRN Fields to the destinated station, as a single event
+   * per receiver covering all the TRN Fields.
    * \param txVector TxVector companioned by this transmission.
-   * \param fieldsRemaining The number of TRN Fields remaining till the end of transmission.
    */
-  void SendTrnField (WifiTxVector txVector, uint8_t fieldsRemaining);
+  void SendTrnFields (WifiTxVector txVector);
   /**
-   * Start receiving TRN Field
-   * \param txVector
-   * \param rxPowerDbm The received power in dBm.
-   */
-  void StartReceiveTrnField (WifiTxVector txVector, double rxPowerDbm, uint8_t fieldsRemaining);
-  /**
-   * Receive TRN Field
-   * \param event The event related to the reception of this TRN Field.
-   */
-  void EndReceiveTrnField (uint8_t sectorId, uint8_t antennaId,
-                           WifiTxVector txVector, uint8_t fieldsRemaining, Ptr<InterferenceHelper::Event> event);
-  /**
-   * This method is called once all the TRN Fields are received.
+   * Start receiving the TRN Fields appended to the packet being received.
+   * The receive antenna gain of each TRN Field is computed at once,
+   * sweeping the receive sectors for TRN-R Fields.
+   * \param txVector TxVector companioned by this transmission.
+   * \param rxPowersDbm The received power of each TRN Field in dBm, before the receive antenna gain.
+   * \param azimuth The azimuth of the transmitter seen from the receiver.
+   * \param elevation The elevation of the transmitter seen from the receiver.
    */
-  void EndReceiveTrnFields (void);
+  void StartReceiveTrnFields (WifiTxVector txVector, std::vector<double> rxPowersDbm, double azimuth, double elevation);
 
   virtual void RegisterListener (WifiPhyListener *listener);
   virtual void UnregisterListener (WifiPhyListener *listener);
@@ -176,6 +170,24 @@ private:
    */
   void EndPsduOnlyReceive (Ptr<Packet> packet, PacketType packetType, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event);
 
+  /// The antenna configuration and the received power of a TRN Field.
+  struct TrnField
+  {
+    uint8_t sectorId;   //!< The receive sector during the TRN Field
+    uint8_t antennaId;  //!< The receive antenna during the TRN Field
+    double rxPowerW;    //!< The received power (W)
+  };
+
+  /**
+   * All the TRN Fields have been received: report the SNR of each of
+   * them to the upper layer and end the reception.
+   *
+   * \param txVector TxVector companioned by this transmission.
+   * \param fields the TRN Fields, in their order of reception
+   * \param event the event covering the reception of the TRN Fields
+   */
+  void EndReceiveTrnFields (WifiTxVector txVector, std::vector<struct TrnField> fields, Ptr<InterferenceHelper::Event> event);
+
   Ptr<YansWifiChannel> m_channel;        //!< YansWifiChannel that this YansWifiPhy is connected to
  
   /* Variables to support 802.11ad */
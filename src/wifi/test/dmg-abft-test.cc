@@ -0,0 +1,301 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ssid.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include <map>
+
+using namespace ns3;
+
+/**
+ * Run a BSS of DMG STAs around a DMG AP and record the outcome of their
+ * beamforming training in the A-BFT.
+ */
+class DmgAbftTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   */
+  DmgAbftTestCase (std::string name);
+
+protected:
+  /**
+   * Run the BSS during a few beacon intervals.
+   * \param positions the positions of the DMG STAs, the DMG AP standing at the origin
+   * \param fastForward whether the A-BFT is resolved analytically
+   * \param intervals the number of beacon intervals
+   */
+  void RunBss (std::vector<Vector> positions, bool fastForward, uint32_t intervals);
+  /**
+   * Record the SLS completion of a DMG STA with the DMG AP.
+   * \param station the DMG STA
+   * \param address the DMG AP
+   * \param accessPeriod the access period of the SLS
+   * \param sectorId the best transmit sector of the DMG STA
+   * \param antennaId the best transmit antenna of the DMG STA
+   */
+  void StationSlsCompleted (Mac48Address station, Mac48Address address, ChannelAccessPeriod accessPeriod,
+                            SECTOR_ID sectorId, ANTENNA_ID antennaId);
+  /**
+   * Record the SLS completion of the DMG AP with a DMG STA.
+   * \param address the DMG STA
+   * \param accessPeriod the access period of the SLS
+   * \param sectorId the best transmit sector of the DMG AP
+   * \param antennaId the best transmit antenna of the DMG AP
+   */
+  void ApSlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                       SECTOR_ID sectorId, ANTENNA_ID antennaId);
+  /**
+   * Record an A-BFT resolved analytically.
+   * \param address the DMG AP
+   * \param trained the number of DMG STAs which completed RSS
+   * \param collisions the number of RSS attempts lost in collisions
+   * \param slots the number of slots in which a DMG STA attempted RSS
+   */
+  void AbftResolved (Mac48Address address, uint32_t trained, uint32_t collisions, uint8_t slots);
+
+  std::vector<Mac48Address> m_stations;           //!< The addresses of the DMG STAs
+  std::map<Mac48Address, SECTOR_ID> m_staSectors; //!< The best sector of each DMG STA towards the DMG AP
+  std::map<Mac48Address, SECTOR_ID> m_apSectors;  //!< The best sector of the DMG AP towards each DMG STA
+  uint32_t m_trained;    //!< The number of DMG STAs trained in the A-BFTs resolved analytically
+  uint32_t m_collisions; //!< The number of collisions in the A-BFTs resolved analytically
+  uint32_t m_abfts;      //!< The number of A-BFTs resolved analytically
+};
+
+DmgAbftTestCase::DmgAbftTestCase (std::string name)
+  : TestCase (name),
+    m_trained (0),
+    m_collisions (0),
+    m_abfts (0)
+{
+}
+
+void
+DmgAbftTestCase::StationSlsCompleted (Mac48Address station, Mac48Address address, ChannelAccessPeriod accessPeriod,
+                                      SECTOR_ID sectorId, ANTENNA_ID antennaId)
+{
+  if (accessPeriod == CHANNEL_ACCESS_BHI)
+    {
+      m_staSectors[station] = sectorId;
+    }
+}
+
+void
+DmgAbftTestCase::ApSlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                                 SECTOR_ID sectorId, ANTENNA_ID antennaId)
+{
+  if (accessPeriod == CHANNEL_ACCESS_BHI)
+    {
+      m_apSectors[address] = sectorId;
+    }
+}
+
+void
+DmgAbftTestCase::AbftResolved (Mac48Address address, uint32_t trained, uint32_t collisions, uint8_t slots)
+{
+  m_abfts++;
+  m_trained += trained;
+  m_collisions += collisions;
+}
+
+void
+DmgAbftTestCase::RunBss (std::vector<Vector> positions, bool fastForward, uint32_t intervals)
+{
+  m_stations.clear ();
+  m_staSectors.clear ();
+  m_apSectors.clear ();
+  m_trained = 0;
+  m_collisions = 0;
+  m_abfts = 0;
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS12"),
+                                "DataMode", StringValue ("DMG_MCS12"));
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (56.16e9));
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("RxNoiseFigure", DoubleValue (3));
+  wifiPhy.SetErrorRateModel ("ns3::SensitivityModel60GHz");
+  wifiPhy.EnableAntenna (true, true);
+  wifiPhy.SetAntenna ("ns3::Directional60GhzAntenna",
+                      "Sectors", UintegerValue (8),
+                      "Antennas", UintegerValue (1));
+
+  NodeContainer apNode;
+  apNode.Create (1);
+  NodeContainer staNodes;
+  staNodes.Create (positions.size ());
+
+  Ssid ssid = Ssid ("dmg-abft");
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "BeaconTransmissionInterval", TimeValue (MicroSeconds (400)),
+                   "ATIDuration", TimeValue (MicroSeconds (300)),
+                   "AbftFastForward", BooleanValue (fastForward));
+  NetDeviceContainer apDevice = wifi.Install (wifiPhy, wifiMac, apNode);
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "ActiveProbing", BooleanValue (false));
+  NetDeviceContainer staDevices = wifi.Install (wifiPhy, wifiMac, staNodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (std::vector<Vector>::const_iterator it = positions.begin (); it != positions.end (); it++)
+    {
+      positionAlloc->Add (*it);
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNodes);
+  int64_t streams = wifi.AssignStreams (apDevice, 1);
+  wifi.AssignStreams (staDevices, 1 + streams);
+
+  Ptr<DmgApWifiMac> apMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  apMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&DmgAbftTestCase::ApSlsCompleted, this));
+  apMac->TraceConnectWithoutContext ("AbftResolved", MakeCallback (&DmgAbftTestCase::AbftResolved, this));
+  for (uint32_t i = 0; i < staDevices.GetN (); i++)
+    {
+      Ptr<DmgStaWifiMac> staMac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (staDevices.Get (i))->GetMac ());
+      m_stations.push_back (staMac->GetAddress ());
+      staMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&DmgAbftTestCase::StationSlsCompleted, this)
+                                         .Bind (staMac->GetAddress ()));
+    }
+
+  Simulator::Stop (intervals * MicroSeconds (102400));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that a DMG STA alone in the A-BFT selects the same sector
+ * whether the A-BFT is simulated or resolved analytically.
+ */
+class DmgAbftSingleStationTestCase : public DmgAbftTestCase
+{
+public:
+  DmgAbftSingleStationTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+DmgAbftSingleStationTestCase::DmgAbftSingleStationTestCase ()
+  : DmgAbftTestCase ("Check the sectors trained in an A-BFT resolved analytically against the simulated A-BFT")
+{
+}
+
+void
+DmgAbftSingleStationTestCase::DoRun (void)
+{
+  std::vector<Vector> positions;
+  positions.push_back (Vector (1.0, 1.0, 0.0));
+
+  RunBss (positions, false, 2);
+  Mac48Address station = m_stations[0];
+  NS_TEST_ASSERT_MSG_EQ (m_staSectors.count (station), 1, "The DMG STA was not trained in the simulated A-BFT");
+  NS_TEST_ASSERT_MSG_EQ (m_apSectors.count (station), 1, "The DMG AP did not complete SLS in the simulated A-BFT");
+  NS_TEST_ASSERT_MSG_EQ (m_abfts, 0, "The A-BFT was resolved analytically by default");
+  SECTOR_ID staSector = m_staSectors[station];
+  SECTOR_ID apSector = m_apSectors[station];
+
+  RunBss (positions, true, 2);
+  station = m_stations[0];
+  NS_TEST_ASSERT_MSG_EQ (m_staSectors.count (station), 1, "The DMG STA was not trained in the fast-forwarded A-BFT");
+  NS_TEST_ASSERT_MSG_EQ (m_apSectors.count (station), 1, "The DMG AP did not complete SLS in the fast-forwarded A-BFT");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t)m_staSectors[station], (uint16_t)staSector, "The DMG STA selected a different sector");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t)m_apSectors[station], (uint16_t)apSector, "The DMG AP selected a different sector");
+  NS_TEST_ASSERT_MSG_GT (m_abfts, 0, "No A-BFT was resolved analytically");
+  NS_TEST_ASSERT_MSG_EQ (m_collisions, 0, "A DMG STA alone collided");
+}
+
+/**
+ * Check that DMG STAs contending in A-BFTs resolved analytically all
+ * get trained, some of them after collisions.
+ */
+class DmgAbftContentionTestCase : public DmgAbftTestCase
+{
+public:
+  DmgAbftContentionTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+DmgAbftContentionTestCase::DmgAbftContentionTestCase ()
+  : DmgAbftTestCase ("Check the training of DMG STAs contending in A-BFTs resolved analytically")
+{
+}
+
+void
+DmgAbftContentionTestCase::DoRun (void)
+{
+  std::vector<Vector> positions;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      double angle = 2 * M_PI * i / 6;
+      positions.push_back (Vector (2 * std::cos (angle), 2 * std::sin (angle), 0.0));
+    }
+
+  RunBss (positions, true, 10);
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_staSectors.count (m_stations[i]), 1, "DMG STA " << i << " was not trained");
+      NS_TEST_ASSERT_MSG_EQ (m_apSectors.count (m_stations[i]), 1, "The DMG AP did not complete SLS with DMG STA " << i);
+    }
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_trained, m_stations.size (), "Trained DMG STAs were not traced");
+  NS_TEST_ASSERT_MSG_GT (m_collisions, 0, "Six DMG STAs in eight slots never collided");
+}
+
+/**
+ * DMG A-BFT TestSuite
+ */
+class DmgAbftTestSuite : public TestSuite
+{
+public:
+  DmgAbftTestSuite ();
+};
+
+DmgAbftTestSuite::DmgAbftTestSuite ()
+  : TestSuite ("dmg-abft", UNIT)
+{
+  AddTestCase (new DmgAbftSingleStationTestCase, TestCase::QUICK);
+  AddTestCase (new DmgAbftContentionTestCase, TestCase::QUICK);
+}
+
+static DmgAbftTestSuite g_dmgAbftTestSuite;
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/directional-60-ghz-antenna.h"
+#include "ns3/directional-antenna-model.h"
+
+using namespace ns3;
+
+/**
+ * Check the elevation pattern of the DMG directional antennas.
+ */
+class DmgAntennaElevationTestCase : public TestCase
+{
+public:
+  DmgAntennaElevationTestCase ();
+
+  virtual void DoRun (void);
+};
+
+DmgAntennaElevationTestCase::DmgAntennaElevationTestCase ()
+  : TestCase ("Check the elevation gain of the DMG directional antennas")
+{
+}
+
+void
+DmgAntennaElevationTestCase::DoRun (void)
+{
+  Ptr<Directional60GhzAntenna> antenna = CreateObject<Directional60GhzAntenna> ();
+  double azimuth = 0.1;
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetTxGainDbi (azimuth, 0.5), antenna->GetTxGainDbi (azimuth), 1e-9,
+                             "The gain depends on the elevation by default");
+
+  /* 30 degrees beam width tilted 30 degrees downwards */
+  antenna->SetAttribute ("ElevationBeamWidth", DoubleValue (M_PI / 6));
+  antenna->SetAttribute ("Tilt", DoubleValue (-M_PI / 6));
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetElevationGainDbi (-M_PI / 6), 0, 1e-9, "Wrong gain towards the tilt");
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetElevationGainDbi (0), -12, 1e-9, "Wrong gain one beam width away");
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetElevationGainDbi (-M_PI / 12), -3, 1e-9, "Wrong gain at the half-power angle");
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetElevationGainDbi (M_PI / 3), -20, 1e-9, "The side lobe attenuation is not applied");
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetElevationGainDbi (-0.5 * M_PI / 180), -11.61, 0.01, "Wrong interpolated gain");
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetTxGainDbi (azimuth, 0), antenna->GetTxGainDbi (azimuth) - 12, 1e-9,
+                             "The elevation gain is not added to the Tx gain");
+
+  antenna->SetInDirectionalReceivingMode ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetRxGainDbi (azimuth, 0), antenna->GetRxGainDbi (azimuth) - 12, 1e-9,
+                             "The elevation gain is not added to the directional Rx gain");
+  antenna->SetInOmniReceivingMode ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (antenna->GetRxGainDbi (azimuth, 0), antenna->GetRxGainDbi (azimuth), 1e-9,
+                             "The elevation gain is added to the omni Rx gain");
+
+  /* Angles are expressed as an inclination from the z axis */
+  Ptr<DirectionalAntennaModel> model = CreateObject<DirectionalAntennaModel> ();
+  model->SetDirectionalAntenna (antenna, true);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetGainDb (Angles (azimuth, M_PI / 2)), antenna->GetTxGainDbi (azimuth) - 12, 1e-9,
+                             "Wrong gain of the AntennaModel adapter");
+}
+
+/**
+ * DMG antenna TestSuite
+ */
+class DmgAntennaTestSuite : public TestSuite
+{
+public:
+  DmgAntennaTestSuite ();
+};
+
+DmgAntennaTestSuite::DmgAntennaTestSuite ()
+  : TestSuite ("dmg-antenna", UNIT)
+{
+  AddTestCase (new DmgAntennaElevationTestCase, TestCase::QUICK);
+}
+
+static DmgAntennaTestSuite g_dmgAntennaTestSuite;
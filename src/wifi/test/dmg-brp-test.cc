@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ssid.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+
+using namespace ns3;
+
+/**
+ * Check the receive sectors trained by the DMG AP from the TRN-R Fields
+ * appended by a DMG STA during the beam refinement in the ATI.
+ */
+class DmgBrpTrnTestCase : public TestCase
+{
+public:
+  /**
+   * \param position the position of the DMG STA, the DMG AP standing at the origin
+   * \param sector the receive sector of the DMG AP towards the DMG STA
+   */
+  DmgBrpTrnTestCase (Vector position, uint8_t sector);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Save the state of the DMG AP.
+   * \param mac the DMG AP
+   */
+  void SaveAp (Ptr<DmgApWifiMac> mac);
+
+  Vector m_position;           //!< The position of the DMG STA
+  uint8_t m_sector;            //!< The expected receive sector of the DMG AP
+  std::ostringstream m_state;  //!< The state of the DMG AP at the end of the simulation
+};
+
+DmgBrpTrnTestCase::DmgBrpTrnTestCase (Vector position, uint8_t sector)
+  : TestCase ("Check the receive sector trained from TRN-R Fields"),
+    m_position (position),
+    m_sector (sector)
+{
+}
+
+void
+DmgBrpTrnTestCase::SaveAp (Ptr<DmgApWifiMac> mac)
+{
+  mac->SaveSnapshot (m_state);
+}
+
+void
+DmgBrpTrnTestCase::DoRun (void)
+{
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS12"),
+                                "DataMode", StringValue ("DMG_MCS12"));
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (56.16e9));
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("RxNoiseFigure", DoubleValue (3));
+  wifiPhy.SetErrorRateModel ("ns3::SensitivityModel60GHz");
+  wifiPhy.EnableAntenna (true, true);
+  wifiPhy.SetAntenna ("ns3::Directional60GhzAntenna",
+                      "Sectors", UintegerValue (8),
+                      "Antennas", UintegerValue (1));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  Ssid ssid = Ssid ("dmg-brp");
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "BeaconTransmissionInterval", TimeValue (MicroSeconds (400)),
+                   "ATIDuration", TimeValue (MicroSeconds (300)));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes.Get (0));
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "ActiveProbing", BooleanValue (false));
+  devices.Add (wifi.Install (wifiPhy, wifiMac, nodes.Get (1)));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (m_position);
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  wifi.AssignStreams (devices, 1);
+
+  Ptr<DmgApWifiMac> apMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (devices.Get (0))->GetMac ());
+  std::ostringstream station;
+  station << Mac48Address::ConvertFrom (devices.Get (1)->GetAddress ());
+  Simulator::Schedule (MicroSeconds (3 * 102400 - 1), &DmgBrpTrnTestCase::SaveAp, this, apMac);
+  Simulator::Stop (MicroSeconds (3 * 102400));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  /* The SNR tables of the DMG AP, the TX one followed by the RX one */
+  std::istringstream is (m_state.str ());
+  std::string token;
+  while ((is >> token) && (token != "snr"))
+    {
+    }
+  uint32_t stations;
+  is >> stations;
+  NS_TEST_ASSERT_MSG_EQ (stations, 1, "The DMG AP has no SNR table for the DMG STA");
+  uint32_t entries;
+  uint32_t sectorId, antennaId;
+  double snr;
+  is >> token >> entries;
+  NS_TEST_ASSERT_MSG_EQ (token, station.str (), "The SNR table is not for the DMG STA");
+  for (uint32_t i = 0; i < entries; i++)
+    {
+      is >> sectorId >> antennaId >> snr;
+    }
+  is >> entries;
+  NS_TEST_ASSERT_MSG_EQ (entries, 8, "The TRN-R Fields did not sweep all the receive sectors");
+  uint32_t bestSector = 0;
+  double bestSnr = 0;
+  for (uint32_t i = 0; i < entries; i++)
+    {
+      is >> sectorId >> antennaId >> snr;
+      NS_TEST_ASSERT_MSG_EQ (sectorId, i + 1, "The TRN-R Fields were not received in the order of the sectors");
+      if (snr > bestSnr)
+        {
+          bestSnr = snr;
+          bestSector = sectorId;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (bestSector, m_sector, "The best TRN-R Field was not received through the sector towards the DMG STA");
+
+  /* The best antenna configurations: TX sector and antenna, then RX sector and antenna */
+  is >> token >> stations >> token;
+  NS_TEST_ASSERT_MSG_EQ (token, station.str (), "The best antenna configuration is not for the DMG STA");
+  uint32_t txSector, txAntenna, rxSector, rxAntenna;
+  is >> txSector >> txAntenna >> rxSector >> rxAntenna;
+  NS_TEST_ASSERT_MSG_EQ (rxSector, m_sector, "Wrong best receive sector");
+}
+
+/**
+ * DMG beam refinement TestSuite
+ */
+class DmgBrpTestSuite : public TestSuite
+{
+public:
+  DmgBrpTestSuite ();
+};
+
+DmgBrpTestSuite::DmgBrpTestSuite ()
+  : TestSuite ("dmg-brp", UNIT)
+{
+  AddTestCase (new DmgBrpTrnTestCase (Vector (1.0, 2.0, 0.0), 2), TestCase::QUICK);
+  AddTestCase (new DmgBrpTrnTestCase (Vector (-2.0, 1.0, 0.0), 4), TestCase::QUICK);
+}
+
+static DmgBrpTestSuite g_dmgBrpTestSuite;
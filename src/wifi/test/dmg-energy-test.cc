@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ssid.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/basic-energy-source-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/dmg-radio-energy-model-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-trailer.h"
+
+using namespace ns3;
+
+/**
+ * Check the energy consumed by a DMG STA sending data to its DMG AP in a
+ * CBAP, with and without dozing outside the CBAP.
+ */
+class DmgEnergyTestCase : public TestCase
+{
+public:
+  DmgEnergyTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the BSS.
+   * \param doze whether the DMG STA dozes outside the allocations
+   */
+  void RunBss (bool doze);
+  /**
+   * Send a packet to the DMG AP every millisecond.
+   * \param device the device of the DMG STA
+   * \param stop the time to stop sending
+   */
+  void Send (Ptr<NetDevice> device, Time stop);
+  /**
+   * Count the packets received by the DMG AP.
+   * \param packet the received packet
+   */
+  void Received (Ptr<const Packet> packet);
+
+  uint32_t m_received;          //!< The number of packets received by the DMG AP
+  double m_energy;              //!< The total energy consumed by the DMG STA (J)
+  double m_beamformingEnergy;   //!< The energy consumed by the DMG STA in beamforming training (J)
+  double m_energyPerBit;        //!< The energy per bit of data of the DMG STA (J/bit)
+  uint64_t m_bits;              //!< The bits of data exchanged by the DMG STA
+};
+
+DmgEnergyTestCase::DmgEnergyTestCase ()
+  : TestCase ("Check the energy of a DMG STA dozing outside its allocations"),
+    m_received (0),
+    m_energy (0),
+    m_beamformingEnergy (0),
+    m_energyPerBit (0),
+    m_bits (0)
+{
+}
+
+void
+DmgEnergyTestCase::Send (Ptr<NetDevice> device, Time stop)
+{
+  device->Send (Create<Packet> (1000), Mac48Address ("00:00:00:00:00:01"), 0x0800);
+  if (Simulator::Now () + MilliSeconds (1) < stop)
+    {
+      Simulator::Schedule (MilliSeconds (1), &DmgEnergyTestCase::Send, this, device, stop);
+    }
+}
+
+void
+DmgEnergyTestCase::Received (Ptr<const Packet> packet)
+{
+  m_received++;
+}
+
+void
+DmgEnergyTestCase::RunBss (bool doze)
+{
+  m_received = 0;
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS12"),
+                                "DataMode", StringValue ("DMG_MCS12"));
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (56.16e9));
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("RxNoiseFigure", DoubleValue (3));
+  wifiPhy.SetErrorRateModel ("ns3::SensitivityModel60GHz");
+  wifiPhy.EnableAntenna (true, true);
+  wifiPhy.SetAntenna ("ns3::Directional60GhzAntenna",
+                      "Sectors", UintegerValue (8),
+                      "Antennas", UintegerValue (1));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  Ssid ssid = Ssid ("dmg-energy");
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "BeaconTransmissionInterval", TimeValue (MicroSeconds (400)),
+                   "ATIDuration", TimeValue (MicroSeconds (300)));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes.Get (0));
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "ActiveProbing", BooleanValue (false),
+                   "DozeOutsideAllocations", BooleanValue (doze));
+  devices.Add (wifi.Install (wifiPhy, wifiMac, nodes.Get (1)));
+  devices.Get (0)->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (1.0, 1.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  wifi.AssignStreams (devices, 1);
+
+  /* The DTI holds a single CBAP of 20 ms */
+  Ptr<DmgApWifiMac> apMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (devices.Get (0))->GetMac ());
+  apMac->AllocateCbapPeriod (true, 0, 20000);
+  apMac->TraceConnectWithoutContext ("MacRx", MakeCallback (&DmgEnergyTestCase::Received, this));
+
+  BasicEnergySourceHelper basicSourceHelper;
+  basicSourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (100.0));
+  EnergySourceContainer sources = basicSourceHelper.Install (nodes.Get (1));
+  DmgRadioEnergyModelHelper radioEnergyHelper;
+  DeviceEnergyModelContainer models = radioEnergyHelper.Install (devices.Get (1), sources);
+  Ptr<DmgRadioEnergyModel> model = DynamicCast<DmgRadioEnergyModel> (models.Get (0));
+
+  Time stop = MicroSeconds (5 * 102400);
+  Simulator::Schedule (MicroSeconds (2 * 102400), &DmgEnergyTestCase::Send, this, devices.Get (1), stop);
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  /* Account the energy of the last state */
+  sources.Get (0)->UpdateEnergySource ();
+  m_energy = model->GetTotalEnergyConsumption ();
+  m_beamformingEnergy = model->GetBeamformingEnergyConsumption ();
+  m_energyPerBit = model->GetEnergyPerBit ();
+  m_bits = model->GetTrafficBits ();
+  Simulator::Destroy ();
+}
+
+void
+DmgEnergyTestCase::DoRun (void)
+{
+  RunBss (false);
+  double awakeEnergy = m_energy;
+  NS_TEST_ASSERT_MSG_GT (m_received, 0, "The DMG AP received no packet");
+  NS_TEST_ASSERT_MSG_GT (m_beamformingEnergy, 0, "No energy was spent in beamforming training");
+  NS_TEST_ASSERT_MSG_LT (m_beamformingEnergy, m_energy, "All the energy was spent in beamforming training");
+  NS_TEST_ASSERT_MSG_GT (m_bits, 0, "No data was exchanged");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_energyPerBit, m_energy / m_bits, m_energyPerBit * 1e-2,
+                             "Wrong energy per bit");
+
+  RunBss (true);
+  NS_TEST_ASSERT_MSG_GT (m_received, 0, "The DMG AP received no packet from the dozing DMG STA");
+  NS_TEST_ASSERT_MSG_GT (m_beamformingEnergy, 0, "The dozing DMG STA did no beamforming training");
+  NS_TEST_ASSERT_MSG_LT (m_energy, awakeEnergy / 2, "Dozing outside the CBAP did not save energy");
+}
+
+/**
+ * Check that the DMG radio energy model counts the bits of the received data
+ * frames addressed to its device only, and not those of the overheard frames.
+ */
+class DmgEnergyOverheardTestCase : public TestCase
+{
+public:
+  DmgEnergyOverheardTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a data frame.
+   * \param receiver the receiver address (Addr1) of the frame
+   * \param size the size of the frame body and FCS
+   * \returns the data frame
+   */
+  static Ptr<Packet> CreateDataFrame (Mac48Address receiver, uint32_t size);
+};
+
+DmgEnergyOverheardTestCase::DmgEnergyOverheardTestCase ()
+  : TestCase ("Check that the overheard data frames are not counted in the energy per bit")
+{
+}
+
+Ptr<Packet>
+DmgEnergyOverheardTestCase::CreateDataFrame (Mac48Address receiver, uint32_t size)
+{
+  Ptr<Packet> packet = Create<Packet> (size);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (receiver);
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:03"));
+  hdr.SetAddr3 (Mac48Address ("00:00:00:00:00:03"));
+  packet->AddHeader (hdr);
+  return packet;
+}
+
+void
+DmgEnergyOverheardTestCase::DoRun (void)
+{
+  Ptr<DmgRadioEnergyModel> model = CreateObject<DmgRadioEnergyModel> ();
+  model->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+
+  model->NotifyRxEnd (CreateDataFrame (Mac48Address ("00:00:00:00:00:02"), 1000 + WIFI_MAC_FCS_LENGTH));
+  NS_TEST_EXPECT_MSG_EQ (model->GetTrafficBits (), 0, "An overheard data frame was counted");
+
+  model->NotifyRxEnd (CreateDataFrame (Mac48Address ("00:00:00:00:00:01"), 1000 + WIFI_MAC_FCS_LENGTH));
+  NS_TEST_EXPECT_MSG_EQ (model->GetTrafficBits (), 8000, "The data frame addressed to the device was not counted");
+
+  model->NotifyRxEnd (CreateDataFrame (Mac48Address::GetBroadcast (), 500 + WIFI_MAC_FCS_LENGTH));
+  NS_TEST_EXPECT_MSG_EQ (model->GetTrafficBits (), 12000, "The broadcast data frame was not counted");
+}
+
+/**
+ * DMG energy TestSuite
+ */
+class DmgEnergyTestSuite : public TestSuite
+{
+public:
+  DmgEnergyTestSuite ();
+};
+
+DmgEnergyTestSuite::DmgEnergyTestSuite ()
+  : TestSuite ("dmg-energy", UNIT)
+{
+  AddTestCase (new DmgEnergyTestCase, TestCase::QUICK);
+  AddTestCase (new DmgEnergyOverheardTestCase, TestCase::QUICK);
+}
+
+static DmgEnergyTestSuite g_dmgEnergyTestSuite;
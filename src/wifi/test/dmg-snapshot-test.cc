@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ssid.h"
+#include "ns3/packet.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/dmg-snapshot-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/mgt-headers.h"
+
+using namespace ns3;
+
+/**
+ * Save the state of an associated and beamformed DMG BSS, restore it
+ * into a fresh simulation and check that the DMG STA transmits without
+ * associating again, and that the DMG AP answers its Information Request
+ * from the restored information elements.
+ */
+class DmgSnapshotTestCase : public TestCase
+{
+public:
+  DmgSnapshotTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run a DMG STA sending packets to a DMG AP.
+   * \param restoreFile the snapshot to restore before the simulation starts, or an empty string
+   * \param saveFile the file in which to save a snapshot
+   * \param saveTime the time at which the snapshot is saved
+   * \param sendStart the time at which the DMG STA starts sending packets
+   * \param requestTime the time at which the DMG STA requests its own information from the DMG AP
+   * \param stop the duration of the simulation
+   */
+  void RunBss (std::string restoreFile, std::string saveFile, Time saveTime, Time sendStart,
+               Time requestTime, Time stop);
+  /**
+   * Send a packet to the DMG AP every millisecond.
+   * \param device the device of the DMG STA
+   * \param stop the time at which to stop sending
+   */
+  void Send (Ptr<NetDevice> device, Time stop);
+  /**
+   * Record the association of the DMG STA.
+   * \param address the DMG AP
+   */
+  void Associated (Mac48Address address);
+  /**
+   * Record a packet received by the DMG AP.
+   * \param packet the packet
+   */
+  void Received (Ptr<const Packet> packet);
+  /**
+   * Record the Information Response frames received by the DMG STA.
+   * \param packet the frame
+   */
+  void PhyRxEnd (Ptr<const Packet> packet);
+  /**
+   * \param filename the file name
+   * \return the content of the file
+   */
+  static std::string ReadFile (std::string filename);
+
+  uint32_t m_associations; //!< The number of associations of the DMG STA
+  Time m_associationTime;  //!< The time of the last association of the DMG STA
+  uint32_t m_received;     //!< The number of packets received by the DMG AP
+  uint32_t m_responses;    //!< The number of Information Response frames received by the DMG STA
+  uint8_t m_responseAid;   //!< The AID in the DMG Capabilities of the last Information Response
+};
+
+DmgSnapshotTestCase::DmgSnapshotTestCase ()
+  : TestCase ("Check the warm start of a DMG BSS from a snapshot"),
+    m_associations (0),
+    m_received (0),
+    m_responses (0),
+    m_responseAid (0)
+{
+}
+
+void
+DmgSnapshotTestCase::Send (Ptr<NetDevice> device, Time stop)
+{
+  device->Send (Create<Packet> (1000), Mac48Address ("00:00:00:00:00:01"), 0x0800);
+  if (Simulator::Now () + MilliSeconds (1) < stop)
+    {
+      Simulator::Schedule (MilliSeconds (1), &DmgSnapshotTestCase::Send, this, device, stop);
+    }
+}
+
+void
+DmgSnapshotTestCase::Associated (Mac48Address address)
+{
+  m_associations++;
+  m_associationTime = Simulator::Now ();
+}
+
+void
+DmgSnapshotTestCase::Received (Ptr<const Packet> packet)
+{
+  m_received++;
+}
+
+void
+DmgSnapshotTestCase::PhyRxEnd (Ptr<const Packet> packet)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  WifiMacHeader hdr;
+  copy->RemoveHeader (hdr);
+  if (!hdr.IsAction () || hdr.GetAddr1 () != Mac48Address ("00:00:00:00:00:02"))
+    {
+      return;
+    }
+  WifiMacTrailer fcs;
+  copy->RemoveTrailer (fcs);
+  WifiActionHeader actionHdr;
+  copy->RemoveHeader (actionHdr);
+  if (actionHdr.GetCategory () == WifiActionHeader::DMG
+      && actionHdr.GetAction ().dmgAction == WifiActionHeader::DMG_INFORMATION_RESPONSE)
+    {
+      ExtInformationResponse responseHdr;
+      copy->RemoveHeader (responseHdr);
+      m_responses++;
+      m_responseAid = responseHdr.GetDmgCapabilitiesList ()[0]->GetAID ();
+    }
+}
+
+std::string
+DmgSnapshotTestCase::ReadFile (std::string filename)
+{
+  std::ifstream ifs (filename.c_str ());
+  std::ostringstream oss;
+  oss << ifs.rdbuf ();
+  return oss.str ();
+}
+
+void
+DmgSnapshotTestCase::RunBss (std::string restoreFile, std::string saveFile, Time saveTime, Time sendStart,
+                             Time requestTime, Time stop)
+{
+  m_associations = 0;
+  m_received = 0;
+  m_responses = 0;
+  m_responseAid = 0;
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS12"),
+                                "DataMode", StringValue ("DMG_MCS12"));
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (56.16e9));
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (100.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("RxNoiseFigure", DoubleValue (3));
+  wifiPhy.SetErrorRateModel ("ns3::SensitivityModel60GHz");
+  wifiPhy.EnableAntenna (true, true);
+  wifiPhy.SetAntenna ("ns3::Directional60GhzAntenna",
+                      "Sectors", UintegerValue (8),
+                      "Antennas", UintegerValue (1));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  Ssid ssid = Ssid ("dmg-snapshot");
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "BeaconTransmissionInterval", TimeValue (MicroSeconds (400)),
+                   "ATIDuration", TimeValue (MicroSeconds (300)));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes.Get (0));
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "ActiveProbing", BooleanValue (false),
+                   "BE_BlockAckThreshold", UintegerValue (1));
+  devices.Add (wifi.Install (wifiPhy, wifiMac, nodes.Get (1)));
+  // the snapshot identifies the devices by their addresses
+  devices.Get (0)->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  devices.Get (1)->SetAddress (Mac48Address ("00:00:00:00:00:02"));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (1.0, 1.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  wifi.AssignStreams (devices, 1);
+
+  Ptr<WifiMac> apMac = StaticCast<WifiNetDevice> (devices.Get (0))->GetMac ();
+  apMac->TraceConnectWithoutContext ("MacRx", MakeCallback (&DmgSnapshotTestCase::Received, this));
+  Ptr<WifiMac> staMac = StaticCast<WifiNetDevice> (devices.Get (1))->GetMac ();
+  staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&DmgSnapshotTestCase::Associated, this));
+  StaticCast<WifiNetDevice> (devices.Get (1))->GetPhy ()->TraceConnectWithoutContext (
+    "PhyRxEnd", MakeCallback (&DmgSnapshotTestCase::PhyRxEnd, this));
+
+  DmgSnapshotHelper snapshot;
+  if (!restoreFile.empty ())
+    {
+      snapshot.Restore (restoreFile, devices);
+    }
+  Simulator::Schedule (saveTime, &DmgSnapshotHelper::Save, &snapshot, saveFile, devices);
+  Simulator::Schedule (sendStart, &DmgSnapshotTestCase::Send, this, devices.Get (1), stop);
+  Simulator::Schedule (requestTime, &DmgStaWifiMac::RequestInformation, StaticCast<DmgStaWifiMac> (staMac),
+                       Mac48Address ("00:00:00:00:00:02"));
+
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+DmgSnapshotTestCase::DoRun (void)
+{
+  std::string warmFile = CreateTempDirFilename ("dmg-snapshot-warm.txt");
+  std::string restoredFile = CreateTempDirFilename ("dmg-snapshot-restored.txt");
+
+  // warm up: associate, beamform and establish a block ack agreement
+  RunBss ("", warmFile, MilliSeconds (450), MilliSeconds (250), MilliSeconds (300), MilliSeconds (500));
+  NS_TEST_ASSERT_MSG_EQ (m_associations, 1, "The DMG STA did not associate during the warm up");
+  NS_TEST_ASSERT_MSG_GT (m_received, 0, "The DMG AP received no packet during the warm up");
+  NS_TEST_ASSERT_MSG_GT (m_responses, 0, "The DMG STA received no Information Response during the warm up");
+  uint8_t aid = m_responseAid;
+  std::string warm = ReadFile (warmFile);
+  NS_TEST_ASSERT_MSG_NE (warm.find ("originators 1"), std::string::npos, "No block ack agreement was saved");
+  NS_TEST_ASSERT_MSG_NE (warm.find ("stations 1"), std::string::npos, "No DMG STA information elements were saved");
+  NS_TEST_ASSERT_MSG_NE (warm.find ("information 1"), std::string::npos, "No Information Response was saved");
+
+  // the restored state is saved back unchanged
+  RunBss (warmFile, restoredFile, Seconds (0), Seconds (0), MilliSeconds (10), MilliSeconds (250));
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (restoredFile), warm, "The restored state differs from the snapshot");
+  NS_TEST_ASSERT_MSG_EQ (m_associations, 1, "The restored DMG STA associated again");
+  NS_TEST_ASSERT_MSG_EQ (m_associationTime, Seconds (0), "The DMG STA was not associated by the snapshot");
+  NS_TEST_ASSERT_MSG_GT (m_received, 0, "The DMG AP received no packet from the restored DMG STA");
+  NS_TEST_ASSERT_MSG_GT (m_responses, 0, "The restored DMG AP did not answer the Information Request");
+  NS_TEST_ASSERT_MSG_EQ (uint32_t (m_responseAid), uint32_t (aid), "The restored DMG AP lost the DMG Capabilities");
+}
+
+/**
+ * DMG snapshot TestSuite
+ */
+class DmgSnapshotTestSuite : public TestSuite
+{
+public:
+  DmgSnapshotTestSuite ();
+};
+
+DmgSnapshotTestSuite::DmgSnapshotTestSuite ()
+  : TestSuite ("dmg-snapshot", UNIT)
+{
+  AddTestCase (new DmgSnapshotTestCase, TestCase::QUICK);
+}
+
+static DmgSnapshotTestSuite g_dmgSnapshotTestSuite;
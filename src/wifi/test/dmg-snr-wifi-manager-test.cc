@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/dmg-snr-wifi-manager.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \param ofdmEnabled whether the OFDM MCSs can be selected
+ * \returns an initialized manager attached to a DMG PHY
+ */
+static Ptr<DmgSnrWifiManager>
+CreateManager (bool ofdmEnabled)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ad);
+  Ptr<DmgSnrWifiManager> manager = CreateObject<DmgSnrWifiManager> ();
+  manager->SetAttribute ("OfdmEnabled", BooleanValue (ofdmEnabled));
+  manager->SetupPhy (phy);
+  manager->Initialize ();
+  return manager;
+}
+
+/**
+ * \param manager the manager
+ * \param address the remote station
+ * \param tid the TID of the data
+ * \returns the name of the mode selected to send data of \p tid to \p address
+ */
+static std::string
+GetDataMode (Ptr<DmgSnrWifiManager> manager, Mac48Address address, uint8_t tid = 0)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (tid);
+  return manager->GetDataTxVector (address, &hdr, Create<Packet> (1000)).GetMode ().GetUniqueName ();
+}
+
+/**
+ * Check the MCS selected by the DmgSnrWifiManager from the beamforming
+ * SNR, the data SNR feedback and the Block ACK losses.
+ */
+class DmgSnrWifiManagerTestCase : public TestCase
+{
+public:
+  DmgSnrWifiManagerTestCase ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Record a rate change.
+   * \param address the remote station
+   * \param oldMode the previous mode
+   * \param newMode the new mode
+   */
+  void RateChange (Mac48Address address, WifiMode oldMode, WifiMode newMode);
+
+  uint32_t m_rateChanges;  //!< The number of rate changes traced
+};
+
+DmgSnrWifiManagerTestCase::DmgSnrWifiManagerTestCase ()
+  : TestCase ("Check the DMG MCS selected from the beamforming SNR and the Block ACK losses"),
+    m_rateChanges (0)
+{
+}
+
+void
+DmgSnrWifiManagerTestCase::RateChange (Mac48Address address, WifiMode oldMode, WifiMode newMode)
+{
+  m_rateChanges++;
+}
+
+void
+DmgSnrWifiManagerTestCase::DoRun (void)
+{
+  Ptr<DmgSnrWifiManager> manager = CreateManager (true);
+  manager->TraceConnectWithoutContext ("RateChange", MakeCallback (&DmgSnrWifiManagerTestCase::RateChange, this));
+  Mac48Address address = Mac48Address::Allocate ();
+
+  /* 2160 MHz noise floor with a noise figure of 7 dB: -73.63 dBm */
+  NS_TEST_ASSERT_MSG_EQ_TOL (10 * std::log10 (manager->GetSnrThreshold (WifiPhy::GetDMG_MCS1 ())), 5.63, 0.01,
+                             "Unexpected threshold of DMG_MCS1");
+  NS_TEST_ASSERT_MSG_EQ_TOL (10 * std::log10 (manager->GetSnrThreshold (WifiPhy::GetDMG_MCS24 ())), 26.63, 0.01,
+                             "Unexpected threshold of DMG_MCS24");
+
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS1", "The slowest SC MCS is used until the link is trained");
+
+  manager->ReportBeamformingSnr (address, std::pow (10.0, 30.0 / 10.0));
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS24", "Wrong MCS for a 30 dB link");
+  NS_TEST_ASSERT_MSG_EQ (m_rateChanges, 1, "Rate change not traced");
+
+  /* DMG_MCS8 (SC) needs 12.63 dB and is faster than DMG_MCS17 (OFDM) */
+  manager->ReportBeamformingSnr (address, std::pow (10.0, 15.0 / 10.0));
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS8", "Wrong MCS for a 15 dB link");
+
+  /* The data SNR fed back by the receiver refines the estimate */
+  manager->ReportAmpduTxStatus (address, 0, 8, 0, 0, std::pow (10.0, 22.0 / 10.0));
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS12", "Wrong MCS for a 22 dB link");
+
+  /* A lossy window steps the MCS down, good windows step it back up */
+  manager->ReportBeamformingSnr (address, std::pow (10.0, 30.0 / 10.0));
+  manager->ReportAmpduTxStatus (address, 0, 32, 32, 0, 0);
+  std::string mode = GetDataMode (manager, address);
+  NS_TEST_ASSERT_MSG_NE (mode, "DMG_MCS24", "The MCS was not lowered after losses");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      manager->ReportAmpduTxStatus (address, 0, 64, 0, 0, 0);
+      NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), mode, "The MCS was raised too early");
+    }
+  manager->ReportAmpduTxStatus (address, 0, 64, 0, 0, 0);
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS24", "The MCS was not raised back");
+
+  /* Successive losses do not go below the slowest MCS and a new training resets them */
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      manager->ReportAmpduTxStatus (address, 0, 0, 64, 0, 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS1", "Wrong MCS after repeated losses");
+  manager->ReportBeamformingSnr (address, std::pow (10.0, 30.0 / 10.0));
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, address), "DMG_MCS24", "A new training does not reset the losses");
+
+  Ptr<DmgSnrWifiManager> scOnly = CreateManager (false);
+  scOnly->ReportBeamformingSnr (address, std::pow (10.0, 30.0 / 10.0));
+  NS_TEST_ASSERT_MSG_EQ (GetDataMode (scOnly, address), "DMG_MCS12", "Wrong MCS for a 30 dB link without OFDM");
+}
+
+/**
+ * Check that the state kept per station and TID is found back among
+ * many stations.
+ */
+class DmgSnrWifiManagerStationsTestCase : public TestCase
+{
+public:
+  DmgSnrWifiManagerStationsTestCase ();
+
+  virtual void DoRun (void);
+};
+
+DmgSnrWifiManagerStationsTestCase::DmgSnrWifiManagerStationsTestCase ()
+  : TestCase ("Check the lookup of the state of many stations and TIDs")
+{
+}
+
+void
+DmgSnrWifiManagerStationsTestCase::DoRun (void)
+{
+  Ptr<DmgSnrWifiManager> manager = CreateManager (true);
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+      for (uint8_t tid = 0; tid < 4; tid++)
+        {
+          GetDataMode (manager, addresses[i], tid);
+        }
+    }
+  for (uint32_t i = 0; i < addresses.size (); i += 2)
+    {
+      manager->ReportBeamformingSnr (addresses[i], std::pow (10.0, 30.0 / 10.0));
+      manager->ReportAmpduTxStatus (addresses[i], 2, 0, 64, 0, 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (manager->GetNAssociatedStation (), addresses.size (), "One state per station expected");
+  for (uint32_t i = 0; i < addresses.size (); i++)
+    {
+      for (uint8_t tid = 0; tid < 4; tid++)
+        {
+          std::string expected = (i % 2) ? "DMG_MCS1" : (tid == 2 ? "DMG_MCS23" : "DMG_MCS24");
+          NS_TEST_ASSERT_MSG_EQ (GetDataMode (manager, addresses[i], tid), expected,
+                                 "Wrong mode for station " << i << " and TID " << (uint16_t)tid);
+        }
+    }
+}
+
+/**
+ * DmgSnrWifiManager TestSuite
+ */
+class DmgSnrWifiManagerTestSuite : public TestSuite
+{
+public:
+  DmgSnrWifiManagerTestSuite ();
+};
+
+DmgSnrWifiManagerTestSuite::DmgSnrWifiManagerTestSuite ()
+  : TestSuite ("dmg-snr-wifi-manager", UNIT)
+{
+  AddTestCase (new DmgSnrWifiManagerTestCase, TestCase::QUICK);
+  AddTestCase (new DmgSnrWifiManagerStationsTestCase, TestCase::QUICK);
+}
+
+static DmgSnrWifiManagerTestSuite g_dmgSnrWifiManagerTestSuite;
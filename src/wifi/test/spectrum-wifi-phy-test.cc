@@ -30,6 +30,8 @@
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/wifi-phy-standard.h"
 #include "ns3/wifi-spectrum-signal-parameters.h"
+#include "ns3/spectrum-converter.h"
+#include <cmath>
 
 using namespace ns3;
 
@@ -247,6 +249,68 @@ SpectrumWifiPhyListenerTest::DoRun (void)
   delete m_listener;
 }
 
+/**
+ * Check the DMG spectrum model and transmit spectrum masks, and the
+ * power leaking into the adjacent DMG channels.
+ */
+class SpectrumWifiPhyDmgSpectrumTest : public TestCase
+{
+public:
+  SpectrumWifiPhyDmgSpectrumTest ();
+  virtual ~SpectrumWifiPhyDmgSpectrumTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param psd the transmit power spectral density
+   * \param centerFrequency the center frequency (MHz) of the receiver
+   * \return the power (W) received through the RF filter of a DMG channel
+   */
+  double GetFilteredPower (Ptr<SpectrumValue> psd, uint32_t centerFrequency);
+};
+
+SpectrumWifiPhyDmgSpectrumTest::SpectrumWifiPhyDmgSpectrumTest ()
+  : TestCase ("SpectrumWifiPhy test of the DMG spectrum masks")
+{
+}
+
+SpectrumWifiPhyDmgSpectrumTest::~SpectrumWifiPhyDmgSpectrumTest ()
+{
+}
+
+double
+SpectrumWifiPhyDmgSpectrumTest::GetFilteredPower (Ptr<SpectrumValue> psd, uint32_t centerFrequency)
+{
+  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (centerFrequency, 2160);
+  SpectrumConverter converter (psd->GetSpectrumModel (), filter->GetSpectrumModel ());
+  return Integral ((*filter) * (*converter.Convert (psd)));
+}
+
+void
+SpectrumWifiPhyDmgSpectrumTest::DoRun (void)
+{
+  double txPowerWatts = 0.010;
+
+  Ptr<SpectrumWifiPhy> phy = CreateObject<SpectrumWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ad);
+  NS_TEST_ASSERT_MSG_EQ (phy->GetRxSpectrumModel ()->GetNumBands (), 109, "Unexpected number of bands of the DMG spectrum model");
+
+  Ptr<SpectrumValue> sc = WifiSpectrumValueHelper::CreateDmgScTxPowerSpectralDensity (60480, txPowerWatts);
+  Ptr<SpectrumValue> ofdm = WifiSpectrumValueHelper::CreateDmgOfdmTxPowerSpectralDensity (60480, txPowerWatts);
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*sc), txPowerWatts, 1e-9, "The SC PSD does not hold the transmit power");
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*ofdm), txPowerWatts, 1e-9, "The OFDM PSD does not hold the transmit power");
+  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (60480, 2160);
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*filter), 2160e6, 1, "The RF filter does not span the channel");
+
+  // Power received in the channel and in the adjacent channels (dBr)
+  double scInBand = 10 * std::log10 (GetFilteredPower (sc, 60480) / txPowerWatts);
+  double scAdjacent = 10 * std::log10 (GetFilteredPower (sc, 62640) / txPowerWatts);
+  double ofdmAdjacent = 10 * std::log10 (GetFilteredPower (ofdm, 58320) / txPowerWatts);
+  NS_TEST_ASSERT_MSG_EQ_TOL (scInBand, 0, 0.2, "Too much SC power out of the channel");
+  NS_TEST_ASSERT_MSG_EQ_TOL (scAdjacent, -19.01, 0.01, "Unexpected SC adjacent channel leakage");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ofdmAdjacent, -19.00, 0.01, "Unexpected OFDM adjacent channel leakage");
+  NS_TEST_ASSERT_MSG_EQ (GetFilteredPower (sc, 64800), 0, "SC power two channels away");
+}
+
 class SpectrumWifiPhyTestSuite : public TestSuite
 {
 public:
@@ -258,6 +322,7 @@ SpectrumWifiPhyTestSuite::SpectrumWifiPhyTestSuite ()
 {
   AddTestCase (new SpectrumWifiPhyBasicTest, TestCase::QUICK);
   AddTestCase (new SpectrumWifiPhyListenerTest, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyDmgSpectrumTest, TestCase::QUICK);
 }
 
 static SpectrumWifiPhyTestSuite spectrumWifiPhyTestSuite;
@@ -32,6 +32,8 @@
 #include "ns3/wifi-mac-trailer.h"
 #include "ns3/msdu-standard-aggregator.h"
 #include "ns3/mpdu-standard-aggregator.h"
+#include "ns3/gso-tag.h"
+#include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 
 using namespace ns3;
@@ -380,6 +382,86 @@ TwoLevelAggregationTest::DoRun (void)
 }
 
 
+class GsoQueueTest : public TestCase
+{
+public:
+  GsoQueueTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Split a super-segment of the test protocol, which has no header.
+   *
+   * \param packet the super-segment
+   * \param segmentSize the payload size of the segments
+   * \returns the segments
+   */
+  static std::list<Ptr<Packet> > Segment (Ptr<const Packet> packet, uint16_t segmentSize);
+};
+
+GsoQueueTest::GsoQueueTest ()
+  : TestCase ("Check that the MAC queue splits the super-segments into MSDUs")
+{
+}
+
+std::list<Ptr<Packet> >
+GsoQueueTest::Segment (Ptr<const Packet> packet, uint16_t segmentSize)
+{
+  std::list<Ptr<Packet> > segments;
+  for (uint32_t offset = 0; offset < packet->GetSize (); offset += segmentSize)
+    {
+      segments.push_back (packet->CreateFragment (offset, std::min<uint32_t> (segmentSize, packet->GetSize () - offset)));
+    }
+  return segments;
+}
+
+void
+GsoQueueTest::DoRun (void)
+{
+  const uint16_t protocol = 0x88b5; // Local experimental EtherType
+  GsoTag::SetSegmentCallback (protocol, MakeCallback (&GsoQueueTest::Segment));
+
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+  WifiMacHeader hdr, peekedHdr;
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:02"));
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  LlcSnapHeader llc;
+  llc.SetType (protocol);
+
+  /*
+   * A super-segment of 3500 bytes with segments of 1000 bytes is enqueued
+   * as four MSDUs, each with the LLC header and without the tag.
+   */
+  Ptr<Packet> superSegment = Create<Packet> (3500);
+  superSegment->AddPacketTag (GsoTag (1000));
+  superSegment->AddHeader (llc);
+  queue->Enqueue (superSegment, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 4, "the super-segment was not split");
+  uint32_t expected[] = {1000, 1000, 1000, 500};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<const Packet> packet = queue->Dequeue (&peekedHdr);
+      GsoTag tag;
+      NS_TEST_EXPECT_MSG_EQ (packet->PeekPacketTag (tag), false, "the MSDU carries the GsoTag");
+      NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), expected[i] + llc.GetSerializedSize (), "wrong MSDU size");
+      NS_TEST_EXPECT_MSG_EQ (peekedHdr.GetAddr1 (), hdr.GetAddr1 (), "wrong MAC header");
+    }
+
+  /*
+   * Without a function splitting them, the super-segments are enqueued whole.
+   */
+  Ptr<Packet> unknown = Create<Packet> (3500);
+  unknown->AddPacketTag (GsoTag (1000));
+  llc.SetType (protocol + 1);
+  unknown->AddHeader (llc);
+  queue->Enqueue (unknown, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 1, "a super-segment of an unknown protocol was split");
+  Simulator::Destroy ();
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiAggregationTestSuite : public TestSuite
 {
@@ -392,6 +474,7 @@ WifiAggregationTestSuite::WifiAggregationTestSuite ()
 {
   AddTestCase (new AmpduAggregationTest, TestCase::QUICK);
   AddTestCase (new TwoLevelAggregationTest, TestCase::QUICK);
+  AddTestCase (new GsoQueueTest, TestCase::QUICK);
 }
 
 static WifiAggregationTestSuite g_wifiAggregationTestSuite;
@@ -39,6 +39,11 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/pcap-file.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/dynamic-queue-limits.h"
 
 using namespace ns3;
 
@@ -1090,6 +1095,213 @@ Bug2222TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_countInternalCollisions, 1, "unexpected number of internal collisions!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the attributes set with WifiPhyHelper::SetPcapFileAttribute
+ * are applied to the files created by EnablePcap: a file written through the
+ * write-behind buffer must be identical to a file written record by record,
+ * and a gzip file must be compressed.
+ */
+class WifiPcapFileAttributeTest : public TestCase
+{
+public:
+  WifiPcapFileAttributeTest ();
+  virtual ~WifiPcapFileAttributeTest ();
+
+  virtual void DoRun (void);
+};
+
+WifiPcapFileAttributeTest::WifiPcapFileAttributeTest ()
+  : TestCase ("Check the pcap file attributes set through the wifi PHY helper")
+{
+}
+
+WifiPcapFileAttributeTest::~WifiPcapFileAttributeTest ()
+{
+}
+
+void
+WifiPcapFileAttributeTest::DoRun (void)
+{
+  NodeContainer wifiNodes;
+  wifiNodes.Create (2);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer wifiDevices = wifi.Install (phy, mac, wifiNodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (10.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  std::string plainFilename = CreateTempDirFilename ("wifi-plain.pcap");
+  std::string bufferedFilename = CreateTempDirFilename ("wifi-buffered.pcap");
+  std::string gzipFilename = CreateTempDirFilename ("wifi-compressed.pcap.gz");
+  bool gzip = PcapFile::IsCompressionSupported (PcapFile::COMPRESSION_GZIP);
+
+  phy.EnablePcap (plainFilename, wifiDevices.Get (1), true, true);
+  phy.SetPcapFileAttribute ("WriteBufferSize", UintegerValue (512));
+  phy.SetPcapFileAttribute ("BackgroundFlush", BooleanValue (true));
+  phy.EnablePcap (bufferedFilename, wifiDevices.Get (1), true, true);
+  if (gzip)
+    {
+      phy.SetPcapFileAttribute ("WriteBufferSize", UintegerValue (0));
+      phy.SetPcapFileAttribute ("BackgroundFlush", BooleanValue (false));
+      phy.SetPcapFileAttribute ("Compression", EnumValue (PcapFile::COMPRESSION_GZIP));
+      phy.EnablePcap (gzipFilename, wifiDevices.Get (1), true, true);
+    }
+
+  PacketSocketAddress socket;
+  socket.SetSingleDevice (wifiDevices.Get (0)->GetIfIndex ());
+  socket.SetPhysicalAddress (wifiDevices.Get (1)->GetAddress ());
+  socket.SetProtocol (1);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (wifiNodes);
+
+  Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+  client->SetAttribute ("PacketSize", UintegerValue (1000));
+  client->SetAttribute ("MaxPackets", UintegerValue (20));
+  client->SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+  client->SetRemote (socket);
+  wifiNodes.Get (0)->AddApplication (client);
+  client->SetStartTime (Seconds (0.1));
+
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->SetLocal (socket);
+  wifiNodes.Get (1)->AddApplication (server);
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  // Closes the pcap files
+  Simulator::Destroy ();
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (plainFilename, bufferedFilename, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Buffered file differs from the plain file at packet " << packets);
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (packets, 40, "The pcap files should hold the data frames and their acks");
+
+  if (gzip)
+    {
+      FILE *p = std::fopen (gzipFilename.c_str (), "rb");
+      NS_TEST_ASSERT_MSG_NE (p, 0, "Compressed file was not created");
+      uint8_t magic[2] = { 0, 0 };
+      size_t result = std::fread (magic, 1, 2, p);
+      std::fclose (p);
+      NS_TEST_EXPECT_MSG_EQ (result, 2, "Compressed file is empty");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)magic[0], 0x1f, "Compressed file has no gzip magic number");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)magic[1], 0x8b, "Compressed file has no gzip magic number");
+      remove (gzipFilename.c_str ());
+    }
+
+  remove (plainFilename.c_str ());
+  remove (bufferedFilename.c_str ());
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the WifiMacQueue reports the bytes of the data frames it
+ * holds to the device transmission queue of their access category, so that
+ * the queue limits of the device stop and wake the queue disc.
+ */
+class WifiMacQueueLimitsTest : public TestCase
+{
+public:
+  WifiMacQueueLimitsTest ();
+  virtual ~WifiMacQueueLimitsTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /// Wake callback of the device transmission queues
+  void Wake (void);
+
+  uint32_t m_wakes; //!< Number of times a device transmission queue was woken
+};
+
+WifiMacQueueLimitsTest::WifiMacQueueLimitsTest ()
+  : TestCase ("Check that the WifiMacQueue reports its bytes to the device queue limits"),
+    m_wakes (0)
+{
+}
+
+WifiMacQueueLimitsTest::~WifiMacQueueLimitsTest ()
+{
+}
+
+void
+WifiMacQueueLimitsTest::Wake (void)
+{
+  m_wakes++;
+}
+
+void
+WifiMacQueueLimitsTest::DoRun (void)
+{
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  ndqi->SetTxQueuesN (4);
+  ndqi->CreateTxQueues ();
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      ndqi->GetTxQueue (i)->SetQueueLimits (CreateObject<DynamicQueueLimits> ());
+      ndqi->GetTxQueue (i)->SetWakeCallback (MakeCallback (&WifiMacQueueLimitsTest::Wake, this));
+    }
+
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+  queue->SetNetDeviceQueueInterface (ndqi);
+
+  WifiMacHeader mgtHdr;
+  mgtHdr.SetType (WIFI_MAC_MGT_ACTION);
+  WifiMacHeader voHdr;
+  voHdr.SetType (WIFI_MAC_QOSDATA);
+  voHdr.SetQosTid (6);
+
+  // The initial limit of the dynamic queue limits is zero
+  queue->Enqueue (Create<Packet> (1000), mgtHdr);
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (0)->IsStopped (), false, "Management frames are not reported");
+  queue->Enqueue (Create<Packet> (1000), voHdr);
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_VO)->IsStopped (), true, "The AC_VO queue should be stopped by its limits");
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_BE)->IsStopped (), false, "The AC_BE queue should not be stopped");
+
+  WifiMacHeader hdr;
+  queue->Dequeue (&hdr);
+  queue->Dequeue (&hdr);
+  NS_TEST_EXPECT_MSG_EQ (hdr.IsQosData (), true, "The QoS data frame should be dequeued last");
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_VO)->IsStopped (), true, "The dequeued bytes are reported in a new event");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_VO)->IsStopped (), false, "The AC_VO queue should be woken by the dequeue");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes, 1, "The queue disc should be woken once");
+
+  // The limit has grown to the bytes of one frame
+  queue->Enqueue (Create<Packet> (1000), voHdr);
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_VO)->IsStopped (), false, "One frame is within the limit");
+  queue->Enqueue (Create<Packet> (1000), voHdr);
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_VO)->IsStopped (), true, "Two frames exceed the limit");
+  queue->Flush ();
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (ndqi->GetTxQueue (AC_VO)->IsStopped (), false, "The flushed frames should be reported");
+  NS_TEST_EXPECT_MSG_EQ (m_wakes, 2, "The queue disc should be woken once by the flush");
+
+  // Without queue limits, nothing is reported
+  Ptr<NetDeviceQueueInterface> unlimited = CreateObject<NetDeviceQueueInterface> ();
+  unlimited->CreateTxQueues ();
+  queue->SetNetDeviceQueueInterface (unlimited);
+  queue->Enqueue (Create<Packet> (1000), voHdr);
+  queue->Dequeue (&hdr);
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "No event should be scheduled without queue limits");
+
+  Simulator::Destroy ();
+}
+
 //-----------------------------------------------------------------------------
 
 class WifiTestSuite : public TestSuite
@@ -1108,6 +1320,8 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
   AddTestCase (new SetChannelFrequencyTest, TestCase::QUICK);
   AddTestCase (new Bug2222TestCase, TestCase::QUICK); //Bug 2222
+  AddTestCase (new WifiPcapFileAttributeTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueLimitsTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;